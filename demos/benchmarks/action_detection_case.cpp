@@ -0,0 +1,77 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "action_detector.hpp"
+#include "benchmark.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+const cv::Size networkInputSize(680, 400);
+const cv::Size frameSize(1920, 1080);
+
+BlobMap generate(std::mt19937& rng) {
+    const ActionDetectorConfig config("");
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> actionLogit(0.0f, 0.2f);
+    std::normal_distribution<float> locOffset(0.0f, 0.5f);
+    std::bernoulli_distribution isPerson(0.01);
+
+    BlobMap outputs;
+    size_t candidates = 0;
+    for (size_t head = 0; head < config.new_det_heads.size(); head++) {
+        const size_t step = config.new_det_heads[head].step;
+        const size_t height = (networkInputSize.height + step - 1) / step;
+        const size_t width = (networkInputSize.width + step - 1) / step;
+        for (int anchor = 0; anchor < config.new_anchors[head]; anchor++) {
+            std::vector<float> actions(config.num_action_classes * height * width);
+            for (float& value : actions) {
+                value = actionLogit(rng);
+            }
+            outputs[config.new_action_conf_blob_name_prefix + std::to_string(head + 1) +
+                    config.new_action_conf_blob_name_suffix + std::to_string(anchor + 1)] =
+                makeBlob({1, config.num_action_classes, height, width}, actions);
+        }
+        candidates += config.new_anchors[head] * height * width;
+    }
+
+    std::vector<float> loc(candidates * 4);
+    for (float& value : loc) {
+        value = locOffset(rng);
+    }
+    std::vector<float> conf(candidates * 2);
+    for (size_t p = 0; p < candidates; p++) {
+        const float personConf = isPerson(rng) ? 0.5f + 0.5f * unit(rng) : 0.1f * unit(rng);
+        conf[p * 2] = 1.0f - personConf;
+        conf[p * 2 + 1] = personConf;
+    }
+    outputs[config.new_loc_blob_name] = makeBlob({1, candidates * 4}, loc);
+    outputs[config.new_det_conf_blob_name] = makeBlob({1, candidates * 2}, conf);
+    return outputs;
+}
+
+Routine prepare(const BlobMap& outputs) {
+    ActionDetectorConfig config("");
+    OutputsDataMap outputsInfo;
+    for (const auto& output : outputs) {
+        outputsInfo[output.first] = std::make_shared<Data>(output.first, output.second->getTensorDesc());
+        if (0 == output.first.find(config.new_action_conf_blob_name_prefix)) {
+            config.num_action_classes = output.second->getTensorDesc().getDims()[1];
+        }
+    }
+    std::shared_ptr<ActionDetection> detector =
+        std::make_shared<ActionDetection>(config, outputsInfo, networkInputSize);
+    return [detector](const BlobMap& outputs) {
+        return detector->GetDetections(outputs, frameSize).size();
+    };
+}
+}  // namespace
+
+BenchmarkCase actionDetectionCase() {
+    return {"action_detection", generate, prepare};
+}
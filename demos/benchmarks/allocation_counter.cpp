@@ -0,0 +1,119 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> allocationsCount{0};
+std::atomic<uint64_t> allocatedBytes{0};
+
+inline void count(size_t size) {
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+}  // namespace
+
+AllocationCounters getAllocationCounters() {
+    return {allocationsCount.load(std::memory_order_relaxed), allocatedBytes.load(std::memory_order_relaxed)};
+}
+
+#if defined(__GLIBC__)
+
+// The definitions interpose the allocator of glibc for the whole process, the libraries
+// included, and forward to its implementation, so the memory may be freed by either.
+extern "C" {
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* ptr, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+void __libc_free(void* ptr) noexcept;
+
+void* malloc(size_t size) noexcept {
+    count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count_, size_t size) noexcept {
+    count(count_ * size);
+    return __libc_calloc(count_, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    count(size);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept {
+    if (0 == alignment || 0 != alignment % sizeof(void*) || 0 != (alignment & (alignment - 1))) {
+        return EINVAL;
+    }
+    count(size);
+    void* result = __libc_memalign(alignment, size);
+    if (!result && 0 != size) {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+
+void free(void* ptr) noexcept {
+    __libc_free(ptr);
+}
+}  // extern "C"
+
+#else
+
+void* operator new(size_t size) {
+    count(size);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    count(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+#endif
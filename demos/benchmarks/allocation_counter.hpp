@@ -0,0 +1,20 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstdint>
+
+///
+/// \brief Counters of the heap allocations made by all threads of the process.
+///
+/// With glibc the counters include malloc() and its aligned variants, so the buffers of
+/// cv::Mat are counted as well as operator new. Elsewhere only operator new is counted.
+///
+struct AllocationCounters {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+AllocationCounters getAllocationCounters();
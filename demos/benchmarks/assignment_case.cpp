@@ -0,0 +1,106 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "kuhn_munkres.hpp"
+#include "linear_assignment.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+// trackers reject the pairs with the affinity below their threshold, smart_classroom_demo's one is 0.85
+const float gate = 1.0f - 0.85f;
+
+// Tracks and detections of a frame: most detections continue a track near them, the others are new objects.
+// The objects are spread over an area growing with their number, so an object has a few neighbours at any count.
+BlobMap generate(std::mt19937& rng, size_t objects) {
+    const float side = std::sqrt(static_cast<float>(objects));
+    const float sigma = 0.5f;
+    std::uniform_real_distribution<float> position(0.0f, side);
+    std::normal_distribution<float> motion(0.0f, 0.1f);
+    std::bernoulli_distribution isNew(0.1);
+
+    std::vector<cv::Point2f> tracks(objects);
+    for (cv::Point2f& track : tracks) {
+        track = {position(rng), position(rng)};
+    }
+    std::vector<size_t> order(objects);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<cv::Point2f> detections(objects);
+    for (size_t i = 0; i < objects; i++) {
+        detections[order[i]] = isNew(rng) ? cv::Point2f(position(rng), position(rng))
+                                          : tracks[i] + cv::Point2f(motion(rng), motion(rng));
+    }
+
+    std::vector<float> dissimilarity(objects * objects);
+    for (size_t i = 0; i < objects; i++) {
+        for (size_t j = 0; j < objects; j++) {
+            const cv::Point2f d = tracks[i] - detections[j];
+            dissimilarity[i * objects + j] = 1.0f - std::exp(-d.dot(d) / (2 * sigma * sigma));
+        }
+    }
+
+    BlobMap outputs;
+    outputs["dissimilarity"] = makeBlob({objects, objects}, dissimilarity);
+    return outputs;
+}
+
+void checkOutputs(const BlobMap& outputs) {
+    if (outputs.size() != 1 || outputs.begin()->second->getTensorDesc().getDims().size() != 2) {
+        throw std::runtime_error("Assignment benchmarks expect one dissimilarity matrix");
+    }
+}
+
+size_t countMatches(const cv::Mat& dissimilarity, const std::vector<size_t>& result) {
+    size_t matches = 0;
+    for (size_t i = 0; i < result.size(); i++) {
+        if (result[i] != static_cast<size_t>(-1)
+                && dissimilarity.at<float>(static_cast<int>(i), static_cast<int>(result[i])) <= gate) {
+            matches++;
+        }
+    }
+    return matches;
+}
+
+Routine prepareLinearAssignment(const BlobMap& outputs) {
+    checkOutputs(outputs);
+    std::shared_ptr<LinearAssignment> solver = std::make_shared<LinearAssignment>();
+    return [solver](const BlobMap& outputs) {
+        const Blob::Ptr& blob = outputs.begin()->second;
+        const SizeVector& dims = blob->getTensorDesc().getDims();
+        LockedMemory<const void> mapped = as<MemoryBlob>(blob)->rmap();
+        const cv::Mat dissimilarity(static_cast<int>(dims[0]), static_cast<int>(dims[1]), CV_32F, mapped.as<float*>());
+        return countMatches(dissimilarity, solver->Solve(dissimilarity, gate));
+    };
+}
+
+// the trackers solved the whole matrix and dropped the pairs above the gate afterwards
+Routine prepareKuhnMunkres(const BlobMap& outputs) {
+    checkOutputs(outputs);
+    std::shared_ptr<KuhnMunkres> solver = std::make_shared<KuhnMunkres>();
+    return [solver](const BlobMap& outputs) {
+        const Blob::Ptr& blob = outputs.begin()->second;
+        const SizeVector& dims = blob->getTensorDesc().getDims();
+        LockedMemory<const void> mapped = as<MemoryBlob>(blob)->rmap();
+        const cv::Mat dissimilarity(static_cast<int>(dims[0]), static_cast<int>(dims[1]), CV_32F, mapped.as<float*>());
+        return countMatches(dissimilarity, solver->Solve(dissimilarity));
+    };
+}
+}  // namespace
+
+BenchmarkCase assignmentCase(size_t objects) {
+    return {"assignment", [objects](std::mt19937& rng) { return generate(rng, objects); }, prepareLinearAssignment};
+}
+
+BenchmarkCase kuhnMunkresCase(size_t objects) {
+    return {"kuhn_munkres", [objects](std::mt19937& rng) { return generate(rng, objects); }, prepareKuhnMunkres};
+}
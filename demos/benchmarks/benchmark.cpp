@@ -0,0 +1,69 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "allocation_counter.hpp"
+
+namespace {
+double getPercentile(const std::vector<double>& sortedValues, double percentile) {
+    const size_t index = static_cast<size_t>(percentile / 100.0 * (sortedValues.size() - 1) + 0.5);
+    return sortedValues[index];
+}
+}  // namespace
+
+BenchmarkResult runBenchmark(const Routine& routine, const std::vector<InferenceEngine::BlobMap>& records,
+                             size_t warmupCalls, size_t calls) {
+    if (records.empty() || 0 == calls) {
+        throw std::invalid_argument("Benchmark needs records and calls");
+    }
+    for (size_t i = 0; i < warmupCalls; i++) {
+        routine(records[i % records.size()]);
+    }
+
+    std::vector<double> latencies(calls);  // allocated before the counting starts
+    size_t objects = 0;
+    const AllocationCounters countersBefore = getAllocationCounters();
+    const auto start = std::chrono::steady_clock::now();
+    auto callStart = start;
+    for (size_t i = 0; i < calls; i++) {
+        objects += routine(records[i % records.size()]);
+        const auto callEnd = std::chrono::steady_clock::now();
+        latencies[i] = std::chrono::duration<double, std::milli>(callEnd - callStart).count();
+        callStart = callEnd;
+    }
+    const double seconds = std::chrono::duration<double>(callStart - start).count();
+    const AllocationCounters countersAfter = getAllocationCounters();
+
+    BenchmarkResult result;
+    result.calls = calls;
+    result.callsPerSecond = seconds > 0.0 ? calls / seconds : 0.0;
+    result.meanMs = seconds * 1000.0 / calls;
+    result.allocationsPerCall = static_cast<double>(countersAfter.allocations - countersBefore.allocations) / calls;
+    result.bytesPerCall = static_cast<double>(countersAfter.bytes - countersBefore.bytes) / calls;
+    result.objectsPerCall = static_cast<double>(objects) / calls;
+    std::sort(latencies.begin(), latencies.end());
+    result.p50Ms = getPercentile(latencies, 50.0);
+    result.p90Ms = getPercentile(latencies, 90.0);
+    result.p99Ms = getPercentile(latencies, 99.0);
+    result.maxMs = latencies.back();
+    return result;
+}
+
+InferenceEngine::Blob::Ptr makeBlob(const InferenceEngine::SizeVector& dims, const std::vector<float>& values) {
+    InferenceEngine::TBlob<float>::Ptr blob = InferenceEngine::make_shared_blob<float>(
+        {InferenceEngine::Precision::FP32, dims, InferenceEngine::TensorDesc::getLayoutByDims(dims)});
+    blob->allocate();
+    if (blob->size() != values.size()) {
+        throw std::invalid_argument("Number of values doesn't match the dimensions of the blob");
+    }
+    InferenceEngine::LockedMemory<void> blobMapped = blob->wmap();
+    std::memcpy(blobMapped.as<float*>(), values.data(), values.size() * sizeof(float));
+    return blob;
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+///
+/// \brief Postprocesses the outputs of one request like a demo does.
+/// \return Number of the objects found, such as detections or poses.
+///
+using Routine = std::function<size_t(const InferenceEngine::BlobMap& outputs)>;
+
+struct BenchmarkCase {
+    std::string name;
+    /// Generates the outputs of one request of a typical model
+    std::function<InferenceEngine::BlobMap(std::mt19937& rng)> generate;
+    /// Makes the routine for outputs shaped like the given ones, doing the setup a demo does once
+    std::function<Routine(const InferenceEngine::BlobMap& outputs)> prepare;
+};
+
+BenchmarkCase yoloV3Case();
+BenchmarkCase fasterRcnnCase();
+BenchmarkCase textDetectionCase();
+BenchmarkCase humanPoseCase();
+BenchmarkCase actionDetectionCase();
+BenchmarkCase segmentationCase();
+BenchmarkCase assignmentCase(size_t objects);
+BenchmarkCase kuhnMunkresCase(size_t objects);
+BenchmarkCase dominantColorCase();
+BenchmarkCase dominantColorKMeansCase();
+BenchmarkCase reidGalleryCase();
+
+struct BenchmarkResult {
+    size_t calls;
+    double callsPerSecond;
+    double meanMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+    double maxMs;
+    double allocationsPerCall;
+    double bytesPerCall;
+    double objectsPerCall;
+};
+
+///
+/// \brief Calls the routine for the records in turn, warmupCalls times unmeasured and then calls times.
+///
+BenchmarkResult runBenchmark(const Routine& routine, const std::vector<InferenceEngine::BlobMap>& records,
+                             size_t warmupCalls, size_t calls);
+
+///
+/// \brief Creates an FP32 blob of the dimensions holding the values.
+///
+InferenceEngine::Blob::Ptr makeBlob(const InferenceEngine::SizeVector& dims, const std::vector<float>& values);
@@ -0,0 +1,75 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "blob_dump.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace {
+template <typename T>
+void write(std::ostream& stream, T value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T read(std::istream& stream) {
+    T value;
+    if (!stream.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+        throw std::runtime_error("Unexpected end of the blob dump");
+    }
+    return value;
+}
+}  // namespace
+
+void writeBlobs(std::ostream& stream, const InferenceEngine::BlobMap& blobs) {
+    write<uint32_t>(stream, static_cast<uint32_t>(blobs.size()));
+    for (const auto& blob : blobs) {
+        const InferenceEngine::TensorDesc& desc = blob.second->getTensorDesc();
+        if (desc.getPrecision() != InferenceEngine::Precision::FP32) {
+            throw std::invalid_argument("Blob " + blob.first + " is not FP32");
+        }
+        write<uint32_t>(stream, static_cast<uint32_t>(blob.first.size()));
+        stream.write(blob.first.data(), blob.first.size());
+        write<uint32_t>(stream, static_cast<uint32_t>(desc.getDims().size()));
+        for (size_t dim : desc.getDims()) {
+            write<uint64_t>(stream, dim);
+        }
+        InferenceEngine::LockedMemory<const void> blobMapped =
+            InferenceEngine::as<InferenceEngine::MemoryBlob>(blob.second)->rmap();
+        stream.write(blobMapped.as<const char*>(), blob.second->byteSize());
+    }
+    if (!stream) {
+        throw std::runtime_error("Can't write the blob dump");
+    }
+}
+
+std::vector<InferenceEngine::BlobMap> readBlobs(std::istream& stream) {
+    std::vector<InferenceEngine::BlobMap> records;
+    while (stream.peek() != std::istream::traits_type::eof()) {
+        InferenceEngine::BlobMap blobs;
+        const uint32_t blobsCount = read<uint32_t>(stream);
+        for (uint32_t i = 0; i < blobsCount; i++) {
+            std::string name(read<uint32_t>(stream), '\0');
+            if (!stream.read(&name[0], name.size())) {
+                throw std::runtime_error("Unexpected end of the blob dump");
+            }
+            InferenceEngine::SizeVector dims(read<uint32_t>(stream));
+            for (size_t& dim : dims) {
+                dim = static_cast<size_t>(read<uint64_t>(stream));
+            }
+            InferenceEngine::TBlob<float>::Ptr blob = InferenceEngine::make_shared_blob<float>(
+                {InferenceEngine::Precision::FP32, dims, InferenceEngine::TensorDesc::getLayoutByDims(dims)});
+            blob->allocate();
+            InferenceEngine::LockedMemory<void> blobMapped = blob->wmap();
+            if (!stream.read(blobMapped.as<char*>(), blob->byteSize())) {
+                throw std::runtime_error("Unexpected end of the blob dump in " + name);
+            }
+            blobs[name] = blob;
+        }
+        records.push_back(blobs);
+    }
+    return records;
+}
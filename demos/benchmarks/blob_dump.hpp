@@ -0,0 +1,25 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+///
+/// \brief Appends the FP32 output blobs of one request to the stream.
+///
+/// A dump is a sequence of such records in the native byte order. A record is the number of blobs
+/// followed by the blobs, each written as the length and the characters of its name, the number
+/// and the values of its dimensions and its data.
+///
+void writeBlobs(std::ostream& stream, const InferenceEngine::BlobMap& blobs);
+
+///
+/// \brief Reads all records of the dump.
+///
+std::vector<InferenceEngine::BlobMap> readBlobs(std::istream& stream);
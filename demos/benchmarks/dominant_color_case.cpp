@@ -0,0 +1,147 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "benchmark.hpp"
+#include "dominant_color.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+// Top and bottom color patches of the persons of a frame, each patch is a mix of a few noisy colors.
+// A patch is a third of the width and a quarter of the height of a 96x256 person crop.
+BlobMap generate(std::mt19937& rng) {
+    const size_t patches = 2 * 16;
+    const size_t height = 64;
+    const size_t width = 32;
+    std::uniform_real_distribution<float> channel(0.0f, 255.0f);
+    std::uniform_real_distribution<float> weight(0.1f, 1.0f);
+    std::uniform_int_distribution<size_t> colorCount(2, 4);
+    std::normal_distribution<float> noise(0.0f, 8.0f);
+
+    std::vector<float> pixels(patches * height * width * 3);
+    for (size_t patch = 0; patch < patches; patch++) {
+        std::vector<cv::Vec3f> colors(colorCount(rng));
+        std::vector<float> weights(colors.size());
+        for (size_t i = 0; i < colors.size(); i++) {
+            colors[i] = {channel(rng), channel(rng), channel(rng)};
+            weights[i] = weight(rng);
+        }
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+        for (size_t i = 0; i < height * width; i++) {
+            const cv::Vec3f& color = colors[pick(rng)];
+            for (size_t c = 0; c < 3; c++) {
+                pixels[(patch * height * width + i) * 3 + c] = std::min(std::max(color[c] + noise(rng), 0.0f), 255.0f);
+            }
+        }
+    }
+
+    BlobMap outputs;
+    outputs["patches"] = makeBlob({patches, height, width, 3}, pixels);
+    return outputs;
+}
+
+// The demo crops the patches from a CV_8UC3 frame, so the records are converted once, during the warmup
+class PatchCache {
+public:
+    const std::vector<cv::Mat>& get(const Blob::Ptr& blob) {
+        std::vector<cv::Mat>& patches = cache[blob.get()];
+        if (patches.empty()) {
+            const SizeVector& dims = blob->getTensorDesc().getDims();
+            const int height = static_cast<int>(dims[1]);
+            const int width = static_cast<int>(dims[2]);
+            LockedMemory<const void> mapped = as<MemoryBlob>(blob)->rmap();
+            const float* data = mapped.as<const float*>();
+            for (size_t patch = 0; patch < dims[0]; patch++) {
+                const cv::Mat patch32f(height, width, CV_32FC3, const_cast<float*>(data) + patch * height * width * 3);
+                patches.emplace_back();
+                patch32f.convertTo(patches.back(), CV_8U);
+            }
+        }
+        return patches;
+    }
+
+private:
+    std::map<const Blob*, std::vector<cv::Mat>> cache;
+};
+
+void checkOutputs(const BlobMap& outputs) {
+    if (outputs.size() != 1) {
+        throw std::runtime_error("Dominant color benchmarks expect one blob of patches");
+    }
+    const SizeVector& dims = outputs.begin()->second->getTensorDesc().getDims();
+    if (dims.size() != 4 || dims[3] != 3) {
+        throw std::runtime_error("Dominant color benchmarks expect patches of 3 channel pixels");
+    }
+}
+
+Routine prepareHistogram(const BlobMap& outputs) {
+    checkOutputs(outputs);
+    std::shared_ptr<PatchCache> cache = std::make_shared<PatchCache>();
+    return [cache](const BlobMap& outputs) {
+        const std::vector<cv::Mat>& patches = cache->get(outputs.begin()->second);
+        size_t colored = 0;
+        for (const cv::Mat& patch : patches) {
+            if (GetDominantColor(patch) != cv::Vec3b()) {
+                colored++;
+            }
+        }
+        return colored;
+    };
+}
+
+// the estimator crossroad_camera_demo used before the histogram one
+cv::Vec3b getKMeansColor(const cv::Mat& image) {
+    int clusterCount = 5;
+    cv::Mat labels;
+    cv::Mat centers;
+    cv::Mat image32f;
+    image.convertTo(image32f, CV_32F);
+    image32f = image32f.reshape(1, image32f.rows*image32f.cols);
+    clusterCount = std::min(clusterCount, image32f.rows);
+    cv::kmeans(image32f, clusterCount, labels, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::MAX_ITER, 10, 1.0),
+                10, cv::KMEANS_RANDOM_CENTERS, centers);
+    centers.convertTo(centers, CV_8U);
+    centers = centers.reshape(0, clusterCount);
+    std::vector<int> freq(clusterCount);
+
+    for (int i = 0; i < labels.rows * labels.cols; ++i) {
+        freq[labels.at<int>(i)]++;
+    }
+
+    auto freqArgmax = std::max_element(freq.begin(), freq.end()) - freq.begin();
+
+    return centers.at<cv::Vec3b>(freqArgmax);
+}
+
+Routine prepareKMeans(const BlobMap& outputs) {
+    checkOutputs(outputs);
+    std::shared_ptr<PatchCache> cache = std::make_shared<PatchCache>();
+    return [cache](const BlobMap& outputs) {
+        const std::vector<cv::Mat>& patches = cache->get(outputs.begin()->second);
+        size_t colored = 0;
+        for (const cv::Mat& patch : patches) {
+            if (getKMeansColor(patch) != cv::Vec3b()) {
+                colored++;
+            }
+        }
+        return colored;
+    };
+}
+}  // namespace
+
+BenchmarkCase dominantColorCase() {
+    return {"dominant_color", generate, prepareHistogram};
+}
+
+BenchmarkCase dominantColorKMeansCase() {
+    return {"dominant_color_kmeans", generate, prepareKMeans};
+}
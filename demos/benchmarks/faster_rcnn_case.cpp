@@ -0,0 +1,122 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "detectionoutput.h"
+
+namespace {
+// defaults of the demo
+const char bboxName[] = "bbox_pred";
+const char probName[] = "cls_prob";
+const char proposalName[] = "proposal";
+const size_t maxProposalCount = 200;
+const size_t objectSize = 7;
+const float threshold = 0.5f;
+
+const size_t imageWidth = 1000;
+const size_t imageHeight = 600;
+
+BlobMap generate(std::mt19937& rng) {
+    // Pascal VOC layout of the model from the demo README
+    const size_t proposals = 300;
+    const size_t classes = 21;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> logit(0.0f, 1.0f);
+    std::normal_distribution<float> offset(0.0f, 0.1f);
+    std::bernoulli_distribution isObject(0.3);
+    std::uniform_int_distribution<size_t> classId(1, classes - 1);
+
+    std::vector<float> rois(proposals * 5);
+    std::vector<float> probs(proposals * classes);
+    std::vector<float> deltas(proposals * classes * 4);
+    for (size_t p = 0; p < proposals; p++) {
+        const float width = (0.05f + 0.5f * unit(rng)) * imageWidth;
+        const float height = (0.05f + 0.5f * unit(rng)) * imageHeight;
+        const float xmin = unit(rng) * (imageWidth - width);
+        const float ymin = unit(rng) * (imageHeight - height);
+        float* roi = &rois[p * 5];
+        roi[0] = 0.0f;
+        roi[1] = xmin;
+        roi[2] = ymin;
+        roi[3] = xmin + width;
+        roi[4] = ymin + height;
+
+        float* prob = &probs[p * classes];
+        const size_t objectClass = isObject(rng) ? classId(rng) : 0;
+        float sum = 0.0f;
+        for (size_t c = 0; c < classes; c++) {
+            prob[c] = std::exp(logit(rng) + (c == objectClass ? 6.0f : 0.0f));
+            sum += prob[c];
+        }
+        for (size_t c = 0; c < classes; c++) {
+            prob[c] /= sum;
+        }
+    }
+    for (float& delta : deltas) {
+        delta = offset(rng);
+    }
+
+    BlobMap outputs;
+    outputs[bboxName] = makeBlob({proposals, classes * 4}, deltas);
+    outputs[probName] = makeBlob({proposals, classes}, probs);
+    outputs[proposalName] = makeBlob({1, 1, proposals, 5}, rois);
+    return outputs;
+}
+
+struct State {
+    explicit State(const BlobMap& outputs):
+        postProcessor({1, 3, imageHeight, imageWidth},
+                      outputs.at(bboxName)->getTensorDesc().getDims(),
+                      outputs.at(probName)->getTensorDesc().getDims(),
+                      outputs.at(proposalName)->getTensorDesc().getDims(),
+                      threshold),
+        inputs(3),
+        output(std::make_shared<TBlob<float>>(
+            TensorDesc(Precision::FP32, {1, 1, maxProposalCount, objectSize}, Layout::NCHW))) {
+        output->allocate();
+        outputBlobs.push_back(output);
+    }
+
+    DetectionOutputPostProcessor postProcessor;
+    std::vector<Blob::Ptr> inputs;
+    Blob::Ptr output;
+    std::vector<Blob::Ptr> outputBlobs;
+};
+
+Routine prepare(const BlobMap& outputs) {
+    std::shared_ptr<State> state = std::make_shared<State>(outputs);
+    return [state](const BlobMap& outputs) {
+        state->inputs[0] = outputs.at(bboxName);
+        state->inputs[1] = outputs.at(probName);
+        state->inputs[2] = outputs.at(proposalName);
+        if (OK != state->postProcessor.execute(state->inputs, state->outputBlobs, nullptr)) {
+            throw std::runtime_error("DetectionOutputPostProcessor failed");
+        }
+
+        LockedMemory<const void> outputMapped = as<MemoryBlob>(state->output)->rmap();
+        const float* detection = outputMapped.as<float*>();
+        size_t objects = 0;
+        for (size_t curProposal = 0; curProposal < maxProposalCount; curProposal++) {
+            if (detection[curProposal * objectSize + 0] < 0) {
+                break;
+            }
+            if (detection[curProposal * objectSize + 2] > threshold) {
+                objects++;
+            }
+        }
+        return objects;
+    };
+}
+}  // namespace
+
+BenchmarkCase fasterRcnnCase() {
+    return {"faster_rcnn", generate, prepare};
+}
@@ -0,0 +1,139 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "postprocess.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+const cv::Size imageSize(1920, 1080);
+const size_t heatMapsCount = keypointsNumber + 1;  // the last one is the background
+const size_t pafsCount = 2 * heatMapsCount;
+
+// joints of a standing person with the height of 1, in the order of the keypoints
+const cv::Point2f poseTemplate[keypointsNumber] = {
+    {0.0f, -0.45f}, {0.0f, -0.3f}, {-0.12f, -0.3f}, {-0.18f, -0.12f}, {-0.2f, 0.03f}, {0.12f, -0.3f},
+    {0.18f, -0.12f}, {0.2f, 0.03f}, {-0.08f, 0.05f}, {-0.09f, 0.27f}, {-0.1f, 0.48f}, {0.08f, 0.05f},
+    {0.09f, 0.27f}, {0.1f, 0.48f}, {-0.03f, -0.48f}, {0.03f, -0.48f}, {-0.06f, -0.46f}, {0.06f, -0.46f}
+};
+
+// limbs as groupPeaksToPoses() pairs them: 1-based joints and the PAF channels offset by the heat maps
+const std::pair<int, int> limbJoints[] = {
+    {2, 3}, {2, 6}, {3, 4}, {4, 5}, {6, 7}, {7, 8}, {2, 9}, {9, 10}, {10, 11}, {2, 12}, {12, 13}, {13, 14},
+    {2, 1}, {1, 15}, {15, 17}, {1, 16}, {16, 18}, {3, 17}, {6, 18}
+};
+const std::pair<int, int> limbPafs[] = {
+    {31, 32}, {39, 40}, {33, 34}, {35, 36}, {41, 42}, {43, 44}, {19, 20}, {21, 22}, {23, 24}, {25, 26},
+    {27, 28}, {29, 30}, {47, 48}, {49, 50}, {53, 54}, {51, 52}, {55, 56}, {37, 38}, {45, 46}
+};
+
+BlobMap generate(std::mt19937& rng) {
+    const int height = 32;
+    const int width = 57;
+    const int persons = 8;
+    const float sigma = 1.0f;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<float> heatMaps(heatMapsCount * height * width, 0.0f);
+    std::vector<float> pafs(pafsCount * height * width, 0.0f);
+    for (int person = 0; person < persons; person++) {
+        const float personHeight = 10.0f + 14.0f * unit(rng);
+        const cv::Point2f center(personHeight / 2 + unit(rng) * (width - personHeight),
+                                 personHeight / 2 + unit(rng) * (height - personHeight));
+        cv::Point2f joints[keypointsNumber];
+        for (size_t k = 0; k < keypointsNumber; k++) {
+            joints[k] = center + poseTemplate[k] * personHeight;
+            float* heatMap = &heatMaps[k * height * width];
+            for (int y = std::max(0, static_cast<int>(joints[k].y) - 3);
+                 y <= std::min(height - 1, static_cast<int>(joints[k].y) + 3); y++) {
+                for (int x = std::max(0, static_cast<int>(joints[k].x) - 3);
+                     x <= std::min(width - 1, static_cast<int>(joints[k].x) + 3); x++) {
+                    const cv::Point2f d = cv::Point2f(static_cast<float>(x), static_cast<float>(y)) - joints[k];
+                    const float value = std::exp(-d.dot(d) / (2 * sigma * sigma));
+                    heatMap[y * width + x] = std::max(heatMap[y * width + x], value);
+                }
+            }
+        }
+        for (size_t limb = 0; limb < sizeof(limbJoints) / sizeof(limbJoints[0]); limb++) {
+            const cv::Point2f a = joints[limbJoints[limb].first - 1];
+            const cv::Point2f b = joints[limbJoints[limb].second - 1];
+            const float length = static_cast<float>(cv::norm(b - a));
+            if (length < 1e-3f) {
+                continue;
+            }
+            const cv::Point2f direction = (b - a) * (1.0f / length);
+            float* pafX = &pafs[(limbPafs[limb].first - heatMapsCount) * height * width];
+            float* pafY = &pafs[(limbPafs[limb].second - heatMapsCount) * height * width];
+            for (float t = 0.0f; t <= length; t += 0.5f) {
+                const cv::Point2f point = a + direction * t;
+                const int x = static_cast<int>(point.x);
+                const int y = static_cast<int>(point.y);
+                if (x >= 0 && x < width && y >= 0 && y < height) {
+                    pafX[y * width + x] = direction.x;
+                    pafY[y * width + x] = direction.y;
+                }
+            }
+        }
+    }
+    float* background = &heatMaps[keypointsNumber * height * width];
+    for (int i = 0; i < height * width; i++) {
+        float maxValue = 0.0f;
+        for (size_t k = 0; k < keypointsNumber; k++) {
+            maxValue = std::max(maxValue, heatMaps[k * height * width + i]);
+        }
+        background[i] = 1.0f - maxValue;
+    }
+
+    BlobMap outputs;
+    outputs["Mconv7_stage2_L1"] = makeBlob({1, pafsCount, static_cast<size_t>(height), static_cast<size_t>(width)},
+                                           pafs);
+    outputs["Mconv7_stage2_L2"] = makeBlob({1, heatMapsCount, static_cast<size_t>(height),
+                                            static_cast<size_t>(width)}, heatMaps);
+    return outputs;
+}
+
+Routine prepare(const BlobMap& outputs) {
+    std::string heatMapsName;
+    std::string pafsName;
+    for (const auto& output : outputs) {
+        const SizeVector& dims = output.second->getTensorDesc().getDims();
+        if (dims.size() == 4 && dims[1] == heatMapsCount) {
+            heatMapsName = output.first;
+        } else if (dims.size() == 4 && dims[1] == pafsCount) {
+            pafsName = output.first;
+        }
+    }
+    if (heatMapsName.empty() || pafsName.empty()) {
+        throw std::runtime_error("Failed to determine the heat maps and the PAFs outputs");
+    }
+
+    return [heatMapsName, pafsName](const BlobMap& outputs) {
+        const Blob::Ptr& heatMapsBlob = outputs.at(heatMapsName);
+        const Blob::Ptr& pafsBlob = outputs.at(pafsName);
+        const SizeVector& heatMapDims = heatMapsBlob->getTensorDesc().getDims();
+        LockedMemory<const void> heatMapsMapped = as<MemoryBlob>(heatMapsBlob)->rmap();
+        LockedMemory<const void> pafsMapped = as<MemoryBlob>(pafsBlob)->rmap();
+        return postprocess(
+            heatMapsMapped.as<float*>(),
+            static_cast<int>(heatMapDims[2] * heatMapDims[3]),
+            keypointsNumber,
+            pafsMapped.as<float*>(),
+            static_cast<int>(heatMapDims[2] * heatMapDims[3]),
+            static_cast<int>(pafsBlob->getTensorDesc().getDims()[1]),
+            static_cast<int>(heatMapDims[3]), static_cast<int>(heatMapDims[2]), imageSize).size();
+    };
+}
+}  // namespace
+
+BenchmarkCase humanPoseCase() {
+    return {"human_pose", generate, prepare};
+}
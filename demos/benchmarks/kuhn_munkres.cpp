@@ -3,7 +3,6 @@
 //
 
 #include "kuhn_munkres.hpp"
-#include "logging.hpp"
 
 #include <algorithm>
 #include <limits>
@@ -12,10 +11,10 @@
 KuhnMunkres::KuhnMunkres() : n_() {}
 
 std::vector<size_t> KuhnMunkres::Solve(const cv::Mat& dissimilarity_matrix) {
-    PT_CHECK(dissimilarity_matrix.type() == CV_32F);
+    CV_Assert(dissimilarity_matrix.type() == CV_32F);
     double min_val;
     cv::minMaxLoc(dissimilarity_matrix, &min_val);
-    PT_CHECK(min_val >= 0);
+    CV_Assert(min_val >= 0);
 
     n_ = std::max(dissimilarity_matrix.rows, dissimilarity_matrix.cols);
     dm_ = cv::Mat(n_, n_, CV_32F, cv::Scalar(0));
@@ -4,16 +4,17 @@
 
 #pragma once
 
-#include "core.hpp"
-
 #include <memory>
 #include <vector>
 
+#include <opencv2/core/core.hpp>
 
 ///
 /// \brief The KuhnMunkres class
 ///
-/// Solves the assignment problem.
+/// Solves the assignment problem. It is the step-marking Hungarian solver
+/// the trackers used before LinearAssignment, kept only as the baseline of
+/// the assignment benchmark.
 ///
 class KuhnMunkres {
 public:
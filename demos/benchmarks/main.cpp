@@ -0,0 +1,146 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+/**
+* \brief Measures the postprocessing routines of the demos on recorded or generated outputs
+* \file benchmarks/main.cpp
+*/
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <samples/slog.hpp>
+
+#include "benchmark.hpp"
+#include "blob_dump.hpp"
+#include "postprocessing_benchmark.hpp"
+
+namespace {
+bool ParseAndCheckCommandLine(int argc, char *argv[]) {
+    gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+    if (FLAGS_h) {
+        showUsage();
+        return false;
+    }
+    if (0 == FLAGS_niter) {
+        throw std::logic_error("Parameter -niter must be positive");
+    }
+    if (0 == FLAGS_frames) {
+        throw std::logic_error("Parameter -frames must be positive");
+    }
+    if (0 == FLAGS_objects) {
+        throw std::logic_error("Parameter -objects must be positive");
+    }
+    return true;
+}
+
+std::set<std::string> parseNames(const std::string& names) {
+    std::set<std::string> result;
+    std::stringstream stream(names);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        result.insert(name);
+    }
+    return result;
+}
+
+std::vector<InferenceEngine::BlobMap> getRecords(const BenchmarkCase& benchmark, unsigned seed) {
+    if (!FLAGS_i.empty()) {
+        std::ifstream file(FLAGS_i + "/" + benchmark.name + ".blobs", std::ios::binary);
+        if (file) {
+            std::vector<InferenceEngine::BlobMap> records = readBlobs(file);
+            if (records.empty()) {
+                throw std::runtime_error("No records in " + FLAGS_i + "/" + benchmark.name + ".blobs");
+            }
+            slog::info << benchmark.name << ": " << records.size() << " recorded requests" << slog::endl;
+            return records;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<InferenceEngine::BlobMap> records;
+    for (unsigned i = 0; i < FLAGS_frames; i++) {
+        records.push_back(benchmark.generate(rng));
+    }
+    if (!FLAGS_o.empty()) {
+        std::ofstream file(FLAGS_o + "/" + benchmark.name + ".blobs", std::ios::binary);
+        for (const auto& record : records) {
+            writeBlobs(file, record);
+        }
+    }
+    slog::info << benchmark.name << ": " << records.size() << " generated requests" << slog::endl;
+    return records;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        if (!ParseAndCheckCommandLine(argc, argv)) {
+            return 0;
+        }
+
+        const std::vector<BenchmarkCase> cases{yoloV3Case(), fasterRcnnCase(), textDetectionCase(),
+                                               humanPoseCase(), actionDetectionCase(), segmentationCase(),
+                                               assignmentCase(FLAGS_objects), kuhnMunkresCase(FLAGS_objects),
+                                               dominantColorCase(), dominantColorKMeansCase(), reidGalleryCase()};
+        const std::set<std::string> names = parseNames(FLAGS_b);
+        std::set<std::string> unknownNames = names;
+        unknownNames.erase("all");
+        for (const BenchmarkCase& benchmark : cases) {
+            unknownNames.erase(benchmark.name);
+        }
+        if (!unknownNames.empty()) {
+            throw std::logic_error("Unknown benchmark: " + *unknownNames.begin());
+        }
+
+        struct Benchmark {
+            std::string name;
+            std::vector<InferenceEngine::BlobMap> records;
+            Routine routine;
+        };
+        std::vector<Benchmark> benchmarks;
+        for (size_t i = 0; i < cases.size(); i++) {
+            if (names.count("all") || names.count(cases[i].name)) {
+                // the outputs of a benchmark don't depend on the benchmarks selected with it
+                std::vector<InferenceEngine::BlobMap> records = getRecords(cases[i], FLAGS_seed + i);
+                Routine routine = cases[i].prepare(records.front());
+                benchmarks.push_back({cases[i].name, std::move(records), std::move(routine)});
+            }
+        }
+
+        std::cout << std::left << std::setw(18) << "benchmark" << std::right
+                  << std::setw(10) << "calls/s" << std::setw(10) << "mean ms" << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+                  << std::setw(10) << "allocs" << std::setw(12) << "KB alloc" << std::setw(10) << "objects"
+                  << std::endl;
+        for (const Benchmark& benchmark : benchmarks) {
+            const BenchmarkResult result = runBenchmark(benchmark.routine, benchmark.records,
+                                                        FLAGS_warmup, FLAGS_niter);
+            std::cout << std::left << std::setw(18) << benchmark.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(10) << result.callsPerSecond
+                      << std::setprecision(3) << std::setw(10) << result.meanMs << std::setw(10) << result.p50Ms
+                      << std::setw(10) << result.p90Ms << std::setw(10) << result.p99Ms << std::setw(10) << result.maxMs
+                      << std::setprecision(1) << std::setw(10) << result.allocationsPerCall
+                      << std::setw(12) << result.bytesPerCall / 1024 << std::setw(10) << result.objectsPerCall
+                      << std::endl;
+        }
+    }
+    catch (const std::exception& error) {
+        slog::err << error.what() << slog::endl;
+        return 1;
+    }
+    catch (...) {
+        slog::err << "Unknown/internal exception happened." << slog::endl;
+        return 1;
+    }
+    return 0;
+}
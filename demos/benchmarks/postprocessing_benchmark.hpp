@@ -0,0 +1,48 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <iostream>
+
+#include <gflags/gflags.h>
+
+static const char help_message[] = "Print a usage message.";
+static const char benchmarks_message[] = "Optional. Comma separated list of the benchmarks to run. "
+                                         "Default value is \"all\".";
+static const char input_message[] = "Optional. Path to a directory with recorded outputs. The outputs of a "
+                                    "benchmark are read from <benchmark>.blobs, generated if there is no such file.";
+static const char output_message[] = "Optional. Path to a directory to write the generated outputs to.";
+static const char frames_message[] = "Optional. Number of requests to generate outputs for. Default value is 4.";
+static const char seed_message[] = "Optional. Seed of the generated outputs. Default value is 0.";
+static const char niter_message[] = "Optional. Number of measured calls of every routine. Default value is 1000.";
+static const char warmup_message[] = "Optional. Number of calls before the measured ones. Default value is 20.";
+static const char objects_message[] = "Optional. Number of tracks and detections matched by the assignment benchmarks. "
+                                      "Default value is 100.";
+
+DEFINE_bool(h, false, help_message);
+DEFINE_string(b, "all", benchmarks_message);
+DEFINE_string(i, "", input_message);
+DEFINE_string(o, "", output_message);
+DEFINE_uint32(frames, 4, frames_message);
+DEFINE_uint32(seed, 0, seed_message);
+DEFINE_uint32(niter, 1000, niter_message);
+DEFINE_uint32(warmup, 20, warmup_message);
+DEFINE_uint32(objects, 100, objects_message);
+
+static void showUsage() {
+    std::cout << std::endl;
+    std::cout << "postprocessing_benchmark [OPTION]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << std::endl;
+    std::cout << "    -h                        " << help_message << std::endl;
+    std::cout << "    -b \"<list>\"               " << benchmarks_message << std::endl;
+    std::cout << "    -i \"<path>\"               " << input_message << std::endl;
+    std::cout << "    -o \"<path>\"               " << output_message << std::endl;
+    std::cout << "    -frames                   " << frames_message << std::endl;
+    std::cout << "    -seed                     " << seed_message << std::endl;
+    std::cout << "    -niter                    " << niter_message << std::endl;
+    std::cout << "    -warmup                   " << warmup_message << std::endl;
+    std::cout << "    -objects                  " << objects_message << std::endl;
+}
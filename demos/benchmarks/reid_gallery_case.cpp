@@ -0,0 +1,87 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "benchmark.hpp"
+#include "person_gallery.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+// the defaults of crossroad_camera_demo
+const size_t capacity = 1000;
+const float threshold = 0.7f;
+
+// Normalized reid vectors of the persons of a frame
+BlobMap generate(std::mt19937& rng) {
+    const size_t channels = 256;
+    std::uniform_int_distribution<size_t> personCount(8, 16);
+    std::normal_distribution<float> value(0.0f, 1.0f);
+
+    const size_t persons = personCount(rng);
+    std::vector<float> reidVecs(persons * channels);
+    for (size_t person = 0; person < persons; person++) {
+        float* reidVec = &reidVecs[person * channels];
+        float squares = 0.0f;
+        for (size_t c = 0; c < channels; c++) {
+            reidVec[c] = value(rng);
+            squares += reidVec[c] * reidVec[c];
+        }
+        const float norm = std::sqrt(squares);
+        for (size_t c = 0; c < channels; c++) {
+            reidVec[c] /= norm;
+        }
+    }
+
+    BlobMap outputs;
+    outputs["reid"] = makeBlob({persons, channels}, reidVecs);
+    return outputs;
+}
+
+// The gallery is kept across the calls as the demo keeps it across the frames. Every person of a call is
+// a new one: the vectors are rotated by the call number, which keeps them normalized and unlike the known
+// ones. So the gallery fills up in the first calls and then forgets persons in every call, and a long run
+// shows whether the latency stays flat once it is full.
+struct GalleryState {
+    PersonGallery gallery{capacity, threshold};
+    cv::Mat rotated;
+    size_t callIdx = 0;
+};
+
+Routine prepare(const BlobMap& outputs) {
+    if (outputs.size() != 1 || outputs.begin()->second->getTensorDesc().getDims().size() != 2) {
+        throw std::runtime_error("Reid gallery benchmark expects one blob of reid vectors");
+    }
+    std::shared_ptr<GalleryState> state = std::make_shared<GalleryState>();
+    return [state](const BlobMap& outputs) {
+        const Blob::Ptr& blob = outputs.begin()->second;
+        const SizeVector& dims = blob->getTensorDesc().getDims();
+        const int persons = static_cast<int>(dims[0]);
+        const int channels = static_cast<int>(dims[1]);
+        LockedMemory<const void> mapped = as<MemoryBlob>(blob)->rmap();
+        const float* reidVecs = mapped.as<const float*>();
+
+        if (state->rotated.rows < persons || state->rotated.cols != channels) {
+            state->rotated.create(persons, channels, CV_32F);
+        }
+        const int shift = static_cast<int>(state->callIdx++ % channels);
+        for (int person = 0; person < persons; person++) {
+            const float* reidVec = reidVecs + person * channels;
+            std::rotate_copy(reidVec, reidVec + shift, reidVec + channels, state->rotated.ptr<float>(person));
+        }
+        return state->gallery.findMatchingPersons(state->rotated.rowRange(0, persons)).size();
+    };
+}
+}  // namespace
+
+BenchmarkCase reidGalleryCase() {
+    return {"reid_gallery", generate, prepare};
+}
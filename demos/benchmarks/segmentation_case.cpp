@@ -0,0 +1,61 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "segmentation_output.h"
+
+using namespace InferenceEngine;
+
+namespace {
+BlobMap generate(std::mt19937& rng) {
+    const size_t classes = 20;
+    const size_t height = 256;
+    const size_t width = 512;
+    const size_t regionSize = 16;  // pixels of a region share the class
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<size_t> classId(0, classes - 1);
+
+    std::vector<size_t> regionClasses((height / regionSize) * (width / regionSize));
+    for (size_t& regionClass : regionClasses) {
+        regionClass = classId(rng);
+    }
+    std::vector<float> scores(classes * height * width);
+    for (size_t c = 0; c < classes; c++) {
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                const size_t regionClass = regionClasses[(y / regionSize) * (width / regionSize) + x / regionSize];
+                scores[(c * height + y) * width + x] = c == regionClass ? 0.5f + 0.5f * unit(rng) : 0.5f * unit(rng);
+            }
+        }
+    }
+
+    BlobMap outputs;
+    outputs["logits"] = makeBlob({1, classes, height, width}, scores);
+    return outputs;
+}
+
+Routine prepare(const BlobMap& outputs) {
+    if (outputs.size() != 1) {
+        throw std::runtime_error("Segmentation network is expected to have 1 output");
+    }
+    std::shared_ptr<cv::Mat> classMap = std::make_shared<cv::Mat>();
+    return [classMap](const BlobMap& outputs) {
+        const Blob::Ptr& blob = outputs.begin()->second;
+        const SizeVector& dims = blob->getTensorDesc().getDims();
+        const int outChannels = dims.size() == 4 ? static_cast<int>(dims[1]) : 0;
+        LockedMemory<const void> outMapped = as<MemoryBlob>(blob)->rmap();
+        argMaxClasses(outMapped.as<float*>(), outChannels, static_cast<int>(dims[dims.size() - 2]),
+                      static_cast<int>(dims[dims.size() - 1]), *classMap);
+        return classMap->total();
+    };
+}
+}  // namespace
+
+BenchmarkCase segmentationCase() {
+    return {"segmentation", generate, prepare};
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "text_detection.hpp"
+
+namespace {
+const cv::Size imageSize(1280, 768);
+const float clsConfThreshold = 0.8f;  // defaults of the demo
+const float linkConfThreshold = 0.8f;
+
+BlobMap generate(std::mt19937& rng) {
+    const size_t height = imageSize.height / 4;
+    const size_t width = imageSize.width / 4;
+    const size_t linkChannels = 16;  // 8 neighbours, 2 logits each
+    const int textBoxes = 30;
+    std::normal_distribution<float> noise(0.0f, 0.5f);
+    std::uniform_int_distribution<int> boxWidth(10, 80);
+    std::uniform_int_distribution<int> boxHeight(3, 12);
+
+    // text pixels with their links are positive, the first logit of a pair is the negative one
+    cv::Mat text = cv::Mat::zeros(static_cast<int>(height), static_cast<int>(width), CV_8UC1);
+    for (int i = 0; i < textBoxes; i++) {
+        const int w = boxWidth(rng);
+        const int h = boxHeight(rng);
+        const int x = std::uniform_int_distribution<int>(0, static_cast<int>(width) - w - 1)(rng);
+        const int y = std::uniform_int_distribution<int>(0, static_cast<int>(height) - h - 1)(rng);
+        text(cv::Rect(x, y, w, h)).setTo(1);
+    }
+
+    std::vector<float> cls(2 * height * width);
+    std::vector<float> link(linkChannels * height * width);
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            const size_t pixel = y * width + x;
+            const float logit = text.at<uint8_t>(static_cast<int>(y), static_cast<int>(x)) ? 3.0f : -3.0f;
+            cls[pixel] = -logit + noise(rng);
+            cls[height * width + pixel] = logit + noise(rng);
+            for (size_t c = 0; c < linkChannels; c += 2) {
+                link[c * height * width + pixel] = -logit + noise(rng);
+                link[(c + 1) * height * width + pixel] = logit + noise(rng);
+            }
+        }
+    }
+
+    BlobMap outputs;
+    outputs["model/segm_logits/add"] = makeBlob({1, 2, height, width}, cls);
+    outputs["model/link_logits_/add"] = makeBlob({1, linkChannels, height, width}, link);
+    return outputs;
+}
+
+Routine prepare(const BlobMap&) {
+    return [](const BlobMap& outputs) {
+        return postProcess(outputs, imageSize, clsConfThreshold, linkConfThreshold).size();
+    };
+}
+}  // namespace
+
+BenchmarkCase textDetectionCase() {
+    return {"text_detection", generate, prepare};
+}
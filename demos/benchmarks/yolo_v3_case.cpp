@@ -0,0 +1,101 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "yolo_output.hpp"
+
+using namespace InferenceEngine;
+
+namespace {
+const int coords = 4;
+const int anchorsPerRegion = 3;
+const int regionsCount = 3;  // the masks of the default anchors cover 3 regions
+const size_t inputToSide = 32;  // input size of the network per cell of the smallest region
+const unsigned long imageWidth = 1280;
+const unsigned long imageHeight = 720;
+const double threshold = 0.5;  // defaults of the demo
+const double iouThreshold = 0.4;
+
+BlobMap generate(std::mt19937& rng) {
+    const int classes = 80;
+    const int entrySize = coords + 1 + classes;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> logSize(0.0f, 0.5f);
+    std::bernoulli_distribution isObject(0.005);
+    std::uniform_int_distribution<int> classId(0, classes - 1);
+
+    BlobMap outputs;
+    for (size_t side : {13, 26, 52}) {
+        const size_t sideSquare = side * side;
+        std::vector<float> values(anchorsPerRegion * entrySize * sideSquare);
+        for (int n = 0; n < anchorsPerRegion; n++) {
+            for (size_t i = 0; i < sideSquare; i++) {
+                float* entry = values.data() + n * entrySize * sideSquare + i;
+                entry[0 * sideSquare] = unit(rng);
+                entry[1 * sideSquare] = unit(rng);
+                entry[2 * sideSquare] = logSize(rng);
+                entry[3 * sideSquare] = logSize(rng);
+                entry[coords * sideSquare] = isObject(rng) ? 0.5f + 0.5f * unit(rng) : 0.05f * unit(rng);
+                const int objectClass = classId(rng);
+                for (int j = 0; j < classes; j++) {
+                    entry[(coords + 1 + j) * sideSquare] = j == objectClass ? 0.6f + 0.4f * unit(rng) : 0.1f * unit(rng);
+                }
+            }
+        }
+        outputs["yolo_" + std::to_string(side)] =
+            makeBlob({1, static_cast<size_t>(anchorsPerRegion * entrySize), side, side}, values);
+    }
+    return outputs;
+}
+
+Routine prepare(const BlobMap& outputs) {
+    // the demo reads the masks from the model, here the regions with more cells get the smaller anchors
+    std::vector<std::pair<size_t, std::string>> sides;
+    for (const auto& output : outputs) {
+        const SizeVector& dims = output.second->getTensorDesc().getDims();
+        if (dims.size() != 4 || 0 != dims[1] % anchorsPerRegion) {
+            throw std::runtime_error("Unexpected dimensions of YOLO V3 output " + output.first);
+        }
+        sides.emplace_back(dims[2], output.first);
+    }
+    if (sides.size() > regionsCount) {
+        throw std::runtime_error("YOLO V3 outputs more than " + std::to_string(regionsCount) + " regions");
+    }
+    std::sort(sides.begin(), sides.end());
+
+    std::map<std::string, YoloParams> yoloParams;
+    for (size_t i = 0; i < sides.size(); i++) {
+        const SizeVector& dims = outputs.at(sides[i].second)->getTensorDesc().getDims();
+        std::vector<int64_t> mask;
+        for (int n = 0; n < anchorsPerRegion; n++) {
+            mask.push_back((sides.size() - 1 - i) * anchorsPerRegion + n);
+        }
+        const int classes = static_cast<int>(dims[1]) / anchorsPerRegion - coords - 1;
+        yoloParams[sides[i].second] = YoloParams(classes, coords, mask);
+    }
+    const unsigned long resizedSize = sides.front().first * inputToSide;
+
+    return [yoloParams, resizedSize](const BlobMap& outputs) {
+        std::vector<DetectionObject> objects;
+        for (const auto& output : outputs) {
+            ParseYOLOV3Output(yoloParams.at(output.first), output.first, output.second, resizedSize, resizedSize,
+                              imageHeight, imageWidth, threshold, objects);
+        }
+        FilterOverlappingObjects(objects, iouThreshold);
+        return static_cast<size_t>(std::count_if(objects.begin(), objects.end(),
+            [](const DetectionObject& object) { return object.confidence >= threshold; }));
+    };
+}
+}  // namespace
+
+BenchmarkCase yoloV3Case() {
+    return {"yolov3", generate, prepare};
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <algorithm>
+#include <list>
 #include <set>
 #include <string>
 #include <vector>
@@ -108,36 +109,48 @@ public:
             }
         }
 
+        // labelled cells are rendered in parallel, only copying to outImg is sequential
+        std::vector<const LabeledImage*> labeledImages;
+        labeledImages.reserve(imageInfos.size());
         for (const auto & imageInfo : imageInfos) {
-            cv::Mat frame = imageInfo.mat;
-
-            cv::Scalar textColor;
-            switch (imageInfo.predictionResult) {
-                case PredictionResult::Correct:
-                    textColor = cv::Scalar(75, 255, 75); break;     // green
-                case PredictionResult::Incorrect:
-                    textColor = cv::Scalar(50, 50, 255); break;     // red
-                case PredictionResult::Unknown:
-                    textColor = cv::Scalar(75, 255, 255); break;    // yellow
-                default:
-                    throw std::runtime_error("Undefined type of prediction result");
+            labeledImages.push_back(&imageInfo);
+        }
+        std::vector<cv::Mat> frames(labeledImages.size());
+        const int labelThickness = cellSize.width / 20;
+        cv::parallel_for_(cv::Range(0, static_cast<int>(labeledImages.size())), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                const LabeledImage& imageInfo = *labeledImages[i];
+
+                cv::Scalar textColor;
+                switch (imageInfo.predictionResult) {
+                    case PredictionResult::Correct:
+                        textColor = cv::Scalar(75, 255, 75); break;     // green
+                    case PredictionResult::Incorrect:
+                        textColor = cv::Scalar(50, 50, 255); break;     // red
+                    case PredictionResult::Unknown:
+                        textColor = cv::Scalar(75, 255, 255); break;    // yellow
+                    default:
+                        throw std::runtime_error("Undefined type of prediction result");
+                }
+
+                int labelBaseline = 0;
+                cv::Size labelTextSize = cv::getTextSize(imageInfo.label, fontType, 1, 2, &labelBaseline);
+                double labelFontScale = static_cast<double>(cellSize.width - 2*labelThickness) / labelTextSize.width;
+                cv::resize(imageInfo.mat, frames[i], cellSize);
+                cv::putText(frames[i],
+                            imageInfo.label,
+                            cv::Point(labelThickness, cellSize.height - labelThickness - labelTextSize.height),
+                            fontType, labelFontScale, textColor, 2);
             }
+        });
 
-            int labelThickness = cellSize.width / 20;
-            cv::Size labelTextSize = cv::getTextSize(imageInfo.label, fontType, 1, 2, &baseline);
-            double labelFontScale = static_cast<double>(cellSize.width - 2*labelThickness) / labelTextSize.width;
-            cv::resize(frame, frame, cellSize);
-            cv::putText(frame,
-                        imageInfo.label,
-                        cv::Point(labelThickness, cellSize.height - labelThickness - labelTextSize.height),
-                        fontType, labelFontScale, textColor, 2);
-            
+        for (const cv::Mat& frame : frames) {
             prevImgs.push(frame);
 
-            cv::Mat cell = outImg(cv::Rect(points[currSourceId], cellSize));                                         
-            frame.copyTo(cell);                                                                                      
+            cv::Mat cell = outImg(cv::Rect(points[currSourceId], cellSize));
+            frame.copyTo(cell);
             cv::rectangle(cell, {0, 0}, {frame.cols, frame.rows}, {255, 50, 50}, labelThickness); // draw a border
-            
+
             if (currSourceId == points.size() - 1) {
                 currSourceId = 0;
             } else {
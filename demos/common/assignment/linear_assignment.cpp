@@ -0,0 +1,366 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "linear_assignment.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+LinearAssignment::LinearAssignment(bool greedy) : greedy_(greedy), forbidden_cost_() {}
+
+std::vector<size_t> LinearAssignment::Solve(const cv::Mat &dissimilarity_matrix, float gate) {
+    CV_Assert(!dissimilarity_matrix.empty());
+    CV_Assert(dissimilarity_matrix.type() == CV_32F);
+
+    const int rows = dissimilarity_matrix.rows;
+    const int cols = dissimilarity_matrix.cols;
+
+    if (gate < std::numeric_limits<float>::infinity()) {
+        edges_.clear();
+        for (int i = 0; i < rows; i++) {
+            const auto ptr = dissimilarity_matrix.ptr<float>(i);
+            for (int j = 0; j < cols; j++) {
+                if (ptr[j] <= gate) {
+                    edges_.push_back({i, j, ptr[j]});
+                }
+            }
+        }
+        return Solve(rows, cols, edges_);
+    }
+
+    // Without a gate all pairs are allowed and the whole matrix is a single
+    // component, so it is solved in place without building the pair list.
+    const int n = std::max(rows, cols);
+    cost_.assign(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < rows; i++) {
+        const auto ptr = dissimilarity_matrix.ptr<float>(i);
+        std::copy(ptr, ptr + cols, cost_.begin() + static_cast<size_t>(i) * n);
+    }
+    forbidden_cost_ = std::numeric_limits<double>::infinity();
+
+    SolveComponent(rows, cols);
+
+    std::vector<size_t> results(rows, -1);
+    for (int i = 0; i < rows; i++) {
+        if (row_sol_[i] >= 0 && row_sol_[i] < cols) {
+            results[i] = row_sol_[i];
+        }
+    }
+    return results;
+}
+
+std::vector<size_t> LinearAssignment::Solve(int rows, int cols,
+                                            const std::vector<AssignmentEdge> &edges) {
+    CV_Assert(rows >= 0 && cols >= 0);
+
+    std::vector<size_t> results(rows, -1);
+    if (edges.empty()) {
+        return results;
+    }
+
+    const int num_nodes = rows + cols;
+    parent_.resize(num_nodes);
+    std::iota(parent_.begin(), parent_.end(), 0);
+    for (const auto &edge : edges) {
+        CV_Assert(edge.row >= 0 && edge.row < rows);
+        CV_Assert(edge.col >= 0 && edge.col < cols);
+        int a = FindRoot(edge.row);
+        int b = FindRoot(rows + edge.col);
+        if (a != b) {
+            parent_[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    for (int node = 0; node < num_nodes; node++) {
+        parent_[node] = FindRoot(node);
+    }
+
+    // Group nodes by component. Nodes are visited in ascending order, so
+    // rows of every component come before its columns.
+    component_start_.assign(num_nodes + 1, 0);
+    for (int node = 0; node < num_nodes; node++) {
+        component_start_[parent_[node] + 1]++;
+    }
+    std::partial_sum(component_start_.begin(), component_start_.end(), component_start_.begin());
+    component_nodes_.resize(num_nodes);
+    local_idx_.resize(num_nodes);
+    fill_.assign(component_start_.begin(), component_start_.end() - 1);
+    for (int node = 0; node < num_nodes; node++) {
+        const int pos = fill_[parent_[node]]++;
+        component_nodes_[pos] = node;
+        local_idx_[node] = pos - component_start_[parent_[node]];
+    }
+
+    // Group edges by component of their row.
+    component_edges_start_.assign(num_nodes + 1, 0);
+    for (const auto &edge : edges) {
+        component_edges_start_[parent_[edge.row] + 1]++;
+    }
+    std::partial_sum(component_edges_start_.begin(), component_edges_start_.end(),
+                     component_edges_start_.begin());
+    component_edges_.resize(edges.size());
+    fill_.assign(component_edges_start_.begin(), component_edges_start_.end() - 1);
+    for (size_t e = 0; e < edges.size(); e++) {
+        component_edges_[fill_[parent_[edges[e].row]]++] = static_cast<int>(e);
+    }
+
+    for (int root = 0; root < num_nodes; root++) {
+        const int edges_begin = component_edges_start_[root];
+        const int edges_end = component_edges_start_[root + 1];
+        if (edges_begin == edges_end) {
+            continue;
+        }
+
+        const int nodes_begin = component_start_[root];
+        const int nodes_end = component_start_[root + 1];
+        const int* nodes = component_nodes_.data() + nodes_begin;
+        const int n_rows = static_cast<int>(
+            std::lower_bound(nodes, nodes + (nodes_end - nodes_begin), rows) - nodes);
+        const int n_cols = nodes_end - nodes_begin - n_rows;
+
+        if (n_rows == 1 && n_cols == 1) {
+            results[nodes[0]] = nodes[1] - rows;
+            continue;
+        }
+
+        double min_cost = 0.0;
+        double max_cost = 0.0;
+        for (int e = edges_begin; e < edges_end; e++) {
+            min_cost = std::min(min_cost, static_cast<double>(edges[component_edges_[e]].cost));
+            max_cost = std::max(max_cost, static_cast<double>(edges[component_edges_[e]].cost));
+        }
+
+        // A forbidden pair must cost more than any assignment of allowed ones,
+        // so that the number of assigned rows is maximized first.
+        const int n = std::max(n_rows, n_cols);
+        forbidden_cost_ = (n + 1) * (max_cost - min_cost + 1.0);
+        cost_.assign(static_cast<size_t>(n) * n, 0.0);
+        for (int i = 0; i < n_rows; i++) {
+            std::fill_n(cost_.begin() + static_cast<size_t>(i) * n, n_cols, forbidden_cost_);
+        }
+        for (int e = edges_begin; e < edges_end; e++) {
+            const auto &edge = edges[component_edges_[e]];
+            double &cost = cost_[static_cast<size_t>(local_idx_[edge.row]) * n
+                                 + local_idx_[rows + edge.col] - n_rows];
+            cost = std::min(cost, static_cast<double>(edge.cost));
+        }
+
+        SolveComponent(n_rows, n_cols);
+
+        for (int i = 0; i < n_rows; i++) {
+            const int j = row_sol_[i];
+            if (j >= 0 && j < n_cols && cost_[static_cast<size_t>(i) * n + j] < forbidden_cost_) {
+                results[nodes[i]] = nodes[n_rows + j] - rows;
+            }
+        }
+    }
+    return results;
+}
+
+int LinearAssignment::FindRoot(int node) {
+    while (parent_[node] != node) {
+        parent_[node] = parent_[parent_[node]];
+        node = parent_[node];
+    }
+    return node;
+}
+
+void LinearAssignment::SolveComponent(int n_rows, int n_cols) {
+    if (greedy_) {
+        SolveGreedy(n_rows, n_cols);
+    } else {
+        SolveDense(std::max(n_rows, n_cols));
+    }
+}
+
+void LinearAssignment::SolveGreedy(int n_rows, int n_cols) {
+    const int n = std::max(n_rows, n_cols);
+    row_sol_.assign(n, -1);
+    col_sol_.assign(n, -1);
+    for (int i = 0; i < n_rows; i++) {
+        const double* row = cost_.data() + static_cast<size_t>(i) * n;
+        int best = -1;
+        for (int j = 0; j < n_cols; j++) {
+            if (col_sol_[j] < 0 && row[j] < forbidden_cost_ && (best < 0 || row[j] < row[best])) {
+                best = j;
+            }
+        }
+        if (best >= 0) {
+            row_sol_[i] = best;
+            col_sol_[best] = i;
+        }
+    }
+}
+
+void LinearAssignment::SolveDense(int n) {
+    const double* c = cost_.data();
+    auto cost = [c, n](int i, int j) { return c[static_cast<size_t>(i) * n + j]; };
+
+    row_sol_.assign(n, -1);
+    col_sol_.assign(n, -1);
+    v_.resize(n);
+    d_.resize(n);
+    pred_.resize(n);
+    col_list_.resize(n);
+    free_rows_.resize(n);
+    matches_.assign(n, 0);
+
+    // Column reduction: every column is priced by its cheapest row and is
+    // assigned to it if the row is still unassigned.
+    for (int j = n - 1; j >= 0; j--) {
+        int i_min = 0;
+        for (int i = 1; i < n; i++) {
+            if (cost(i, j) < cost(i_min, j)) {
+                i_min = i;
+            }
+        }
+        v_[j] = cost(i_min, j);
+        if (++matches_[i_min] == 1) {
+            row_sol_[i_min] = j;
+            col_sol_[j] = i_min;
+        }
+    }
+
+    // Reduction transfer from rows assigned once.
+    int num_free = 0;
+    for (int i = 0; i < n; i++) {
+        if (matches_[i] == 0) {
+            free_rows_[num_free++] = i;
+        } else if (matches_[i] == 1) {
+            const int j1 = row_sol_[i];
+            double min_val = std::numeric_limits<double>::max();
+            for (int j = 0; j < n; j++) {
+                if (j != j1) {
+                    min_val = std::min(min_val, cost(i, j) - v_[j]);
+                }
+            }
+            if (n > 1) {
+                v_[j1] -= min_val;
+            }
+        }
+    }
+
+    // Augmenting row reduction. Two passes over the free rows, rows which are
+    // displaced during a pass are left for the next one.
+    for (int pass = 0; pass < 2 && num_free > 0; pass++) {
+        const int prev_num_free = num_free;
+        num_free = 0;
+        for (int k = 0; k < prev_num_free; k++) {
+            const int i = free_rows_[k];
+
+            double u_min = cost(i, 0) - v_[0];
+            double u_sub_min = std::numeric_limits<double>::max();
+            int j1 = 0;
+            int j2 = -1;
+            for (int j = 1; j < n; j++) {
+                const double h = cost(i, j) - v_[j];
+                if (h < u_sub_min) {
+                    if (h >= u_min) {
+                        u_sub_min = h;
+                        j2 = j;
+                    } else {
+                        u_sub_min = u_min;
+                        u_min = h;
+                        j2 = j1;
+                        j1 = j;
+                    }
+                }
+            }
+
+            int i0 = col_sol_[j1];
+            if (u_min < u_sub_min) {
+                v_[j1] -= u_sub_min - u_min;
+            } else if (i0 >= 0) {
+                j1 = j2;
+                i0 = col_sol_[j2];
+            }
+            row_sol_[i] = j1;
+            col_sol_[j1] = i;
+            if (i0 >= 0) {
+                row_sol_[i0] = -1;
+                free_rows_[num_free++] = i0;
+            }
+        }
+    }
+
+    // Augmentation: Dijkstra-like shortest augmenting path from every
+    // remaining free row.
+    for (int f = 0; f < num_free; f++) {
+        const int free_row = free_rows_[f];
+        for (int j = 0; j < n; j++) {
+            d_[j] = cost(free_row, j) - v_[j];
+            pred_[j] = free_row;
+            col_list_[j] = j;
+        }
+
+        // Columns in [0, low) are scanned, in [low, up) are at the current
+        // minimum distance and in [up, n) are not reached yet.
+        int low = 0;
+        int up = 0;
+        int last = 0;
+        int end_of_path = -1;
+        double min_val = 0.0;
+        while (end_of_path < 0) {
+            if (up == low) {
+                last = low - 1;
+                min_val = d_[col_list_[up++]];
+                for (int k = up; k < n; k++) {
+                    const int j = col_list_[k];
+                    const double h = d_[j];
+                    if (h <= min_val) {
+                        if (h < min_val) {
+                            up = low;
+                            min_val = h;
+                        }
+                        col_list_[k] = col_list_[up];
+                        col_list_[up++] = j;
+                    }
+                }
+                for (int k = low; k < up; k++) {
+                    if (col_sol_[col_list_[k]] < 0) {
+                        end_of_path = col_list_[k];
+                        break;
+                    }
+                }
+            }
+
+            if (end_of_path < 0) {
+                const int j1 = col_list_[low++];
+                const int i = col_sol_[j1];
+                const double h = cost(i, j1) - v_[j1] - min_val;
+                for (int k = up; k < n; k++) {
+                    const int j = col_list_[k];
+                    const double v2 = cost(i, j) - v_[j] - h;
+                    if (v2 < d_[j]) {
+                        pred_[j] = i;
+                        if (v2 == min_val) {
+                            if (col_sol_[j] < 0) {
+                                end_of_path = j;
+                                break;
+                            }
+                            col_list_[k] = col_list_[up];
+                            col_list_[up++] = j;
+                        }
+                        d_[j] = v2;
+                    }
+                }
+            }
+        }
+
+        // Update prices of the scanned columns.
+        for (int k = 0; k <= last; k++) {
+            const int j1 = col_list_[k];
+            v_[j1] += d_[j1] - min_val;
+        }
+
+        // Augment along the path.
+        int i;
+        do {
+            i = pred_[end_of_path];
+            col_sol_[end_of_path] = i;
+            std::swap(end_of_path, row_sol_[i]);
+        } while (i != free_row);
+    }
+}
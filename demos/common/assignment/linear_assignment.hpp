@@ -0,0 +1,100 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+///
+/// \brief An allowed (row, column) pair of a sparse assignment problem.
+///
+struct AssignmentEdge {
+    int row;     ///< Row index.
+    int col;     ///< Column index.
+    float cost;  ///< Cost of assigning the column to the row.
+};
+
+///
+/// \brief The LinearAssignment class
+///
+/// Solves the rectangular linear assignment problem with the Jonker-Volgenant
+/// shortest augmenting path algorithm. Costs above the gate are treated as
+/// forbidden pairs: the problem is split into connected components of allowed
+/// pairs and every component is solved separately, maximizing the number of
+/// assigned rows first and minimizing the total cost second. Workspace buffers
+/// are kept between calls, so one instance should be reused across frames.
+///
+class LinearAssignment {
+public:
+    ///
+    /// \brief Initializes the class for assignment problem solving.
+    /// \param[in] greedy If a faster greedy matching should be used instead
+    /// of the optimal one. Every row takes its cheapest free column in order.
+    ///
+    explicit LinearAssignment(bool greedy = false);
+
+    ///
+    /// \brief Solves the assignment problem for given dissimilarity matrix.
+    /// It returns a vector that where each element is a column index for
+    /// corresponding row (e.g. result[0] stores optimal column index for very
+    /// first row in the dissimilarity matrix).
+    /// \param dissimilarity_matrix CV_32F dissimilarity matrix.
+    /// \param gate Pairs with dissimilarity above the gate are never assigned.
+    /// \return Optimal column index for each row. -1 means that there is no
+    /// column for row.
+    ///
+    std::vector<size_t> Solve(const cv::Mat &dissimilarity_matrix,
+                              float gate = std::numeric_limits<float>::infinity());
+
+    ///
+    /// \brief Solves the assignment problem given by the list of allowed pairs.
+    /// Pairs which are not listed are never assigned.
+    /// \param rows Number of rows.
+    /// \param cols Number of columns.
+    /// \param edges Allowed pairs with their costs.
+    /// \return Optimal column index for each row. -1 means that there is no
+    /// column for row.
+    ///
+    std::vector<size_t> Solve(int rows, int cols,
+                              const std::vector<AssignmentEdge> &edges);
+
+private:
+    int FindRoot(int node);
+    void SolveComponent(int n_rows, int n_cols);
+    void SolveDense(int n);
+    void SolveGreedy(int n_rows, int n_cols);
+
+    bool greedy_;
+
+    // Square cost matrix of the component being solved, row-major.
+    std::vector<double> cost_;
+    // Cost of forbidden pairs of the component being solved.
+    double forbidden_cost_;
+
+    // Jonker-Volgenant state: column of each row, row of each column,
+    // column prices, shortest path distances and predecessors.
+    std::vector<int> row_sol_;
+    std::vector<int> col_sol_;
+    std::vector<double> v_;
+    std::vector<double> d_;
+    std::vector<int> pred_;
+    std::vector<int> col_list_;
+    std::vector<int> free_rows_;
+    std::vector<int> matches_;
+
+    // Connected components of allowed pairs. Rows are nodes [0, rows),
+    // columns are nodes [rows, rows + cols). Nodes and edges are grouped by
+    // component root with a counting sort.
+    std::vector<int> parent_;
+    std::vector<int> local_idx_;
+    std::vector<int> component_start_;
+    std::vector<int> component_nodes_;
+    std::vector<int> component_edges_start_;
+    std::vector<int> component_edges_;
+    std::vector<int> fill_;
+    std::vector<AssignmentEdge> edges_;
+};
@@ -0,0 +1,310 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "cpu_planner.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <samples/slog.hpp>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <fstream>
+#endif
+
+namespace {
+#ifdef __linux__
+int readSysInt(const std::string& path, int defaultValue) {
+    std::ifstream file(path);
+    int value;
+    return file >> value ? value : defaultValue;
+}
+
+int readCpuNode(int cpu) {
+    // cpuN directory has a nodeK link to the node of the CPU if the kernel supports NUMA
+    DIR* dir = opendir(("/sys/devices/system/cpu/cpu" + std::to_string(cpu)).c_str());
+    if (nullptr == dir) {
+        return 0;
+    }
+    int node = 0;
+    while (dirent* entry = readdir(dir)) {
+        if (0 == std::strncmp(entry->d_name, "node", 4) && std::isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+#endif
+
+// Splits total items to contiguous ranges, one per weight, of at least one item and otherwise
+// proportional to the weights. If there are fewer items than weights, the ranges share them.
+std::vector<std::pair<size_t, size_t>> split(size_t total, const std::vector<unsigned>& weights) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (0 == total || weights.empty()) {
+        return ranges;
+    }
+    if (total < weights.size()) {
+        for (size_t i = 0; i < weights.size(); i++) {
+            ranges.emplace_back(i % total, 1);
+        }
+        return ranges;
+    }
+    unsigned weightsSum = 0;
+    for (unsigned weight : weights) {
+        weightsSum += std::max(weight, 1u);
+    }
+    if (0 == weightsSum) {
+        return ranges;
+    }
+    // everyone gets one item, the rest is distributed by the largest remainder method
+    const size_t spare = total - weights.size();
+    std::vector<size_t> counts;
+    std::vector<std::pair<size_t, size_t>> remainders;  // remainder, index
+    size_t given = 0;
+    for (size_t i = 0; i < weights.size(); i++) {
+        const size_t share = spare * std::max(weights[i], 1u);
+        counts.push_back(1 + share / weightsSum);
+        given += share / weightsSum;
+        remainders.emplace_back(share % weightsSum, i);
+    }
+    std::stable_sort(remainders.begin(), remainders.end(),
+        [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) { return a.first > b.first; });
+    for (size_t i = 0; given < spare; i++, given++) {
+        counts[remainders[i].second]++;
+    }
+    size_t begin = 0;
+    for (size_t count : counts) {
+        ranges.emplace_back(begin, count);
+        begin += count;
+    }
+    return ranges;
+}
+
+double meanLoad(const std::vector<int>& cpus, const std::vector<double>& cpuLoad) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (int cpu : cpus) {
+        if (static_cast<size_t>(cpu) < cpuLoad.size()) {
+            sum += cpuLoad[cpu];
+            count++;
+        }
+    }
+    return 0 == count ? 0.0 : sum / count;
+}
+}  // namespace
+
+CpuTopology CpuTopology::read() {
+    CpuTopology topology;
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (0 == sched_getaffinity(0, sizeof(mask), &mask)) {
+        std::map<std::pair<int, int>, Core> cores;  // by package and core id
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &mask)) {
+                continue;
+            }
+            const std::string topologyDir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            const int package = readSysInt(topologyDir + "physical_package_id", 0);
+            const int coreId = readSysInt(topologyDir + "core_id", -1 - cpu);  // unknown, the CPU is a core of its own
+            Core& core = cores[{package, coreId}];
+            core.cpus.push_back(cpu);
+            core.node = readCpuNode(cpu);
+        }
+        for (auto& core : cores) {
+            topology.cores.push_back(std::move(core.second));
+        }
+        std::sort(topology.cores.begin(), topology.cores.end(), [](const Core& a, const Core& b) {
+            return a.node != b.node ? a.node < b.node : a.cpus.front() < b.cpus.front();
+        });
+    }
+#endif
+    if (topology.cores.empty()) {
+        const int cpusCount = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+        for (int cpu = 0; cpu < cpusCount; cpu++) {
+            topology.cores.push_back({{cpu}, 0});
+        }
+    }
+    return topology;
+}
+
+size_t CpuTopology::getCpusCount() const {
+    size_t count = 0;
+    for (const Core& core : cores) {
+        count += core.cpus.size();
+    }
+    return count;
+}
+
+std::vector<int> CpuTopology::getCpus() const {
+    std::vector<int> cpus;
+    for (const Core& core : cores) {
+        cpus.insert(cpus.end(), core.cpus.begin(), core.cpus.end());
+    }
+    return cpus;
+}
+
+std::vector<CpuTopology> CpuTopology::splitByNodes() const {
+    std::vector<CpuTopology> nodes;
+    for (size_t i = 0; i < cores.size(); i++) {
+        if (0 == i || cores[i].node != cores[i - 1].node) {  // the cores are sorted by nodes
+            nodes.emplace_back();
+        }
+        nodes.back().cores.push_back(cores[i]);
+    }
+    return nodes;
+}
+
+void bindCurrentThread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &mask);
+    }
+    if (0 != pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask)) {
+        slog::warn << "Can't bind a thread to CPUs " << formatCpus(cpus) << slog::endl;
+    }
+#else
+    (void)cpus;
+#endif
+}
+
+std::string formatCpus(std::vector<int> cpus) {
+    std::sort(cpus.begin(), cpus.end());
+    std::ostringstream str;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        size_t last = i;
+        while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) {
+            last++;
+        }
+        str << (0 == i ? "" : ",") << cpus[i];
+        if (last != i) {
+            str << '-' << cpus[last];
+        }
+        i = last;
+    }
+    return str.str();
+}
+
+CpuPlanner::CpuPlanner(const CpuTopology& topology): topology(topology) {}
+
+void CpuPlanner::addNetwork(const std::string& name, unsigned weight) {
+    networks.push_back({name, weight});
+}
+
+void CpuPlanner::addStage(const std::string& name, unsigned threads) {
+    stages.push_back({name, threads});
+}
+
+void CpuPlanner::plan() {
+    assignments.clear();
+    const std::vector<CpuTopology::Core>& cores = topology.cores;
+
+    size_t hostThreads = 0;
+    size_t threadsPerCore = 1;
+    for (const Request& stage : stages) {
+        hostThreads += stage.amount;
+    }
+    for (const CpuTopology::Core& core : cores) {
+        threadsPerCore = std::max(threadsPerCore, core.cpus.size());
+    }
+    // host threads are lighter than inference, so they share hyper-threads of a core,
+    // but at least one core is left for the networks
+    size_t hostCores = (hostThreads + threadsPerCore - 1) / threadsPerCore;
+    hostCores = std::min(hostCores, cores.size() - (networks.empty() || cores.size() < 2 ? 0 : 1));
+    const size_t networkCores = 0 == hostCores || hostCores == cores.size() ? cores.size() : cores.size() - hostCores;
+
+    std::vector<int> hostCpus;
+    for (size_t i = cores.size() - (0 == hostCores ? cores.size() : hostCores); i < cores.size(); i++) {
+        hostCpus.insert(hostCpus.end(), cores[i].cpus.begin(), cores[i].cpus.end());
+    }
+    std::vector<unsigned> stageWeights;
+    for (const Request& stage : stages) {
+        stageWeights.push_back(stage.amount);
+    }
+    const auto stageRanges = split(hostCpus.size(), stageWeights);
+    for (size_t i = 0; i < stages.size(); i++) {
+        const auto& range = stageRanges[i];
+        assignments.push_back({stages[i].name,
+                               {hostCpus.begin() + range.first, hostCpus.begin() + range.first + range.second},
+                               stages[i].amount, 0});
+    }
+
+    if (networks.empty()) {
+        return;
+    }
+    std::vector<unsigned> networkWeights;
+    for (const Request& network : networks) {
+        networkWeights.push_back(network.amount);
+    }
+    const auto networkRanges = split(networkCores, networkWeights);
+    for (size_t i = 0; i < networks.size(); i++) {
+        Assignment assignment{networks[i].name, {}, 0, 0};
+        std::set<int> nodes;
+        for (size_t core = networkRanges[i].first; core < networkRanges[i].first + networkRanges[i].second; core++) {
+            assignment.cpus.insert(assignment.cpus.end(), cores[core].cpus.begin(), cores[core].cpus.end());
+            nodes.insert(cores[core].node);
+        }
+        assignment.threads = static_cast<unsigned>(networkRanges[i].second);
+        assignment.streams = static_cast<unsigned>(nodes.size());
+        assignments.push_back(std::move(assignment));
+    }
+}
+
+const CpuPlanner::Assignment& CpuPlanner::getAssignment(const std::string& name) const {
+    for (const Assignment& assignment : assignments) {
+        if (assignment.name == name) {
+            return assignment;
+        }
+    }
+    throw std::invalid_argument("The CPU plan has no " + name);
+}
+
+void CpuPlanner::bindCurrentThread(const std::string& name) const {
+    ::bindCurrentThread(getAssignment(name).cpus);
+}
+
+void CpuPlanner::printPlan() const {
+    std::set<int> nodes;
+    for (const CpuTopology::Core& core : topology.cores) {
+        nodes.insert(core.node);
+    }
+    slog::info << "CPU plan for " << topology.getCpusCount() << " CPUs, " << topology.cores.size() << " cores, "
+               << nodes.size() << " NUMA nodes:" << slog::endl;
+    for (const Assignment& assignment : assignments) {
+        slog::info << "    " << assignment.name << ": CPUs " << formatCpus(assignment.cpus)
+                   << ", " << assignment.threads << " threads";
+        if (0 != assignment.streams) {
+            slog::info << ", " << assignment.streams << " streams";
+        }
+        slog::info << slog::endl;
+    }
+}
+
+void CpuPlanner::printUtilization(const std::vector<double>& cpuLoad) const {
+    if (cpuLoad.empty()) {
+        return;
+    }
+    slog::info << "Mean CPU utilization: " << static_cast<int>(meanLoad(topology.getCpus(), cpuLoad) * 100) << "%" << slog::endl;
+    for (const Assignment& assignment : assignments) {
+        slog::info << "    " << assignment.name << ": " << static_cast<int>(meanLoad(assignment.cpus, cpuLoad) * 100)
+                   << "% of CPUs " << formatCpus(assignment.cpus) << slog::endl;
+    }
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+///
+/// \brief Logical CPUs the process may run on, grouped by physical cores and NUMA nodes.
+///
+struct CpuTopology {
+    struct Core {
+        std::vector<int> cpus;  // logical CPUs (hyper-threads) of the core
+        int node;
+    };
+
+    std::vector<Core> cores;  // sorted by NUMA nodes
+
+    ///
+    /// \brief Reads the topology from /sys, leaving out CPUs which aren't in the affinity mask
+    /// of the process, so instances started by taskset or numactl plan within their own CPUs.
+    /// Other systems get std::thread::hardware_concurrency() cores on one node.
+    ///
+    static CpuTopology read();
+
+    size_t getCpusCount() const;
+
+    std::vector<int> getCpus() const;
+
+    ///
+    /// \brief Splits the topology to parts of one NUMA node each.
+    ///
+    std::vector<CpuTopology> splitByNodes() const;
+};
+
+///
+/// \brief Restricts the calling thread to the CPUs. Threads it creates afterwards inherit the mask.
+/// Does nothing on other systems than Linux.
+///
+void bindCurrentThread(const std::vector<int>& cpus);
+
+///
+/// \brief Formats CPUs like the cpulist files of /sys, for example "0-3,8".
+///
+std::string formatCpus(std::vector<int> cpus);
+
+///
+/// \brief Splits the CPUs between the networks and the host stages of a pipeline.
+///
+/// Host stages (decoding, postprocessing, rendering) get the cores they ask for
+/// first, taken from the end of the CPU list. The rest of the physical cores is
+/// split between the networks in proportion to their weights, so that networks
+/// inferred concurrently don't compete for the same cores. A network gets one
+/// stream per NUMA node its cores belong to and one thread per core.
+///
+class CpuPlanner {
+public:
+    struct Assignment {
+        std::string name;
+        std::vector<int> cpus;
+        unsigned threads;
+        unsigned streams;  // 0 for host stages
+    };
+
+    explicit CpuPlanner(const CpuTopology& topology = CpuTopology::read());
+
+    ///
+    /// \brief Adds a network inferred on the CPU.
+    /// \param weight Relative amount of cores the network needs.
+    ///
+    void addNetwork(const std::string& name, unsigned weight);
+
+    ///
+    /// \brief Adds a pool of host threads.
+    ///
+    void addStage(const std::string& name, unsigned threads);
+
+    ///
+    /// \brief Assigns the CPUs to the networks and the stages added before.
+    ///
+    void plan();
+
+    const Assignment& getAssignment(const std::string& name) const;
+
+    ///
+    /// \brief Restricts the calling thread to the CPUs of the assignment. The inference threads
+    /// of the plugin inherit the mask if the network is loaded by the bound thread.
+    ///
+    void bindCurrentThread(const std::string& name) const;
+
+    void printPlan() const;
+
+    ///
+    /// \brief Prints the mean load of the CPUs of every assignment.
+    /// \param cpuLoad Load of every CPU from 0 to 1, CpuMonitor::getMeanCpuLoad() for example.
+    ///
+    void printUtilization(const std::vector<double>& cpuLoad) const;
+
+private:
+    struct Request {
+        std::string name;
+        unsigned amount;
+    };
+
+    const CpuTopology topology;
+    std::vector<Request> networks;
+    std::vector<Request> stages;
+    std::vector<Assignment> assignments;
+};
@@ -0,0 +1,100 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tests/check.hpp>
+
+#include "cpu_planner.hpp"
+
+namespace {
+// cores of two hyper-threads each, the first half on node 0 and the second on node 1
+CpuTopology makeTopology(int coresCount, int nodesCount) {
+    CpuTopology topology;
+    for (int core = 0; core < coresCount; core++) {
+        topology.cores.push_back({{core, core + coresCount}, core * nodesCount / coresCount});
+    }
+    return topology;
+}
+
+bool hasAssignment(const CpuPlanner& planner, const std::string& name) {
+    try {
+        planner.getAssignment(name);
+        return true;
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+}
+
+// security_barrier adds no networks if none of them is inferred on the CPU
+void testOnlyStages() {
+    CpuPlanner planner(makeTopology(4, 1));
+    planner.addStage("workers", 3);
+    planner.plan();
+    const CpuPlanner::Assignment& workers = planner.getAssignment("workers");
+    CHECK(3 == workers.threads);
+    CHECK(0 == workers.streams);
+    CHECK(!workers.cpus.empty());
+}
+
+void testNothingAdded() {
+    CpuPlanner planner(makeTopology(4, 1));
+    planner.plan();
+    CHECK(!hasAssignment(planner, "workers"));
+}
+
+void testNetworksAndStages() {
+    CpuPlanner planner(makeTopology(8, 2));
+    planner.addNetwork("detection", 3);
+    planner.addNetwork("recognition", 1);
+    planner.addStage("workers", 2);
+    planner.plan();
+
+    const CpuPlanner::Assignment& detection = planner.getAssignment("detection");
+    const CpuPlanner::Assignment& recognition = planner.getAssignment("recognition");
+    const CpuPlanner::Assignment& workers = planner.getAssignment("workers");
+    // two workers share the hyper-threads of the last core, the networks split the other 7 cores 3:1
+    CHECK(std::vector<int>({7, 15}) == workers.cpus);
+    CHECK(5 == detection.threads);
+    CHECK(2 == recognition.threads);
+    CHECK(2 == detection.streams);  // cores 0-4 span both nodes
+    CHECK(1 == recognition.streams);
+
+    std::set<int> cpus;
+    for (const CpuPlanner::Assignment* assignment : {&detection, &recognition, &workers}) {
+        for (int cpu : assignment->cpus) {
+            CHECK(cpus.insert(cpu).second);
+        }
+    }
+    CHECK(16 == cpus.size());
+}
+
+void testMoreNetworksThanCores() {
+    CpuPlanner planner(makeTopology(2, 1));
+    planner.addNetwork("a", 1);
+    planner.addNetwork("b", 1);
+    planner.addNetwork("c", 1);
+    planner.plan();
+    for (const char* name : {"a", "b", "c"}) {
+        CHECK(1 == planner.getAssignment(name).threads);
+    }
+}
+
+void testFormatCpus() {
+    CHECK("0-3,8" == formatCpus({8, 2, 0, 1, 3}));
+    CHECK("" == formatCpus({}));
+}
+}  // namespace
+
+int main() {
+    testOnlyStages();
+    testNothingAdded();
+    testNetworksAndStages();
+    testMoreNetworksThanCores();
+    testFormatCpus();
+    return tests::result();
+}
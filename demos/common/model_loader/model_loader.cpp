@@ -0,0 +1,295 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "model_loader.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <samples/slog.hpp>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+enum class Origin {
+    COMPILED,
+    IMPORTED,
+    COMPILED_AND_EXPORTED,
+    EXPORT_UNSUPPORTED
+};
+
+struct LoadRecord {
+    std::string modelPath;
+    std::string deviceName;
+    std::chrono::milliseconds readTime;
+    std::chrono::milliseconds loadTime;
+    Origin origin;
+};
+
+// Unique among the threads of all processes, so concurrent exports of the same blob don't write to the same file
+std::string makeTmpSuffix() {
+#ifdef _WIN32
+    const int pid = _getpid();
+#else
+    const int pid = static_cast<int>(getpid());
+#endif
+    std::ostringstream suffix;
+    suffix << '.' << pid << '-' << std::hex << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+    return suffix.str();
+}
+
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t fnvPrime = 1099511628211ULL;
+
+void hashBytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * fnvPrime;
+    }
+}
+
+void hashFile(uint64_t& hash, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return;  // ONNX models have no weights file
+    }
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        hashBytes(hash, buffer.data(), static_cast<size_t>(file.gcount()));
+    }
+}
+
+uint64_t hashModel(const std::string& modelPath) {
+    uint64_t hash = fnvOffsetBasis;
+    hashFile(hash, modelPath);
+    const size_t extensionPos = modelPath.rfind('.');
+    if (std::string::npos != extensionPos && modelPath.substr(extensionPos) == ".xml") {
+        hashFile(hash, modelPath.substr(0, extensionPos) + ".bin");
+    }
+    return hash;
+}
+
+std::string fileName(const std::string& path) {
+    return path.substr(path.find_last_of("/\\") + 1);
+}
+
+std::string fileStem(const std::string& path) {
+    std::string name = fileName(path);
+    return name.substr(0, name.rfind('.'));
+}
+
+template<typename Dims>
+void describeDims(std::ostream& description, const Dims& dims) {
+    for (size_t dim : dims) {
+        description << ' ' << dim;
+    }
+}
+
+std::string describeNetwork(const InferenceEngine::CNNNetwork& network) {
+    std::ostringstream description;
+    description << "batch " << network.getBatchSize() << '\n';
+    for (const auto& input : network.getInputsInfo()) {
+        const InferenceEngine::InputInfo::Ptr& info = input.second;
+        description << "input " << input.first << ' ' << info->getPrecision().name() << ' ' << info->getLayout()
+                    << ' ' << static_cast<int>(info->getPreProcess().getResizeAlgorithm())
+                    << ' ' << static_cast<int>(info->getPreProcess().getColorFormat())
+                    << ' ' << static_cast<int>(info->getPreProcess().getMeanVariant());
+        describeDims(description, info->getTensorDesc().getDims());
+        description << '\n';
+    }
+    for (const auto& output : network.getOutputsInfo()) {
+        const InferenceEngine::DataPtr& data = output.second;
+        description << "output " << output.first << ' ' << data->getPrecision().name() << ' ' << data->getLayout();
+        describeDims(description, data->getTensorDesc().getDims());
+        description << '\n';
+    }
+    return description.str();
+}
+}  // namespace
+
+struct ModelLoader::State {
+    State(const InferenceEngine::Core& ie, const std::string& cacheDir): ie(ie), cacheDir(cacheDir) {}
+
+    InferenceEngine::Core ie;
+    const std::string cacheDir;
+
+    // Guards the members below. It also serializes device queries, which create plugins
+    // of the Core on the first use, so that networks can be loaded to the devices concurrently.
+    std::mutex mutex;
+    std::set<std::string> initializedDevices;
+    std::map<std::string, std::pair<std::chrono::milliseconds, uint64_t>> reads;  // read time and hash by model path
+    std::vector<LoadRecord> loads;
+    std::chrono::milliseconds runTime{-1};
+};
+
+ModelLoader::ModelLoader(): ModelLoader(InferenceEngine::Core(), "") {}
+
+ModelLoader::ModelLoader(const InferenceEngine::Core& ie, const std::string& cacheDir):
+    state(std::make_shared<State>(ie, cacheDir)) {}
+
+InferenceEngine::Core& ModelLoader::getCore() const {
+    return state->ie;
+}
+
+InferenceEngine::CNNNetwork ModelLoader::readNetwork(const std::string& modelPath) const {
+    const auto begin = Clock::now();
+    InferenceEngine::CNNNetwork network = state->ie.ReadNetwork(modelPath);
+    const uint64_t modelHash = state->cacheDir.empty() ? 0 : hashModel(modelPath);
+    const auto readTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->reads[modelPath] = {readTime, modelHash};
+    return network;
+}
+
+InferenceEngine::ExecutableNetwork ModelLoader::loadNetwork(const InferenceEngine::CNNNetwork& network,
+                                                            const std::string& modelPath,
+                                                            const std::string& deviceName,
+                                                            const std::map<std::string, std::string>& config) const {
+    const auto begin = Clock::now();
+    InferenceEngine::Core& ie = state->ie;
+    std::chrono::milliseconds readTime{0};
+    uint64_t modelHash = 0;
+    std::ostringstream description;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->initializedDevices.insert(deviceName).second) {
+            ie.GetVersions(deviceName);
+        }
+        auto read = state->reads.find(modelPath);
+        if (state->reads.end() != read) {
+            readTime = read->second.first;
+            modelHash = read->second.second;
+        }
+
+        if (!state->cacheDir.empty()) {
+            description << InferenceEngine::GetInferenceEngineVersion()->buildNumber << '\n' << deviceName << '\n';
+            try {
+                std::vector<std::string> keys = ie.GetMetric(deviceName, METRIC_KEY(SUPPORTED_CONFIG_KEYS));
+                for (const std::string& key : keys) {
+                    try {
+                        description << key << '=' << ie.GetConfig(deviceName, key).as<std::string>() << '\n';
+                    } catch (const std::exception&) {}  // not a string
+                }
+            } catch (const std::exception&) {}  // HETERO and MULTI don't report their keys
+            for (const auto& item : config) {
+                description << item.first << '=' << item.second << '\n';
+            }
+            description << describeNetwork(network);
+        }
+    }
+
+    InferenceEngine::ExecutableNetwork executableNetwork;
+    Origin origin = Origin::COMPILED;
+    if (state->cacheDir.empty()) {
+        executableNetwork = ie.LoadNetwork(network, deviceName, config);
+    } else {
+        if (0 == modelHash) {
+            modelHash = hashModel(modelPath);  // the network wasn't read by this loader
+        }
+        std::string descriptionStr = description.str();
+        hashBytes(modelHash, descriptionStr.data(), descriptionStr.size());
+        std::ostringstream blobPath;
+        blobPath << state->cacheDir << '/' << fileStem(modelPath) << '-'
+                 << std::hex << std::setw(16) << std::setfill('0') << modelHash << ".blob";
+
+        if (std::ifstream(blobPath.str()).good()) {
+            try {
+                executableNetwork = ie.ImportNetwork(blobPath.str(), deviceName, config);
+                origin = Origin::IMPORTED;
+            } catch (const std::exception&) {}  // stale or damaged, overwrite it
+        }
+        if (Origin::IMPORTED != origin) {
+            executableNetwork = ie.LoadNetwork(network, deviceName, config);
+            // Other demo instances may use the cache at the same time, so the blob appears atomically
+            const std::string tmpPath = blobPath.str() + makeTmpSuffix();
+            try {
+                executableNetwork.Export(tmpPath);
+#ifdef _WIN32
+                std::remove(blobPath.str().c_str());  // rename() doesn't replace existing files on Windows
+#endif
+                origin = 0 == std::rename(tmpPath.c_str(), blobPath.str().c_str())
+                    ? Origin::COMPILED_AND_EXPORTED : Origin::EXPORT_UNSUPPORTED;
+            } catch (const std::exception&) {
+                origin = Origin::EXPORT_UNSUPPORTED;
+            }
+            std::remove(tmpPath.c_str());
+        }
+    }
+    const auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->loads.push_back({modelPath, deviceName, readTime, loadTime, origin});
+    return executableNetwork;
+}
+
+void ModelLoader::run(const std::vector<std::function<void()>>& loaders) const {
+    const auto begin = Clock::now();
+    std::vector<std::exception_ptr> errors(loaders.size());
+    std::vector<std::thread> threads;
+    threads.reserve(loaders.size());
+    for (size_t i = 0; i < loaders.size(); i++) {
+        threads.emplace_back([&loaders, &errors, i]() {
+            try {
+                loaders[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->runTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void ModelLoader::printReport() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->runTime.count() >= 0) {
+        slog::info << "Networks are loaded in " << state->runTime.count() << " ms" << slog::endl;
+    }
+    for (const LoadRecord& load : state->loads) {
+        slog::info << "    " << fileName(load.modelPath) << " on " << load.deviceName
+                   << ": read in " << load.readTime.count() << " ms, ";
+        switch (load.origin) {
+        case Origin::COMPILED:
+            slog::info << "compiled in " << load.loadTime.count() << " ms" << slog::endl;
+            break;
+        case Origin::IMPORTED:
+            slog::info << "imported from the cache in " << load.loadTime.count() << " ms" << slog::endl;
+            break;
+        case Origin::COMPILED_AND_EXPORTED:
+            slog::info << "compiled and cached in " << load.loadTime.count() << " ms" << slog::endl;
+            break;
+        case Origin::EXPORT_UNSUPPORTED:
+            slog::info << "compiled in " << load.loadTime.count() << " ms, can't be cached" << slog::endl;
+            break;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+///
+/// \brief Reads and compiles networks of a demo, optionally caching compiled networks on disk.
+///
+/// Copies share the Core, the cache and the timing report, so a loader can be
+/// passed around by value like InferenceEngine::Core. All methods are thread-safe.
+///
+/// Cached networks are exported by ExecutableNetwork::Export() and stored as
+/// <cache dir>/<model name>-<key>.blob. The key is a hash of the model files,
+/// the Inference Engine build, the device, its configuration, the load config
+/// and the precisions, layouts, shapes and preprocessing of the network inputs
+/// and outputs, so changing any of them leads to a new compilation. Devices
+/// which don't support export compile the networks every time.
+///
+class ModelLoader {
+public:
+    ///
+    /// \brief Creates a loader with a Core of its own and without the cache.
+    ///
+    ModelLoader();
+
+    ///
+    /// \brief Creates a loader.
+    /// \param ie Core to load networks with. Configure its devices and add
+    /// extensions before loading networks.
+    /// \param cacheDir Existing directory for compiled networks, empty to disable the cache.
+    ///
+    ModelLoader(const InferenceEngine::Core& ie, const std::string& cacheDir);
+
+    InferenceEngine::Core& getCore() const;
+
+    ///
+    /// \brief Reads a network.
+    ///
+    InferenceEngine::CNNNetwork readNetwork(const std::string& modelPath) const;
+
+    ///
+    /// \brief Imports the network from the cache or compiles it.
+    /// \param network Network read by readNetwork() and configured by the caller.
+    /// \param modelPath Path the network was read from.
+    /// \param deviceName Device to load the network to.
+    /// \param config Load config.
+    ///
+    InferenceEngine::ExecutableNetwork loadNetwork(const InferenceEngine::CNNNetwork& network,
+                                                   const std::string& modelPath,
+                                                   const std::string& deviceName,
+                                                   const std::map<std::string, std::string>& config = {}) const;
+
+    ///
+    /// \brief Runs functions which load networks concurrently and waits for all of them.
+    /// If some of them throw, the first exception is rethrown.
+    ///
+    void run(const std::vector<std::function<void()>>& loaders) const;
+
+    ///
+    /// \brief Prints how long every network was read and loaded.
+    ///
+    void printReport() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+};
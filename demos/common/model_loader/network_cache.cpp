@@ -0,0 +1,140 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "network_cache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <utility>
+
+#include <samples/slog.hpp>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif __linux__
+#include <fstream>
+#include <unistd.h>
+#endif
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t bytesInMb = 1024 * 1024;
+
+// Returns 0 where it isn't known, so the estimates fall back to the sizes of the blobs
+size_t residentMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+#elif __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages, residentPages;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+size_t byteSize(const InferenceEngine::TensorDesc& desc) {
+    const InferenceEngine::SizeVector& dims = desc.getDims();
+    return std::accumulate(dims.begin(), dims.end(), size_t{1}, std::multiplies<size_t>()) * desc.getPrecision().size();
+}
+
+size_t blobsSize(const InferenceEngine::ExecutableNetwork& network) {
+    size_t size = 0;
+    for (const auto& input : network.GetInputsInfo()) {
+        size += byteSize(input.second->getTensorDesc());
+    }
+    for (const auto& output : network.GetOutputsInfo()) {
+        size += byteSize(output.second->getTensorDesc());
+    }
+    return size;
+}
+
+std::string describeShapes(const InferenceEngine::ICNNNetwork::InputShapes& shapes) {
+    std::ostringstream description;
+    for (const auto& input : shapes) {
+        description << (shapes.begin()->first == input.first ? "" : ", ") << input.first << ' ';
+        for (size_t i = 0; i < input.second.size(); i++) {
+            description << (0 == i ? "" : "x") << input.second[i];
+        }
+    }
+    return description.str();
+}
+}  // namespace
+
+NetworkCache::NetworkCache(const ModelLoader& loader, const InferenceEngine::CNNNetwork& network,
+                           const std::string& modelPath, const std::string& deviceName,
+                           size_t memoryBudget, const std::map<std::string, std::string>& config):
+    loader(loader), network(network), modelPath(modelPath), deviceName(deviceName),
+    memoryBudget(memoryBudget), config(config), stats{0, 0, 0, std::chrono::milliseconds{0}, 0, 0} {}
+
+InferenceEngine::ExecutableNetwork NetworkCache::get(const InferenceEngine::ICNNNetwork::InputShapes& shapes) {
+    // Misses reshape the network, so they are serialized with everything else
+    std::lock_guard<std::mutex> lock(mutex);
+    auto indexIt = index.find(shapes);
+    if (index.end() != indexIt) {
+        entries.splice(entries.begin(), entries, indexIt->second);
+        indexIt->second->hits++;
+        stats.hits++;
+        return indexIt->second->network;
+    }
+
+    const auto begin = Clock::now();
+    const size_t memoryBefore = residentMemory();
+    if (network.getInputShapes() != shapes) {
+        network.reshape(shapes);
+    }
+    InferenceEngine::ExecutableNetwork executableNetwork = loader.loadNetwork(network, modelPath, deviceName, config);
+    const size_t memoryAfter = residentMemory();
+    const auto compileTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin);
+
+    const size_t memoryUsage = std::max(memoryAfter > memoryBefore ? memoryAfter - memoryBefore : size_t{0},
+                                        blobsSize(executableNetwork));
+    entries.push_front({shapes, executableNetwork, compileTime, memoryUsage, 0});
+    index[shapes] = entries.begin();
+    stats.misses++;
+    stats.compileTime += compileTime;
+    stats.memoryUsage += memoryUsage;
+    stats.networksCount = entries.size();
+    evict();
+    return executableNetwork;
+}
+
+void NetworkCache::evict() {
+    while (stats.memoryUsage > memoryBudget && entries.size() > 1) {
+        const Entry& entry = entries.back();
+        stats.memoryUsage -= entry.memoryUsage;
+        stats.evictions++;
+        index.erase(entry.shapes);
+        entries.pop_back();
+    }
+    stats.networksCount = entries.size();
+}
+
+NetworkCache::Stats NetworkCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void NetworkCache::printReport() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint64_t requests = stats.hits + stats.misses;
+    slog::info << "Network cache: " << stats.hits << " hits of " << requests << " requests ("
+               << (0 == requests ? 0 : 100 * stats.hits / requests) << "%), "
+               << stats.misses << " networks compiled in " << stats.compileTime.count() << " ms, "
+               << stats.evictions << " evicted, " << stats.memoryUsage / bytesInMb << " of "
+               << memoryBudget / bytesInMb << " MB used" << slog::endl;
+    for (const Entry& entry : entries) {
+        slog::info << "    " << describeShapes(entry.shapes) << ": compiled in " << entry.compileTime.count() << " ms, "
+                   << entry.memoryUsage / bytesInMb << " MB, " << entry.hits << " hits" << slog::endl;
+    }
+}
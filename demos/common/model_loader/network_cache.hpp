@@ -0,0 +1,98 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <inference_engine.hpp>
+
+#include "model_loader.hpp"
+
+///
+/// \brief Keeps networks compiled for different input shapes of a model.
+///
+/// A demo which gets inputs of varying sizes reshapes its network to fit them. Compiling
+/// the network for every new shape takes much longer than an inference, so the cache keeps
+/// the compiled networks and returns them when the shape comes again. To keep the number of
+/// shapes small, the demo rounds the sizes up to a bucket with bucket() and pads the inputs
+/// to the shape of the bucket.
+///
+/// The compiled networks take memory, so the least recently used networks are released
+/// when their total size exceeds the budget. The size of a network is estimated as the growth
+/// of the resident memory of the process while the network is compiled, but not less than
+/// the size of its input and output blobs. A released network stays alive while the caller
+/// keeps a copy of it.
+///
+/// The networks are compiled by a ModelLoader, so they are also cached on disk if the loader
+/// has a cache directory. All methods are thread-safe.
+///
+class NetworkCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        std::chrono::milliseconds compileTime;  // of all misses
+        size_t memoryUsage;  // estimated bytes of the networks in the cache
+        size_t networksCount;
+    };
+
+    ///
+    /// \param network Network to compile. The cache reshapes it, so the caller must not
+    /// reshape it or compile it while the cache exists.
+    /// \param memoryBudget Bytes the compiled networks may take. The most recently used
+    /// network is kept even if it exceeds the budget alone.
+    ///
+    NetworkCache(const ModelLoader& loader, const InferenceEngine::CNNNetwork& network,
+                 const std::string& modelPath, const std::string& deviceName,
+                 size_t memoryBudget, const std::map<std::string, std::string>& config = {});
+
+    ///
+    /// \brief Returns the network compiled for the input shapes, compiles it on a miss.
+    ///
+    InferenceEngine::ExecutableNetwork get(const InferenceEngine::ICNNNetwork::InputShapes& shapes);
+
+    Stats getStats() const;
+
+    ///
+    /// \brief Prints the hit rate, the compile time and the networks in the cache.
+    ///
+    void printReport() const;
+
+    ///
+    /// \brief Rounds a dimension up to a multiple of the step.
+    ///
+    static size_t bucket(size_t dim, size_t step) {
+        return (dim + step - 1) / step * step;
+    }
+
+private:
+    struct Entry {
+        InferenceEngine::ICNNNetwork::InputShapes shapes;
+        InferenceEngine::ExecutableNetwork network;
+        std::chrono::milliseconds compileTime;
+        size_t memoryUsage;
+        uint64_t hits;
+    };
+
+    void evict();
+
+    ModelLoader loader;
+    InferenceEngine::CNNNetwork network;
+    const std::string modelPath;
+    const std::string deviceName;
+    const size_t memoryBudget;
+    const std::map<std::string, std::string> config;
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries;  // the most recently used first
+    std::map<InferenceEngine::ICNNNetwork::InputShapes, std::list<Entry>::iterator> index;
+    Stats stats;
+};
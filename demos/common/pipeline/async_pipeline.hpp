@@ -0,0 +1,225 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+///
+/// \brief Runs inference of a stream of inputs on a pool of infer requests.
+///
+/// Up to depth inputs are inferred at the same time. The caller preprocesses an input into
+/// a free request in submit(). When a request completes, its completion callback hands it
+/// to worker threads, which postprocess it and free it for the next input. pop() delivers
+/// the outputs in the order the inputs were submitted. A single-stream demo which keeps
+/// depth inputs submitted overlaps capture, preprocessing, inference, postprocessing and
+/// rendering of different frames.
+///
+/// The postprocessor may run for several requests at once, so it must be thread-safe.
+/// Output must be default-constructible. submit() and pop() may be called from different
+/// threads.
+///
+template <typename Input, typename Output>
+class AsyncPipeline {
+public:
+    using Preprocessor = std::function<void(const Input&, InferenceEngine::InferRequest&)>;
+    using Postprocessor = std::function<Output(const Input&, InferenceEngine::InferRequest&)>;
+
+    ///
+    /// \param depth Number of infer requests.
+    /// \param workersCount Number of postprocessing threads, 0 to use up to depth threads.
+    ///
+    AsyncPipeline(InferenceEngine::ExecutableNetwork& network, size_t depth,
+                  Preprocessor preprocessor, Postprocessor postprocessor, size_t workersCount = 0)
+            : preprocessor(std::move(preprocessor)), postprocessor(std::move(postprocessor)) {
+        if (0 == depth) {
+            throw std::invalid_argument("The depth of a pipeline must be positive");
+        }
+        for (size_t i = 0; i < depth; i++) {
+            requests.emplace_back(new Request{network.CreateInferRequest(), Input(), 0});
+            Request* request = requests.back().get();
+            request->inferRequest.SetCompletionCallback([this, request] {
+                // notifies under the lock, so the pipeline can't be destroyed before the callback returns
+                std::lock_guard<std::mutex> lock(mutex);
+                completedRequests.push(request);
+                completedCondVar.notify_one();
+            });
+            freeRequests.push(request);
+        }
+
+        if (0 == workersCount) {
+            workersCount = std::max<size_t>(1, std::min<size_t>(depth, std::thread::hardware_concurrency()));
+        }
+        for (size_t i = 0; i < workersCount; i++) {
+            workers.emplace_back(&AsyncPipeline::work, this);
+        }
+    }
+
+    ~AsyncPipeline() {
+        waitAll();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        completedCondVar.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AsyncPipeline(const AsyncPipeline&) = delete;
+    AsyncPipeline& operator=(const AsyncPipeline&) = delete;
+
+    size_t getDepth() const {
+        return requests.size();
+    }
+
+    ///
+    /// \brief Preprocesses the input into a free request and starts the request.
+    /// Waits for a request to be freed if all of them are busy. Errors of preprocessing,
+    /// inference and postprocessing are rethrown by pop() of the input.
+    ///
+    void submit(Input input) {
+        Request* request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            freeCondVar.wait(lock, [this] { return !freeRequests.empty(); });
+            request = freeRequests.front();
+            freeRequests.pop();
+            request->id = submittedCount++;
+        }
+        request->input = std::move(input);
+        try {
+            preprocessor(request->input, request->inferRequest);
+            request->inferRequest.StartAsync();
+        } catch (...) {
+            finish(request, Output(), std::current_exception());
+        }
+    }
+
+    ///
+    /// \brief Returns the number of inputs which were submitted and weren't popped yet.
+    ///
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<size_t>(submittedCount - deliveredCount);
+    }
+
+    ///
+    /// \brief Waits for the output of the earliest submitted input which wasn't popped yet.
+    /// \return false if there are no such inputs.
+    ///
+    bool pop(Input& input, Output& output) {
+        Result result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (deliveredCount == submittedCount) {
+                return false;
+            }
+            readyCondVar.wait(lock, [this] { return results.count(deliveredCount) != 0; });
+            auto resultIt = results.find(deliveredCount);
+            result = std::move(resultIt->second);
+            results.erase(resultIt);
+            deliveredCount++;
+        }
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+        input = std::move(result.input);
+        output = std::move(result.output);
+        return true;
+    }
+
+    ///
+    /// \brief Waits until all submitted inputs are postprocessed. The outputs stay to be popped.
+    ///
+    void waitAll() {
+        std::unique_lock<std::mutex> lock(mutex);
+        freeCondVar.wait(lock, [this] { return freeRequests.size() == requests.size(); });
+    }
+
+    ///
+    /// \brief Returns a request of the pool, for example to print its performance counts after waitAll().
+    ///
+    InferenceEngine::InferRequest& getRequest(size_t index) {
+        return requests.at(index)->inferRequest;
+    }
+
+private:
+    struct Request {
+        InferenceEngine::InferRequest inferRequest;
+        Input input;
+        uint64_t id;
+    };
+
+    struct Result {
+        Input input;
+        Output output;
+        std::exception_ptr error;
+    };
+
+    void work() {
+        while (true) {
+            Request* request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                completedCondVar.wait(lock, [this] { return stopped || !completedRequests.empty(); });
+                if (completedRequests.empty()) {
+                    return;
+                }
+                request = completedRequests.front();
+                completedRequests.pop();
+            }
+            try {
+                // rethrows the error of the inference
+                request->inferRequest.Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+                finish(request, postprocessor(request->input, request->inferRequest), nullptr);
+            } catch (...) {
+                finish(request, Output(), std::current_exception());
+            }
+        }
+    }
+
+    void finish(Request* request, Output&& output, std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results[request->id] = Result{std::move(request->input), std::move(output), error};
+            request->input = Input();
+            freeRequests.push(request);
+        }
+        freeCondVar.notify_all();
+        readyCondVar.notify_all();
+    }
+
+    Preprocessor preprocessor;
+    Postprocessor postprocessor;
+    std::vector<std::unique_ptr<Request>> requests;
+
+    std::mutex mutex;
+    std::condition_variable freeCondVar;
+    std::condition_variable completedCondVar;
+    std::condition_variable readyCondVar;
+    std::queue<Request*> freeRequests;
+    std::queue<Request*> completedRequests;
+    std::map<uint64_t, Result> results;  // by the ids of the inputs
+    uint64_t submittedCount = 0;
+    uint64_t deliveredCount = 0;
+    bool stopped = false;
+
+    std::vector<std::thread> workers;
+};
@@ -0,0 +1,335 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "replay.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// The file is a header followed by records:
+//   header: magic, uint32 rank of the input, uint64 dimensions of the input
+//   record: uint64 stream, int64 frame, uint32 number of blobs, blobs
+//   blob: uint32 length of the name, name, uint32 rank, uint64 dimensions,
+//         padding to a multiple of 8 bytes from the start of the file, FP32 data
+// Values have the byte order of the machine which wrote them.
+const char magic[8] = {'O', 'M', 'Z', 'R', 'E', 'C', '0', '1'};
+constexpr size_t dataAlignment = 8;
+
+size_t alignedOffset(size_t offset) {
+    return (offset + dataAlignment - 1) / dataAlignment * dataAlignment;
+}
+
+class Reader {
+public:
+    Reader(const char* data, size_t size): data(data), size(size) {}
+
+    bool atEnd() const {
+        return offset == size;
+    }
+
+    const char* take(size_t count) {
+        if (count > size - offset) {
+            throw std::runtime_error("Unexpected end of the recorded outputs");
+        }
+        const char* result = data + offset;
+        offset += count;
+        return result;
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    void align() {
+        take(alignedOffset(offset) - offset);
+    }
+
+private:
+    const char* data;
+    size_t size;
+    size_t offset = 0;
+};
+
+InferenceEngine::SizeVector readDims(Reader& reader) {
+    InferenceEngine::SizeVector dims(reader.read<uint32_t>());
+    for (size_t& dim : dims) {
+        dim = static_cast<size_t>(reader.read<uint64_t>());
+    }
+    return dims;
+}
+}  // namespace
+
+OutputsRecorder::OutputsRecorder(const std::string& path): file(path, std::ios::binary) {
+    if (!file) {
+        throw std::runtime_error("Can't open " + path + " for recording the outputs");
+    }
+    writeBytes(magic, sizeof(magic));
+}
+
+void OutputsRecorder::setInputDims(const InferenceEngine::SizeVector& dims) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!inputDims.empty()) {
+        if (dims != inputDims) {
+            throw std::invalid_argument("The recorded networks have different inputs");
+        }
+        return;
+    }
+    inputDims = dims;
+    const uint32_t rank = static_cast<uint32_t>(inputDims.size());
+    writeBytes(&rank, sizeof(rank));
+    for (size_t dim : inputDims) {
+        const uint64_t value = dim;
+        writeBytes(&value, sizeof(value));
+    }
+}
+
+void OutputsRecorder::write(size_t stream, int64_t frame, const InferenceEngine::BlobMap& outputs) {
+    for (const auto& output : outputs) {
+        if (output.second->getTensorDesc().getPrecision() != InferenceEngine::Precision::FP32) {
+            throw std::invalid_argument("Only FP32 outputs can be recorded, " + output.first + " isn't FP32");
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (inputDims.empty()) {
+        throw std::logic_error("The input dimensions must be recorded before the outputs");
+    }
+    int64_t& nextFrame = nextFrames[stream];
+    if (frame < 0) {
+        frame = nextFrame;
+    }
+    nextFrame = frame + 1;
+
+    const uint64_t streamValue = stream;
+    writeBytes(&streamValue, sizeof(streamValue));
+    writeBytes(&frame, sizeof(frame));
+    const uint32_t blobsCount = static_cast<uint32_t>(outputs.size());
+    writeBytes(&blobsCount, sizeof(blobsCount));
+    for (const auto& output : outputs) {
+        const uint32_t nameLength = static_cast<uint32_t>(output.first.size());
+        writeBytes(&nameLength, sizeof(nameLength));
+        writeBytes(output.first.data(), output.first.size());
+        const InferenceEngine::SizeVector& dims = output.second->getTensorDesc().getDims();
+        const uint32_t rank = static_cast<uint32_t>(dims.size());
+        writeBytes(&rank, sizeof(rank));
+        for (size_t dim : dims) {
+            const uint64_t value = dim;
+            writeBytes(&value, sizeof(value));
+        }
+        align();
+        InferenceEngine::LockedMemory<const void> outputMapped =
+            InferenceEngine::as<InferenceEngine::MemoryBlob>(output.second)->rmap();
+        writeBytes(outputMapped.as<const char*>(), output.second->byteSize());
+    }
+    if (!file) {
+        throw std::runtime_error("Can't write the recorded outputs");
+    }
+}
+
+void OutputsRecorder::writeBytes(const void* data, size_t size) {
+    file.write(static_cast<const char*>(data), size);
+    offset += size;
+}
+
+void OutputsRecorder::align() {
+    static const char padding[dataAlignment] = {};
+    writeBytes(padding, alignedOffset(offset) - offset);
+}
+
+struct OutputsReplayer::Mapping {
+    explicit Mapping(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (INVALID_HANDLE_VALUE == file) {
+            throw std::system_error(GetLastError(), std::system_category(), "Can't open " + path);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::system_error(GetLastError(), std::system_category(), "Can't get the size of " + path);
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        if (0 == size) {
+            CloseHandle(file);
+            throw std::runtime_error(path + " is empty");
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (nullptr == mapping) {
+            CloseHandle(file);
+            throw std::system_error(GetLastError(), std::system_category(), "Can't map " + path);
+        }
+        data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        if (nullptr == data) {
+            const DWORD error = GetLastError();
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::system_error(error, std::system_category(), "Can't map " + path);
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (-1 == fd) {
+            throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+        }
+        struct stat fileStat;
+        if (-1 == fstat(fd, &fileStat)) {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "Can't get the size of " + path);
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        if (0 == size) {
+            close(fd);
+            throw std::runtime_error(path + " is empty");
+        }
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        close(fd);  // the mapping keeps the file
+        if (MAP_FAILED == address) {
+            throw std::system_error(error, std::generic_category(), "Can't map " + path);
+        }
+        data = static_cast<char*>(address);
+#endif
+    }
+
+    ~Mapping() {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        munmap(data, size);
+#endif
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+    char* data;
+    size_t size;
+};
+
+OutputsReplayer::OutputsReplayer(const std::string& path, std::chrono::microseconds latency):
+        mapping(new Mapping(path)), latency(latency) {
+    Reader reader(mapping->data, mapping->size);
+    if (0 != std::memcmp(reader.take(sizeof(magic)), magic, sizeof(magic))) {
+        throw std::runtime_error(path + " isn't a file of recorded outputs");
+    }
+    inputDims = readDims(reader);
+
+    std::map<size_t, std::map<int64_t, InferenceEngine::BlobMap>> records;
+    while (!reader.atEnd()) {
+        const size_t stream = static_cast<size_t>(reader.read<uint64_t>());
+        const int64_t frame = reader.read<int64_t>();
+        InferenceEngine::BlobMap& outputs = records[stream][frame];
+        const uint32_t blobsCount = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < blobsCount; i++) {
+            const uint32_t nameLength = reader.read<uint32_t>();
+            const std::string name(reader.take(nameLength), nameLength);
+            const InferenceEngine::SizeVector dims = readDims(reader);
+            reader.align();
+            const InferenceEngine::TensorDesc desc(InferenceEngine::Precision::FP32, dims,
+                                                   InferenceEngine::TensorDesc::getLayoutByDims(dims));
+            const size_t elementsCount = std::accumulate(dims.begin(), dims.end(), size_t{1}, std::multiplies<size_t>());
+            // the data is aligned to 8 bytes from the start of the mapping, which is page aligned
+            float* data = reinterpret_cast<float*>(const_cast<char*>(reader.take(elementsCount * sizeof(float))));
+            outputs[name] = InferenceEngine::make_shared_blob<float>(desc, data, elementsCount);
+        }
+        if (outputNames.empty()) {
+            for (const auto& output : outputs) {
+                outputNames.push_back(output.first);
+            }
+        }
+    }
+    if (records.empty()) {
+        throw std::runtime_error("No outputs were recorded in " + path);
+    }
+
+    for (auto& record : records) {
+        streams.push_back({record.first, {}, 0});
+        for (auto& frame : record.second) {
+            streams.back().frames.emplace_back(frame.first, std::move(frame.second));
+        }
+    }
+}
+
+OutputsReplayer::~OutputsReplayer() = default;
+
+const InferenceEngine::SizeVector& OutputsReplayer::getInputDims() const {
+    return inputDims;
+}
+
+const std::vector<std::string>& OutputsReplayer::getOutputNames() const {
+    return outputNames;
+}
+
+std::chrono::microseconds OutputsReplayer::getLatency() const {
+    return latency;
+}
+
+InferenceEngine::BlobMap OutputsReplayer::getOutputs(size_t stream, int64_t frame) {
+    auto streamIt = std::lower_bound(streams.begin(), streams.end(), stream,
+        [](const Stream& recorded, size_t id) { return recorded.id < id; });
+    Stream& recorded = streams.end() != streamIt && stream == streamIt->id ? *streamIt : streams[stream % streams.size()];
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t position;
+    if (frame < 0) {
+        position = recorded.next % recorded.frames.size();
+    } else {
+        auto frameIt = std::lower_bound(recorded.frames.begin(), recorded.frames.end(), frame,
+            [](const std::pair<int64_t, InferenceEngine::BlobMap>& recordedFrame, int64_t index) {
+                return recordedFrame.first < index;
+            });
+        position = recorded.frames.end() != frameIt && frame == frameIt->first
+            ? static_cast<size_t>(frameIt - recorded.frames.begin())
+            : static_cast<size_t>(frame) % recorded.frames.size();
+    }
+    recorded.next = position + 1;
+    return recorded.frames[position].second;
+}
+
+InferenceEngine::SizeVector getInputDims(const InferenceEngine::ExecutableNetwork& network) {
+    const InferenceEngine::ConstInputsDataMap inputs = network.GetInputsInfo();
+    if (inputs.empty()) {
+        throw std::invalid_argument("The network has no inputs");
+    }
+    return inputs.begin()->second->getTensorDesc().getDims();
+}
+
+InferenceEngine::BlobMap getOutputs(InferenceEngine::InferRequest& request, const InferenceEngine::ExecutableNetwork& network) {
+    InferenceEngine::BlobMap outputs;
+    for (const auto& output : network.GetOutputsInfo()) {
+        outputs[output.first] = request.GetBlob(output.first);
+    }
+    return outputs;
+}
+
+void setOutputs(InferenceEngine::InferRequest& request, const InferenceEngine::BlobMap& outputs) {
+    for (const auto& output : outputs) {
+        request.SetBlob(output.first, output.second);
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <inference_engine.hpp>
+
+///
+/// \brief Writes the outputs of inference requests to a file for OutputsReplayer.
+///
+/// A record holds the FP32 output blobs of one request and is keyed by the stream and
+/// the frame the request was made for. The file starts with the input dimensions of the
+/// network, so a replay doesn't need the model. All methods are thread-safe.
+///
+class OutputsRecorder {
+public:
+    explicit OutputsRecorder(const std::string& path);
+
+    ///
+    /// \brief Writes the input dimensions of the network. Must be called before write(),
+    /// later calls only check that the dimensions are the same.
+    ///
+    void setInputDims(const InferenceEngine::SizeVector& dims);
+
+    ///
+    /// \brief Appends the outputs of a request.
+    /// \param frame Index of the frame in the stream, negative if it is unknown. Frames
+    /// with unknown indices are numbered in the order they are written.
+    ///
+    void write(size_t stream, int64_t frame, const InferenceEngine::BlobMap& outputs);
+
+private:
+    void writeBytes(const void* data, size_t size);
+    void align();
+
+    std::mutex mutex;
+    std::ofstream file;
+    uint64_t offset = 0;
+    InferenceEngine::SizeVector inputDims;
+    std::map<size_t, int64_t> nextFrames;
+};
+
+///
+/// \brief Serves the outputs written by OutputsRecorder instead of running inference.
+///
+/// The file is memory-mapped and the blobs point to the mapping, so serving outputs
+/// copies nothing and records of any number of streams don't take memory until they
+/// are read. The mapping is private, so the blobs may be written to. The blobs are
+/// valid while the replayer exists. All methods are thread-safe.
+///
+class OutputsReplayer {
+public:
+    ///
+    /// \param latency Time a request takes, the time between starting a request and
+    /// getting its outputs.
+    ///
+    OutputsReplayer(const std::string& path, std::chrono::microseconds latency);
+    ~OutputsReplayer();
+
+    const InferenceEngine::SizeVector& getInputDims() const;
+
+    ///
+    /// \brief Returns the sorted names of the outputs of the first record.
+    ///
+    const std::vector<std::string>& getOutputNames() const;
+
+    std::chrono::microseconds getLatency() const;
+
+    ///
+    /// \brief Returns the outputs recorded for the frame of the stream.
+    /// A stream which wasn't recorded replays the recorded stream number stream % count,
+    /// and a frame which wasn't recorded replays the frame number frame % count of the
+    /// stream, so a short recording of a few streams can be replayed for many streams
+    /// indefinitely. A negative frame takes the frame after the one returned before.
+    ///
+    InferenceEngine::BlobMap getOutputs(size_t stream, int64_t frame);
+
+private:
+    struct Mapping;
+    struct Stream {
+        size_t id;
+        std::vector<std::pair<int64_t, InferenceEngine::BlobMap>> frames;  // sorted by frame
+        size_t next;  // position of the frame replayed for a negative frame
+    };
+
+    std::unique_ptr<Mapping> mapping;
+    std::chrono::microseconds latency;
+    InferenceEngine::SizeVector inputDims;
+    std::vector<std::string> outputNames;
+    std::mutex mutex;
+    std::vector<Stream> streams;  // sorted by id
+};
+
+///
+/// \brief Returns the dimensions of the first input of the network, which OutputsRecorder::setInputDims()
+/// takes for the network and OutputsReplayer::getInputDims() is checked against.
+///
+InferenceEngine::SizeVector getInputDims(const InferenceEngine::ExecutableNetwork& network);
+
+///
+/// \brief Returns the output blobs of the request.
+///
+InferenceEngine::BlobMap getOutputs(InferenceEngine::InferRequest& request, const InferenceEngine::ExecutableNetwork& network);
+
+///
+/// \brief Sets the replayed blobs as the outputs of the request, so postprocessing which reads
+/// the outputs of the request gets them without copying, as if the request was inferred.
+///
+void setOutputs(InferenceEngine::InferRequest& request, const InferenceEngine::BlobMap& outputs);
@@ -0,0 +1,38 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+///
+/// \brief Minimal checks for the unit tests of the common demo libraries.
+///
+/// A failed CHECK() prints the condition and its location and lets the test continue,
+/// main() returns tests::result() to report the failures to CTest.
+///
+#define CHECK(condition) tests::check(condition, #condition, __FILE__, __LINE__)
+
+namespace tests {
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        std::cerr << file << ":" << line << ": " << expression << " failed" << std::endl;
+        failures()++;
+    }
+}
+
+inline int result() {
+    if (0 != failures()) {
+        std::cerr << failures() << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+}  // namespace tests
@@ -0,0 +1,252 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "tracing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace tracing {
+
+namespace detail {
+
+struct Event {
+    const char* name;  // nullptr for marks
+    int channel;
+    int64_t frameIdx;
+    int64_t begin;  // ns since the origin
+    int64_t end;
+};
+
+// Events are appended by the owning thread or track only. A reader sees the events
+// published by the release stores of size and next.
+struct Chunk {
+    static constexpr size_t capacity = 4096;
+    std::array<Event, capacity> events;
+    std::atomic<size_t> size{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+std::atomic<bool> enabled{false};
+
+struct Buffer {
+    int tid;
+    std::string name;  // guarded by registryMutex
+    Chunk head;
+    Chunk* tail = &head;  // accessed by the writer only
+
+    ~Buffer() {
+        Chunk* chunk = head.next.load(std::memory_order_acquire);
+        while (chunk) {
+            Chunk* next = chunk->next.load(std::memory_order_acquire);
+            delete chunk;
+            chunk = next;
+        }
+    }
+};
+
+}  // namespace detail
+
+namespace {
+
+using detail::Buffer;
+using detail::Chunk;
+using detail::Event;
+
+std::mutex registryMutex;
+// Buffers are kept after their threads exit, so a trace can be saved at the end
+std::vector<std::unique_ptr<Buffer>> registry;
+std::atomic<Clock::rep> origin{0};
+
+Buffer& registerBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock{registryMutex};
+    registry.emplace_back(new Buffer);
+    registry.back()->tid = static_cast<int>(registry.size());
+    registry.back()->name = name;
+    return *registry.back();
+}
+
+Buffer& threadBuffer() {
+    thread_local Buffer* buffer = nullptr;
+    if (!buffer) {
+        buffer = &registerBuffer("");
+    }
+    return *buffer;
+}
+
+int64_t sinceOrigin(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        t - Clock::time_point(Clock::duration(origin.load(std::memory_order_relaxed)))).count();
+}
+
+void record(Buffer& buffer, const Event& event) {
+    Chunk* chunk = buffer.tail;
+    size_t size = chunk->size.load(std::memory_order_relaxed);
+    if (Chunk::capacity == size) {
+        Chunk* next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        buffer.tail = chunk = next;
+        size = 0;
+    }
+    chunk->events[size] = event;
+    chunk->size.store(size + 1, std::memory_order_release);
+}
+
+std::string escape(const std::string& str) {
+    std::string escaped;
+    for (char c : str) {
+        if ('"' == c || '\\' == c) {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeTimestamp(std::ostream& out, int64_t ns) {
+    // microseconds with nanosecond precision
+    if (ns < 0) {
+        out << '-';
+        ns = -ns;
+    }
+    out << ns / 1000 << '.' << static_cast<char>('0' + ns / 100 % 10)
+        << static_cast<char>('0' + ns / 10 % 10) << static_cast<char>('0' + ns % 10);
+}
+
+}  // namespace
+
+void enable() {
+    Clock::rep expected = 0;
+    origin.compare_exchange_strong(expected, Clock::now().time_since_epoch().count());
+    detail::enabled.store(true, std::memory_order_release);
+}
+
+void save(const std::string& fileName) {
+    detail::enabled.store(false, std::memory_order_relaxed);
+
+    std::ofstream out(fileName);
+    if (!out) {
+        throw std::runtime_error("Can't open " + fileName + " to save the trace");
+    }
+
+    struct FlowPoint {
+        int channel;
+        int64_t frameIdx;
+        int64_t time;
+        int tid;
+    };
+    std::vector<FlowPoint> flowPoints;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"demo\"}}";
+    std::lock_guard<std::mutex> lock{registryMutex};
+    for (const auto& buffer : registry) {
+        if (!buffer->name.empty()) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"" << escape(buffer->name) << "\"}}";
+        }
+        for (const Chunk* chunk = &buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const size_t size = chunk->size.load(std::memory_order_acquire);
+            for (size_t i = 0; i < size; i++) {
+                const Event& event = chunk->events[i];
+                if (event.frameIdx >= 0) {
+                    flowPoints.push_back({event.channel, event.frameIdx, event.begin, buffer->tid});
+                }
+                if (!event.name) {
+                    continue;
+                }
+                out << ",\n{\"name\":\"" << escape(event.name) << "\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                    << buffer->tid << ",\"ts\":";
+                writeTimestamp(out, event.begin);
+                out << ",\"dur\":";
+                writeTimestamp(out, event.end - event.begin);
+                if (event.channel >= 0 || event.frameIdx >= 0) {
+                    out << ",\"args\":{\"channel\":" << event.channel << ",\"frame\":" << event.frameIdx << '}';
+                }
+                out << '}';
+            }
+        }
+    }
+
+    // Every frame gets a flow going through its events in time order
+    std::sort(flowPoints.begin(), flowPoints.end(), [](const FlowPoint& lhs, const FlowPoint& rhs) {
+        return std::tie(lhs.channel, lhs.frameIdx, lhs.time) < std::tie(rhs.channel, rhs.frameIdx, rhs.time);
+    });
+    int flowId = 0;
+    for (size_t begin = 0, end = 0; begin < flowPoints.size(); begin = end) {
+        while (end < flowPoints.size() && flowPoints[end].channel == flowPoints[begin].channel
+                && flowPoints[end].frameIdx == flowPoints[begin].frameIdx) {
+            end++;
+        }
+        if (end - begin < 2) {
+            continue;
+        }
+        flowId++;
+        for (size_t i = begin; i < end; i++) {
+            const char* phase = begin == i ? "s" : end - 1 == i ? "f" : "t";
+            out << ",\n{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"" << phase << "\",\"id\":" << flowId
+                << ",\"pid\":1,\"tid\":" << flowPoints[i].tid << ",\"ts\":";
+            writeTimestamp(out, flowPoints[i].time);
+            if (begin != i) {
+                out << ",\"bp\":\"e\"";
+            }
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        throw std::runtime_error("Can't write the trace to " + fileName);
+    }
+}
+
+void setThreadName(const std::string& name) {
+    if (isEnabled()) {
+        Buffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock{registryMutex};
+        buffer.name = name;
+    }
+}
+
+void complete(const char* name, Clock::time_point begin, Clock::time_point end, int channel, int64_t frameIdx) {
+    if (isEnabled()) {
+        record(threadBuffer(), {name, channel, frameIdx, sinceOrigin(begin), sinceOrigin(end)});
+    }
+}
+
+void mark(int channel, int64_t frameIdx) {
+    if (isEnabled()) {
+        const int64_t now = sinceOrigin(Clock::now());
+        record(threadBuffer(), {nullptr, channel, frameIdx, now, now});
+    }
+}
+
+void Track::complete(const char* name, Clock::time_point begin, Clock::time_point end, int channel, int64_t frameIdx) {
+    if (isEnabled()) {
+        record(buffer(), {name, channel, frameIdx, sinceOrigin(begin), sinceOrigin(end)});
+    }
+}
+
+void Track::mark(int channel, int64_t frameIdx, Clock::time_point time) {
+    if (isEnabled()) {
+        const int64_t timeSinceOrigin = sinceOrigin(time);
+        record(buffer(), {nullptr, channel, frameIdx, timeSinceOrigin, timeSinceOrigin});
+    }
+}
+
+detail::Buffer& Track::buffer() {
+    if (!trackBuffer) {
+        trackBuffer = &registerBuffer(name);
+    }
+    return *trackBuffer;
+}
+
+}  // namespace tracing
@@ -0,0 +1,135 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+///
+/// \brief Pipeline tracing
+///
+/// Threads record time intervals of pipeline stages to their own buffers
+/// without locks. Intervals may carry a channel and a frame index. All
+/// intervals and marks of the same frame of the same channel are connected
+/// by flow arrows in the exported trace. The trace is saved in the Chrome
+/// trace event JSON format, which chrome://tracing and ui.perfetto.dev
+/// open. Until tracing is enabled, recording costs a single relaxed atomic
+/// load. Event names are stored as pointers, so they must be string
+/// literals or outlive the tracing.
+///
+namespace tracing {
+
+using Clock = std::chrono::steady_clock;
+
+namespace detail {
+extern std::atomic<bool> enabled;
+struct Buffer;
+}  // namespace detail
+
+inline bool isEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+///
+/// \brief Starts recording events.
+///
+void enable();
+
+///
+/// \brief Stops recording and writes all recorded events to the file.
+/// \param fileName Path of the JSON file.
+///
+void save(const std::string& fileName);
+
+///
+/// \brief Names the calling thread in the trace. Threads which are named
+/// before tracing is enabled stay unnamed.
+///
+void setThreadName(const std::string& name);
+
+///
+/// \brief Records an interval which was measured by the caller, for example
+/// an asynchronous inference which is started and finished on different threads.
+/// \param name Stage name.
+/// \param begin Interval begin.
+/// \param end Interval end.
+/// \param channel Channel index or -1.
+/// \param frameIdx Frame index in the channel or -1.
+///
+void complete(const char* name, Clock::time_point begin, Clock::time_point end,
+              int channel = -1, int64_t frameIdx = -1);
+
+///
+/// \brief Adds the frame to the flow of its channel at the current time
+/// without an interval of its own. The flow arrow is attached to the
+/// interval which encloses the mark on the calling thread, which allows to
+/// connect frames processed together, for example in a batch, with it.
+///
+void mark(int channel, int64_t frameIdx);
+
+///
+/// \brief A timeline of its own for intervals which are not bound to a
+/// thread, for example inferences of an InferRequest. Intervals of a track
+/// must not overlap and must be recorded by one thread at a time.
+///
+class Track {
+public:
+    explicit Track(std::string name): name(std::move(name)) {}
+    Track(Track&&) = default;
+    Track& operator=(Track&&) = default;
+    Track(const Track&) = delete;
+    Track& operator=(const Track&) = delete;
+
+    ///
+    /// \brief Records an interval on the track, see tracing::complete().
+    ///
+    void complete(const char* name, Clock::time_point begin, Clock::time_point end,
+                  int channel = -1, int64_t frameIdx = -1);
+
+    ///
+    /// \brief Adds the frame to the flow of its channel at the given time,
+    /// see tracing::mark().
+    ///
+    void mark(int channel, int64_t frameIdx, Clock::time_point time);
+
+private:
+    detail::Buffer& buffer();
+
+    std::string name;
+    detail::Buffer* trackBuffer = nullptr;  // registered on the first record
+};
+
+///
+/// \brief Records the lifetime of the object as an interval.
+///
+class Scope {
+public:
+    explicit Scope(const char* name, int channel = -1, int64_t frameIdx = -1):
+        name(name), channel(channel), frameIdx(frameIdx) {
+        if (isEnabled()) {
+            begin = Clock::now();
+        }
+    }
+
+    ~Scope() {
+        if (Clock::time_point() != begin) {
+            complete(name, begin, Clock::now(), channel, frameIdx);
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+    int channel;
+    int64_t frameIdx;
+    Clock::time_point begin;
+};
+
+}  // namespace tracing
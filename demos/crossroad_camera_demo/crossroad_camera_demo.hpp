@@ -33,6 +33,8 @@ static const char custom_cpu_library_message[] = "Optional. For MKLDNN (CPU)-tar
                                                  "Absolute path to a shared library with the kernels impl.";
 static const char threshold_output_message[] = "Optional. Probability threshold for person/vehicle/bike crossroad detections.";
 static const char threshold_output_message_person_reid[] = "Optional. Cosine similarity threshold between two vectors for person reidentification.";
+static const char reid_capacity_message[] = "Optional. Maximum number of persons kept for reidentification. "
+                                            "When it is reached, the person who was not seen for the longest time is forgotten.";
 static const char raw_output_message[] = "Optional. Output Inference results as raw values.";
 static const char no_show_processed_video[] = "Optional. No show processed video.";
 static const char input_resizable_message[] = "Optional. Enables resizable input with support of ROI crop & auto resize.";
@@ -55,6 +57,7 @@ DEFINE_string(l, "", custom_cpu_library_message);
 DEFINE_bool(r, false, raw_output_message);
 DEFINE_double(t, 0.5, threshold_output_message);
 DEFINE_double(t_reid, 0.7, threshold_output_message_person_reid);
+DEFINE_uint32(reid_capacity, 1000, reid_capacity_message);
 DEFINE_bool(no_show, false, no_show_processed_video);
 DEFINE_bool(auto_resize, false, input_resizable_message);
 
@@ -86,6 +89,7 @@ static void showUsage() {
     std::cout << "    -r                           " << raw_output_message << std::endl;
     std::cout << "    -t                           " << threshold_output_message << std::endl;
     std::cout << "    -t_reid                      " << threshold_output_message_person_reid << std::endl;
+    std::cout << "    -reid_capacity               " << reid_capacity_message << std::endl;
     std::cout << "    -no_show                     " << no_show_processed_video << std::endl;
     std::cout << "    -auto_resize                 " << input_resizable_message << std::endl;
     std::cout << "    -u                           " << utilization_monitors_message << std::endl;
@@ -0,0 +1,82 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <opencv2/core/core.hpp>
+
+namespace dominant_color {
+constexpr int colorShift = 5;  // 8 levels per channel
+constexpr int colorLevels = 256 >> colorShift;
+constexpr int colorBins = colorLevels * colorLevels * colorLevels;
+
+struct ColorHistogram {
+    std::array<uint32_t, colorBins> counts;
+    std::array<cv::Vec<uint32_t, 3>, colorBins> sums;  // sums of pixel colors in bins
+};
+
+// Returns the number of pixels in the 3x3x3 neighbourhood of the bin, adds their colors to sum if it is given
+inline uint32_t NeighbourhoodCount(const ColorHistogram& histogram, int bin, cv::Vec<uint32_t, 3>* sum) {
+    const int b = bin / (colorLevels * colorLevels);
+    const int g = bin / colorLevels % colorLevels;
+    const int r = bin % colorLevels;
+    uint32_t count = 0;
+    for (int nb = std::max(b - 1, 0); nb <= std::min(b + 1, colorLevels - 1); ++nb) {
+        for (int ng = std::max(g - 1, 0); ng <= std::min(g + 1, colorLevels - 1); ++ng) {
+            for (int nr = std::max(r - 1, 0); nr <= std::min(r + 1, colorLevels - 1); ++nr) {
+                const int neighbour = (nb * colorLevels + ng) * colorLevels + nr;
+                count += histogram.counts[neighbour];
+                if (sum) {
+                    *sum += histogram.sums[neighbour];
+                }
+            }
+        }
+    }
+    return count;
+}
+}  // namespace dominant_color
+
+// Returns the dominant color of a CV_8UC3 image. Pixels are counted in a histogram with 8 levels per
+// channel, the bin having the most pixels in its 3x3x3 neighbourhood wins and the mean color of the
+// neighbourhood pixels is returned. The neighbourhood keeps a color split by a bin border together.
+inline cv::Vec3b GetDominantColor(const cv::Mat& image) {
+    using namespace dominant_color;
+    ColorHistogram histogram{};
+    for (int y = 0; y < image.rows; ++y) {
+        const uchar* pixel = image.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; ++x, pixel += 3) {
+            const int bin = ((pixel[0] >> colorShift) * colorLevels + (pixel[1] >> colorShift)) * colorLevels
+                + (pixel[2] >> colorShift);
+            ++histogram.counts[bin];
+            histogram.sums[bin][0] += pixel[0];
+            histogram.sums[bin][1] += pixel[1];
+            histogram.sums[bin][2] += pixel[2];
+        }
+    }
+
+    int bestBin = -1;
+    uint32_t bestCount = 0;
+    for (int bin = 0; bin < colorBins; ++bin) {
+        if (0 != histogram.counts[bin]) {
+            const uint32_t count = NeighbourhoodCount(histogram, bin, nullptr);
+            if (count > bestCount) {
+                bestCount = count;
+                bestBin = bin;
+            }
+        }
+    }
+    if (bestBin < 0) {
+        return cv::Vec3b{};
+    }
+
+    cv::Vec<uint32_t, 3> sum;
+    NeighbourhoodCount(histogram, bestBin, &sum);
+    return cv::Vec3b{static_cast<uchar>((sum[0] + bestCount / 2) / bestCount),
+                     static_cast<uchar>((sum[1] + bestCount / 2) / bestCount),
+                     static_cast<uchar>((sum[2] + bestCount / 2) / bestCount)};
+}
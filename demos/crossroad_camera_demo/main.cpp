@@ -8,6 +8,7 @@
 * \example crossroad_camera_demo/main.cpp
 */
 #include <gflags/gflags.h>
+#include <array>
 #include <functional>
 #include <iostream>
 #include <fstream>
@@ -27,6 +28,8 @@
 #include <samples/slog.hpp>
 #include <samples/ocv_common.hpp>
 #include "crossroad_camera_demo.hpp"
+#include "dominant_color.hpp"
+#include "person_gallery.hpp"
 
 using namespace InferenceEngine;
 
@@ -50,6 +53,10 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
         throw std::logic_error("Parameter -m is not set");
     }
 
+    if (FLAGS_reid_capacity == 0) {
+        throw std::logic_error("Parameter -reid_capacity must be positive");
+    }
+
     return true;
 }
 
@@ -265,29 +272,6 @@ struct PersonAttribsDetection : BaseDetection {
         cv::Vec3b bottom_color;
     };
 
-    static cv::Vec3b GetAvgColor(const cv::Mat& image) {
-        int clusterCount = 5;
-        cv::Mat labels;
-        cv::Mat centers;
-        cv::Mat image32f;
-        image.convertTo(image32f, CV_32F);
-        image32f = image32f.reshape(1, image32f.rows*image32f.cols);
-        clusterCount = std::min(clusterCount, image32f.rows);
-        cv::kmeans(image32f, clusterCount, labels, cv::TermCriteria(cv::TermCriteria::EPS+cv::TermCriteria::MAX_ITER, 10, 1.0),
-                    10, cv::KMEANS_RANDOM_CENTERS, centers);
-        centers.convertTo(centers, CV_8U);
-        centers = centers.reshape(0, clusterCount);
-        std::vector<int> freq(clusterCount);
-
-        for (int i = 0; i < labels.rows * labels.cols; ++i) {
-            freq[labels.at<int>(i)]++;
-        }
-
-        auto freqArgmax = std::max_element(freq.begin(), freq.end()) - freq.begin();
-
-        return centers.at<cv::Vec3b>(freqArgmax);
-    }
-
     AttributesAndColorPoints GetPersonAttributes() {
         static const char *const attributeStrings[] = {
                 "is male", "has_bag", "has_backpack" , "has hat", "has longsleeves", "has longpants", "has longhair", "has coat_jacket"
@@ -381,61 +365,75 @@ struct PersonAttribsDetection : BaseDetection {
 };
 
 struct PersonReIdentification : BaseDetection {
-    std::vector<std::vector<float>> globalReIdVec;  // contains vectors characterising all detected persons
+    PersonGallery gallery{FLAGS_reid_capacity, static_cast<float>(FLAGS_t_reid)};
 
-    PersonReIdentification() : BaseDetection(FLAGS_m_reid, "Person Reidentification Retail") {}
+    std::vector<InferRequest> requests;  // one request per person of a frame
 
-    unsigned long int findMatchingPerson(const std::vector<float> &newReIdVec) {
-        auto size = globalReIdVec.size();
+    PersonReIdentification() : BaseDetection(FLAGS_m_reid, "Person Reidentification Retail") {}
 
-        /* assigned REID is index of the matched vector from the globalReIdVec */
-        for (size_t i = 0; i < size; ++i) {
-            float cosSim = cosineSimilarity(newReIdVec, globalReIdVec[i]);
-            if (FLAGS_r) {
-                std::cout << "cosineSimilarity: " << cosSim << std::endl;
-            }
-            if (cosSim > FLAGS_t_reid) {
-                /* We substitute previous person's vector by a new one characterising
-                 * last person's position */
-                globalReIdVec[i] = newReIdVec;
-                return i;
-            }
+    InferRequest& getRequest(size_t idx) {
+        while (requests.size() <= idx) {
+            requests.push_back(net.CreateInferRequest());
         }
-        globalReIdVec.push_back(newReIdVec);
-        return size;
+        if (!request) {
+            request = requests.front();  // used for performance counts
+        }
+        return requests[idx];
     }
 
-    std::vector<float> getReidVec() {
-        Blob::Ptr attribsBlob = request.GetBlob(outputName);
+    void setPersonRoiBlob(size_t idx, const Blob::Ptr &roiBlob) {
+        getRequest(idx).SetBlob(inputName, roiBlob);
+    }
 
-        auto numOfChannels = attribsBlob->getTensorDesc().getDims().at(1);
-        LockedMemory<const void> attribsBlobMapped = as<MemoryBlob>(attribsBlob)->rmap();
-        auto outputValues = attribsBlobMapped.as<float*>();
-        return std::vector<float>(outputValues, outputValues + numOfChannels);
+    void enqueuePerson(size_t idx, const cv::Mat &person) {
+        matU8ToBlob<uint8_t>(person, getRequest(idx).GetBlob(inputName));
+    }
+
+    void submitRequests(size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            requests[i].StartAsync();
+        }
     }
 
-    template <typename T>
-    float cosineSimilarity(const std::vector<T> &vecA, const std::vector<T> &vecB) {
-        if (vecA.size() != vecB.size()) {
-            throw std::logic_error("cosine similarity can't be called for the vectors of different lengths: "
-                                   "vecA size = " + std::to_string(vecA.size()) +
-                                   "vecB size = " + std::to_string(vecB.size()));
+    void waitRequests(size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            requests[i].Wait(IInferRequest::WaitMode::RESULT_READY);
         }
+    }
+
+    /* Returns reid vectors of the first count requests as L2-normalized rows of a matrix */
+    cv::Mat getReidVecs(size_t count) {
+        cv::Mat reidVecs;
+        for (size_t i = 0; i < count; ++i) {
+            Blob::Ptr attribsBlob = requests[i].GetBlob(outputName);
+
+            auto numOfChannels = static_cast<int>(attribsBlob->getTensorDesc().getDims().at(1));
+            if (reidVecs.empty()) {
+                reidVecs.create(static_cast<int>(count), numOfChannels, CV_32F);
+            }
+            LockedMemory<const void> attribsBlobMapped = as<MemoryBlob>(attribsBlob)->rmap();
+            cv::Mat reidVec(1, numOfChannels, CV_32F, attribsBlobMapped.as<float*>());
 
-        T mul, denomA, denomB, A, B;
-        mul = denomA = denomB = A = B = 0;
-        for (size_t i = 0; i < vecA.size(); ++i) {
-            A = vecA[i];
-            B = vecB[i];
-            mul += A * B;
-            denomA += A * A;
-            denomB += B * B;
+            double norm = cv::norm(reidVec);
+            if (norm == 0) {
+                throw std::logic_error("cosine similarity is not defined whenever one or both "
+                                       "input vectors are zero-vectors.");
+            }
+            reidVec.convertTo(reidVecs.row(static_cast<int>(i)), CV_32F, 1. / norm);
         }
-        if (denomA == 0 || denomB == 0) {
-            throw std::logic_error("cosine similarity is not defined whenever one or both "
-                                   "input vectors are zero-vectors.");
+        return reidVecs;
+    }
+
+    /* Matches every row of reidVecs with the most similar known person of the gallery */
+    std::vector<unsigned long> findMatchingPersons(const cv::Mat &reidVecs) {
+        std::vector<float> bestSimilarities;
+        std::vector<unsigned long> foundIds = gallery.findMatchingPersons(reidVecs, &bestSimilarities);
+        if (FLAGS_r) {
+            for (float similarity : bestSimilarities) {
+                std::cout << "cosineSimilarity: " << similarity << std::endl;
+            }
         }
-        return mul / (sqrt(denomA) * sqrt(denomB));
+        return foundIds;
     }
 
     CNNNetwork read(const Core& ie) override {
@@ -569,10 +567,19 @@ int main(int argc, char *argv[]) {
 
         // --------------------------- 3. Do inference ---------------------------------------------------------
         Blob::Ptr frameBlob;  // Blob to be used to keep processed frame data
-        ROI cropRoi;  // cropped image coordinates
         Blob::Ptr roiBlob;  // This blob contains data from cropped image (vehicle or license plate)
         cv::Mat person;  // Mat object containing person data cropped by openCV
 
+        // cropped image coordinates
+        auto getPersonRoi = [width, height](const cv::Rect &location) {
+            ROI cropRoi;
+            cropRoi.posX = (location.x < 0) ? 0 : location.x;
+            cropRoi.posY = (location.y < 0) ? 0 : location.y;
+            cropRoi.sizeX = std::min((size_t) location.width, width - cropRoi.posX);
+            cropRoi.sizeY = std::min((size_t) location.height, height - cropRoi.posY);
+            return cropRoi;
+        };
+
         /** Start inference & calc performance **/
         typedef std::chrono::duration<double, std::ratio<1, 1000>> ms;
         auto total_t0 = std::chrono::high_resolution_clock::now();
@@ -614,14 +621,42 @@ int main(int argc, char *argv[]) {
             // --------------------------- Process the results down to the pipeline ----------------------------
             ms personAttribsNetworkTime(0), personReIdNetworktime(0);
             int personAttribsInferred = 0,  personReIdInferred = 0;
+
+            // --------------------------- Run Person Reidentification for all persons at once -----------------
+            std::vector<unsigned long> personReIds;
+            if (personReId.enabled()) {
+                size_t personsNum = 0;
+                for (auto && result : personDetection.results) {
+                    if (result.label == 1) {  // person
+                        if (FLAGS_auto_resize) {
+                            personReId.setPersonRoiBlob(personsNum, make_shared_blob(frameBlob, getPersonRoi(result.location)));
+                        } else {
+                            personReId.enqueuePerson(personsNum, frame(result.location & cv::Rect(0, 0, width, height)));
+                        }
+                        personsNum++;
+                    }
+                }
+
+                t0 = std::chrono::high_resolution_clock::now();
+                personReId.submitRequests(personsNum);
+                personReId.waitRequests(personsNum);
+                t1 = std::chrono::high_resolution_clock::now();
+
+                personReIdNetworktime += std::chrono::duration_cast<ms>(t1 - t0);
+                personReIdInferred += static_cast<int>(personsNum);
+
+                /* Check cosine similarity with all previously detected persons.
+                   If it's new person it is added to the global Reid gallery and
+                   new global ID is assigned to the person. Otherwise, ID of
+                   matched person is assigned to it. */
+                personReIds = personReId.findMatchingPersons(personReId.getReidVecs(personsNum));
+            }
+
+            size_t personIdx = 0;
             for (auto && result : personDetection.results) {
                 if (result.label == 1) {  // person
                     if (FLAGS_auto_resize) {
-                        cropRoi.posX = (result.location.x < 0) ? 0 : result.location.x;
-                        cropRoi.posY = (result.location.y < 0) ? 0 : result.location.y;
-                        cropRoi.sizeX = std::min((size_t) result.location.width, width - cropRoi.posX);
-                        cropRoi.sizeY = std::min((size_t) result.location.height, height - cropRoi.posY);
-                        roiBlob = make_shared_blob(frameBlob, cropRoi);
+                        roiBlob = make_shared_blob(frameBlob, getPersonRoi(result.location));
                     } else {
                         // To crop ROI manually and allocate required memory (cv::Mat) again
                         auto clippedRect = result.location & cv::Rect(0, 0, width, height);
@@ -677,34 +712,13 @@ int main(int argc, char *argv[]) {
 
                         bc_rect = bc_rect & person_rect;
 
-                        resPersAttrAndColor.top_color = PersonAttribsDetection::GetAvgColor(person(tc_rect));
-                        resPersAttrAndColor.bottom_color = PersonAttribsDetection::GetAvgColor(person(bc_rect));
+                        resPersAttrAndColor.top_color = GetDominantColor(person(tc_rect));
+                        resPersAttrAndColor.bottom_color = GetDominantColor(person(bc_rect));
                     }
                     if (personReId.enabled()) {
-                        // --------------------------- Run Person Reidentification -----------------------------
-                        if (FLAGS_auto_resize) {
-                            personReId.setRoiBlob(roiBlob);
-                        } else {
-                            personReId.enqueue(person);
-                        }
-
-                        t0 = std::chrono::high_resolution_clock::now();
-                        personReId.submitRequest();
-                        personReId.wait();
-                        t1 = std::chrono::high_resolution_clock::now();
-
-                        personReIdNetworktime += std::chrono::duration_cast<ms>(t1 - t0);
-                        personReIdInferred++;
-
-                        auto reIdVector = personReId.getReidVec();
-
-                        /* Check cosine similarity with all previously detected persons.
-                           If it's new person it is added to the global Reid vector and
-                           new global ID is assigned to the person. Otherwise, ID of
-                           matched person is assigned to it. */
-                        auto foundId = personReId.findMatchingPerson(reIdVector);
-                        resPersReid = "REID: " + std::to_string(foundId);
+                        resPersReid = "REID: " + std::to_string(personReIds[personIdx]);
                     }
+                    personIdx++;
 
                     // --------------------------- Process outputs -----------------------------------------
                     if (!resPersAttrAndColor.attributes_strings.empty()) {
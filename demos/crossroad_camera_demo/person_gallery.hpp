@@ -0,0 +1,111 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+///
+/// \brief Gallery of known persons for reidentification. Their normalized reid vectors are kept as rows
+/// of a single matrix so that all persons of a frame are compared with all known persons by one matrix
+/// multiplication. The gallery holds at most capacity persons, when it is full, the person who has not
+/// been seen for the longest time is forgotten.
+///
+class PersonGallery {
+public:
+    PersonGallery(size_t capacity_, float threshold_): capacity(capacity_), threshold(threshold_) {}
+
+    ///
+    /// \brief Matches every row of reidVecs with the most similar known person. Persons of the same
+    /// frame never share an ID. Unmatched persons are added to the gallery.
+    /// \param reidVecs L2-normalized reid vectors of the persons of a frame.
+    /// \param bestSimilarities Filled with the highest similarity of every row if the gallery was not empty.
+    /// \return IDs of the persons.
+    ///
+    std::vector<unsigned long> findMatchingPersons(const cv::Mat &reidVecs,
+                                                   std::vector<float> *bestSimilarities = nullptr) {
+        ++frameIdx;
+        int count = reidVecs.rows;
+        std::vector<unsigned long> foundIds(count);
+        std::vector<bool> isMatched(count, false);
+        int size = static_cast<int>(galleryIds.size());
+        if (bestSimilarities) {
+            bestSimilarities->clear();
+        }
+
+        if (count > 0 && size > 0) {
+            cv::Mat cosSims = reidVecs * gallery.rowRange(0, size).t();
+
+            std::vector<std::pair<float, std::pair<int, int>>> candidates;
+            for (int i = 0; i < count; ++i) {
+                const float *row = cosSims.ptr<float>(i);
+                for (int j = 0; j < size; ++j) {
+                    if (row[j] > threshold) {
+                        candidates.push_back({row[j], {i, j}});
+                    }
+                }
+                if (bestSimilarities) {
+                    bestSimilarities->push_back(*std::max_element(row, row + size));
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const std::pair<float, std::pair<int, int>> &a, const std::pair<float, std::pair<int, int>> &b) {
+                          return a.first > b.first;
+                      });
+
+            std::vector<bool> isTaken(size, false);
+            for (const auto &candidate : candidates) {
+                int i = candidate.second.first;
+                int j = candidate.second.second;
+                if (isMatched[i] || isTaken[j]) {
+                    continue;
+                }
+                isMatched[i] = isTaken[j] = true;
+                /* We substitute previous person's vector by a new one characterising
+                 * last person's position */
+                reidVecs.row(i).copyTo(gallery.row(j));
+                galleryLastSeen[j] = frameIdx;
+                foundIds[i] = galleryIds[j];
+            }
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (!isMatched[i]) {
+                foundIds[i] = addPerson(reidVecs.row(i));
+            }
+        }
+        return foundIds;
+    }
+
+private:
+    unsigned long addPerson(const cv::Mat &reidVec) {
+        if (gallery.empty()) {
+            gallery.create(static_cast<int>(capacity), reidVec.cols, CV_32F);
+        }
+
+        size_t row = galleryIds.size();
+        if (row < capacity) {
+            galleryIds.push_back(nextId);
+            galleryLastSeen.push_back(frameIdx);
+        } else {
+            row = std::min_element(galleryLastSeen.begin(), galleryLastSeen.end()) - galleryLastSeen.begin();
+            galleryIds[row] = nextId;
+            galleryLastSeen[row] = frameIdx;
+        }
+        reidVec.copyTo(gallery.row(static_cast<int>(row)));
+        return nextId++;
+    }
+
+    size_t capacity;
+    float threshold;
+    cv::Mat gallery;
+    std::vector<unsigned long> galleryIds;
+    std::vector<size_t> galleryLastSeen;  // number of the frame where the person was seen last time
+    size_t frameIdx = 0;
+    unsigned long nextId = 0;
+};
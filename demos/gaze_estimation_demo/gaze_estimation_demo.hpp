@@ -47,6 +47,7 @@ static const char raw_output_message[] = "Optional. Output inference results as
 static const char fd_reshape_message[] = "Optional. Reshape Face Detector network so that its input resolution has the same aspect ratio as the input frame.";
 static const char no_show_processed_video[] = "Optional. Do not show processed video.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char cache_dir_message[] = "Optional. Existing directory to cache compiled networks in. Networks found in the cache are imported instead of being compiled. Only devices which support network export use the cache.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "cam", video_message);
@@ -67,6 +68,7 @@ DEFINE_bool(r, false, raw_output_message);
 DEFINE_double(t, 0.5, thresh_output_message);
 DEFINE_bool(no_show, false, no_show_processed_video);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_string(cache_dir, "", cache_dir_message);
 
 /**
 * \brief This function shows a help message
@@ -96,4 +98,5 @@ static void showUsage() {
     std::cout << "    -r                       " << raw_output_message << std::endl;
     std::cout << "    -t                       " << thresh_output_message << std::endl;
     std::cout << "    -u                       " << utilization_monitors_message << std::endl;
+    std::cout << "    -cache_dir \"<path>\"      " << cache_dir_message << std::endl;
 }
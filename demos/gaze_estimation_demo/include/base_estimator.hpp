@@ -4,13 +4,17 @@
 
 #pragma once
 
+#include <vector>
+
 #include "face_inference_results.hpp"
 
 namespace gaze_estimation {
 class BaseEstimator {
 public:
+    // Processes all faces found on the image at once: inputs for every face are submitted
+    // to their own infer requests before any of the results is waited for
     void virtual estimate(const cv::Mat& image,
-                          FaceInferenceResults& outputResults) = 0;
+                          std::vector<FaceInferenceResults>& outputResults) = 0;
     void virtual printPerformanceCounts() const = 0;
     virtual ~BaseEstimator() = default;
 };
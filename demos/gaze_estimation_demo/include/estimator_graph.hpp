@@ -0,0 +1,73 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base_estimator.hpp"
+#include "exponential_averager.hpp"
+#include "face_inference_results.hpp"
+
+namespace gaze_estimation {
+// Runs estimators as a dependency graph: every estimator is started as soon as
+// all the estimators it depends on have processed the faces of the current frame,
+// so independent estimators (e.g. head pose and landmarks) run concurrently.
+// Every estimator has a worker thread of its own which lives as long as the graph
+class EstimatorGraph {
+public:
+    using NodeId = size_t;
+
+    explicit EstimatorGraph(double smoothingFactor = 0.1);
+    ~EstimatorGraph();
+
+    EstimatorGraph(const EstimatorGraph&) = delete;
+    EstimatorGraph& operator=(const EstimatorGraph&) = delete;
+
+    // Dependencies must be added to the graph before the estimators that depend on them.
+    // Nodes can't be added after the first estimate()
+    NodeId addNode(const std::string& name,
+                   BaseEstimator& estimator,
+                   const std::vector<NodeId>& dependencies = {});
+
+    void estimate(const cv::Mat& image, std::vector<FaceInferenceResults>& outputResults);
+
+    void printPerformanceCounts() const;
+    // Averaged time in milliseconds each estimator spends on one frame
+    void printLatencies(std::ostream& os) const;
+
+private:
+    struct Node {
+        std::string name;
+        BaseEstimator* estimator;
+        std::vector<NodeId> dependencies;
+        ExponentialAverager latencyAverager;
+        // The last frame the node has processed, or skipped because a dependency failed
+        size_t frameDone;
+        std::exception_ptr error;
+    };
+
+    void run(NodeId id);
+    bool dependenciesDone(NodeId id) const;
+
+    double smoothingFactor;
+    std::vector<Node> nodes;
+    std::vector<std::thread> workers;
+
+    // The frame being processed, guarded by mutex together with frameDone and error of the nodes
+    const cv::Mat* image;
+    std::vector<FaceInferenceResults>* outputResults;
+    size_t frameId;
+    bool stopped;
+    std::mutex mutex;
+    std::condition_variable stateChanged;
+};
+}  // namespace gaze_estimation
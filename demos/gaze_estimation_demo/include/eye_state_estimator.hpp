@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "base_estimator.hpp"
 
@@ -15,10 +16,10 @@
 namespace gaze_estimation {
 class EyeStateEstimator: public BaseEstimator {
 public:
-    EyeStateEstimator(InferenceEngine::Core& ie,
+    EyeStateEstimator(const ModelLoader& loader,
                       const std::string& modelPath,
                       const std::string& deviceName);
-    void virtual estimate(const cv::Mat& image, FaceInferenceResults& outputResults);
+    void virtual estimate(const cv::Mat& image, std::vector<FaceInferenceResults>& outputResults);
     void virtual printPerformanceCounts() const;
     virtual ~EyeStateEstimator();
 
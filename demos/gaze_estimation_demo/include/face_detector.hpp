@@ -17,7 +17,7 @@
 namespace gaze_estimation {
 class FaceDetector {
 public:
-    FaceDetector(InferenceEngine::Core& ie,
+    FaceDetector(const ModelLoader& loader,
                  const std::string& modelPath,
                  const std::string& deviceName,
                  double detectionConfidenceThreshold,
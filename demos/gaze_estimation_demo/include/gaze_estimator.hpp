@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -15,12 +16,12 @@
 namespace gaze_estimation {
 class GazeEstimator: public BaseEstimator {
 public:
-    GazeEstimator(InferenceEngine::Core& ie,
+    GazeEstimator(const ModelLoader& loader,
                   const std::string& modelPath,
                   const std::string& deviceName,
                   bool doRollAlign = true);
     void virtual estimate(const cv::Mat& image,
-                          FaceInferenceResults& outputResults);
+                          std::vector<FaceInferenceResults>& outputResults);
     void virtual printPerformanceCounts() const;
     virtual ~GazeEstimator();
 
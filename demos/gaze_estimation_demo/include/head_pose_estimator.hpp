@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -15,11 +16,11 @@
 namespace gaze_estimation {
 class HeadPoseEstimator: public BaseEstimator {
 public:
-    HeadPoseEstimator(InferenceEngine::Core& ie,
+    HeadPoseEstimator(const ModelLoader& loader,
                       const std::string& modelPath,
                       const std::string& deviceName);
     void virtual estimate(const cv::Mat& image,
-                          FaceInferenceResults& outputResults);
+                          std::vector<FaceInferenceResults>& outputResults);
     void virtual printPerformanceCounts() const;
     virtual ~HeadPoseEstimator();
 
@@ -18,20 +18,24 @@
 #include <samples/ocv_common.hpp>
 #include <samples/slog.hpp>
 #include <samples/common.hpp>
+#include <model_loader/model_loader.hpp>
 
 namespace gaze_estimation {
 class IEWrapper {
 public:
-    IEWrapper(InferenceEngine::Core& ie,
+    IEWrapper(const ModelLoader& loader,
               const std::string& modelPath,
               const std::string& deviceName);
     // For setting input blobs containing images
-    void setInputBlob(const std::string& blobName, const cv::Mat& image);
+    void setInputBlob(const std::string& blobName, const cv::Mat& image, size_t requestIdx = 0);
     // For setting input blobs containing vectors of data
-    void setInputBlob(const std::string& blobName, const std::vector<float>& data);
+    void setInputBlob(const std::string& blobName, const std::vector<float>& data, size_t requestIdx = 0);
 
     // Get output blob content as a vector given its name
-    void getOutputBlob(const std::string& blobName, std::vector<float>& output);
+    void getOutputBlob(const std::string& blobName, std::vector<float>& output, size_t requestIdx = 0);
+    // Get read-only access to output blob content without copying it.
+    // The returned object keeps the blob mapped, use as<const float*>() to read it
+    InferenceEngine::LockedMemory<const void> mapOutputBlob(const std::string& blobName, size_t requestIdx = 0);
 
     void printPerlayerPerformance() const;
 
@@ -47,13 +51,22 @@ public:
 
     void infer();
 
+    // Makes sure there are at least requestsNum infer requests, so that several inputs
+    // (e.g. all faces of a frame) could be processed concurrently. Starts a new inference:
+    // performance counts are reported for the first requestsNum requests only
+    void reserveRequests(size_t requestsNum);
+    void startAsync(size_t requestIdx);
+    void wait(size_t requestIdx);
+
 private:
     std::string modelPath;
     std::string deviceName;
-    InferenceEngine::Core& ie;
+    ModelLoader loader;
     InferenceEngine::CNNNetwork network;
     InferenceEngine::ExecutableNetwork executableNetwork;
-    InferenceEngine::InferRequest request;
+    std::vector<InferenceEngine::InferRequest> requests;
+    // Number of requests used by the last inference, the other ones keep the counters of older inferences
+    size_t usedRequestsNum = 0;
     std::map<std::string, std::vector<unsigned long>> inputBlobsDimsInfo;
     std::map<std::string, std::vector<unsigned long>> outputBlobsDimsInfo;
 
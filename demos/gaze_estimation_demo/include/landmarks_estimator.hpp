@@ -6,6 +6,7 @@
 
 #include <cstdio>
 #include <string>
+#include <vector>
 
 #include "face_inference_results.hpp"
 #include "base_estimator.hpp"
@@ -15,11 +16,11 @@
 namespace gaze_estimation {
 class LandmarksEstimator: public BaseEstimator {
 public:
-    LandmarksEstimator(InferenceEngine::Core& ie,
+    LandmarksEstimator(const ModelLoader& loader,
                        const std::string& modelPath,
                        const std::string& deviceName);
     void virtual estimate(const cv::Mat& image,
-                          FaceInferenceResults& outputResults);
+                          std::vector<FaceInferenceResults>& outputResults);
     void virtual printPerformanceCounts() const;
     virtual ~LandmarksEstimator();
 
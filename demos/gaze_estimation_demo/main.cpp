@@ -27,6 +27,7 @@
 
 #include <inference_engine.hpp>
 
+#include <model_loader/model_loader.hpp>
 #include <monitors/presenter.h>
 #include <samples/ocv_common.hpp>
 #include <samples/slog.hpp>
@@ -42,6 +43,7 @@
 #include "landmarks_estimator.hpp"
 #include "eye_state_estimator.hpp"
 #include "gaze_estimator.hpp"
+#include "estimator_graph.hpp"
 
 #include "results_marker.hpp"
 
@@ -135,20 +137,32 @@ int main(int argc, char *argv[]) {
         }
 
         // Set up face detector and estimators
-        FaceDetector faceDetector(ie, FLAGS_m_fd, FLAGS_d_fd, FLAGS_t, FLAGS_fd_reshape);
-
-        HeadPoseEstimator headPoseEstimator(ie, FLAGS_m_hp, FLAGS_d_hp);
-        LandmarksEstimator landmarksEstimator(ie, FLAGS_m_lm, FLAGS_d_lm);
-        EyeStateEstimator eyeStateEstimator(ie, FLAGS_m_es, FLAGS_d_es);
-        GazeEstimator gazeEstimator(ie, FLAGS_m, FLAGS_d);
-
-        // Put pointers to all estimators in an array so that they could be processed uniformly in a loop
-        BaseEstimator* estimators[] = {&headPoseEstimator, &landmarksEstimator, &eyeStateEstimator, &gazeEstimator};
-        // Each element of the vector contains inference results on one face
-        std::vector<FaceInferenceResults> inferenceResults;
+        ModelLoader loader(ie, FLAGS_cache_dir);
+        std::unique_ptr<FaceDetector> faceDetector;
+        std::unique_ptr<HeadPoseEstimator> headPoseEstimator;
+        std::unique_ptr<LandmarksEstimator> landmarksEstimator;
+        std::unique_ptr<EyeStateEstimator> eyeStateEstimator;
+        std::unique_ptr<GazeEstimator> gazeEstimator;
+        loader.run({
+            [&]() { faceDetector.reset(new FaceDetector(loader, FLAGS_m_fd, FLAGS_d_fd, FLAGS_t, FLAGS_fd_reshape)); },
+            [&]() { headPoseEstimator.reset(new HeadPoseEstimator(loader, FLAGS_m_hp, FLAGS_d_hp)); },
+            [&]() { landmarksEstimator.reset(new LandmarksEstimator(loader, FLAGS_m_lm, FLAGS_d_lm)); },
+            [&]() { eyeStateEstimator.reset(new EyeStateEstimator(loader, FLAGS_m_es, FLAGS_d_es)); },
+            [&]() { gazeEstimator.reset(new GazeEstimator(loader, FLAGS_m, FLAGS_d)); }
+        });
+        loader.printReport();
 
         // Exponential averagers for times
         double smoothingFactor = 0.1;
+
+        // Head pose and landmarks need only the face crop and run concurrently,
+        // eye state needs both of them, gaze needs head pose and eye state
+        EstimatorGraph estimatorGraph(smoothingFactor);
+        auto headPoseNode = estimatorGraph.addNode("head pose", *headPoseEstimator);
+        auto landmarksNode = estimatorGraph.addNode("landmarks", *landmarksEstimator);
+        auto eyeStateNode = estimatorGraph.addNode("eye state", *eyeStateEstimator, {headPoseNode, landmarksNode});
+        estimatorGraph.addNode("gaze", *gazeEstimator, {headPoseNode, eyeStateNode});
+
         ExponentialAverager overallTimeAverager(smoothingFactor, 30.);
         ExponentialAverager inferenceTimeAverager(smoothingFactor, 30.);
 
@@ -164,12 +178,9 @@ int main(int argc, char *argv[]) {
 
             // Infer results
             auto tInferenceBegins = cv::getTickCount();
-            auto inferenceResults = faceDetector.detect(frame);
-            for (auto& inferenceResult : inferenceResults) {
-                for (auto estimator : estimators) {
-                    estimator->estimate(frame, inferenceResult);
-                }
-            }
+            // Each element of the vector contains inference results on one face
+            auto inferenceResults = faceDetector->detect(frame);
+            estimatorGraph.estimate(frame, inferenceResults);
             auto tInferenceEnds = cv::getTickCount();
 
             // Measure FPS
@@ -182,10 +193,8 @@ int main(int argc, char *argv[]) {
             inferenceTimeAverager.updateValue(inferenceTime);
 
             if (FLAGS_pc) {
-                faceDetector.printPerformanceCounts();
-                for (auto const estimator : estimators) {
-                    estimator->printPerformanceCounts();
-                }
+                faceDetector->printPerformanceCounts();
+                estimatorGraph.printPerformanceCounts();
             }
 
             if (FLAGS_r) {
@@ -221,6 +230,8 @@ int main(int argc, char *argv[]) {
                 presenter.handleKey(key);
         } while (cap.read(frame));
         std::cout << presenter.reportMeans() << '\n';
+        estimatorGraph.printLatencies(std::cout);
+        std::cout << '\n';
     }
     catch (const std::exception& error) {
         slog::err << error.what() << slog::endl;
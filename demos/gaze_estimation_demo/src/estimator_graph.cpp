@@ -0,0 +1,142 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "estimator_graph.hpp"
+
+namespace gaze_estimation {
+EstimatorGraph::EstimatorGraph(double smoothingFactor):
+    smoothingFactor(smoothingFactor), image(nullptr), outputResults(nullptr), frameId(0), stopped(false) {
+}
+
+EstimatorGraph::~EstimatorGraph() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    stateChanged.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+EstimatorGraph::NodeId EstimatorGraph::addNode(const std::string& name,
+                                               BaseEstimator& estimator,
+                                               const std::vector<NodeId>& dependencies) {
+    if (!workers.empty()) {
+        throw std::logic_error("Estimator \"" + name + "\" is added to the graph after it has started");
+    }
+    for (auto dependency : dependencies) {
+        if (dependency >= nodes.size()) {
+            throw std::logic_error("Estimator \"" + name + "\" depends on an estimator which is not in the graph");
+        }
+    }
+    nodes.push_back({name, &estimator, dependencies, ExponentialAverager(smoothingFactor, 0.), 0, nullptr});
+    return nodes.size() - 1;
+}
+
+bool EstimatorGraph::dependenciesDone(NodeId id) const {
+    for (auto dependency : nodes[id].dependencies) {
+        if (nodes[dependency].frameDone != frameId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EstimatorGraph::run(NodeId id) {
+    Node& node = nodes[id];
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        stateChanged.wait(lock, [this, id, &node] {
+            return stopped || (node.frameDone != frameId && dependenciesDone(id));
+        });
+        if (stopped) {
+            return;
+        }
+
+        bool dependencyFailed = false;
+        for (auto dependency : node.dependencies) {
+            dependencyFailed = dependencyFailed || nodes[dependency].error;
+        }
+        size_t frame = frameId;
+        lock.unlock();
+
+        // Estimators write disjoint fields of FaceInferenceResults, and a node reads only
+        // the fields written by its dependencies, so the nodes need no further synchronization
+        std::exception_ptr error;
+        if (!dependencyFailed) {
+            try {
+                auto tBegins = std::chrono::steady_clock::now();
+                node.estimator->estimate(*image, *outputResults);
+                auto tEnds = std::chrono::steady_clock::now();
+
+                node.latencyAverager.updateValue(
+                    std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(tEnds - tBegins).count());
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        node.error = error;
+        node.frameDone = frame;
+        stateChanged.notify_all();
+    }
+}
+
+void EstimatorGraph::estimate(const cv::Mat& image, std::vector<FaceInferenceResults>& outputResults) {
+    if (outputResults.empty()) {
+        return;
+    }
+
+    if (workers.empty()) {
+        for (NodeId id = 0; id < nodes.size(); ++id) {
+            workers.emplace_back(&EstimatorGraph::run, this, id);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    this->image = &image;
+    this->outputResults = &outputResults;
+    ++frameId;
+    stateChanged.notify_all();
+
+    // Wait for every node, including the ones nothing depends on
+    stateChanged.wait(lock, [this] {
+        for (const auto& node : nodes) {
+            if (node.frameDone != frameId) {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    // Dependencies precede the nodes depending on them, so the first error is the one which failed the frame
+    for (const auto& node : nodes) {
+        if (node.error) {
+            std::rethrow_exception(node.error);
+        }
+    }
+}
+
+void EstimatorGraph::printPerformanceCounts() const {
+    for (const auto& node : nodes) {
+        node.estimator->printPerformanceCounts();
+    }
+}
+
+void EstimatorGraph::printLatencies(std::ostream& os) const {
+    os << "Estimators latency per frame (ms):";
+    for (const auto& node : nodes) {
+        os << ' ' << node.name << ' ' << std::fixed << std::setprecision(1)
+           << node.latencyAverager.getAveragedValue() << ';';
+    }
+}
+}  // namespace gaze_estimation
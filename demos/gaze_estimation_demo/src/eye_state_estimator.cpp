@@ -9,10 +9,10 @@
 
 namespace gaze_estimation {
 
-EyeStateEstimator::EyeStateEstimator(InferenceEngine::Core& ie,
+EyeStateEstimator::EyeStateEstimator(const ModelLoader& loader,
                                      const std::string& modelPath,
                                      const std::string& deviceName):
-                                     ieWrapper(ie, modelPath, deviceName) {
+                                     ieWrapper(loader, modelPath, deviceName) {
     inputBlobName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputBlobName);
     outputBlobName = ieWrapper.expectSingleOutput();
@@ -49,42 +49,48 @@ void EyeStateEstimator::rotateImageAroundCenter(const cv::Mat& srcImage,
     cv::warpAffine(srcImage, dstImage, rotMatrix, size, 1, cv::BORDER_REPLICATE);
 }
 
-void EyeStateEstimator::estimate(const cv::Mat& image, FaceInferenceResults& outputResults) {
-    auto roll = outputResults.headPoseAngles.z;
-
-    auto leftEyeBoundingBox = createEyeBoundingBox(outputResults.faceLandmarks[0],
-        outputResults.faceLandmarks[1]);
-    auto rightEyeBoundingBox = createEyeBoundingBox(outputResults.faceLandmarks[2],
-        outputResults.faceLandmarks[3]);
-    auto leftEyeImage(cv::Mat(image, leftEyeBoundingBox));
-    auto rightEyeImage(cv::Mat(image, rightEyeBoundingBox));
-
-    cv::Mat leftEyeImageRotated, rightEyeImageRotated;
-    rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
-    rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
-    leftEyeImage = leftEyeImageRotated;
-    rightEyeImage = rightEyeImageRotated;
-
-    outputResults.leftEyeBoundingBox = leftEyeBoundingBox;
-    outputResults.rightEyeBoundingBox = rightEyeBoundingBox;
-
-    auto leftEyeMidpoint = (outputResults.faceLandmarks[0] + outputResults.faceLandmarks[1]) / 2;
-    auto rightEyeMidpoint = (outputResults.faceLandmarks[2] + outputResults.faceLandmarks[3]) / 2;
-
-    outputResults.leftEyeMidpoint = leftEyeMidpoint;
-    outputResults.rightEyeMidpoint = rightEyeMidpoint;
-
-    std::vector<float> outputValue;
-    ieWrapper.setInputBlob(inputBlobName, leftEyeImage);
-    ieWrapper.infer();
-    ieWrapper.getOutputBlob(outputBlobName, outputValue);
-    outputResults.leftEyeState = outputValue[0] < outputValue[1];
-
-    outputValue.clear();
-    ieWrapper.setInputBlob(inputBlobName, rightEyeImage);
-    ieWrapper.infer();
-    ieWrapper.getOutputBlob(outputBlobName, outputValue);
-    outputResults.rightEyeState = outputValue[0] < outputValue[1];  
+void EyeStateEstimator::estimate(const cv::Mat& image, std::vector<FaceInferenceResults>& outputResults) {
+    // Two requests per face: the left eye goes to the even one, the right eye to the odd one
+    ieWrapper.reserveRequests(2 * outputResults.size());
+
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto& faceResults = outputResults[i];
+        auto roll = faceResults.headPoseAngles.z;
+
+        auto leftEyeBoundingBox = createEyeBoundingBox(faceResults.faceLandmarks[0],
+            faceResults.faceLandmarks[1]);
+        auto rightEyeBoundingBox = createEyeBoundingBox(faceResults.faceLandmarks[2],
+            faceResults.faceLandmarks[3]);
+        auto leftEyeImage(cv::Mat(image, leftEyeBoundingBox));
+        auto rightEyeImage(cv::Mat(image, rightEyeBoundingBox));
+
+        cv::Mat leftEyeImageRotated, rightEyeImageRotated;
+        rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
+        rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
+
+        faceResults.leftEyeBoundingBox = leftEyeBoundingBox;
+        faceResults.rightEyeBoundingBox = rightEyeBoundingBox;
+
+        faceResults.leftEyeMidpoint = (faceResults.faceLandmarks[0] + faceResults.faceLandmarks[1]) / 2;
+        faceResults.rightEyeMidpoint = (faceResults.faceLandmarks[2] + faceResults.faceLandmarks[3]) / 2;
+
+        ieWrapper.setInputBlob(inputBlobName, leftEyeImageRotated, 2 * i);
+        ieWrapper.startAsync(2 * i);
+        ieWrapper.setInputBlob(inputBlobName, rightEyeImageRotated, 2 * i + 1);
+        ieWrapper.startAsync(2 * i + 1);
+    }
+
+    auto isOpen = [this](size_t requestIdx) {
+        ieWrapper.wait(requestIdx);
+        auto outputMapped = ieWrapper.mapOutputBlob(outputBlobName, requestIdx);
+        auto outputValue = outputMapped.as<const float*>();
+        return outputValue[0] < outputValue[1];
+    };
+
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        outputResults[i].leftEyeState = isOpen(2 * i);
+        outputResults[i].rightEyeState = isOpen(2 * i + 1);
+    }
 }
 
 void EyeStateEstimator::printPerformanceCounts() const {
@@ -11,12 +11,12 @@
 #include "face_detector.hpp"
 
 namespace gaze_estimation {
-FaceDetector::FaceDetector(InferenceEngine::Core& ie,
+FaceDetector::FaceDetector(const ModelLoader& loader,
                            const std::string& modelPath,
                            const std::string& deviceName,
                            double detectionConfidenceThreshold,
                            bool enableReshape):
-             ieWrapper(ie, modelPath, deviceName),
+             ieWrapper(loader, modelPath, deviceName),
              detectionThreshold(detectionConfidenceThreshold),
              enableReshape(enableReshape) {
     const auto& inputInfo = ieWrapper.getInputBlobDimsInfo();
@@ -14,11 +14,11 @@ const char BLOB_HEAD_POSE_ANGLES[] = "head_pose_angles";
 const char BLOB_LEFT_EYE_IMAGE[] = "left_eye_image";
 const char BLOB_RIGHT_EYE_IMAGE[] = "right_eye_image";
 
-GazeEstimator::GazeEstimator(InferenceEngine::Core& ie,
+GazeEstimator::GazeEstimator(const ModelLoader& loader,
                              const std::string& modelPath,
                              const std::string& deviceName,
                              bool doRollAlign):
-               ieWrapper(ie, modelPath, deviceName), rollAlign(doRollAlign) {
+               ieWrapper(loader, modelPath, deviceName), rollAlign(doRollAlign) {
     const auto& inputInfo = ieWrapper.getInputBlobDimsInfo();
 
     for (const auto& blobName: {BLOB_HEAD_POSE_ANGLES, BLOB_LEFT_EYE_IMAGE, BLOB_RIGHT_EYE_IMAGE}) {
@@ -62,57 +62,75 @@ void GazeEstimator::rotateImageAroundCenter(const cv::Mat& srcImage,
 }
 
 void GazeEstimator::estimate(const cv::Mat& image,
-                             FaceInferenceResults& outputResults) {
-    if (!outputResults.leftEyeState && !outputResults.rightEyeState)
-        return;
+                             std::vector<FaceInferenceResults>& outputResults) {
+    ieWrapper.reserveRequests(outputResults.size());
+
+    auto isSkipped = [](const FaceInferenceResults& faceResults) {
+        return !faceResults.leftEyeState && !faceResults.rightEyeState;
+    };
+
     std::vector<float> headPoseAngles(3);
-    auto roll = outputResults.headPoseAngles.z;
-    headPoseAngles[0] = outputResults.headPoseAngles.x;
-    headPoseAngles[1] = outputResults.headPoseAngles.y;
-    headPoseAngles[2] = roll;
-
-    cv::Mat leftEyeImage(image, outputResults.leftEyeBoundingBox);
-    cv::Mat rightEyeImage(image, outputResults.rightEyeBoundingBox);
-
-    if (rollAlign) {
-        headPoseAngles[2] = 0;
-        cv::Mat leftEyeImageRotated, rightEyeImageRotated;
-        rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
-        rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
-        leftEyeImage = leftEyeImageRotated;
-        rightEyeImage = rightEyeImageRotated;
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        const auto& faceResults = outputResults[i];
+        if (isSkipped(faceResults))
+            continue;
+
+        auto roll = faceResults.headPoseAngles.z;
+        headPoseAngles[0] = faceResults.headPoseAngles.x;
+        headPoseAngles[1] = faceResults.headPoseAngles.y;
+        headPoseAngles[2] = roll;
+
+        cv::Mat leftEyeImage(image, faceResults.leftEyeBoundingBox);
+        cv::Mat rightEyeImage(image, faceResults.rightEyeBoundingBox);
+
+        if (rollAlign) {
+            headPoseAngles[2] = 0;
+            cv::Mat leftEyeImageRotated, rightEyeImageRotated;
+            rotateImageAroundCenter(leftEyeImage, leftEyeImageRotated, roll);
+            rotateImageAroundCenter(rightEyeImage, rightEyeImageRotated, roll);
+            leftEyeImage = leftEyeImageRotated;
+            rightEyeImage = rightEyeImageRotated;
+        }
+
+        ieWrapper.setInputBlob(BLOB_HEAD_POSE_ANGLES, headPoseAngles, i);
+        ieWrapper.setInputBlob(BLOB_LEFT_EYE_IMAGE, leftEyeImage, i);
+        ieWrapper.setInputBlob(BLOB_RIGHT_EYE_IMAGE, rightEyeImage, i);
+
+        ieWrapper.startAsync(i);
     }
 
-    ieWrapper.setInputBlob(BLOB_HEAD_POSE_ANGLES, headPoseAngles);
-    ieWrapper.setInputBlob(BLOB_LEFT_EYE_IMAGE, leftEyeImage);
-    ieWrapper.setInputBlob(BLOB_RIGHT_EYE_IMAGE, rightEyeImage);
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto& faceResults = outputResults[i];
+        if (isSkipped(faceResults))
+            continue;
 
-    ieWrapper.infer();
+        ieWrapper.wait(i);
 
-    std::vector<float> rawResults;
+        auto outputMapped = ieWrapper.mapOutputBlob(outputBlobName, i);
+        auto rawResults = outputMapped.as<const float*>();
 
-    ieWrapper.getOutputBlob(outputBlobName, rawResults);
+        cv::Point3f gazeVector;
+        gazeVector.x = rawResults[0];
+        gazeVector.y = rawResults[1];
+        gazeVector.z = rawResults[2];
 
-    cv::Point3f gazeVector;
-    gazeVector.x = rawResults[0];
-    gazeVector.y = rawResults[1];
-    gazeVector.z = rawResults[2];
+        gazeVector = gazeVector / cv::norm(gazeVector);
 
-    gazeVector = gazeVector / cv::norm(gazeVector);
+        if (rollAlign) {
+            // rotate gaze vector to compensate for the alignment
+            auto roll = faceResults.headPoseAngles.z;
+            float cs = static_cast<float>(std::cos(static_cast<double>(roll) * CV_PI / 180.0));
+            float sn = static_cast<float>(std::sin(static_cast<double>(roll) * CV_PI / 180.0));
 
-    if (rollAlign) {
-        // rotate gaze vector to compensate for the alignment
-        float cs = static_cast<float>(std::cos(static_cast<double>(roll) * CV_PI / 180.0));
-        float sn = static_cast<float>(std::sin(static_cast<double>(roll) * CV_PI / 180.0));
+            auto tmpX = gazeVector.x * cs + gazeVector.y * sn;
+            auto tmpY = -gazeVector.x * sn + gazeVector.y * cs;
 
-        auto tmpX = gazeVector.x * cs + gazeVector.y * sn;
-        auto tmpY = -gazeVector.x * sn + gazeVector.y * cs;
+            gazeVector.x = tmpX;
+            gazeVector.y = tmpY;
+        }
 
-        gazeVector.x = tmpX;
-        gazeVector.y = tmpY;
+        faceResults.gazeVector = gazeVector;
     }
-
-    outputResults.gazeVector = gazeVector;
 }
 
 void GazeEstimator::printPerformanceCounts() const {
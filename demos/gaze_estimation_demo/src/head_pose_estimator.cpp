@@ -15,10 +15,10 @@ const std::pair<const char*, float cv::Point3f::*> OUTPUTS[] = {
     {"angle_r_fc", &cv::Point3f::z},
 };
 
-HeadPoseEstimator::HeadPoseEstimator(InferenceEngine::Core& ie,
+HeadPoseEstimator::HeadPoseEstimator(const ModelLoader& loader,
                                      const std::string& modelPath,
                                      const std::string& deviceName):
-                   ieWrapper(ie, modelPath, deviceName) {
+                   ieWrapper(loader, modelPath, deviceName) {
     inputBlobName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputBlobName);
 
@@ -40,18 +40,23 @@ HeadPoseEstimator::HeadPoseEstimator(InferenceEngine::Core& ie,
 }
 
 void HeadPoseEstimator::estimate(const cv::Mat& image,
-                                 FaceInferenceResults& outputResults) {
-    auto faceBoundingBox = outputResults.faceBoundingBox;
-    auto faceCrop(cv::Mat(image, faceBoundingBox));
+                                 std::vector<FaceInferenceResults>& outputResults) {
+    ieWrapper.reserveRequests(outputResults.size());
 
-    ieWrapper.setInputBlob(inputBlobName, faceCrop);
-    ieWrapper.infer();
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto faceCrop(cv::Mat(image, outputResults[i].faceBoundingBox));
 
-    std::vector<float> outputValue;
+        ieWrapper.setInputBlob(inputBlobName, faceCrop, i);
+        ieWrapper.startAsync(i);
+    }
+
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        ieWrapper.wait(i);
 
-    for (const auto &output: OUTPUTS) {
-        ieWrapper.getOutputBlob(output.first, outputValue);
-        outputResults.headPoseAngles.*output.second = outputValue[0];
+        for (const auto &output: OUTPUTS) {
+            auto outputMapped = ieWrapper.mapOutputBlob(output.first, i);
+            outputResults[i].headPoseAngles.*output.second = outputMapped.as<const float*>()[0];
+        }
     }
 }
 
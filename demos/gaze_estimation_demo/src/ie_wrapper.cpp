@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -12,11 +13,11 @@ using namespace InferenceEngine;
 
 namespace gaze_estimation {
 
-IEWrapper::IEWrapper(InferenceEngine::Core& ie,
+IEWrapper::IEWrapper(const ModelLoader& loader,
                      const std::string& modelPath,
                      const std::string& deviceName):
-           modelPath(modelPath), deviceName(deviceName), ie(ie) {
-    network = ie.ReadNetwork(modelPath);
+           modelPath(modelPath), deviceName(deviceName), loader(loader) {
+    network = loader.readNetwork(modelPath);
     setExecPart();
 }
 
@@ -54,12 +55,23 @@ void IEWrapper::setExecPart() {
         layerData->setPrecision(Precision::FP32);
     }
 
-    executableNetwork = ie.LoadNetwork(network, deviceName);
-    request = executableNetwork.CreateInferRequest();
+    executableNetwork = loader.loadNetwork(network, modelPath, deviceName);
+    size_t requestsNum = std::max<size_t>(requests.size(), 1);
+    requests.clear();
+    reserveRequests(requestsNum);
+    usedRequestsNum = 0;
+}
+
+void IEWrapper::reserveRequests(size_t requestsNum) {
+    while (requests.size() < requestsNum) {
+        requests.push_back(executableNetwork.CreateInferRequest());
+    }
+    usedRequestsNum = requestsNum;
 }
 
 void IEWrapper::setInputBlob(const std::string& blobName,
-                             const cv::Mat& image) {
+                             const cv::Mat& image,
+                             size_t requestIdx) {
     auto blobDims = inputBlobsDimsInfo[blobName];
 
     if (blobDims.size() != 4) {
@@ -70,12 +82,13 @@ void IEWrapper::setInputBlob(const std::string& blobName,
     cv::Mat resizedImage;
     cv::resize(image, resizedImage, scaledSize, 0, 0, cv::INTER_CUBIC);
 
-    auto inputBlob = request.GetBlob(blobName);
+    auto inputBlob = requests.at(requestIdx).GetBlob(blobName);
     matU8ToBlob<uint8_t>(resizedImage, inputBlob);
 }
 
 void IEWrapper::setInputBlob(const std::string& blobName,
-                             const std::vector<float>& data) {
+                             const std::vector<float>& data,
+                             size_t requestIdx) {
     auto blobDims = inputBlobsDimsInfo[blobName];
     unsigned long dimsProduct = 1;
     for (auto const& dim : blobDims) {
@@ -84,28 +97,26 @@ void IEWrapper::setInputBlob(const std::string& blobName,
     if (dimsProduct != data.size()) {
         throw std::runtime_error("Input data does not match size of the blob");
     }
-    LockedMemory<void> blobMapped = as<MemoryBlob>(request.GetBlob(blobName))->wmap();
-    auto buffer = blobMapped.as<float *>();
-    for (unsigned long int i = 0; i < data.size(); ++i) {
-        buffer[i] = data[i];
-    }
+    LockedMemory<void> blobMapped = as<MemoryBlob>(requests.at(requestIdx).GetBlob(blobName))->wmap();
+    std::copy(data.begin(), data.end(), blobMapped.as<float *>());
 }
 
 void IEWrapper::getOutputBlob(const std::string& blobName,
-                              std::vector<float> &output) {
-    output.clear();
+                              std::vector<float> &output,
+                              size_t requestIdx) {
     auto blobDims = outputBlobsDimsInfo[blobName];
-    auto dataSize = 1;
+    size_t dataSize = 1;
     for (auto dim : blobDims) {
         dataSize *= dim;
     }
-    
-    LockedMemory<const void> blobMapped = as<MemoryBlob>(request.GetBlob(blobName))->rmap();
-    auto buffer = blobMapped.as<float *>();
 
-    for (int i = 0; i < dataSize; ++i) {
-        output.push_back(buffer[i]);
-    }
+    LockedMemory<const void> blobMapped = mapOutputBlob(blobName, requestIdx);
+    auto buffer = blobMapped.as<const float *>();
+    output.assign(buffer, buffer + dataSize);
+}
+
+LockedMemory<const void> IEWrapper::mapOutputBlob(const std::string& blobName, size_t requestIdx) {
+    return as<MemoryBlob>(requests.at(requestIdx).GetBlob(blobName))->rmap();
 }
 
 const std::map<std::string, std::vector<unsigned long>>& IEWrapper::getInputBlobDimsInfo() const {
@@ -140,7 +151,16 @@ void IEWrapper::expectImageInput(const std::string& blobName) const {
 }
 
 void IEWrapper::infer() {
-    request.Infer();
+    requests.front().Infer();
+    usedRequestsNum = 1;
+}
+
+void IEWrapper::startAsync(size_t requestIdx) {
+    requests.at(requestIdx).StartAsync();
+}
+
+void IEWrapper::wait(size_t requestIdx) {
+    requests.at(requestIdx).Wait(IInferRequest::WaitMode::RESULT_READY);
 }
 
 void IEWrapper::reshape(const std::map<std::string, std::vector<unsigned long> > &newBlobsDimsInfo) {
@@ -163,7 +183,23 @@ void IEWrapper::reshape(const std::map<std::string, std::vector<unsigned long> >
 void IEWrapper::printPerlayerPerformance() const {
     std::cout << "\n-----------------START-----------------" << std::endl;
     std::cout << "Performance for " << modelPath << " model\n" << std::endl;
-    printPerformanceCounts(request, std::cout, getFullDeviceName(ie, deviceName), false);
+    // Faces of a frame are inferred by requests of their own, so the counters of the requests
+    // of the last inference add up
+    std::map<std::string, InferenceEngineProfileInfo> performanceMap;
+    for (size_t requestIdx = 0; requestIdx < usedRequestsNum; ++requestIdx) {
+        for (const auto& layer : requests[requestIdx].GetPerformanceCounts()) {
+            auto inserted = performanceMap.insert(layer);
+            if (!inserted.second) {
+                InferenceEngineProfileInfo& total = inserted.first->second;
+                total.realTime_uSec += layer.second.realTime_uSec;
+                total.cpu_uSec += layer.second.cpu_uSec;
+                if (layer.second.status == InferenceEngineProfileInfo::EXECUTED) {
+                    total.status = InferenceEngineProfileInfo::EXECUTED;
+                }
+            }
+        }
+    }
+    printPerformanceCounts(performanceMap, std::cout, getFullDeviceName(loader.getCore(), deviceName), false);
     std::cout << "------------------END------------------\n" << std::endl;
 }
 }  // namespace gaze_estimation
@@ -8,10 +8,10 @@
 #include "landmarks_estimator.hpp"
 
 namespace gaze_estimation {
-LandmarksEstimator::LandmarksEstimator(InferenceEngine::Core& ie,
+LandmarksEstimator::LandmarksEstimator(const ModelLoader& loader,
                                        const std::string& modelPath,
                                        const std::string& deviceName):
-                    ieWrapper(ie, modelPath, deviceName) {
+                    ieWrapper(loader, modelPath, deviceName) {
     inputBlobName = ieWrapper.expectSingleInput();
     ieWrapper.expectImageInput(inputBlobName);
 
@@ -30,20 +30,34 @@ LandmarksEstimator::LandmarksEstimator(InferenceEngine::Core& ie,
 }
 
 void LandmarksEstimator::estimate(const cv::Mat& image,
-                                  FaceInferenceResults& outputResults) {
-    auto faceBoundingBox = outputResults.faceBoundingBox;
-    auto faceCrop(cv::Mat(image, faceBoundingBox));
+                                  std::vector<FaceInferenceResults>& outputResults) {
+    ieWrapper.reserveRequests(outputResults.size());
 
-    ieWrapper.setInputBlob(inputBlobName, faceCrop);
-    ieWrapper.infer();
-    std::vector<float> rawLandmarks;
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        auto faceCrop(cv::Mat(image, outputResults[i].faceBoundingBox));
 
-    ieWrapper.getOutputBlob(outputBlobName, rawLandmarks);
+        ieWrapper.setInputBlob(inputBlobName, faceCrop, i);
+        ieWrapper.startAsync(i);
+    }
+
+    const auto& outputBlobDims = ieWrapper.getOutputBlobDimsInfo().at(outputBlobName);
+    unsigned long numLandmarks = outputBlobDims.back() / 2;
+
+    for (size_t i = 0; i < outputResults.size(); ++i) {
+        ieWrapper.wait(i);
+
+        auto faceBoundingBox = outputResults[i].faceBoundingBox;
+        auto outputMapped = ieWrapper.mapOutputBlob(outputBlobName, i);
+        auto rawLandmarks = outputMapped.as<const float*>();
 
-    for (unsigned long i = 0; i < rawLandmarks.size() / 2; ++i) {
-        int x = static_cast<int>(rawLandmarks[2 * i] * faceCrop.cols + faceBoundingBox.tl().x);
-        int y = static_cast<int>(rawLandmarks[2 * i + 1] * faceCrop.rows + faceBoundingBox.tl().y);
-        outputResults.faceLandmarks.push_back(cv::Point2i(x, y));
+        auto& faceLandmarks = outputResults[i].faceLandmarks;
+        faceLandmarks.clear();
+        faceLandmarks.reserve(numLandmarks);
+        for (unsigned long j = 0; j < numLandmarks; ++j) {
+            int x = static_cast<int>(rawLandmarks[2 * j] * faceBoundingBox.width + faceBoundingBox.tl().x);
+            int y = static_cast<int>(rawLandmarks[2 * j + 1] * faceBoundingBox.height + faceBoundingBox.tl().y);
+            faceLandmarks.push_back(cv::Point2i(x, y));
+        }
     }
 }
 
@@ -19,6 +19,11 @@ static const char no_show_processed_video[] = "Optional. Do not show processed v
 static const char black_background[] = "Optional. Show black background.";
 static const char raw_output_message[] = "Optional. Output inference results as raw values.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char num_infer_requests_message[] = "Optional. Number of infer requests, the depth of the pipeline in the async mode. "
+                                                 "Default value is 2.";
+static const char network_cache_message[] = "Optional. Memory budget in MB of the networks compiled for different input widths. "
+                                             "The least recently used networks are released when it is exceeded. "
+                                             "Default value is 1024.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "cam", video_message);
@@ -29,6 +34,8 @@ DEFINE_bool(no_show, false, no_show_processed_video);
 DEFINE_bool(black, false, black_background);
 DEFINE_bool(r, false, raw_output_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_uint32(nireq, 2, num_infer_requests_message);
+DEFINE_uint32(net_cache_mb, 1024, network_cache_message);
 
 /**
 * @brief This function shows a help message
@@ -47,4 +54,6 @@ static void showUsage() {
     std::cout << "    -black                     " << black_background << std::endl;
     std::cout << "    -r                         " << raw_output_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"         " << num_infer_requests_message << std::endl;
+    std::cout << "    -net_cache_mb \"<integer>\"  " << network_cache_message << std::endl;
 }
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <inference_engine.hpp>
+#include <model_loader/model_loader.hpp>
+#include <model_loader/network_cache.hpp>
 #include <opencv2/core/core.hpp>
+#include <pipeline/async_pipeline.hpp>
 
 #include "human_pose.hpp"
 
@@ -19,19 +23,27 @@ public:
 
     HumanPoseEstimator(const std::string& modelPath,
                        const std::string& targetDeviceName,
-                       bool enablePerformanceReport = false);
-    std::vector<HumanPose> postprocessCurr();
+                       bool enablePerformanceReport = false,
+                       size_t inferRequestsCount = 2,
+                       size_t networkCacheBudget = 1024 * 1024 * 1024);
+    /** Fits the network to the size of the image, all submitted images must be popped before */
     void reshape(const cv::Mat& image);
-    void frameToBlobCurr(const cv::Mat& image);
-    void frameToBlobNext(const cv::Mat& image);
-    void startCurr();
-    void startNext();
-    bool readyCurr();
-    void swapRequest();
+    /** Size of the image the network is fitted to */
+    cv::Size getImageSize() const;
+    /** Starts inference of the image, waits for a free infer request if all of them are busy */
+    void submit(const cv::Mat& image);
+    /** Number of submitted images whose poses weren't popped yet */
+    size_t pending();
+    size_t getInferRequestsCount() const;
+    /** Waits for the poses of the earliest submitted image, returns false if there are no submitted images */
+    bool pop(cv::Mat& image, std::vector<HumanPose>& poses);
+    /** Prints the hit rate and the compile time of the networks compiled for different input widths */
+    void printNetworkCacheReport() const;
     ~HumanPoseEstimator();
 
 private:
     void preprocess(const cv::Mat& image, uint8_t* buffer) const;
+    void createPipeline();
     std::vector<HumanPose> postprocess(
             const float* heatMapsData, const int heatMapOffset, const int nHeatMaps,
             const float* pafsData, const int pafOffset, const int nPafs,
@@ -56,15 +68,18 @@ private:
     cv::Size inputLayerSize;
     cv::Size imageSize;
     int upsampleRatio;
+    int widthBucket;
     InferenceEngine::Core ie;
     std::string targetDeviceName;
     InferenceEngine::CNNNetwork network;
+    std::unique_ptr<NetworkCache> networkCache;
     InferenceEngine::ExecutableNetwork executableNetwork;
-    InferenceEngine::InferRequest::Ptr requestNext;
-    InferenceEngine::InferRequest::Ptr requestCurr;
+    size_t inferRequestsCount;
     std::string pafsBlobName;
     std::string heatmapsBlobName;
     bool enablePerformanceReport;
     std::string modelPath;
+    // the last member, so the postprocessing finishes before the members it uses are destroyed
+    std::unique_ptr<AsyncPipeline<cv::Mat, std::vector<HumanPose>>> pipeline;
 };
 }  // namespace human_pose_estimation
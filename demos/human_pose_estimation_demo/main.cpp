@@ -55,7 +55,8 @@ int main(int argc, char* argv[]) {
             return EXIT_SUCCESS;
         }
 
-        HumanPoseEstimator estimator(FLAGS_m, FLAGS_d, FLAGS_pc);
+        HumanPoseEstimator estimator(FLAGS_m, FLAGS_d, FLAGS_pc, FLAGS_nireq,
+                                     static_cast<size_t>(FLAGS_net_cache_mb) * 1024 * 1024);
         cv::VideoCapture cap;
         if (!(FLAGS_i == "cam" ? cap.open(0) : cap.open(FLAGS_i))) {
             throw std::logic_error("Cannot open input file or camera: " + FLAGS_i);
@@ -64,13 +65,12 @@ int main(int argc, char* argv[]) {
         int delay = 33;
 
         // read input (video) frame
-        cv::Mat curr_frame; cap >> curr_frame;
-        cv::Mat next_frame;
+        cv::Mat next_frame; cap >> next_frame;
         if (!cap.grab()) {
             throw std::logic_error("Failed to get frame from cv::VideoCapture");
         }
 
-        estimator.reshape(curr_frame);  // Do not measure network reshape, if it happened
+        estimator.reshape(next_frame);  // Do not measure network reshape, if it happened
 
         std::cout << "To close the application, press 'CTRL+C' here";
         if (!FLAGS_no_show) {
@@ -81,137 +81,110 @@ int main(int argc, char* argv[]) {
 
         cv::Size graphSize{static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH) / 4), 60};
         Presenter presenter(FLAGS_u, static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)) - graphSize.height - 10, graphSize);
+        cv::Mat curr_frame;
         std::vector<HumanPose> poses;
         bool isLastFrame = false;
         bool isAsyncMode = false; // execution is always started in SYNC mode
-        bool isModeChanged = false; // set to true when execution mode is changed (SYNC<->ASYNC)
         bool blackBackground = FLAGS_black;
 
         typedef std::chrono::duration<double, std::ratio<1, 1000>> ms;
         auto total_t0 = std::chrono::high_resolution_clock::now();
         auto wallclock = std::chrono::high_resolution_clock::now();
         double render_time = 0;
+        size_t framesCount = 0;
 
         while (true) {
             auto t0 = std::chrono::high_resolution_clock::now();
             //here is the first asynchronus point:
-            //in the async mode we capture frame to populate the NEXT infer request
-            //in the regular mode we capture frame to the current infer request
-
-            if (!cap.read(next_frame)) {
-                if (next_frame.empty()) {
-                    isLastFrame = true; //end of video file
-                } else {
-                    throw std::logic_error("Failed to get frame from cv::VideoCapture");
-                }
-            }
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    estimator.frameToBlobCurr(curr_frame);
+            //in the async mode we capture frames to populate free infer requests until nireq of them are busy
+            //in the regular mode we capture the frame for the only busy infer request
+            const size_t depth = isAsyncMode ? estimator.getInferRequestsCount() : 1;
+            while (!isLastFrame && estimator.pending() < depth) {
+                if (next_frame.size() != estimator.getImageSize()) {
+                    // the frames in flight use the current padding, so the size changes after they are shown
+                    if (estimator.pending() > 0) {
+                        break;
+                    }
+                    estimator.reshape(next_frame);
                 }
-                if (!isLastFrame) {
-                    estimator.frameToBlobNext(next_frame);
+                estimator.submit(next_frame);
+                next_frame = cv::Mat(); // the estimator keeps the submitted frame
+                if (!cap.read(next_frame)) {
+                    if (next_frame.empty()) {
+                        isLastFrame = true; //end of video file
+                    } else {
+                        throw std::logic_error("Failed to get frame from cv::VideoCapture");
+                    }
                 }
-            } else if (!isModeChanged) {
-                estimator.frameToBlobCurr(curr_frame);
             }
             auto t1 = std::chrono::high_resolution_clock::now();
             double decode_time = std::chrono::duration_cast<ms>(t1 - t0).count();
 
-            t0 = std::chrono::high_resolution_clock::now();
             // Main sync point:
-            // in the trully Async mode we start the NEXT infer request, while waiting for the CURRENT to complete
-            // in the regular mode we start the CURRENT request and immediately wait for it's completion
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    estimator.startCurr();
-                }
-                if (!isLastFrame) {
-                    estimator.startNext();
-                }
-            } else if (!isModeChanged) {
-                estimator.startCurr();
+            // we wait for the poses of the earliest submitted frame, in the regular mode it is the frame
+            // which was just submitted, so the wait measures the detection
+            if (!estimator.pop(curr_frame, poses)) {
+                break; // all frames are shown
             }
+            t1 = std::chrono::high_resolution_clock::now();
+            ms detection = std::chrono::duration_cast<ms>(t1 - t0);
+            framesCount++;
 
-            if (estimator.readyCurr()) {
-                t1 = std::chrono::high_resolution_clock::now();
-                ms detection = std::chrono::duration_cast<ms>(t1 - t0);
-                t0 = std::chrono::high_resolution_clock::now();
-                ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
-                wallclock = t0;
-
-                t0 = std::chrono::high_resolution_clock::now();
-
-                if (!FLAGS_no_show) {
-                    if (blackBackground) {
-                        curr_frame = cv::Mat::zeros(curr_frame.size(), curr_frame.type());
-                    }
-                    std::ostringstream out;
-                    out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
-                        << (decode_time + render_time) << " ms";
+            t0 = std::chrono::high_resolution_clock::now();
+            ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
+            wallclock = t0;
 
-                    cv::putText(curr_frame, out.str(), cv::Point2f(0, 25),
-                                cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+            if (!FLAGS_no_show) {
+                if (blackBackground) {
+                    curr_frame = cv::Mat::zeros(curr_frame.size(), curr_frame.type());
+                }
+                std::ostringstream out;
+                out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
+                    << (decode_time + render_time) << " ms";
+
+                cv::putText(curr_frame, out.str(), cv::Point2f(0, 25),
+                            cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+                out.str("");
+                out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
+                out << std::fixed << std::setprecision(2) << wall.count()
+                    << " ms (" << 1000.f / wall.count() << " fps)";
+                cv::putText(curr_frame, out.str(), cv::Point2f(0, 50),
+                            cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
+                if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
                     out.str("");
-                    out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
-                    out << std::fixed << std::setprecision(2) << wall.count()
-                        << " ms (" << 1000.f / wall.count() << " fps)";
-                    cv::putText(curr_frame, out.str(), cv::Point2f(0, 50),
-                                cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
-                    if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
-                        out.str("");
-                        out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
-                        << " ms ("
-                        << 1000.f / detection.count() << " fps)";
-                        cv::putText(curr_frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
-                            cv::Scalar(255, 0, 0));
-                    }
+                    out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
+                    << " ms ("
+                    << 1000.f / detection.count() << " fps)";
+                    cv::putText(curr_frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
+                        cv::Scalar(255, 0, 0));
                 }
+            }
 
-                poses = estimator.postprocessCurr();
-
-                if (FLAGS_r) {
-                    if (!poses.empty()) {
-                        std::time_t result = std::time(nullptr);
-                        char timeString[sizeof("2020-01-01 00:00:00: ")];
-                        std::strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S: ", std::localtime(&result));
-                        std::cout << timeString;
-                     }
-
-                    for (HumanPose const& pose : poses) {
-                        std::stringstream rawPose;
-                        rawPose << std::fixed << std::setprecision(0);
-                        for (auto const& keypoint : pose.keypoints) {
-                            rawPose << keypoint.x << "," << keypoint.y << " ";
-                        }
-                        rawPose << pose.score;
-                        std::cout << rawPose.str() << std::endl;
+            if (FLAGS_r) {
+                if (!poses.empty()) {
+                    std::time_t result = std::time(nullptr);
+                    char timeString[sizeof("2020-01-01 00:00:00: ")];
+                    std::strftime(timeString, sizeof(timeString), "%Y-%m-%d %H:%M:%S: ", std::localtime(&result));
+                    std::cout << timeString;
+                 }
+
+                for (HumanPose const& pose : poses) {
+                    std::stringstream rawPose;
+                    rawPose << std::fixed << std::setprecision(0);
+                    for (auto const& keypoint : pose.keypoints) {
+                        rawPose << keypoint.x << "," << keypoint.y << " ";
                     }
-                }
-
-                if (!FLAGS_no_show) {
-                    presenter.drawGraphs(curr_frame);
-                    renderHumanPose(poses, curr_frame);
-                    cv::imshow("Human Pose Estimation on " + FLAGS_d, curr_frame);
-                    t1 = std::chrono::high_resolution_clock::now();
-                    render_time = std::chrono::duration_cast<ms>(t1 - t0).count();
+                    rawPose << pose.score;
+                    std::cout << rawPose.str() << std::endl;
                 }
             }
 
-            if (isLastFrame) {
-                break;
-            }
-
-            if (isModeChanged) {
-                isModeChanged = false;
-            }
-
-            // Final point:
-            // in the truly Async mode we swap the NEXT and CURRENT requests for the next iteration
-            curr_frame = next_frame;
-            next_frame = cv::Mat();
-            if (isAsyncMode) {
-                estimator.swapRequest();
+            if (!FLAGS_no_show) {
+                presenter.drawGraphs(curr_frame);
+                renderHumanPose(poses, curr_frame);
+                cv::imshow("Human Pose Estimation on " + FLAGS_d, curr_frame);
+                t1 = std::chrono::high_resolution_clock::now();
+                render_time = std::chrono::duration_cast<ms>(t1 - t0).count();
             }
 
             const int key = cv::waitKey(delay) & 255;
@@ -221,7 +194,6 @@ int main(int argc, char* argv[]) {
                 break;
             } else if (9 == key) { // Tab
                 isAsyncMode ^= true;
-                isModeChanged = true;
             } else if (32 == key) { // Space
                 blackBackground ^= true;
             }
@@ -231,7 +203,10 @@ int main(int argc, char* argv[]) {
         auto total_t1 = std::chrono::high_resolution_clock::now();
         ms total = std::chrono::duration_cast<ms>(total_t1 - total_t0);
         std::cout << "Total Inference time: " << total.count() << std::endl;
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+                  << framesCount * 1000.0 / total.count() << " fps" << std::endl;
         std::cout << presenter.reportMeans() << '\n';
+        estimator.printNetworkCacheReport();
     }
     catch (const std::exception& error) {
         std::cerr << "[ ERROR ] " << error.what() << std::endl;
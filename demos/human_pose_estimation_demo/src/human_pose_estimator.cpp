@@ -16,7 +16,9 @@
 namespace human_pose_estimation {
 HumanPoseEstimator::HumanPoseEstimator(const std::string& modelPath,
                                        const std::string& targetDeviceName_,
-                                       bool enablePerformanceReport)
+                                       bool enablePerformanceReport,
+                                       size_t inferRequestsCount,
+                                       size_t networkCacheBudget)
     : minJointsNumber(3),
       stride(8),
       pad(cv::Vec4i::all(0)),
@@ -27,7 +29,9 @@ HumanPoseEstimator::HumanPoseEstimator(const std::string& modelPath,
       minSubsetScore(0.2f),
       inputLayerSize(-1, -1),
       upsampleRatio(4),
+      widthBucket(32),
       targetDeviceName(targetDeviceName_),
+      inferRequestsCount(inferRequestsCount),
       enablePerformanceReport(enablePerformanceReport),
       modelPath(modelPath) {
     if (enablePerformanceReport) {
@@ -93,9 +97,9 @@ HumanPoseEstimator::HumanPoseEstimator(const std::string& modelPath,
                 "to have matching last two dimensions");
     }
 
-    executableNetwork = ie.LoadNetwork(network, targetDeviceName);
-    requestNext = executableNetwork.CreateInferRequestPtr();
-    requestCurr = executableNetwork.CreateInferRequestPtr();
+    networkCache.reset(new NetworkCache(ModelLoader(ie, ""), network, modelPath, targetDeviceName, networkCacheBudget));
+    executableNetwork = networkCache->get(network.getInputShapes());
+    createPipeline();
 }
 
 void HumanPoseEstimator::reshape(const cv::Mat& image){
@@ -110,71 +114,67 @@ void HumanPoseEstimator::reshape(const cv::Mat& image){
         input_shape[2] = inputLayerSize.height;
         input_shape[3] = inputLayerSize.width;
         input_shapes[input_name] = input_shape;
-        network.reshape(input_shapes);
-        executableNetwork = ie.LoadNetwork(network, targetDeviceName);
-        requestNext = executableNetwork.CreateInferRequestPtr();
-        requestCurr = executableNetwork.CreateInferRequestPtr();
+        pipeline.reset();
+        executableNetwork = networkCache->get(input_shapes);
+        createPipeline();
         std::cout << "Reshape needed" << std::endl;
     }
 }
 
-void HumanPoseEstimator::frameToBlobCurr(const cv::Mat& image) {
-    CV_Assert(image.type() == CV_8UC3);
-    InferenceEngine::Blob::Ptr input = requestCurr->GetBlob(network.getInputsInfo().begin()->first);
-    InferenceEngine::LockedMemory<void> requestCurrBlobMapped =
-        InferenceEngine::as<InferenceEngine::MemoryBlob>(input)->wmap();
-    auto buffer = requestCurrBlobMapped.as<uint8_t *>();
-    preprocess(image, buffer);
+void HumanPoseEstimator::createPipeline() {
+    // Images are preprocessed on the thread which submits them and postprocessed on the threads of the pipeline
+    const std::string inputName = network.getInputsInfo().begin()->first;
+    pipeline.reset(new AsyncPipeline<cv::Mat, std::vector<HumanPose>>(executableNetwork, inferRequestsCount,
+        [this, inputName](const cv::Mat& image, InferenceEngine::InferRequest& request) {
+            CV_Assert(image.type() == CV_8UC3);
+            InferenceEngine::Blob::Ptr input = request.GetBlob(inputName);
+            InferenceEngine::LockedMemory<void> inputBlobMapped =
+                InferenceEngine::as<InferenceEngine::MemoryBlob>(input)->wmap();
+            auto buffer = inputBlobMapped.as<uint8_t *>();
+            preprocess(image, buffer);
+        },
+        [this](const cv::Mat& image, InferenceEngine::InferRequest& request) {
+            InferenceEngine::Blob::Ptr pafsBlob = request.GetBlob(pafsBlobName);
+            InferenceEngine::Blob::Ptr heatMapsBlob = request.GetBlob(heatmapsBlobName);
+            InferenceEngine::SizeVector heatMapDims = heatMapsBlob->getTensorDesc().getDims();
+
+            InferenceEngine::LockedMemory<const void> heatMapsBlobMapped =
+                InferenceEngine::as<InferenceEngine::MemoryBlob>(heatMapsBlob)->rmap();
+            InferenceEngine::LockedMemory<const void> pafsBlobMapped =
+                InferenceEngine::as<InferenceEngine::MemoryBlob>(pafsBlob)->rmap();
+            return postprocess(
+                    heatMapsBlobMapped.as<float*>(),
+                    heatMapDims[2] * heatMapDims[3],
+                    keypointsNumber,
+                    pafsBlobMapped.as<float*>(),
+                    heatMapDims[2] * heatMapDims[3],
+                    pafsBlob->getTensorDesc().getDims()[1],
+                    heatMapDims[3], heatMapDims[2], image.size());
+        }));
 }
 
-void HumanPoseEstimator::frameToBlobNext(const cv::Mat& image) {
-    CV_Assert(image.type() == CV_8UC3);
-    InferenceEngine::Blob::Ptr input = requestNext->GetBlob(network.getInputsInfo().begin()->first);
-    InferenceEngine::LockedMemory<void> requestNextBlobMapped =
-        InferenceEngine::as<InferenceEngine::MemoryBlob>(input)->wmap();
-    auto buffer = requestNextBlobMapped.as<uint8_t *>();
-    preprocess(image, buffer);
+void HumanPoseEstimator::submit(const cv::Mat& image) {
+    pipeline->submit(image);
 }
 
-void HumanPoseEstimator::startCurr() {
-    requestCurr->StartAsync();
+size_t HumanPoseEstimator::pending() {
+    return pipeline->pending();
 }
 
-void HumanPoseEstimator::startNext() {
-    requestNext->StartAsync();
+size_t HumanPoseEstimator::getInferRequestsCount() const {
+    return inferRequestsCount;
 }
 
-bool HumanPoseEstimator::readyCurr() {
-    if (InferenceEngine::OK == requestCurr->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY)) {
-        return true;
-    } else {
-        return false;
-    }
+bool HumanPoseEstimator::pop(cv::Mat& image, std::vector<HumanPose>& poses) {
+    return pipeline->pop(image, poses);
 }
 
-void HumanPoseEstimator::swapRequest() {
-    requestCurr.swap(requestNext);
+cv::Size HumanPoseEstimator::getImageSize() const {
+    return imageSize;
 }
 
-std::vector<HumanPose> HumanPoseEstimator::postprocessCurr() {
-    InferenceEngine::Blob::Ptr pafsBlob = requestCurr->GetBlob(pafsBlobName);
-    InferenceEngine::Blob::Ptr heatMapsBlob = requestCurr->GetBlob(heatmapsBlobName);
-    InferenceEngine::SizeVector heatMapDims = heatMapsBlob->getTensorDesc().getDims();
-
-    InferenceEngine::LockedMemory<const void> heatMapsBlobMapped =
-        InferenceEngine::as<InferenceEngine::MemoryBlob>(heatMapsBlob)->rmap();
-    InferenceEngine::LockedMemory<const void> pafsBlobMapped =
-        InferenceEngine::as<InferenceEngine::MemoryBlob>(pafsBlob)->rmap();
-    std::vector<HumanPose> poses = postprocess(
-            heatMapsBlobMapped.as<float*>(),
-            heatMapDims[2] * heatMapDims[3],
-            keypointsNumber,
-            pafsBlobMapped.as<float*>(),
-            heatMapDims[2] * heatMapDims[3],
-            pafsBlob->getTensorDesc().getDims()[1],
-            heatMapDims[3], heatMapDims[2], imageSize);
-
-    return poses;
+void HumanPoseEstimator::printNetworkCacheReport() const {
+    networkCache->printReport();
 }
 
 void HumanPoseEstimator::preprocess(const cv::Mat& image, uint8_t* buffer) const {
@@ -301,11 +301,16 @@ bool HumanPoseEstimator::inputWidthIsChanged(const cv::Size& imageSize) {
     int minHeight = std::min(scaledImageSize.height, scaledSize.height);
     scaledImageSize.width = static_cast<int>(std::ceil(
                 scaledImageSize.width / static_cast<float>(stride))) * stride;
+    if (scaledImageSize.width != inputLayerSize.width) {
+        // The image is padded to a bucket of widths, so images of close aspect ratios share a compiled network.
+        // The bucket is a multiple of the stride.
+        scaledImageSize.width = static_cast<int>(NetworkCache::bucket(scaledImageSize.width, widthBucket));
+    }
     pad(0) = static_cast<int>(std::floor((scaledImageSize.height - minHeight) / 2.0));
     pad(1) = static_cast<int>(std::floor((scaledImageSize.width - scaledSize.width) / 2.0));
     pad(2) = scaledImageSize.height - minHeight - pad(0);
     pad(3) = scaledImageSize.width - scaledSize.width - pad(1);
-    if (scaledSize.width == (inputLayerSize.width - pad(1) - pad(3))) {
+    if (scaledImageSize.width == inputLayerSize.width) {
         return false;
     }
 
@@ -316,8 +321,9 @@ bool HumanPoseEstimator::inputWidthIsChanged(const cv::Size& imageSize) {
 HumanPoseEstimator::~HumanPoseEstimator() {
     try {
         if (enablePerformanceReport) {
+            pipeline->waitAll();
             std::cout << "Performance counts for " << modelPath << std::endl << std::endl;
-            printPerformanceCounts(*requestCurr, std::cout, getFullDeviceName(ie, targetDeviceName), false);
+            printPerformanceCounts(pipeline->getRequest(0), std::cout, getFullDeviceName(ie, targetDeviceName), false);
         }
     }
     catch (...) {
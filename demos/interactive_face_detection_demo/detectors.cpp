@@ -35,7 +35,8 @@ BaseDetection::BaseDetection(const std::string &topoName,
                              bool doRawOutputMessages)
     : topoName(topoName), pathToModel(pathToModel), deviceForInference(deviceForInference),
       maxBatch(maxBatch), isBatchDynamic(isBatchDynamic), isAsync(isAsync),
-      enablingChecked(false), _enabled(false), doRawOutputMessages(doRawOutputMessages) {
+      enablingChecked(false), _enabled(false), doRawOutputMessages(doRawOutputMessages),
+      loadLog("INFO", loadLogStream) {
     if (isAsync) {
         slog::info << "Use async mode for " << topoName << slog::endl;
     }
@@ -66,13 +67,17 @@ bool BaseDetection::enabled() const  {
     if (!enablingChecked) {
         _enabled = !pathToModel.empty();
         if (!_enabled) {
-            slog::info << topoName << " DISABLED" << slog::endl;
+            loadLog << topoName << " DISABLED" << slog::endl;
         }
         enablingChecked = true;
     }
     return _enabled;
 }
 
+void BaseDetection::printLoadLog() const {
+    std::cout << loadLogStream.str();
+}
+
 void BaseDetection::printPerformanceCounts(std::string fullDeviceName) {
     if (!enabled()) {
         return;
@@ -119,17 +124,17 @@ void FaceDetection::enqueue(const cv::Mat &frame) {
     enquedFrames = 1;
 }
 
-CNNNetwork FaceDetection::read(const InferenceEngine::Core& ie)  {
-    slog::info << "Loading network files for Face Detection" << slog::endl;
+CNNNetwork FaceDetection::read(const ModelLoader& loader)  {
+    loadLog << "Loading network files for Face Detection" << slog::endl;
     /** Read network model **/
-    auto network = ie.ReadNetwork(pathToModel);
+    auto network = loader.readNetwork(pathToModel);
     /** Set batch size to 1 **/
-    slog::info << "Batch size is set to " << maxBatch << slog::endl;
+    loadLog << "Batch size is set to " << maxBatch << slog::endl;
     network.setBatchSize(maxBatch);
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check inputs -------------------------------------------------------------
-    slog::info << "Checking Face Detection network inputs" << slog::endl;
+    loadLog << "Checking Face Detection network inputs" << slog::endl;
     InputsDataMap inputInfo(network.getInputsInfo());
     if (inputInfo.size() != 1) {
         throw std::logic_error("Face Detection network should have only one input");
@@ -144,7 +149,7 @@ CNNNetwork FaceDetection::read(const InferenceEngine::Core& ie)  {
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check outputs ------------------------------------------------------------
-    slog::info << "Checking Face Detection network outputs" << slog::endl;
+    loadLog << "Checking Face Detection network outputs" << slog::endl;
     OutputsDataMap outputInfo(network.getOutputsInfo());
     if (outputInfo.size() == 1) {
         DataPtr& _output = outputInfo.begin()->second;
@@ -178,7 +183,7 @@ CNNNetwork FaceDetection::read(const InferenceEngine::Core& ie)  {
         }
     }
 
-    slog::info << "Loading Face Detection model to the " << deviceForInference << " device" << slog::endl;
+    loadLog << "Loading Face Detection model to the " << deviceForInference << " device" << slog::endl;
     input = inputInfo.begin()->first;
     return network;
 }
@@ -339,17 +344,17 @@ AgeGenderDetection::Result AgeGenderDetection::operator[] (int idx) const {
     return r;
 }
 
-CNNNetwork AgeGenderDetection::read(const InferenceEngine::Core& ie) {
-    slog::info << "Loading network files for Age/Gender Recognition network" << slog::endl;
+CNNNetwork AgeGenderDetection::read(const ModelLoader& loader) {
+    loadLog << "Loading network files for Age/Gender Recognition network" << slog::endl;
     // Read network
-    auto network = ie.ReadNetwork(pathToModel);
+    auto network = loader.readNetwork(pathToModel);
     // Set maximum batch size to be used.
     network.setBatchSize(maxBatch);
-    slog::info << "Batch size is set to " << network.getBatchSize() << " for Age/Gender Recognition network" << slog::endl;
+    loadLog << "Batch size is set to " << network.getBatchSize() << " for Age/Gender Recognition network" << slog::endl;
 
     // ---------------------------Check inputs -------------------------------------------------------------
     // Age/Gender Recognition network should have one input and two outputs
-    slog::info << "Checking Age/Gender Recognition network inputs" << slog::endl;
+    loadLog << "Checking Age/Gender Recognition network inputs" << slog::endl;
     InputsDataMap inputInfo(network.getInputsInfo());
     if (inputInfo.size() != 1) {
         throw std::logic_error("Age/Gender Recognition network should have only one input");
@@ -360,7 +365,7 @@ CNNNetwork AgeGenderDetection::read(const InferenceEngine::Core& ie) {
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check outputs ------------------------------------------------------------
-    slog::info << "Checking Age/Gender Recognition network outputs" << slog::endl;
+    loadLog << "Checking Age/Gender Recognition network outputs" << slog::endl;
     OutputsDataMap outputInfo(network.getOutputsInfo());
     if (outputInfo.size() != 2) {
         throw std::logic_error("Age/Gender Recognition network should have two output layers");
@@ -373,7 +378,7 @@ CNNNetwork AgeGenderDetection::read(const InferenceEngine::Core& ie) {
     outputAge = ptrAgeOutput->getName();
     outputGender = ptrGenderOutput->getName();
 
-    slog::info << "Loading Age/Gender Recognition model to the " << deviceForInference << " plugin" << slog::endl;
+    loadLog << "Loading Age/Gender Recognition model to the " << deviceForInference << " plugin" << slog::endl;
     _enabled = true;
     return network;
 }
@@ -435,16 +440,16 @@ HeadPoseDetection::Results HeadPoseDetection::operator[] (int idx) const {
     return r;
 }
 
-CNNNetwork HeadPoseDetection::read(const InferenceEngine::Core& ie) {
-    slog::info << "Loading network files for Head Pose Estimation network" << slog::endl;
+CNNNetwork HeadPoseDetection::read(const ModelLoader& loader) {
+    loadLog << "Loading network files for Head Pose Estimation network" << slog::endl;
     // Read network model
-    auto network = ie.ReadNetwork(pathToModel);
+    auto network = loader.readNetwork(pathToModel);
     // Set maximum batch size
     network.setBatchSize(maxBatch);
-    slog::info << "Batch size is set to  " << network.getBatchSize() << " for Head Pose Estimation network" << slog::endl;
+    loadLog << "Batch size is set to  " << network.getBatchSize() << " for Head Pose Estimation network" << slog::endl;
 
     // ---------------------------Check inputs -------------------------------------------------------------
-    slog::info << "Checking Head Pose Estimation network inputs" << slog::endl;
+    loadLog << "Checking Head Pose Estimation network inputs" << slog::endl;
     InputsDataMap inputInfo(network.getInputsInfo());
     if (inputInfo.size() != 1) {
         throw std::logic_error("Head Pose Estimation network should have only one input");
@@ -455,7 +460,7 @@ CNNNetwork HeadPoseDetection::read(const InferenceEngine::Core& ie) {
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check outputs ------------------------------------------------------------
-    slog::info << "Checking Head Pose Estimation network outputs" << slog::endl;
+    loadLog << "Checking Head Pose Estimation network outputs" << slog::endl;
     OutputsDataMap outputInfo(network.getOutputsInfo());
     for (auto& output : outputInfo) {
         output.second->setPrecision(Precision::FP32);
@@ -466,7 +471,7 @@ CNNNetwork HeadPoseDetection::read(const InferenceEngine::Core& ie) {
         }
     }
 
-    slog::info << "Loading Head Pose Estimation model to the " << deviceForInference << " plugin" << slog::endl;
+    loadLog << "Loading Head Pose Estimation model to the " << deviceForInference << " plugin" << slog::endl;
 
     _enabled = true;
     return network;
@@ -547,18 +552,18 @@ std::map<std::string, float> EmotionsDetection::operator[] (int idx) const {
     return emotions;
 }
 
-CNNNetwork EmotionsDetection::read(const InferenceEngine::Core& ie) {
-    slog::info << "Loading network files for Emotions Recognition" << slog::endl;
+CNNNetwork EmotionsDetection::read(const ModelLoader& loader) {
+    loadLog << "Loading network files for Emotions Recognition" << slog::endl;
     // Read network model
-    auto network = ie.ReadNetwork(pathToModel);
+    auto network = loader.readNetwork(pathToModel);
     // Set maximum batch size
     network.setBatchSize(maxBatch);
-    slog::info << "Batch size is set to " << network.getBatchSize() << " for Emotions Recognition" << slog::endl;
+    loadLog << "Batch size is set to " << network.getBatchSize() << " for Emotions Recognition" << slog::endl;
     // -----------------------------------------------------------------------------------------------------
 
     // Emotions Recognition network should have one input and one output.
     // ---------------------------Check inputs -------------------------------------------------------------
-    slog::info << "Checking Emotions Recognition network inputs" << slog::endl;
+    loadLog << "Checking Emotions Recognition network inputs" << slog::endl;
     InferenceEngine::InputsDataMap inputInfo(network.getInputsInfo());
     if (inputInfo.size() != 1) {
         throw std::logic_error("Emotions Recognition network should have only one input");
@@ -569,7 +574,7 @@ CNNNetwork EmotionsDetection::read(const InferenceEngine::Core& ie) {
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check outputs ------------------------------------------------------------
-    slog::info << "Checking Emotions Recognition network outputs" << slog::endl;
+    loadLog << "Checking Emotions Recognition network outputs" << slog::endl;
     InferenceEngine::OutputsDataMap outputInfo(network.getOutputsInfo());
     if (outputInfo.size() != 1) {
         throw std::logic_error("Emotions Recognition network should have one output layer");
@@ -580,7 +585,7 @@ CNNNetwork EmotionsDetection::read(const InferenceEngine::Core& ie) {
 
     outputEmotions = outputInfo.begin()->first;
 
-    slog::info << "Loading Emotions Recognition model to the " << deviceForInference << " plugin" << slog::endl;
+    loadLog << "Loading Emotions Recognition model to the " << deviceForInference << " plugin" << slog::endl;
     _enabled = true;
     return network;
 }
@@ -651,16 +656,16 @@ std::vector<float> FacialLandmarksDetection::operator[] (int idx) const {
     return normedLandmarks;
 }
 
-CNNNetwork FacialLandmarksDetection::read(const InferenceEngine::Core& ie) {
-    slog::info << "Loading network files for Facial Landmarks Estimation" << slog::endl;
+CNNNetwork FacialLandmarksDetection::read(const ModelLoader& loader) {
+    loadLog << "Loading network files for Facial Landmarks Estimation" << slog::endl;
     // Read network model
-    auto network = ie.ReadNetwork(pathToModel);
+    auto network = loader.readNetwork(pathToModel);
     // Set maximum batch size
     network.setBatchSize(maxBatch);
-    slog::info << "Batch size is set to  " << network.getBatchSize() << " for Facial Landmarks Estimation network" << slog::endl;
+    loadLog << "Batch size is set to  " << network.getBatchSize() << " for Facial Landmarks Estimation network" << slog::endl;
 
     // ---------------------------Check inputs -------------------------------------------------------------
-    slog::info << "Checking Facial Landmarks Estimation network inputs" << slog::endl;
+    loadLog << "Checking Facial Landmarks Estimation network inputs" << slog::endl;
     InputsDataMap inputInfo(network.getInputsInfo());
     if (inputInfo.size() != 1) {
         throw std::logic_error("Facial Landmarks Estimation network should have only one input");
@@ -671,7 +676,7 @@ CNNNetwork FacialLandmarksDetection::read(const InferenceEngine::Core& ie) {
     // -----------------------------------------------------------------------------------------------------
 
     // ---------------------------Check outputs ------------------------------------------------------------
-    slog::info << "Checking Facial Landmarks Estimation network outputs" << slog::endl;
+    loadLog << "Checking Facial Landmarks Estimation network outputs" << slog::endl;
     OutputsDataMap outputInfo(network.getOutputsInfo());
     const std::string outName = outputInfo.begin()->first;
     if (outName != outputFacialLandmarksBlobName) {
@@ -686,7 +691,7 @@ CNNNetwork FacialLandmarksDetection::read(const InferenceEngine::Core& ie) {
                                " the last dimension");
     }
 
-    slog::info << "Loading Facial Landmarks Estimation model to the " << deviceForInference << " plugin"
+    loadLog << "Loading Facial Landmarks Estimation model to the " << deviceForInference << " plugin"
         << slog::endl;
 
     _enabled = true;
@@ -697,7 +702,7 @@ CNNNetwork FacialLandmarksDetection::read(const InferenceEngine::Core& ie) {
 Load::Load(BaseDetection& detector) : detector(detector) {
 }
 
-void Load::into(InferenceEngine::Core & ie, const std::string & deviceName, bool enable_dynamic_batch) const {
+void Load::into(const ModelLoader& loader, const std::string & deviceName, bool enable_dynamic_batch) const {
     if (detector.enabled()) {
         std::map<std::string, std::string> config = { };
         bool isPossibleDynBatch = deviceName.find("CPU") != std::string::npos ||
@@ -707,7 +712,7 @@ void Load::into(InferenceEngine::Core & ie, const std::string & deviceName, bool
             config[PluginConfigParams::KEY_DYN_BATCH_ENABLED] = PluginConfigParams::YES;
         }
 
-        detector.net = ie.LoadNetwork(detector.read(ie), deviceName, config);
+        detector.net = loader.loadNetwork(detector.read(loader), detector.pathToModel, deviceName, config);
     }
 }
 
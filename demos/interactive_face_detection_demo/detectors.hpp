@@ -17,12 +17,15 @@
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <sstream>
 
 #include <inference_engine.hpp>
 
 #include <samples/common.hpp>
 #include <samples/slog.hpp>
 
+#include <model_loader/model_loader.hpp>
+
 #include <ie_iextension.h>
 
 #include <opencv2/opencv.hpp>
@@ -41,6 +44,10 @@ struct BaseDetection {
     mutable bool enablingChecked;
     mutable bool _enabled;
     const bool doRawOutputMessages;
+    // Networks are read and loaded concurrently, so the messages of read() go to a buffer
+    // of the detector which is printed by printLoadLog() once all networks are loaded
+    mutable std::ostringstream loadLogStream;
+    mutable slog::LogStream loadLog;
 
     BaseDetection(const std::string &topoName,
                   const std::string &pathToModel,
@@ -51,11 +58,12 @@ struct BaseDetection {
     virtual ~BaseDetection();
 
     InferenceEngine::ExecutableNetwork* operator ->();
-    virtual InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) = 0;
+    virtual InferenceEngine::CNNNetwork read(const ModelLoader& loader) = 0;
     virtual void submitRequest();
     virtual void wait();
     bool enabled() const;
     void printPerformanceCounts(std::string fullDeviceName);
+    void printLoadLog() const;
 };
 
 struct FaceDetection : BaseDetection {
@@ -89,7 +97,7 @@ struct FaceDetection : BaseDetection {
                   float bb_enlarge_coefficient, float bb_dx_coefficient,
                   float bb_dy_coefficient);
 
-    InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) override;
+    InferenceEngine::CNNNetwork read(const ModelLoader& loader) override;
     void submitRequest() override;
 
     void enqueue(const cv::Mat &frame);
@@ -112,7 +120,7 @@ struct AgeGenderDetection : BaseDetection {
                        int maxBatch, bool isBatchDynamic, bool isAsync,
                        bool doRawOutputMessages);
 
-    InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) override;
+    InferenceEngine::CNNNetwork read(const ModelLoader& loader) override;
     void submitRequest() override;
 
     void enqueue(const cv::Mat &face);
@@ -138,7 +146,7 @@ struct HeadPoseDetection : BaseDetection {
                       int maxBatch, bool isBatchDynamic, bool isAsync,
                       bool doRawOutputMessages);
 
-    InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) override;
+    InferenceEngine::CNNNetwork read(const ModelLoader& loader) override;
     void submitRequest() override;
 
     void enqueue(const cv::Mat &face);
@@ -155,7 +163,7 @@ struct EmotionsDetection : BaseDetection {
                       int maxBatch, bool isBatchDynamic, bool isAsync,
                       bool doRawOutputMessages);
 
-    InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) override;
+    InferenceEngine::CNNNetwork read(const ModelLoader& loader) override;
     void submitRequest() override;
 
     void enqueue(const cv::Mat &face);
@@ -176,7 +184,7 @@ struct FacialLandmarksDetection : BaseDetection {
                              int maxBatch, bool isBatchDynamic, bool isAsync,
                              bool doRawOutputMessages);
 
-    InferenceEngine::CNNNetwork read(const InferenceEngine::Core& ie) override;
+    InferenceEngine::CNNNetwork read(const ModelLoader& loader) override;
     void submitRequest() override;
 
     void enqueue(const cv::Mat &face);
@@ -188,7 +196,7 @@ struct Load {
 
     explicit Load(BaseDetection& detector);
 
-    void into(InferenceEngine::Core & ie, const std::string & deviceName, bool enable_dynamic_batch = false) const;
+    void into(const ModelLoader& loader, const std::string & deviceName, bool enable_dynamic_batch = false) const;
 };
 
 class CallStat {
@@ -65,6 +65,7 @@ static const char loop_video_output_message[] = "Optional. Enable playing video
 static const char no_smooth_output_message[] = "Optional. Do not smooth person attributes";
 static const char no_show_emotion_bar_message[] = "Optional. Do not show emotion bar";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char cache_dir_message[] = "Optional. Existing directory to cache compiled networks in. Networks found in the cache are imported instead of being compiled. Only devices which support network export use the cache.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", input_video_message);
@@ -103,6 +104,7 @@ DEFINE_bool(loop_video, false, loop_video_output_message);
 DEFINE_bool(no_smooth, false, no_smooth_output_message);
 DEFINE_bool(no_show_emotion_bar, false, no_show_emotion_bar_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_string(cache_dir, "", cache_dir_message);
 
 
 /**
@@ -152,4 +154,5 @@ static void showUsage() {
     std::cout << "    -no_smooth                 " << no_smooth_output_message << std::endl;
     std::cout << "    -no_show_emotion_bar       " << no_show_emotion_bar_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
+    std::cout << "    -cache_dir \"<path>\"        " << cache_dir_message << std::endl;
 }
@@ -21,6 +21,7 @@
 #include <map>
 #include <list>
 #include <set>
+#include <initializer_list>
 
 #include <inference_engine.hpp>
 
@@ -157,12 +158,21 @@ int main(int argc, char *argv[]) {
         // ---------------------------------------------------------------------------------------------------
 
         // --------------------------- 2. Reading IR models and loading them to plugins ----------------------
-        // Disable dynamic batching for face detector as it processes one image at a time
-        Load(faceDetector).into(ie, FLAGS_d, false);
-        Load(ageGenderDetector).into(ie, FLAGS_d_ag, FLAGS_dyn_ag);
-        Load(headPoseDetector).into(ie, FLAGS_d_hp, FLAGS_dyn_hp);
-        Load(emotionsDetector).into(ie, FLAGS_d_em, FLAGS_dyn_em);
-        Load(facialLandmarksDetector).into(ie, FLAGS_d_lm, FLAGS_dyn_lm);
+        ModelLoader loader(ie, FLAGS_cache_dir);
+        loader.run({
+            // Disable dynamic batching for face detector as it processes one image at a time
+            [&]() { Load(faceDetector).into(loader, FLAGS_d, false); },
+            [&]() { Load(ageGenderDetector).into(loader, FLAGS_d_ag, FLAGS_dyn_ag); },
+            [&]() { Load(headPoseDetector).into(loader, FLAGS_d_hp, FLAGS_dyn_hp); },
+            [&]() { Load(emotionsDetector).into(loader, FLAGS_d_em, FLAGS_dyn_em); },
+            [&]() { Load(facialLandmarksDetector).into(loader, FLAGS_d_lm, FLAGS_dyn_lm); }
+        });
+        // the detectors are loaded concurrently, their messages are printed in order once all of them are loaded
+        for (const BaseDetection* detector : std::initializer_list<const BaseDetection*>{
+                &faceDetector, &ageGenderDetector, &headPoseDetector, &emotionsDetector, &facialLandmarksDetector}) {
+            detector->printLoadLog();
+        }
+        loader.printReport();
         // ----------------------------------------------------------------------------------------------------
 
         // --------------------------- 3. Doing inference -----------------------------------------------------
@@ -0,0 +1,212 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "capture_executor.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include <tracing/tracing.hpp>
+
+constexpr unsigned TimerWheel::SlotBits;
+constexpr size_t TimerWheel::SlotsCount;
+constexpr size_t TimerWheel::LevelsCount;
+
+TimerWheel::TimerWheel(Clock::duration tick, Clock::time_point start):
+    tick(tick),
+    start(start) {}
+
+void TimerWheel::add(size_t id, Clock::time_point time) {
+    uint64_t timerTick = 0;
+    if (time > start) {
+        timerTick = static_cast<uint64_t>((time - start + tick - Clock::duration(1)) / tick);
+    }
+    if (timerTick <= currentTick) {
+        due.push_back(id);
+    } else {
+        insert({id, timerTick});
+    }
+}
+
+void TimerWheel::insert(const Timer& timer) {
+    const uint64_t delta = timer.tick - currentTick;
+    uint64_t placeTick = timer.tick;
+    size_t level = LevelsCount - 1;
+    if (delta >= uint64_t(1) << (SlotBits * LevelsCount)) {
+        // further than the wheel reaches, the timer waits in the last slot and is placed again
+        placeTick = currentTick + (uint64_t(1) << (SlotBits * LevelsCount)) - 1;
+    } else {
+        level = 0;
+        while (level + 1 < LevelsCount && delta >= uint64_t(1) << (SlotBits * (level + 1))) {
+            level++;
+        }
+    }
+    slots[level][(placeTick >> (SlotBits * level)) & (SlotsCount - 1)].push_back(timer);
+    levelSizes[level]++;
+}
+
+void TimerWheel::advance(Clock::time_point now, std::vector<size_t>& expired) {
+    expired.insert(expired.end(), due.begin(), due.end());
+    due.clear();
+    if (now <= start) {
+        return;
+    }
+    const uint64_t targetTick = static_cast<uint64_t>((now - start) / tick);
+    while (currentTick < targetTick) {
+        size_t timersCount = 0;
+        for (size_t size : levelSizes) {
+            timersCount += size;
+        }
+        if (0 == timersCount) {
+            currentTick = targetTick;
+            break;
+        }
+
+        currentTick++;
+        // the higher levels go first, because their timers may move to the slots of the lower ones reached now
+        size_t topLevel = 0;
+        while (topLevel + 1 < LevelsCount && 0 == (currentTick & ((uint64_t(1) << (SlotBits * (topLevel + 1))) - 1))) {
+            topLevel++;
+        }
+        for (size_t level = topLevel; level > 0; level--) {
+            std::vector<Timer> cascaded;
+            cascaded.swap(slots[level][(currentTick >> (SlotBits * level)) & (SlotsCount - 1)]);
+            levelSizes[level] -= cascaded.size();
+            for (const Timer& timer : cascaded) {
+                if (timer.tick <= currentTick) {
+                    expired.push_back(timer.id);
+                } else {
+                    insert(timer);
+                }
+            }
+        }
+        std::vector<Timer>& slot = slots[0][currentTick & (SlotsCount - 1)];
+        for (const Timer& timer : slot) {
+            expired.push_back(timer.id);
+        }
+        levelSizes[0] -= slot.size();
+        slot.clear();
+    }
+}
+
+TimerWheel::Clock::time_point TimerWheel::getNextExpiry() const {
+    if (!due.empty()) {
+        return getTime(currentTick);
+    }
+    Clock::time_point next = Clock::time_point::max();
+    for (size_t level = 1; level < LevelsCount; level++) {
+        if (0 != levelSizes[level]) {
+            // the next slot of the second level, timers of all higher levels move down at its beginning
+            next = getTime(((currentTick >> SlotBits) + 1) << SlotBits);
+            break;
+        }
+    }
+    if (0 != levelSizes[0]) {
+        for (uint64_t i = 1; i < SlotsCount; i++) {
+            if (!slots[0][(currentTick + i) & (SlotsCount - 1)].empty()) {
+                return std::min(next, getTime(currentTick + i));
+            }
+        }
+    }
+    return next;
+}
+
+TimerWheel::Clock::time_point TimerWheel::getTime(uint64_t timerTick) const {
+    return start + tick * timerTick;
+}
+
+CaptureExecutor::CaptureExecutor():
+    timers(std::chrono::milliseconds(1), Clock::now()) {}
+
+CaptureExecutor::~CaptureExecutor() {
+    stop();
+}
+
+size_t CaptureExecutor::addTask(std::function<void()> task) {
+    tasks.push_back(std::move(task));
+    return tasks.size() - 1;
+}
+
+void CaptureExecutor::start(size_t threadsCount) {
+    for (size_t i = 0; i < threadsCount; i++) {
+        threads.emplace_back([this, i]() {
+            tracing::setThreadName("capture " + std::to_string(i));
+            work();
+        });
+    }
+}
+
+void CaptureExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    readyCondVar.notify_all();
+    timerCondVar.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+}
+
+void CaptureExecutor::post(size_t task) {
+    bool notifyTimekeeper;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(task);
+        notifyTimekeeper = 0 == readyWaiters;
+    }
+    if (notifyTimekeeper) {
+        timerCondVar.notify_one();
+    } else {
+        readyCondVar.notify_one();
+    }
+}
+
+void CaptureExecutor::schedule(size_t task, Clock::time_point time) {
+    bool notifyTimekeeper;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        timers.add(task, time);
+        notifyTimekeeper = timekeeperWaiting && time < timekeeperDeadline;
+    }
+    if (notifyTimekeeper) {
+        timerCondVar.notify_one();
+    }
+}
+
+void CaptureExecutor::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped) {
+        timers.advance(Clock::now(), expired);
+        ready.insert(ready.end(), expired.begin(), expired.end());
+        expired.clear();
+        if (!ready.empty()) {
+            const size_t task = ready.front();
+            ready.pop_front();
+            // an idle thread takes the other tasks or keeps the time instead of this one
+            const bool notify = 0 != readyWaiters && (!ready.empty() || !timekeeperWaiting);
+            lock.unlock();
+            if (notify) {
+                readyCondVar.notify_one();
+            }
+            tasks[task]();
+            lock.lock();
+        } else if (!timekeeperWaiting) {
+            timekeeperWaiting = true;
+            timekeeperDeadline = timers.getNextExpiry();
+            if (Clock::time_point::max() == timekeeperDeadline) {
+                timerCondVar.wait(lock);
+            } else {
+                timerCondVar.wait_until(lock, timekeeperDeadline);
+            }
+            timekeeperWaiting = false;
+        } else {
+            readyWaiters++;
+            readyCondVar.wait(lock);
+            readyWaiters--;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// \brief Hierarchical timer wheel of 4 levels with 64 slots each.
+///
+/// A slot of the first level holds the timers of one tick, a slot of every next
+/// level covers the whole previous level, and its timers move to the lower levels
+/// when the time reaches the slot. Adding a timer and advancing the time by a
+/// tick take constant time regardless of the number of timers.
+///
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TimerWheel(Clock::duration tick, Clock::time_point start);
+
+    ///
+    /// \brief Adds a timer which expires at the first tick not earlier than the time.
+    ///
+    void add(size_t id, Clock::time_point time);
+
+    ///
+    /// \brief Advances the wheel to the time and appends the timers which expired to the vector.
+    ///
+    void advance(Clock::time_point now, std::vector<size_t>& expired);
+
+    ///
+    /// \brief Returns when advance() should be called next, Clock::time_point::max() if there are no timers.
+    ///
+    Clock::time_point getNextExpiry() const;
+
+private:
+    static constexpr unsigned SlotBits = 6;
+    static constexpr size_t SlotsCount = 1 << SlotBits;
+    static constexpr size_t LevelsCount = 4;
+
+    struct Timer {
+        size_t id;
+        uint64_t tick;
+    };
+
+    void insert(const Timer& timer);
+    Clock::time_point getTime(uint64_t tick) const;
+
+    const Clock::duration tick;
+    const Clock::time_point start;
+    uint64_t currentTick = 0;
+    std::vector<size_t> due;  // timers which expire at the next advance()
+    std::array<std::array<std::vector<Timer>, SlotsCount>, LevelsCount> slots;
+    std::array<size_t, LevelsCount> levelSizes{};
+};
+
+///
+/// \brief Runs the capture tasks of many inputs on a fixed number of threads.
+///
+/// A task captures one frame and then posts or schedules itself again, so an input
+/// paced at its frame rate occupies a thread only while it captures. A task is never
+/// run by two threads at once, as long as it is posted or scheduled once per run.
+/// One of the idle threads waits for the nearest timer, the others wait for posted tasks.
+///
+class CaptureExecutor {
+public:
+    using Clock = TimerWheel::Clock;
+
+    CaptureExecutor();
+    ~CaptureExecutor();
+
+    ///
+    /// \brief Registers a task, must be called before start().
+    /// \return Index of the task for post() and schedule().
+    ///
+    size_t addTask(std::function<void()> task);
+
+    void start(size_t threadsCount);
+
+    ///
+    /// \brief Stops the threads after the tasks they run return. Tasks posted or scheduled later are never run.
+    ///
+    void stop();
+
+    void post(size_t task);
+
+    void schedule(size_t task, Clock::time_point time);
+
+private:
+    void work();
+
+    std::vector<std::function<void()>> tasks;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable readyCondVar;
+    std::condition_variable timerCondVar;
+    std::deque<size_t> ready;
+    TimerWheel timers;
+    std::vector<size_t> expired;
+    size_t readyWaiters = 0;
+    bool timekeeperWaiting = false;  // an idle thread waits for the nearest timer
+    Clock::time_point timekeeperDeadline;
+    bool stopped = false;
+};
@@ -0,0 +1,98 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "channel_multiplexer.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// How often a reader waiting for frames checks if the multiplexer is stopped
+const std::chrono::milliseconds pollingTimeout(100);
+}  // namespace
+
+ChannelMultiplexer::ChannelMultiplexer(VideoSources& sources, const std::vector<Channel>& channels):
+    sources(sources),
+    lastStatsTime(std::chrono::steady_clock::now()) {
+    if (channels.empty()) {
+        throw std::invalid_argument("ChannelMultiplexer needs at least one channel");
+    }
+    for (const Channel& channel : channels) {
+        states.emplace_back(new State(channel));
+    }
+    states.front()->deficit = states.front()->channel.weight;
+}
+
+bool ChannelMultiplexer::getFrame(VideoFrame& frame) {
+    while (!stopped) {
+        const uint64_t framesCount = sources.getFramesCount();
+        for (size_t visited = 0; visited <= states.size(); visited++) {
+            State& state = *states[current];
+            if (0 != state.deficit) {
+                if (sources.isFrameReady(state.channel.input)) {
+                    state.deficit--;
+                    state.served++;
+                    for (State* skipped : skippedStates) {
+                        if (skipped != &state) {
+                            skipped->starved++;
+                        }
+                        skipped->skipped = false;
+                    }
+                    skippedStates.clear();
+                    frame.sourceIdx = state.channel.index;
+                    return sources.getFrame(state.channel.input, frame);
+                }
+                if (!state.skipped) {
+                    state.skipped = true;
+                    skippedStates.push_back(&state);
+                }
+            }
+            // the turn passes to the next channel, a channel without frames doesn't keep its deficit
+            state.deficit = 0;
+            current = (current + 1) % states.size();
+            states[current]->deficit = states[current]->channel.weight;
+        }
+        sources.waitForFrames(framesCount, pollingTimeout);
+    }
+    return false;
+}
+
+void ChannelMultiplexer::stop() {
+    stopped = true;
+}
+
+std::vector<ChannelMultiplexer::ChannelStats> ChannelMultiplexer::getStats() {
+    const auto now = std::chrono::steady_clock::now();
+    const float seconds = std::chrono::duration_cast<std::chrono::duration<float>>(now - lastStatsTime).count();
+    lastStatsTime = now;
+    std::vector<ChannelStats> stats;
+    for (auto& state : states) {
+        const uint64_t served = state->served;
+        stats.push_back({state->channel.index,
+                         seconds > 0.0f ? (served - state->lastServed) / seconds : 0.0f,
+                         state->starved});
+        state->lastServed = served;
+    }
+    return stats;
+}
+
+std::vector<unsigned> ChannelMultiplexer::parseWeights(const std::string& weights) {
+    std::vector<unsigned> result;
+    std::stringstream stream(weights);
+    std::string weight;
+    while (std::getline(stream, weight, ',')) {
+        size_t end = 0;
+        int value = 0;
+        try {
+            value = std::stoi(weight, &end);
+        } catch (const std::logic_error&) {
+            end = 0;
+        }
+        if (0 == end || end != weight.size() || value <= 0) {
+            throw std::invalid_argument("Invalid channel weight: \"" + weight + "\"");
+        }
+        result.push_back(static_cast<unsigned>(value));
+    }
+    return result;
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "input.hpp"
+
+///
+/// \brief Feeds the frames of several channels to an IEGraph, taking them from the channels which have one ready.
+///
+/// The channels are served by deficit round-robin: at its turn a channel may give as many frames
+/// as its weight, and a channel without a ready frame loses the rest of its turn instead of
+/// blocking the others. The multiplexer waits only if no channel has a frame. A channel is
+/// starved each time another one is served while it has no frame ready, so a stalled or slow
+/// camera shows up as a starved channel with a low served rate.
+///
+class ChannelMultiplexer {
+public:
+    struct Channel {
+        std::size_t input;  // index of the input in VideoSources
+        std::size_t index;  // index of the channel, stored to VideoFrame::sourceIdx
+        unsigned weight;  // frames per turn
+    };
+
+    ChannelMultiplexer(VideoSources& sources, const std::vector<Channel>& channels);
+
+    ///
+    /// \brief Reads the next frame, the getter of an IEGraph.
+    /// \return False if the input of the channel is out of frames or the multiplexer is stopped.
+    ///
+    bool getFrame(VideoFrame& frame);
+
+    ///
+    /// \brief Makes getFrame() return false instead of waiting for the next frame.
+    ///
+    void stop();
+
+    struct ChannelStats {
+        std::size_t channel;
+        float fps;  // frames served per second since the previous call
+        uint64_t starved;
+    };
+
+    std::vector<ChannelStats> getStats();
+
+    ///
+    /// \brief Parses weights separated by commas, such as "2,1,1".
+    ///
+    static std::vector<unsigned> parseWeights(const std::string& weights);
+
+private:
+    struct State {
+        explicit State(const Channel& channel): channel(channel) {}
+
+        const Channel channel;
+        unsigned deficit = 0;
+        bool skipped = false;  // had no frame ready since the last frame served
+        std::atomic<uint64_t> served{0};
+        std::atomic<uint64_t> starved{0};
+        uint64_t lastServed = 0;
+    };
+
+    VideoSources& sources;
+    std::vector<std::unique_ptr<State>> states;
+    std::vector<State*> skippedStates;
+    std::size_t current = 0;
+    std::atomic_bool stopped{false};
+    std::chrono::steady_clock::time_point lastStatsTime;
+};
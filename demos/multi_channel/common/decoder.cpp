@@ -517,8 +517,8 @@ struct Decoder::HwContext {
         }
     }
 
-    float getLatency() const {
-        return perf_timer_decode.getValue();
+    const PerfTimer& getLatencyTimer() const {
+        return perf_timer_decode;
     }
 
     void decodeImpl(const void* d, size_t s, VABufferID* buffers,
@@ -895,7 +895,8 @@ Decoder::~Decoder() {
 Decoder::Stats Decoder::getStats() const {
 #ifdef USE_LIBVA
     if (nullptr != hw_context) {
-        return {hw_context->getLatency()};
+        const PerfTimer& timer = hw_context->getLatencyTimer();
+        return {timer.getValue(), timer.getPercentile(99.0f)};
     }
 #endif
     return {};
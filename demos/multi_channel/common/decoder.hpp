@@ -39,6 +39,7 @@ public:
 
     struct Stats {
         float decoding_latency = 0.0f;
+        float decoding_latency_p99 = 0.0f;
     };
 
     Stats getStats() const;
@@ -38,7 +38,7 @@ void loadImgToIEGraph(const cv::Mat& img, size_t batch, void* ieBuffer) {
 
 }  // namespace
 
-void IEGraph::initNetwork(const std::string& deviceName) {
+void IEGraph::initNetwork(const std::string& deviceName, const std::map<std::string, std::string>& config) {
     auto cnnNetwork = ie.ReadNetwork(modelPath);
 
     if (deviceName.find("CPU") != std::string::npos) {
@@ -69,7 +69,7 @@ void IEGraph::initNetwork(const std::string& deviceName) {
     }
 
     InferenceEngine::ExecutableNetwork network;
-    network = ie.LoadNetwork(cnnNetwork, deviceName);
+    network = ie.LoadNetwork(cnnNetwork, deviceName, config);
 
     InferenceEngine::InputsDataMap inputInfo(cnnNetwork.getInputsInfo());
     if (inputInfo.size() != 1) {
@@ -85,14 +85,44 @@ void IEGraph::initNetwork(const std::string& deviceName) {
 
     for (size_t i = 0; i < maxRequests; ++i) {
         auto req = network.CreateInferRequestPtr();
-        availableRequests.push(req);
+        requests.emplace_back(new Request{req, req->GetBlob(inputDataBlobName),
+                                          tracing::Track("infer request " + std::to_string(i)), {}});
+        availableRequests.push(requests.back().get());
+    }
+    if (recorder) {
+        recorder->setInputDims(getInputDims());
     }
 
     if (postLoad != nullptr)
         postLoad(outputDataBlobNames, cnnNetwork);
 
-    availableRequests.front()->StartAsync();
-    availableRequests.front()->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+    availableRequests.front()->inferRequest->StartAsync();
+    availableRequests.front()->inferRequest->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+}
+
+void IEGraph::initReplay() {
+    const InferenceEngine::SizeVector& inputDims = replayer->getInputDims();
+    if (4 != inputDims.size() || batchSize != inputDims[0]) {
+        throw std::logic_error("The outputs were recorded with another batch size");
+    }
+    outputDataBlobNames = replayer->getOutputNames();
+
+    // requests keep the input blobs, so preprocessing is the same as with a device
+    for (size_t i = 0; i < maxRequests; ++i) {
+        InferenceEngine::Blob::Ptr input = InferenceEngine::make_shared_blob<float>(
+            {InferenceEngine::Precision::FP32, inputDims, InferenceEngine::Layout::NCHW});
+        input->allocate();
+        requests.emplace_back(new Request{nullptr, input, tracing::Track("replayed request " + std::to_string(i)), {}});
+        availableRequests.push(requests.back().get());
+    }
+    if (recorder) {
+        recorder->setInputDims(inputDims);
+    }
+
+    if (!modelPath.empty() && postLoad != nullptr) {
+        auto cnnNetwork = ie.ReadNetwork(modelPath);
+        postLoad(outputDataBlobNames, cnnNetwork);
+    }
 }
 
 void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc) {
@@ -102,6 +132,7 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
     getter = std::move(getterFunc);
     postprocessing = std::move(postprocessingFunc);
     getterThread = std::thread([&]() {
+        tracing::setThreadName("preprocess");
         std::vector<std::shared_ptr<VideoFrame>> vframes;
         std::vector<cv::Mat> imgsToProc(batchSize);
         while (!terminate) {
@@ -110,6 +141,7 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
             while (b != batchSize) {
                 VideoFrame vframe;
                 if (getter(vframe)) {
+                    vframe.readTime = VideoFrame::Clock::now();
                     vframes.push_back(std::make_shared<VideoFrame>(vframe));
                     ++b;
                 } else {
@@ -118,7 +150,7 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
                 }
             }
 
-            InferenceEngine::InferRequest::Ptr req;
+            Request* req;
             {
                 std::unique_lock<std::mutex> lock(mtxAvalableRequests);
                 condVarAvailableRequests.wait(lock, [&]() {
@@ -127,11 +159,11 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
                 if (terminate) {
                     break;
                 }
-                req = std::move(availableRequests.front());
+                req = availableRequests.front();
                 availableRequests.pop();
             }
 
-            auto inputBlob = req->GetBlob(inputDataBlobName);
+            const InferenceEngine::Blob::Ptr& inputBlob = req->input;
             imgsToProc.resize(batchSize);
             for (size_t i = 0; i < batchSize; i++) {
                 if (imgsToProc[i].empty()) {
@@ -144,6 +176,10 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
             }
 
             auto preprocess = [&]() {
+                tracing::Scope scope("preprocess");
+                for (const auto& vframe : vframes) {
+                    tracing::mark(static_cast<int>(vframe->sourceIdx), vframe->frameIdx);
+                }
                 InferenceEngine::LockedMemory<void> buff = InferenceEngine::as<
                     InferenceEngine::MemoryBlob>(inputBlob)->wmap();
                 float* inputPtr = static_cast<float*>(buff);
@@ -164,21 +200,40 @@ void IEGraph::start(GetterFunc getterFunc, PostprocessingFunc postprocessingFunc
 #endif
             };
 
+            auto stampInferStart = [&]() {
+                const VideoFrame::Clock::time_point inferStartTime = VideoFrame::Clock::now();
+                for (const auto& vframe : vframes) {
+                    vframe->inferStartTime = inferStartTime;
+                }
+            };
+
+            auto startRequest = [&]() {
+                if (replayer) {
+                    req->replayEndTime = std::chrono::steady_clock::now() + replayer->getLatency();
+                } else {
+                    req->inferRequest->StartAsync();
+                }
+            };
+
             if (perfTimerInfer.enabled()) {
                 {
                     ScopedTimer st(perfTimerPreprocess);
                     preprocess();
                 }
+                stampInferStart();
                 auto startTime = std::chrono::high_resolution_clock::now();
-                req->StartAsync();
+                auto traceStartTime = tracing::isEnabled() ? tracing::Clock::now() : tracing::Clock::time_point();
+                startRequest();
                 std::unique_lock<std::mutex> lock(mtxBusyRequests);
-                busyBatchRequests.push({std::move(vframes), std::move(req), startTime});
+                busyBatchRequests.push({std::move(vframes), req, startTime, traceStartTime});
             } else {
                 preprocess();
-                req->StartAsync();
+                stampInferStart();
+                auto traceStartTime = tracing::isEnabled() ? tracing::Clock::now() : tracing::Clock::time_point();
+                startRequest();
                 std::unique_lock<std::mutex> lock(mtxBusyRequests);
-                busyBatchRequests.push({std::move(vframes), std::move(req),
-                                    std::chrono::high_resolution_clock::time_point()});
+                busyBatchRequests.push({std::move(vframes), req,
+                                    std::chrono::high_resolution_clock::time_point(), traceStartTime});
             }
             condVarBusyRequests.notify_one();
         }
@@ -197,7 +252,13 @@ IEGraph::IEGraph(const InitParams& p):
     assert(p.maxRequests > 0);
 
     postLoad = p.postLoadFunc;
-    initNetwork(p.deviceName);
+    recorder = p.recorder;
+    replayer = p.replayer;
+    if (replayer) {
+        initReplay();
+    } else {
+        initNetwork(p.deviceName, p.config);
+    }
 }
 
 bool IEGraph::isRunning() {
@@ -205,36 +266,94 @@ bool IEGraph::isRunning() {
     return !terminate || !busyBatchRequests.empty();
 }
 
+void IEGraph::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtxAvalableRequests);
+        terminate = true;
+    }
+    condVarAvailableRequests.notify_one();
+    {
+        // the lock makes sure getBatchData() isn't between checking terminate and waiting
+        std::lock_guard<std::mutex> lock(mtxBusyRequests);
+    }
+    condVarBusyRequests.notify_all();
+}
+
 InferenceEngine::SizeVector IEGraph::getInputDims() const {
-    assert(!availableRequests.empty());
-    auto inputBlob = availableRequests.front()->GetBlob(inputDataBlobName);
-    return inputBlob->getTensorDesc().getDims();
+    assert(!requests.empty());
+    return requests.front()->input->getTensorDesc().getDims();
 }
 
-std::vector<std::shared_ptr<VideoFrame> > IEGraph::getBatchData(cv::Size frameSize) {
+std::vector<std::shared_ptr<VideoFrame> > IEGraph::getBatchData(cv::Size frameSize,
+                                                                 std::chrono::steady_clock::time_point deadline) {
     std::vector<std::shared_ptr<VideoFrame>> vframes;
-    InferenceEngine::InferRequest::Ptr req;
+    Request* req = nullptr;
     std::chrono::high_resolution_clock::time_point startTime;
+    tracing::Clock::time_point traceStartTime;
     {
         std::unique_lock<std::mutex> lock(mtxBusyRequests);
-        condVarBusyRequests.wait(lock, [&]() {
+        auto stoppedOrBusy = [&]() {
             // wait until the pipeline is stopped or there are new InferRequests
             return terminate || !busyBatchRequests.empty();
-        });
+        };
+        if (std::chrono::steady_clock::time_point::max() == deadline) {
+            condVarBusyRequests.wait(lock, stoppedOrBusy);
+        } else {
+            condVarBusyRequests.wait_until(lock, deadline, stoppedOrBusy);
+        }
         if (busyBatchRequests.empty()) {
-            return {}; // woke up because of termination, so leave if nothing to preces
+            return {}; // woke up because of termination or the deadline, so leave if nothing to preces
         }
         vframes = std::move(busyBatchRequests.front().vfPtrVec);
-        req = std::move(busyBatchRequests.front().req);
+        req = busyBatchRequests.front().req;
         startTime = std::move(busyBatchRequests.front().startTime);
+        traceStartTime = busyBatchRequests.front().traceStartTime;
         busyBatchRequests.pop();
     }
 
-    if (nullptr != req && InferenceEngine::OK == req->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY)) {
-        auto detections = postprocessing(req, outputDataBlobNames, frameSize);
+    bool ready = false;
+    if (nullptr != req) {
+        if (replayer) {
+            std::this_thread::sleep_until(req->replayEndTime);
+            ready = true;
+        } else {
+            ready = InferenceEngine::OK == req->inferRequest->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+        }
+    }
+
+    if (ready) {
+        // requests are waited for by this function only, so the track of a request is written by one thread at a time
+        if (tracing::isEnabled() && tracing::Clock::time_point() != traceStartTime) {
+            tracing::Track& track = req->track;
+            track.complete("infer", traceStartTime, tracing::Clock::now());
+            for (const auto& vframe : vframes) {
+                track.mark(static_cast<int>(vframe->sourceIdx), vframe->frameIdx, traceStartTime);
+            }
+        }
+        InferenceEngine::BlobMap outputs;
+        if (replayer) {
+            outputs = replayer->getOutputs(vframes.front()->sourceIdx, vframes.front()->frameIdx);
+        } else {
+            for (const std::string& name : outputDataBlobNames) {
+                outputs[name] = req->inferRequest->GetBlob(name);
+            }
+        }
+        if (recorder) {
+            recorder->write(vframes.front()->sourceIdx, vframes.front()->frameIdx, outputs);
+        }
+
+        tracing::Scope scope("postprocess");
+        for (const auto& vframe : vframes) {
+            tracing::mark(static_cast<int>(vframe->sourceIdx), vframe->frameIdx);
+        }
+        auto detections = postprocessing(outputs, outputDataBlobNames, frameSize);
         for (decltype(detections.size()) i = 0; i < detections.size(); i ++) {
             vframes[i]->detections = std::move(detections[i]);
         }
+        const VideoFrame::Clock::time_point inferEndTime = VideoFrame::Clock::now();
+        for (const auto& vframe : vframes) {
+            vframe->inferEndTime = inferEndTime;
+        }
         if (perfTimerInfer.enabled()) {
             auto endTime = std::chrono::high_resolution_clock::now();
             perfTimerInfer.addValue(endTime - startTime);
@@ -243,7 +362,7 @@ std::vector<std::shared_ptr<VideoFrame> > IEGraph::getBatchData(cv::Size frameSi
 
     if (nullptr != req) {
         std::unique_lock<std::mutex> lock(mtxAvalableRequests);
-        availableRequests.push(std::move(req));
+        availableRequests.push(req);
         lock.unlock();
         condVarAvailableRequests.notify_one();
     }
@@ -267,10 +386,12 @@ IEGraph::~IEGraph() {
         while (!ready) {
             std::unique_lock<std::mutex> lock(mtxBusyRequests);
             if (!busyBatchRequests.empty()) {
-                auto& req = busyBatchRequests.front().req;
+                Request* req = busyBatchRequests.front().req;
                 if (nullptr != req) {
-                    req->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
-                    availableRequests.push(std::move(req));
+                    if (req->inferRequest) {
+                        req->inferRequest->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+                    }
+                    availableRequests.push(req);
                 }
                 busyBatchRequests.pop();
             }
@@ -278,7 +399,7 @@ IEGraph::~IEGraph() {
                 ready = true;
             }
         }
-        if (printPerfReport) {
+        if (printPerfReport && !replayer) {
             slog::info << "Performance counts report" << slog::endl << slog::endl;
             printPerformanceCounts(getFullDeviceName(ie, deviceName));
         }
@@ -290,9 +411,10 @@ IEGraph::~IEGraph() {
 }
 
 IEGraph::Stats IEGraph::getStats() const {
-    return Stats{perfTimerPreprocess.getValue(), perfTimerInfer.getValue()};
+    return Stats{perfTimerPreprocess.getValue(), perfTimerInfer.getValue(),
+                 perfTimerPreprocess.getPercentile(99.0f), perfTimerInfer.getPercentile(99.0f)};
 }
 
 void IEGraph::printPerformanceCounts(std::string fullDeviceName) {
-    ::printPerformanceCounts(*availableRequests.front(), std::cout, fullDeviceName, false);
+    ::printPerformanceCounts(*availableRequests.front()->inferRequest, std::cout, fullDeviceName, false);
 }
@@ -13,6 +13,7 @@
 #include <functional>
 #include <atomic>
 #include <string>
+#include <map>
 #include <memory>
 
 #include <inference_engine.hpp>
@@ -23,6 +24,8 @@
 
 #include <samples/common.hpp>
 #include <samples/slog.hpp>
+#include <replay/replay.hpp>
+#include <tracing/tracing.hpp>
 #include "perf_timer.hpp"
 #include "input.hpp"
 
@@ -50,12 +53,23 @@ private:
     std::string deviceName;
 
     InferenceEngine::Core ie;
-    std::queue<InferenceEngine::InferRequest::Ptr> availableRequests;
+    std::shared_ptr<OutputsRecorder> recorder;
+    std::shared_ptr<OutputsReplayer> replayer;
+
+    struct Request {
+        InferenceEngine::InferRequest::Ptr inferRequest;  // null if the outputs are replayed
+        InferenceEngine::Blob::Ptr input;
+        tracing::Track track;  // timeline of the request for tracing
+        std::chrono::steady_clock::time_point replayEndTime;  // when the replayed outputs are ready
+    };
+    std::vector<std::unique_ptr<Request>> requests;
+    std::queue<Request*> availableRequests;
 
     struct BatchRequestDesc {
         std::vector<std::shared_ptr<VideoFrame>> vfPtrVec;
-        InferenceEngine::InferRequest::Ptr req;
+        Request* req;
         std::chrono::high_resolution_clock::time_point startTime;
+        tracing::Clock::time_point traceStartTime;
     };
     std::queue<BatchRequestDesc> busyBatchRequests;
 
@@ -67,15 +81,19 @@ private:
     std::condition_variable condVarAvailableRequests;
     std::condition_variable condVarBusyRequests;
 
+public:
     using GetterFunc = std::function<bool(VideoFrame&)>;
+    using PostprocessingFunc = std::function<std::vector<Detections>(const InferenceEngine::BlobMap&, const std::vector<std::string>&, cv::Size)>;
+    using PostLoadFunc = std::function<void (const std::vector<std::string>&, InferenceEngine::CNNNetwork&)>;
+
+private:
     GetterFunc getter;
-    using PostprocessingFunc = std::function<std::vector<Detections>(InferenceEngine::InferRequest::Ptr, const std::vector<std::string>&, cv::Size)>;
     PostprocessingFunc postprocessing;
-    using PostLoadFunc = std::function<void (const std::vector<std::string>&, InferenceEngine::CNNNetwork&)>;
     PostLoadFunc postLoad;
     std::thread getterThread;
 
-    void initNetwork(const std::string& deviceName);
+    void initNetwork(const std::string& deviceName, const std::map<std::string, std::string>& config);
+    void initReplay();
 
 public:
     struct InitParams {
@@ -88,6 +106,12 @@ public:
         std::string cldnnConfigPath;
         std::string deviceName;
         PostLoadFunc postLoadFunc = nullptr;
+        std::map<std::string, std::string> config;  // passed to LoadNetwork()
+        // Records the outputs of the requests, keyed by the channel and the frame of the first frame of a batch
+        std::shared_ptr<OutputsRecorder> recorder;
+        // Replaces the device, the outputs of a batch are the recorded ones for its first frame. The model is
+        // read only if modelPath is set, postLoadFunc isn't called otherwise
+        std::shared_ptr<OutputsReplayer> replayer;
     };
 
     explicit IEGraph(const InitParams& p);
@@ -96,9 +120,20 @@ public:
 
     bool isRunning();
 
+    ///
+    /// \brief Stops taking new frames. getBatchData() returns the frames being inferred
+    /// and then empty batches.
+    ///
+    void stop();
+
     InferenceEngine::SizeVector getInputDims() const;
 
-    std::vector<std::shared_ptr<VideoFrame>> getBatchData(cv::Size windowSize);
+    ///
+    /// \brief Returns the frames of the next inferred batch, or an empty batch if the graph is stopped
+    /// or no batch was inferred before the deadline.
+    ///
+    std::vector<std::shared_ptr<VideoFrame>> getBatchData(cv::Size windowSize,
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
 
     unsigned int getBatchSize() const;
 
@@ -109,6 +144,8 @@ public:
     struct Stats {
         float preprocessTime;
         float inferTime;
+        float preprocessTimeP99;
+        float inferTimeP99;
     };
 
     Stats getStats() const;
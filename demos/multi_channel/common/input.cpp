@@ -4,6 +4,7 @@
 
 #include "input.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -12,6 +13,8 @@
 #include <string>
 #include <utility>
 
+#include <tracing/tracing.hpp>
+
 #include "perf_timer.hpp"
 
 #include "decoder.hpp"
@@ -40,13 +43,30 @@ public:
 
     virtual bool read(VideoFrame& frame) = 0;
 
-    virtual float getAvgReadTime() const = 0;
+    ///
+    /// \brief Returns true if read() returns without waiting for a frame.
+    ///
+    virtual bool isReady();
+
+    virtual const PerfTimer& getReadTimer() const = 0;
 
     virtual ~VideoSource();
 };
 
+bool VideoSource::isReady() {
+    return true;
+}
+
 VideoSource::~VideoSource() {}
 
+// A frame decoded by the Decoder and waiting to be read
+struct DecodedFrame {
+    bool decoded;
+    cv::Mat frame;
+    int64_t frameIdx;
+    VideoFrame::Clock::time_point decodeTime;
+};
+
 #ifdef USE_LIBVA
 
 struct VideoStream {
@@ -135,7 +155,7 @@ struct VideoStream {
 };
 
 class VideoSourceStreamFile : public VideoSource {
-    using queue_elem_t = std::pair<bool, cv::Mat>;
+    using queue_elem_t = DecodedFrame;
     using queue_t = std::queue<queue_elem_t>;
 
     VideoSources& parent;
@@ -152,6 +172,7 @@ class VideoSourceStreamFile : public VideoSource {
 
     queue_t frameQueue;
     const std::size_t queueSize;
+    int64_t framesDecoded = 0;
 
     using clock = std::chrono::high_resolution_clock;
     clock::time_point lastFrameTime;
@@ -187,7 +208,7 @@ public:
                         parent.decoder.decode(stream.frame.ptr, stream.frame.length, stream.frame.width, stream.frame.height,
                             [this](cv::Mat&& img) mutable {
                             bool success = !img.empty();
-                            frameQueue.push({success, std::move(img)});
+                            frameQueue.push({success, std::move(img), framesDecoded++, VideoFrame::Clock::now()});
                             if (perfTimer.enabled()) {
                                 auto prev = lastFrameTime;
                                 auto current = clock::now();
@@ -199,6 +220,7 @@ public:
                             }
                             is_decoding = false;
                             condVar.notify_one();
+                            parent.notifyFrame();
                         });
                         stream.advance_frame();
                     }
@@ -221,6 +243,11 @@ public:
         }
     }
 
+    bool isReady() override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !frameQueue.empty() || !running;
+    }
+
     bool read(VideoFrame& frame)  {
         queue_elem_t elem;
 
@@ -236,47 +263,64 @@ public:
             frameQueue.pop();
         }
         condVar.notify_one();
-        frame.frame = std::move(elem.second);
+        frame.frame = std::move(elem.frame);
+        frame.frameIdx = elem.frameIdx;
+        frame.captureTime = elem.decodeTime;
 
-        return elem.first && running;
+        return elem.decoded && running;
     }
 
-    float getAvgReadTime() const {
-        return perfTimer.getValue();
+    const PerfTimer& getReadTimer() const {
+        return perfTimer;
     }
 };
 
 #endif
 
 class VideoSourceOCV : public VideoSource {
+    VideoSources& parent;
     PerfTimer perfTimer;
-    std::thread workThread;
     const bool isAsync;
     std::atomic_bool running = {true};
     std::string videoName;
 
     std::mutex mutex;
-    std::condition_variable condVar;
     std::condition_variable hasFrame;
-    std::queue<std::pair<bool, cv::Mat>> queue;
+    struct CapturedFrame {
+        bool captured;
+        cv::Mat frame;
+        int64_t frameIdx;
+        VideoFrame::Clock::time_point captureTime;
+    };
+    // Frames waiting to be read, a paced capture overwrites the oldest one if the ring is full
+    std::vector<CapturedFrame> ring;
+    size_t ringBegin = 0;
+    size_t ringSize = 0;
+    bool parked = false;  // the capture isn't paced and waits for space in the ring
+
+    size_t captureTask = 0;
+    VideoFrame::Clock::duration capturePeriod;  // zero if the capture isn't paced
+    VideoFrame::Clock::time_point nextCaptureTime;
 
     cv::VideoCapture source;
     bool loopVideo;
+    const int inputIdx;
+    int64_t framesRead = 0;
 
     bool realFps;
 
-    const size_t queueSize = 1;
     const size_t pollingTimeMSec = 1000;
 
     template<bool CollectStats>
     bool readFrame(cv::Mat& frame);
 
-    template<bool CollectStats>
-    void startImpl();
-
 public:
-    VideoSourceOCV(bool async, bool collectStats_, const std::string& name, bool loopVideo,
-                size_t queueSize_, size_t pollingTimeMSec_, bool realFps_);
+    ///
+    /// \param fps Rate of the asynchronous capture, 0 to capture when there is space for a frame,
+    /// negative for the frame rate reported by the input.
+    ///
+    VideoSourceOCV(VideoSources& p, bool async, bool collectStats_, const std::string& name, bool loopVideo,
+                size_t queueSize_, size_t pollingTimeMSec_, bool realFps_, int inputIdx, double fps);
 
     ~VideoSourceOCV();
 
@@ -286,22 +330,26 @@ public:
 
     void stop();
 
-    bool read(cv::Mat& frame);
     bool read(VideoFrame& frame);
 
-    float getAvgReadTime() const {
-        return perfTimer.getValue();
+    bool isReady() override;
+
+    const PerfTimer& getReadTimer() const {
+        return perfTimer;
     }
 
 private:
     template<bool CollectStats>
-    static void thread_fn(VideoSourceOCV*);
+    bool captureFrame(cv::Mat& frame, int64_t& frameIdx);
+
+    template<bool CollectStats>
+    void captureNext();
 };
 
 #ifdef USE_NATIVE_CAMERA_API
 class VideoSourceNative : public VideoSource {
     VideoSources& parent;
-    using queue_elem_t = std::pair<bool, cv::Mat>;
+    using queue_elem_t = DecodedFrame;
 #ifdef USE_TBB
     using queue_t = tbb::concurrent_bounded_queue<queue_elem_t>;
 #else
@@ -309,7 +357,7 @@ class VideoSourceNative : public VideoSource {
 #endif
     const int queueSize = 0;
     const bool realFps = false;
-    cv::Mat dummyFrame;
+    DecodedFrame dummyFrame = {};  // the last frame, read again while there are no new ones
     std::size_t frameIdx = 0;
     queue_t frameQueue;
     mcam::camera camera;
@@ -335,8 +383,8 @@ public:
 
     bool read(VideoFrame& frame);
 
-    float getAvgReadTime() const {
-        return perfTimer.getValue();
+    const PerfTimer& getReadTimer() const {
+        return perfTimer;
     }
 };
 
@@ -387,7 +435,7 @@ void VideoSourceNative::frameHandler(mcam::camera::frame_status status,
             [this, fr = std::move(frame)](cv::Mat&& img) mutable {
                 fr = {};
                 bool success = !img.empty();
-                frameQueue.push({success, std::move(img)});
+                frameQueue.push({success, std::move(img), static_cast<int64_t>(frameIdx++), VideoFrame::Clock::now()});
                 if (perfTimer.enabled()) {
                     auto prev = lastFrameTime;
                     auto current = clock::now();
@@ -398,6 +446,7 @@ void VideoSourceNative::frameHandler(mcam::camera::frame_status status,
 
                     lastFrameTime = current;
                 }
+                parent.notifyFrame();
             });
         }
     }
@@ -418,18 +467,20 @@ bool VideoSourceNative::read(VideoFrame& frame) {
 #else
         elem = std::move(frameQueue.front());
         frameQueue.pop();
-        if (elem.first) {
+        if (elem.decoded) {
 #endif
-            if (elem.first) {
-                dummyFrame = elem.second;
+            if (elem.decoded) {
+                dummyFrame = elem;
             }
         } else {
-            elem.first = (!dummyFrame.empty());
-            elem.second = dummyFrame;
+            elem = dummyFrame;
+            elem.decoded = !dummyFrame.frame.empty();
         }
     }
-    frame.frame = std::move(elem.second);
-    return elem.first;
+    frame.frame = std::move(elem.frame);
+    frame.frameIdx = elem.frameIdx;
+    frame.captureTime = elem.decodeTime;
+    return elem.decoded;
 }
 #endif  // USE_NATIVE_CAMERA_API
 
@@ -459,14 +510,17 @@ bool VideoSourceOCV::readFrame(cv::Mat& frame) {
     }
 }
 
-VideoSourceOCV::VideoSourceOCV(bool async, bool collectStats_,
+VideoSourceOCV::VideoSourceOCV(VideoSources& p, bool async, bool collectStats_,
                          const std::string& name, bool loopVideo, size_t queueSize_,
-                         size_t pollingTimeMSec_, bool realFps_):
+                         size_t pollingTimeMSec_, bool realFps_, int inputIdx, double fps):
+        parent(p),
         perfTimer(collectStats_ ? PerfTimer::DefaultIterationsCount : 0),
         isAsync(async), videoName(name),
+        ring(std::max<size_t>(queueSize_, 1)),
+        capturePeriod(VideoFrame::Clock::duration::zero()),
         loopVideo(loopVideo),
+        inputIdx(inputIdx),
         realFps(realFps_),
-        queueSize(queueSize_),
         pollingTimeMSec(pollingTimeMSec_) {
     if (isNumeric(videoName)) {
         if (!source.open(std::stoi(videoName))) {
@@ -478,6 +532,12 @@ VideoSourceOCV::VideoSourceOCV(bool async, bool collectStats_,
         }
     }
     source.set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    if (fps < 0.0) {
+        fps = source.get(cv::CAP_PROP_FPS);  // 0 if the backend doesn't know it
+    }
+    if (fps > 0.0) {
+        capturePeriod = std::chrono::duration_cast<VideoFrame::Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    }
 }
 
 VideoSourceOCV::~VideoSourceOCV() {
@@ -489,71 +549,123 @@ bool VideoSourceOCV::isRunning() const {
 }
 
 template<bool CollectStats>
-void VideoSourceOCV::thread_fn(VideoSourceOCV *vs) {
-    while (vs->running) {
-        cv::Mat frame;
-        const bool result = vs->readFrame<CollectStats>(frame);
-        if (!result) {
-            vs->running = false; // stop() also affects running, so override it only when out of frames
-        }
-        std::unique_lock<std::mutex> lock(vs->mutex);
-        vs->condVar.wait(lock, [&]() {
-            return vs->queue.size() < vs->queueSize || !vs->running; // queue has space or source ran out of frames
-        });
-        vs->queue.push({result, frame});
-        vs->hasFrame.notify_one();
-    }
+bool VideoSourceOCV::captureFrame(cv::Mat& frame, int64_t& frameIdx) {
+    frameIdx = framesRead++;
+    tracing::Scope scope("capture", inputIdx, frameIdx);
+    return readFrame<CollectStats>(frame);
 }
 
 template<bool CollectStats>
-void VideoSourceOCV::startImpl() {
-    if (isAsync) {
-        running = true;
-        workThread = std::thread(&VideoSourceOCV::thread_fn<CollectStats>, this);
+void VideoSourceOCV::captureNext() {
+    if (!running) {
+        return;
+    }
+    cv::Mat frame;
+    int64_t frameIdx;
+    const bool result = captureFrame<CollectStats>(frame, frameIdx);
+    const VideoFrame::Clock::time_point captureTime = VideoFrame::Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!result) {
+            running = false; // stop() also affects running, so override it only when out of frames
+        }
+        if (ring.size() == ringSize) {
+            ringBegin = (ringBegin + 1) % ring.size();
+            ringSize--;
+        }
+        ring[(ringBegin + ringSize) % ring.size()] = {result, frame, frameIdx, captureTime};
+        ringSize++;
+
+        if (running) {
+            if (VideoFrame::Clock::duration::zero() != capturePeriod) {
+                // a capture which fell behind goes on from now instead of catching up with a burst
+                nextCaptureTime = std::max(nextCaptureTime + capturePeriod, captureTime);
+                parent.captureExecutor.schedule(captureTask, nextCaptureTime);
+            } else if (ringSize < ring.size()) {
+                parent.captureExecutor.post(captureTask);
+            } else {
+                parked = true;
+            }
+        }
     }
+    hasFrame.notify_one();
+    parent.notifyFrame();
 }
 
 void VideoSourceOCV::start() {
-    if (perfTimer.enabled()) {
-        startImpl<true>();
-    } else {
-        startImpl<false>();
+    if (isAsync) {
+        running = true;
+        if (perfTimer.enabled()) {
+            captureTask = parent.captureExecutor.addTask([this]() { captureNext<true>(); });
+        } else {
+            captureTask = parent.captureExecutor.addTask([this]() { captureNext<false>(); });
+        }
+        nextCaptureTime = VideoFrame::Clock::now();
+        parent.captureExecutor.post(captureTask);
     }
 }
 
 void VideoSourceOCV::stop() {
     if (isAsync) {
-        running = false;
-        condVar.notify_one();
-        if (workThread.joinable()) {
-            workThread.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
         }
+        hasFrame.notify_all();
     }
 }
 
-bool VideoSourceOCV::read(cv::Mat& frame) {
+bool VideoSourceOCV::read(VideoFrame& frame) {
     if (isAsync) {
-        bool res;
-        {
-            std::unique_lock<std::mutex> lock(mutex);
-            hasFrame.wait(lock, [&]() {
-                return !queue.empty() || !running;
-            });
-            res = queue.front().first;
-            frame = queue.front().second;
-            if (realFps || queue.size() > 1 || queueSize == 1) {
-                queue.pop();
+        std::unique_lock<std::mutex> lock(mutex);
+        hasFrame.wait(lock, [&]() {
+            return 0 != ringSize || !running;
+        });
+        if (0 == ringSize) {
+            return false;
+        }
+        if (!realFps && ringSize > 1) {
+            // the latest frame wins, the older ones would only add latency
+            while (ringSize > 1) {
+                ring[ringBegin] = CapturedFrame();
+                ringBegin = (ringBegin + 1) % ring.size();
+                ringSize--;
+            }
+            if (parked) {
+                parked = false;
+                parent.captureExecutor.post(captureTask);
+            }
+        }
+        CapturedFrame& oldest = ring[ringBegin];
+        const bool res = oldest.captured;
+        frame.frame = oldest.frame;
+        frame.frameIdx = oldest.frameIdx;
+        frame.captureTime = oldest.captureTime;  // a frame read again keeps its time
+        if (realFps || ringSize > 1 || ring.size() == 1) {
+            oldest.frame = cv::Mat();
+            ringBegin = (ringBegin + 1) % ring.size();
+            ringSize--;
+            if (parked) {
+                parked = false;
+                parent.captureExecutor.post(captureTask);
             }
         }
-        condVar.notify_one();
         return res;
     } else {
-        return source.read(frame);
+        frame.frameIdx = framesRead++;
+        tracing::Scope scope("capture", inputIdx, frame.frameIdx);
+        const bool captured = source.read(frame.frame);
+        frame.captureTime = VideoFrame::Clock::now();
+        return captured;
     }
 }
 
-bool VideoSourceOCV::read(VideoFrame& frame) {
-    return read(frame.frame);
+bool VideoSourceOCV::isReady() {
+    if (isAsync) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return 0 != ringSize || !running;
+    }
+    return true;
 }
 
 namespace {
@@ -582,10 +694,13 @@ VideoSources::VideoSources(const InitParams& p):
     collectStats(p.collectStats),
     realFps(p.realFps),
     queueSize(p.queueSize),
-    pollingTimeMSec(p.pollingTimeMSec) {}
+    pollingTimeMSec(p.pollingTimeMSec),
+    captureThreads(p.captureThreads),
+    captureFps(p.captureFps) {}
 
 VideoSources::~VideoSources() {
-    // nothing
+    // the capture tasks refer to the inputs
+    captureExecutor.stop();
 }
 
 bool VideoSources::isRunning() const {
@@ -620,17 +735,24 @@ void VideoSources::openVideo(const std::string& source, bool native, bool loopVi
 #if defined(USE_LIBVA)
         const std::string extension = ".mjpeg";
         std::unique_ptr<VideoSource> newSrc;
-        if (source.size() > extension.size() && std::equal(extension.rbegin(), extension.rend(), source.rbegin()))
-            if (loopVideo)
+        if (source.size() > extension.size() && std::equal(extension.rbegin(), extension.rend(), source.rbegin())) {
+            if (loopVideo) {
                 throw std::runtime_error("Looping video is not supported for .mjpeg when built with USE_LIBVA");
+            }
             newSrc.reset(new VideoSourceStreamFile(*this, isAsync, collectStats, source,
                                             queueSize, pollingTimeMSec, realFps));
-        else
-            newSrc.reset(new VideoSourceOCV(isAsync, collectStats, source, loopVideo,
-                                            queueSize, pollingTimeMSec, realFps));
+        } else {
+            // only the inputs read by cv::VideoCapture are captured by the shared pool
+            newSrc.reset(new VideoSourceOCV(*this, isAsync, collectStats, source, loopVideo,
+                                            queueSize, pollingTimeMSec, realFps, static_cast<int>(inputs.size()),
+                                            captureFps));
+            capturedInputsCount++;
+        }
 #else
-        std::unique_ptr<VideoSource> newSrc(new VideoSourceOCV(isAsync, collectStats, source, loopVideo,
-                                            queueSize, pollingTimeMSec, realFps));
+        std::unique_ptr<VideoSource> newSrc(new VideoSourceOCV(*this, isAsync, collectStats, source, loopVideo,
+                                            queueSize, pollingTimeMSec, realFps, static_cast<int>(inputs.size()),
+                                            captureFps));
+        capturedInputsCount++;
 #endif
         inputs.emplace_back(std::move(newSrc));
     }
@@ -640,6 +762,37 @@ void VideoSources::start() {
     for (auto& input : inputs) {
         input->start();
     }
+    if (isAsync && 0 != capturedInputsCount) {
+        size_t threadsCount = captureThreads;
+        if (0 == threadsCount) {
+            threadsCount = std::min<size_t>(capturedInputsCount, std::max(std::thread::hardware_concurrency(), 1u));
+        }
+        captureExecutor.start(threadsCount);
+    }
+}
+
+bool VideoSources::isFrameReady(size_t index) {
+    return index < inputs.size() && inputs[index]->isReady();
+}
+
+uint64_t VideoSources::getFramesCount() const {
+    std::lock_guard<std::mutex> lock(framesMutex);
+    return framesCount;
+}
+
+void VideoSources::waitForFrames(uint64_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(framesMutex);
+    framesCondVar.wait_for(lock, timeout, [&]() {
+        return framesCount != count;
+    });
+}
+
+void VideoSources::notifyFrame() {
+    {
+        std::lock_guard<std::mutex> lock(framesMutex);
+        framesCount++;
+    }
+    framesCondVar.notify_all();
 }
 
 bool VideoSources::getFrame(size_t index, VideoFrame& frame) {
@@ -655,10 +808,15 @@ VideoSources::Stats VideoSources::getStats() const {
     Stats ret;
     if (collectStats) {
         ret.readTimes.reserve(inputs.size());
+        ret.readTimesP99.reserve(inputs.size());
         for (auto& input : inputs) {
-            ret.readTimes.push_back(input->getAvgReadTime());
+            const PerfTimer& readTimer = input->getReadTimer();
+            ret.readTimes.push_back(readTimer.getValue());
+            ret.readTimesP99.push_back(readTimer.getPercentile(99.0f));
         }
-        ret.decodingLatency = decoder.getStats().decoding_latency;
+        const Decoder::Stats decoderStats = decoder.getStats();
+        ret.decodingLatency = decoderStats.decoding_latency;
+        ret.decodingLatencyP99 = decoderStats.decoding_latency_p99;
     }
     return ret;
 }
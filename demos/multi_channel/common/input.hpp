@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <thread>
@@ -19,6 +20,7 @@
 #include "multicam/controller.hpp"
 #endif
 
+#include "capture_executor.hpp"
 #include "decoder.hpp"
 
 class Detections {
@@ -35,9 +37,18 @@ private:
 
 class VideoFrame final {
 public:
+    using Clock = std::chrono::steady_clock;
+
     cv::Mat frame;
     std::size_t sourceIdx = 0;
+    int64_t frameIdx = -1;  // index of the frame in its input if it is known
     Detections detections;
+
+    // When the frame passed the stages of the pipeline, default if it is unknown
+    Clock::time_point captureTime;  // captured or decoded by the input
+    Clock::time_point readTime;  // taken from the input for preprocessing
+    Clock::time_point inferStartTime;
+    Clock::time_point inferEndTime;  // inferred and postprocessed
     VideoFrame() = default;
 
     VideoFrame& operator =(VideoFrame const& vf) = delete;
@@ -57,7 +68,9 @@ private:
 
     std::mutex decode_mutex;  // hardware decoding enqueue lock
 
+    CaptureExecutor captureExecutor;  // captures the frames of the cv::VideoCapture inputs
     std::vector<std::unique_ptr<VideoSource>> inputs;
+    size_t capturedInputsCount = 0;
     const bool isAsync;
     const bool collectStats;
 
@@ -65,8 +78,16 @@ private:
 
     const size_t queueSize = 1;
     const size_t pollingTimeMSec = 1000;
+    const size_t captureThreads;
+    const double captureFps;
+
+    // Frames produced by all inputs, for a reader waiting for any of them
+    mutable std::mutex framesMutex;
+    std::condition_variable framesCondVar;
+    uint64_t framesCount = 0;
 
     void stop();
+    void notifyFrame();
 
     friend VideoSourceNative;
     friend VideoSourceOCV;
@@ -79,6 +100,8 @@ public:
         bool isAsync = true;
         bool collectStats = false;
         bool realFps = false;
+        std::size_t captureThreads = 0;  // 0 for a thread per input, up to the number of CPUs
+        double captureFps = 0.0;  // 0 to capture as fast as the frames are read, negative for the frame rate of the inputs
         unsigned expectedWidth = 0;
         unsigned expectedHeight = 0;
     };
@@ -94,9 +117,26 @@ public:
 
     bool getFrame(size_t index, VideoFrame& frame);
 
+    ///
+    /// \brief Returns true if getFrame() for the input returns without waiting for a frame.
+    ///
+    bool isFrameReady(size_t index);
+
+    ///
+    /// \brief Returns the number of frames produced by the inputs so far.
+    ///
+    uint64_t getFramesCount() const;
+
+    ///
+    /// \brief Waits until the inputs produce more frames than the count or the timeout expires.
+    ///
+    void waitForFrames(uint64_t count, std::chrono::milliseconds timeout);
+
     struct Stats {
         std::vector<float> readTimes;
+        std::vector<float> readTimesP99;
         float decodingLatency = 0.0f;
+        float decodingLatencyP99 = 0.0f;
     };
 
     Stats getStats() const;
@@ -0,0 +1,82 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "latency_tracker.hpp"
+
+namespace {
+bool isKnown(VideoFrame::Clock::time_point time) {
+    return VideoFrame::Clock::time_point() != time;
+}
+
+void addHop(PerfTimer& timer, VideoFrame::Clock::time_point begin, VideoFrame::Clock::time_point end) {
+    if (timer.enabled() && isKnown(begin) && isKnown(end)) {
+        timer.addValue(end - begin);
+    }
+}
+
+LatencyTracker::HopStats getHopStats(const PerfTimer& timer) {
+    return {timer.getValue(), timer.getPercentile(99.0f)};
+}
+}  // namespace
+
+LatencyTracker::LatencyTracker(bool collectStats):
+    minCount(collectStats ? PerfTimer::DefaultIterationsCount : 0),
+    inputQueueTimer(minCount),
+    preprocessTimer(minCount),
+    inferenceTimer(minCount),
+    outputTimer(minCount) {}
+
+LatencyTracker::Channel& LatencyTracker::getChannel(std::size_t channel) {
+    std::unique_ptr<Channel>& result = channels[channel];
+    if (!result) {
+        result.reset(new Channel(minCount));
+    }
+    return *result;
+}
+
+void LatencyTracker::addReceived(const VideoFrame& frame) {
+    if (frame.frameIdx < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Channel& channel = getChannel(frame.sourceIdx);
+    if (frame.frameIdx <= channel.lastFrameIdx) {
+        channel.repeated++;
+        return;
+    }
+    if (channel.lastFrameIdx >= 0) {
+        channel.skipped += static_cast<uint64_t>(frame.frameIdx - channel.lastFrameIdx - 1);
+    }
+    channel.lastFrameIdx = frame.frameIdx;
+}
+
+void LatencyTracker::addDisplayed(const VideoFrame& frame, VideoFrame::Clock::time_point displayTime) {
+    addHop(inputQueueTimer, frame.captureTime, frame.readTime);
+    addHop(preprocessTimer, frame.readTime, frame.inferStartTime);
+    addHop(inferenceTimer, frame.inferStartTime, frame.inferEndTime);
+    addHop(outputTimer, frame.inferEndTime, displayTime);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Channel& channel = getChannel(frame.sourceIdx);
+    channel.displayed++;
+    addHop(channel.latency, frame.captureTime, displayTime);
+}
+
+void LatencyTracker::addDropped(const VideoFrame& frame) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Channel& channel = getChannel(frame.sourceIdx);
+    channel.dropped++;
+}
+
+LatencyTracker::Stats LatencyTracker::getStats() const {
+    Stats stats{getHopStats(inputQueueTimer), getHopStats(preprocessTimer),
+                getHopStats(inferenceTimer), getHopStats(outputTimer), {}};
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& channel : channels) {
+        const Channel& c = *channel.second;
+        stats.channels.push_back({channel.first, c.latency.getValue(), c.latency.getPercentile(99.0f),
+                                  c.displayed, c.dropped, c.skipped, c.repeated});
+    }
+    return stats;
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "input.hpp"
+#include "perf_timer.hpp"
+
+///
+/// \brief Collects how old frames are when they are displayed and how many of them are lost.
+///
+/// The latency is measured from the capture or decoding of a frame by its input, the time
+/// between the stages it passed is reported for all channels together. A frame is skipped if
+/// it never reached the output, so its channel displays the next frame of the input, dropped
+/// if the output discarded it, and repeated if the input gave it to the channel once more
+/// because there was no new frame yet. Channels duplicating an input share its frames, so
+/// each of them skips the frames given to the others.
+///
+class LatencyTracker {
+public:
+    explicit LatencyTracker(bool collectStats);
+
+    ///
+    /// \brief Counts the skipped and repeated frames, must be called in the order the frames reach the output.
+    ///
+    void addReceived(const VideoFrame& frame);
+
+    void addDisplayed(const VideoFrame& frame, VideoFrame::Clock::time_point displayTime);
+
+    void addDropped(const VideoFrame& frame);
+
+    struct ChannelStats {
+        std::size_t channel;
+        float latency;
+        float latencyP99;
+        uint64_t displayed;
+        uint64_t dropped;
+        uint64_t skipped;
+        uint64_t repeated;
+    };
+
+    struct HopStats {
+        float mean;
+        float p99;
+    };
+
+    struct Stats {
+        HopStats inputQueue;  // from the capture to preprocessing
+        HopStats preprocess;  // batching and preprocessing
+        HopStats inference;  // inference and postprocessing
+        HopStats output;  // waiting for the display and rendering
+        std::vector<ChannelStats> channels;
+    };
+
+    Stats getStats() const;
+
+private:
+    struct Channel {
+        explicit Channel(size_t minCount): latency(minCount) {}
+
+        PerfTimer latency;
+        uint64_t displayed = 0;
+        uint64_t dropped = 0;
+        uint64_t skipped = 0;
+        uint64_t repeated = 0;
+        int64_t lastFrameIdx = -1;
+    };
+
+    Channel& getChannel(std::size_t channel);
+
+    const size_t minCount;
+    PerfTimer inputQueueTimer;
+    PerfTimer preprocessTimer;
+    PerfTimer inferenceTimer;
+    PerfTimer outputTimer;
+
+    mutable std::mutex mutex;
+    std::map<std::size_t, std::unique_ptr<Channel>> channels;
+};
@@ -31,6 +31,26 @@ static const char real_input_fps[] = "Optional. Disable input frames caching, fo
 static const char input_video[] = "Optional. Specify full path to input video files";
 static const char loop_video_output_message[] = "Optional. Enable playing video on a loop.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char trace_message[] = "Optional. Save the timeline of capture, inference and rendering of frames to the specified file "
+                                    "in the Chrome trace event format, which chrome://tracing and ui.perfetto.dev open.";
+static const char shards_message[] = "Optional. Number of shards to split the channels to. Every shard has its own copy of the network "
+                                     "and its own inputs and runs on the cores of one NUMA node. 0 means one shard per NUMA node. "
+                                     "Default value is 1.";
+static const char latency_budget_message[] = "Optional. Discard the frames which are older than the specified number of msec "
+                                             "when they are ready to be displayed. 0 disables it. Default value is 0.";
+static const char capture_threads_message[] = "Optional. Number of threads capturing the frames of all inputs. "
+                                              "Default value is 0, which means a thread per input, up to the number of CPUs.";
+static const char input_fps_message[] = "Optional. Capture every input at the specified number of frames per second, dropping the oldest "
+                                        "frame if it is not read in time. -1 uses the frame rate of the input. "
+                                        "Default value is 0, which captures frames as fast as they are read.";
+static const char channel_weights_message[] = "Optional. Comma-separated numbers of frames every channel gives to a batch at its turn, "
+                                              "relative to the other channels. The channels not listed get 1.";
+static const char record_message[] = "Optional. Save the outputs of the network for every batch to the specified file, "
+                                     "keyed by the channel and the frame, to replay them with -replay.";
+static const char replay_message[] = "Optional. Take the outputs of the network from the specified file saved with -record "
+                                     "instead of running inference. The device isn't used. Channels and frames which weren't "
+                                     "recorded get the outputs of the recorded ones in a loop.";
+static const char replay_latency_message[] = "Optional. Time in msec every replayed request takes. Default value is 0.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(m, "", model_path_message);
@@ -51,3 +71,12 @@ DEFINE_bool(real_input_fps, false, real_input_fps);
 DEFINE_string(i, "", input_video);
 DEFINE_bool(loop_video, false, loop_video_output_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_string(trace, "", trace_message);
+DEFINE_uint32(shards, 1, shards_message);
+DEFINE_uint32(latency_budget, 0, latency_budget_message);
+DEFINE_uint32(capture_threads, 0, capture_threads_message);
+DEFINE_int32(input_fps, 0, input_fps_message);
+DEFINE_string(channel_weights, "", channel_weights_message);
+DEFINE_string(record, "", record_message);
+DEFINE_string(replay, "", replay_message);
+DEFINE_double(replay_latency, 0.0, replay_latency_message);
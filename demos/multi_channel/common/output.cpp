@@ -2,17 +2,24 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <vector>
 #include <utility>
 
+#include <tracing/tracing.hpp>
+
 #include "output.hpp"
 
 AsyncOutput::AsyncOutput(bool collectStats, size_t queueSize,
+                         std::chrono::milliseconds latencyBudget,
                          DrawFunc drawFunc):
     queueSize(queueSize),
+    latencyBudget(latencyBudget),
     drawFunc(std::move(drawFunc)),
-    perfTimer(collectStats ? PerfTimer::DefaultIterationsCount : 0) {}
+    perfTimer(collectStats ? PerfTimer::DefaultIterationsCount : 0),
+    latencyTracker(collectStats) {}
 
 AsyncOutput::~AsyncOutput() {
     terminate = true;
@@ -23,8 +30,33 @@ AsyncOutput::~AsyncOutput() {
 }
 
 void AsyncOutput::push(std::vector<std::shared_ptr<VideoFrame> > &&item) {
+    const auto now = VideoFrame::Clock::now();
+    for (const auto& vframe : item) {
+        latencyTracker.addReceived(*vframe);
+    }
+    if (latencyBudget > std::chrono::milliseconds::zero()) {
+        // the fresh frames of the batch are still displayed, the stale ones would only delay them
+        std::vector<std::shared_ptr<VideoFrame>> stale;
+        auto freshEnd = std::stable_partition(item.begin(), item.end(), [&](const std::shared_ptr<VideoFrame>& vframe) {
+            return VideoFrame::Clock::time_point() == vframe->captureTime || now - vframe->captureTime <= latencyBudget;
+        });
+        std::move(freshEnd, item.end(), std::back_inserter(stale));
+        item.erase(freshEnd, item.end());
+        drop(stale);
+        if (item.empty()) {
+            return;
+        }
+    }
+    if (!drawFunc) {
+        for (const auto& vframe : item) {
+            latencyTracker.addDisplayed(*vframe, now);
+        }
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(mutex);
     while (queue.size() >= queueSize) {
+        drop(queue.front());
         queue.pop();
     }
     queue.push(std::move(item));
@@ -34,6 +66,7 @@ void AsyncOutput::push(std::vector<std::shared_ptr<VideoFrame> > &&item) {
 
 void AsyncOutput::start() {
     thread = std::thread([&]() {
+        tracing::setThreadName("render");
         std::vector<std::shared_ptr<VideoFrame>> elem;
         while (!terminate) {
             std::unique_lock<std::mutex> lock(mutex);
@@ -48,6 +81,11 @@ void AsyncOutput::start() {
             queue.pop();
             lock.unlock();
 
+            tracing::Scope scope("render");
+            for (const auto& vframe : elem) {
+                tracing::mark(static_cast<int>(vframe->sourceIdx), vframe->frameIdx);
+            }
+
             if (perfTimer.enabled()) {
                 ScopedTimer sc(perfTimer);
                 if (!drawFunc(elem)) {
@@ -58,6 +96,11 @@ void AsyncOutput::start() {
                     terminate = true;
                 }
             }
+
+            const auto displayTime = VideoFrame::Clock::now();
+            for (const auto& vframe : elem) {
+                latencyTracker.addDisplayed(*vframe, displayTime);
+            }
         }
     });
 }
@@ -67,5 +110,47 @@ bool AsyncOutput::isAlive() const {
 }
 
 AsyncOutput::Stats AsyncOutput::getStats() const {
-    return Stats{perfTimer.getValue()};
+    return Stats{perfTimer.getValue(), perfTimer.getPercentile(99.0f), latencyTracker.getStats()};
+}
+
+void AsyncOutput::drop(const std::vector<std::shared_ptr<VideoFrame>>& item) {
+    for (const auto& vframe : item) {
+        latencyTracker.addDropped(*vframe);
+    }
+}
+
+DisplayBatcher::DisplayBatcher(size_t channelsCount, std::chrono::milliseconds interval):
+    interval(interval), frames(channelsCount) {}
+
+bool DisplayBatcher::add(std::shared_ptr<VideoFrame>&& frame) {
+    const auto now = std::chrono::steady_clock::now();
+    if (frame->sourceIdx >= frames.size()) {
+        frames.resize(frame->sourceIdx + 1);
+    }
+    std::shared_ptr<VideoFrame>& waiting = frames[frame->sourceIdx];
+    if (!waiting) {
+        if (0 == waitingCount) {
+            firstWaitingTime = now;
+        }
+        waitingCount++;
+    }
+    waiting = std::move(frame);
+    return waitingCount == frames.size() || now - firstWaitingTime >= interval;
+}
+
+std::chrono::steady_clock::time_point DisplayBatcher::getDeadline() const {
+    return empty() ? std::chrono::steady_clock::time_point::max() : firstWaitingTime + interval;
+}
+
+std::vector<std::shared_ptr<VideoFrame>> DisplayBatcher::take() {
+    std::vector<std::shared_ptr<VideoFrame>> result;
+    result.reserve(waitingCount);
+    for (auto& frame : frames) {
+        if (frame) {
+            result.push_back(std::move(frame));
+            frame.reset();
+        }
+    }
+    waitingCount = 0;
+    return result;
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <queue>
 #include <vector>
 #include <thread>
@@ -14,24 +15,34 @@
 #include <memory>
 
 #include "graph.hpp"
+#include "latency_tracker.hpp"
 #include "perf_timer.hpp"
 
 class AsyncOutput{
 public:
     using DrawFunc = std::function<bool(const std::vector<std::shared_ptr<VideoFrame>>&)>;
 
-    AsyncOutput(bool collectStats, size_t queueSize, DrawFunc drawFunc);
+    ///
+    /// \param latencyBudget Frames older than the budget are discarded by push(), zero disables it.
+    /// \param drawFunc Renders the frames, if it is empty the frames count as displayed when pushed.
+    ///
+    AsyncOutput(bool collectStats, size_t queueSize, std::chrono::milliseconds latencyBudget, DrawFunc drawFunc);
     ~AsyncOutput();
     void push(std::vector<std::shared_ptr<VideoFrame>>&& item);
     void start();
     bool isAlive() const;
     struct Stats {
         float renderTime;
+        float renderTimeP99;
+        LatencyTracker::Stats latency;
     };
     Stats getStats() const;
 
 private:
+    void drop(const std::vector<std::shared_ptr<VideoFrame>>& item);
+
     const size_t queueSize;
+    const std::chrono::milliseconds latencyBudget;
     DrawFunc drawFunc;
     std::queue<std::vector<std::shared_ptr<VideoFrame>>> queue;
     std::atomic_bool terminate = {false};
@@ -40,4 +51,44 @@ private:
     std::condition_variable condVar;
 
     PerfTimer perfTimer;
+    LatencyTracker latencyTracker;
+};
+
+///
+/// \brief Collects inferred frames for AsyncOutput, keeping the latest frame of every channel.
+///
+/// ChannelMultiplexer serves the channels out of order, several times in a row and skips the
+/// stalled ones, so the frames are sent when every channel has a new one or when the interval
+/// since the first frame waiting has passed. A stalled channel delays the others by the
+/// interval at most. A frame replaced by a newer one of its channel is never received by the
+/// output, so LatencyTracker counts it as skipped.
+///
+class DisplayBatcher {
+public:
+    DisplayBatcher(size_t channelsCount, std::chrono::milliseconds interval);
+
+    ///
+    /// \brief Adds a frame, replacing the waiting frame of its channel.
+    /// \return True if the waiting frames should be taken.
+    ///
+    bool add(std::shared_ptr<VideoFrame>&& frame);
+
+    ///
+    /// \brief Returns the waiting frames ordered by channel.
+    ///
+    std::vector<std::shared_ptr<VideoFrame>> take();
+
+    bool empty() const { return 0 == waitingCount; }
+
+    ///
+    /// \brief Returns the time the waiting frames should be taken at even if no new frame comes,
+    /// or time_point::max() if no frame is waiting.
+    ///
+    std::chrono::steady_clock::time_point getDeadline() const;
+
+private:
+    const std::chrono::milliseconds interval;
+    std::vector<std::shared_ptr<VideoFrame>> frames;  // by channel
+    size_t waitingCount = 0;
+    std::chrono::steady_clock::time_point firstWaitingTime;
 };
@@ -4,15 +4,112 @@
 
 #include "perf_timer.hpp"
 
-PerfTimer::PerfTimer(size_t maxCount_):
-    maxCount(maxCount_) {
-    values.reserve(maxCount);
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+constexpr uint64_t PerfTimer::SubBucketsCount;
+constexpr size_t PerfTimer::BucketsCount;
+constexpr size_t PerfTimer::ShardsCount;
+
+namespace {
+// Threads are spread over the shards in the order they first add a value
+size_t threadShard(size_t shardsCount) {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed);
+    return shard % shardsCount;
+}
+}  // namespace
+
+PerfTimer::PerfTimer(size_t minCount_):
+    minCount(minCount_) {
+    if (enabled()) {
+        // value-initialization zeroes the counters
+        shards.reset(new Shard[ShardsCount]());
+    }
+}
+
+void PerfTimer::addMicroseconds(uint64_t value) {
+    unsigned shift = 0;
+    while (shift <= MaxShift && (value >> shift) >= 2 * SubBucketsCount) {
+        shift++;
+    }
+    // values below 2 * SubBucketsCount get buckets of their own
+    const size_t bucket = shift > MaxShift ? BucketsCount - 1
+                                           : static_cast<size_t>(shift * SubBucketsCount + (value >> shift));
+
+    Shard& shard = shards[threadShard(ShardsCount)];
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (max < value && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t PerfTimer::getCount() const {
+    uint64_t count = 0;
+    for (size_t i = 0; enabled() && i < ShardsCount; i++) {
+        count += shards[i].count.load(std::memory_order_relaxed);
+    }
+    return count;
 }
 
 float PerfTimer::getValue() const {
-    return avgValue;
+    const uint64_t count = getCount();
+    // a disabled timer has no shards and a minimal count of 0
+    if (!enabled() || 0 == count || count < minCount) {
+        return 0.0f;
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < ShardsCount; i++) {
+        sum += shards[i].sum.load(std::memory_order_relaxed);
+    }
+    return static_cast<float>(sum) / count / 1000.0f;
+}
+
+float PerfTimer::getPercentile(float percent) const {
+    const uint64_t totalCount = getCount();
+    if (!enabled() || 0 == totalCount || totalCount < minCount) {
+        return 0.0f;
+    }
+    if (percent >= 100.0f) {
+        return getMax();
+    }
+    std::vector<uint64_t> buckets(BucketsCount);
+    uint64_t count = 0;
+    for (size_t i = 0; i < ShardsCount; i++) {
+        for (size_t bucket = 0; bucket < BucketsCount; bucket++) {
+            uint64_t bucketCount = shards[i].buckets[bucket].load(std::memory_order_relaxed);
+            buckets[bucket] += bucketCount;
+            count += bucketCount;
+        }
+    }
+    const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percent / 100.0f * count)), 1);
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    while (bucket < BucketsCount - 1 && (seen += buckets[bucket]) < rank) {
+        bucket++;
+    }
+
+    // the middle of the bucket, but not above the real maximum
+    const size_t shift = bucket < 2 * SubBucketsCount ? 0 : bucket / SubBucketsCount - 1;
+    const uint64_t lowest = (bucket - shift * SubBucketsCount) << shift;
+    const float value = (lowest + ((uint64_t(1) << shift) - 1) / 2.0f) / 1000.0f;
+    return std::min(value, getMax());
+}
+
+float PerfTimer::getMax() const {
+    const uint64_t count = getCount();
+    if (!enabled() || 0 == count || count < minCount) {
+        return 0.0f;
+    }
+    uint64_t max = 0;
+    for (size_t i = 0; i < ShardsCount; i++) {
+        max = std::max(max, shards[i].max.load(std::memory_order_relaxed));
+    }
+    return max / 1000.0f;
 }
 
 bool PerfTimer::enabled() const {
-    return maxCount > 0;
+    return minCount > 0;
 }
@@ -4,40 +4,76 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cassert>
-#include <vector>
 #include <chrono>
-#include <atomic>
-#include <numeric>
+#include <cstdint>
+#include <memory>
 
+///
+/// \brief Collects durations to a log-linear histogram.
+///
+/// Every power-of-two range of microseconds is divided to SubBucketsCount
+/// buckets, so the reported values are within about 3% of the real ones.
+/// Writers update atomic counters of their own shard and may run on any
+/// threads concurrently. The shards are merged when the statistics are read.
+///
 class PerfTimer final {
-    const size_t maxCount;
-    using duration = std::chrono::duration<float, std::milli>;
-    std::vector<duration> values;
-    std::atomic<float> avgValue = {0.0f};
+    static constexpr unsigned SubBucketBits = 5;
+    static constexpr uint64_t SubBucketsCount = 1 << SubBucketBits;
+    static constexpr unsigned MaxShift = 26;  // durations up to about 35 minutes
+    static constexpr size_t BucketsCount = (MaxShift + 2) * SubBucketsCount;
+    static constexpr size_t ShardsCount = 8;
+
+    struct Shard {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        std::array<std::atomic<uint32_t>, BucketsCount> buckets;
+    };
+
+    const size_t minCount;
+    std::unique_ptr<Shard[]> shards;
+
+    void addMicroseconds(uint64_t value);
+    uint64_t getCount() const;
 
 public:
     enum {
         DefaultIterationsCount = 50
     };
 
-    explicit PerfTimer(size_t maxCount_);
+    ///
+    /// \brief Creates the timer.
+    /// \param minCount_ Number of values to collect before the statistics
+    /// are reported. The timer is disabled if it is 0.
+    ///
+    explicit PerfTimer(size_t minCount_);
 
     template<typename T>
     void addValue(const T& dur) {
         assert(enabled());
-        values.push_back(std::chrono::duration_cast<duration>(dur));
-        if (values.size() >= maxCount) {
-            auto res = std::accumulate(values.begin(),
-                                       values.end(),
-                                       duration(0.0f));
-            avgValue = res.count() / static_cast<float>(values.size());
-            values.clear();
-        }
+        auto value = std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
+        addMicroseconds(value > 0 ? static_cast<uint64_t>(value) : 0);
     }
 
+    ///
+    /// \brief Returns the mean of all values in milliseconds.
+    ///
     float getValue() const;
 
+    ///
+    /// \brief Returns the percentile of all values in milliseconds.
+    /// \param percent Percentile, for example 99.
+    ///
+    float getPercentile(float percent) const;
+
+    ///
+    /// \brief Returns the maximum of all values in milliseconds.
+    ///
+    float getMax() const;
+
     bool enabled() const;
 };
 
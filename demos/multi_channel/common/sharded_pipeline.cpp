@@ -0,0 +1,265 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "sharded_pipeline.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <utility>
+
+#include <cpu_planner/cpu_planner.hpp>
+#include <tracing/tracing.hpp>
+
+ShardedPipeline::ShardedPipeline(const IEGraph::InitParams& graphParams, VideoSources::InitParams sourcesParams,
+                                 size_t shardsCount) {
+    const std::vector<CpuTopology> nodes = CpuTopology::read().splitByNodes();
+    if (0 == shardsCount) {
+        shardsCount = nodes.size();
+    }
+    std::vector<size_t> coresCounts(shardsCount);
+    for (size_t i = 0; i < shardsCount; i++) {
+        shards.emplace_back(new Shard);
+    }
+    if (shardsCount > 1) {
+        if (shardsCount <= nodes.size()) {
+            for (size_t node = 0; node < nodes.size(); node++) {
+                const std::vector<int> cpus = nodes[node].getCpus();
+                std::vector<int>& shardCpus = shards[node % shardsCount]->cpus;
+                shardCpus.insert(shardCpus.end(), cpus.begin(), cpus.end());
+                coresCounts[node % shardsCount] += nodes[node].cores.size();
+            }
+        } else {
+            // shards node, node + nodes.size(), ... split the cores of the node
+            for (size_t node = 0; node < nodes.size(); node++) {
+                const std::vector<CpuTopology::Core>& cores = nodes[node].cores;
+                const size_t nodeShardsCount = (shardsCount - node + nodes.size() - 1) / nodes.size();
+                for (size_t i = 0; i < nodeShardsCount; i++) {
+                    const size_t begin = cores.size() * i / nodeShardsCount;
+                    const size_t end = std::max(cores.size() * (i + 1) / nodeShardsCount, begin + 1);
+                    const size_t shard = node + i * nodes.size();
+                    for (size_t core = begin; core < end; core++) {
+                        shards[shard]->cpus.insert(shards[shard]->cpus.end(),
+                                                   cores[core].cpus.begin(), cores[core].cpus.end());
+                    }
+                    coresCounts[shard] = end - begin;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < shardsCount; i++) {
+        Shard& shard = *shards[i];
+        IEGraph::InitParams shardGraphParams = graphParams;
+        if (!shard.cpus.empty() && "CPU" == graphParams.deviceName) {
+            shardGraphParams.config[InferenceEngine::PluginConfigParams::KEY_CPU_THREADS_NUM] = std::to_string(coresCounts[i]);
+        }
+        // every shard has a Core of its own, so the inference threads of the plugin are created by the bound thread
+        runOnShard(shard, [&]() {
+            shard.graph.reset(new IEGraph(shardGraphParams));
+        });
+        if (!shard.cpus.empty()) {
+            slog::info << "Shard " << i << " runs on CPUs " << formatCpus(shard.cpus) << slog::endl;
+        }
+    }
+
+    const InferenceEngine::SizeVector inputDims = getInputDims();
+    if (4 != inputDims.size()) {
+        throw std::runtime_error("Invalid network input dimensions");
+    }
+    sourcesParams.expectedHeight = static_cast<unsigned>(inputDims[2]);
+    sourcesParams.expectedWidth = static_cast<unsigned>(inputDims[3]);
+    for (auto& shard : shards) {
+        runOnShard(*shard, [&]() {
+            shard->sources.reset(new VideoSources(sourcesParams));
+        });
+    }
+}
+
+ShardedPipeline::~ShardedPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    batchesCondVar.notify_all();
+    for (auto& shard : shards) {
+        if (shard->multiplexer) {
+            shard->multiplexer->stop();
+        }
+        shard->graph->stop();
+    }
+    for (auto& shard : shards) {
+        if (shard->collector.joinable()) {
+            shard->collector.join();
+        }
+    }
+    // the preprocessing thread of a graph reads the sources until the graph is destroyed
+    for (auto& shard : shards) {
+        shard->graph.reset();
+    }
+}
+
+size_t ShardedPipeline::getShardsCount() const {
+    return shards.size();
+}
+
+InferenceEngine::SizeVector ShardedPipeline::getInputDims() const {
+    return shards.front()->graph->getInputDims();
+}
+
+void ShardedPipeline::openVideo(const std::string& source, bool native, bool loopVideo) {
+    Shard& shard = **std::min_element(shards.begin(), shards.end(),
+        [](const std::unique_ptr<Shard>& a, const std::unique_ptr<Shard>& b) { return a->inputs.size() < b->inputs.size(); });
+    runOnShard(shard, [&]() {
+        shard.sources->openVideo(source, native, loopVideo);
+    });
+    shard.inputs.push_back(inputsCount++);
+}
+
+void ShardedPipeline::start(size_t duplicateFactor, IEGraph::PostprocessingFunc postprocessing,
+                            const std::vector<unsigned>& channelWeights) {
+    for (auto& shard : shards) {
+        if (shard->inputs.empty()) {
+            shard->graph->stop();  // there are more shards than inputs
+            continue;
+        }
+        std::vector<ChannelMultiplexer::Channel> channels;
+        for (size_t i = 0; i < shard->inputs.size(); i++) {
+            for (size_t j = 0; j < duplicateFactor; j++) {
+                const size_t channel = shard->inputs[i] * duplicateFactor + j;
+                channels.push_back({i, channel, channel < channelWeights.size() ? channelWeights[channel] : 1});
+            }
+        }
+        shard->multiplexer.reset(new ChannelMultiplexer(*shard->sources, channels));
+        ChannelMultiplexer* multiplexer = shard->multiplexer.get();
+        IEGraph::GetterFunc getter = [multiplexer](VideoFrame& img) {
+            return multiplexer->getFrame(img);
+        };
+        runOnShard(*shard, [&]() {
+            shard->sources->start();
+            shard->graph->start(std::move(getter), postprocessing);
+        });
+    }
+    lastStatsTime = std::chrono::steady_clock::now();
+}
+
+bool ShardedPipeline::isRunning() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (collectorsStarted) {
+            return 0 != runningCollectors || !batches.empty();
+        }
+    }
+    return std::any_of(shards.begin(), shards.end(), [](const std::unique_ptr<Shard>& shard) {
+        return !shard->inputs.empty() && (shard->sources->isRunning() || shard->graph->isRunning());
+    });
+}
+
+std::vector<std::shared_ptr<VideoFrame>> ShardedPipeline::getBatchData(cv::Size frameSize,
+                                                                       std::chrono::steady_clock::time_point deadline) {
+    if (1 == shards.size()) {
+        std::vector<std::shared_ptr<VideoFrame>> batch = shards.front()->graph->getBatchData(frameSize, deadline);
+        shards.front()->framesCount += batch.size();
+        return batch;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!collectorsStarted) {
+        collectorsStarted = true;
+        runningCollectors = shards.size();
+        for (size_t i = 0; i < shards.size(); i++) {
+            Shard* shard = shards[i].get();
+            shard->collector = std::thread([this, shard, frameSize, i]() {
+                bindCurrentThread(shard->cpus);  // postprocessing runs on the node of the shard
+                tracing::setThreadName("postprocess " + std::to_string(i));
+                collect(*shard, frameSize);
+            });
+        }
+    }
+    auto batchOrStopped = [&]() {
+        return !batches.empty() || 0 == runningCollectors;
+    };
+    if (std::chrono::steady_clock::time_point::max() == deadline) {
+        batchesCondVar.wait(lock, batchOrStopped);
+    } else {
+        batchesCondVar.wait_until(lock, deadline, batchOrStopped);
+    }
+    if (batches.empty()) {
+        return {};
+    }
+    std::vector<std::shared_ptr<VideoFrame>> batch = std::move(batches.front());
+    batches.pop_front();
+    lock.unlock();
+    batchesCondVar.notify_all();
+    return batch;
+}
+
+void ShardedPipeline::collect(Shard& shard, cv::Size frameSize) {
+    while (true) {
+        std::vector<std::shared_ptr<VideoFrame>> batch = shard.graph->getBatchData(frameSize);
+        if (batch.empty()) {
+            break;
+        }
+        shard.framesCount += batch.size();
+        std::unique_lock<std::mutex> lock(mutex);
+        // one waiting batch per shard keeps all shards busy without letting them run ahead of the display
+        batchesCondVar.wait(lock, [&]() {
+            return batches.size() < shards.size() || stopped;
+        });
+        if (!stopped) {
+            batches.push_back(std::move(batch));
+            lock.unlock();
+            batchesCondVar.notify_all();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        runningCollectors--;
+    }
+    batchesCondVar.notify_all();
+}
+
+void ShardedPipeline::setDetectionConfidence(float conf) {
+    for (auto& shard : shards) {
+        shard->graph->setDetectionConfidence(conf);
+    }
+}
+
+std::vector<ShardedPipeline::ShardStats> ShardedPipeline::getStats() {
+    const auto now = std::chrono::steady_clock::now();
+    const float seconds = std::chrono::duration_cast<std::chrono::duration<float>>(now - lastStatsTime).count();
+    lastStatsTime = now;
+    std::vector<ShardStats> stats;
+    for (auto& shard : shards) {
+        const uint64_t framesCount = shard->framesCount;
+        stats.push_back({formatCpus(shard->cpus),
+                         seconds > 0.0f ? (framesCount - shard->lastFramesCount) / seconds : 0.0f,
+                         shard->sources->getStats(),
+                         shard->graph->getStats(),
+                         shard->multiplexer ? shard->multiplexer->getStats()
+                                            : std::vector<ChannelMultiplexer::ChannelStats>()});
+        shard->lastFramesCount = framesCount;
+    }
+    return stats;
+}
+
+void ShardedPipeline::runOnShard(Shard& shard, const std::function<void()>& func) {
+    if (shard.cpus.empty()) {
+        func();
+        return;
+    }
+    std::exception_ptr error;
+    std::thread thread([&]() {
+        bindCurrentThread(shard.cpus);
+        try {
+            func();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    thread.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
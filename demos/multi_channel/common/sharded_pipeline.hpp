@@ -0,0 +1,106 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "channel_multiplexer.hpp"
+#include "graph.hpp"
+#include "input.hpp"
+
+///
+/// \brief Runs the channels of a demo on several shards, each with its own IEGraph and VideoSources.
+///
+/// If there are several shards, every shard is pinned to the cores of a NUMA node, or to a part
+/// of them if there are more shards than nodes. Decoding, preprocessing, inference and
+/// postprocessing of a shard run on threads inheriting the mask, so frames are allocated in the
+/// memory of the node which decodes, preprocesses and infers them. The results of all shards
+/// are merged into one stream of batches for the display. A single shard isn't pinned and
+/// behaves like a plain IEGraph with VideoSources.
+///
+class ShardedPipeline {
+public:
+    ///
+    /// \param shardsCount Number of shards, 0 for one shard per NUMA node.
+    /// \param sourcesParams Parameters of the inputs, their expected size is taken from the network.
+    ///
+    ShardedPipeline(const IEGraph::InitParams& graphParams, VideoSources::InitParams sourcesParams, size_t shardsCount);
+    ~ShardedPipeline();
+
+    size_t getShardsCount() const;
+
+    InferenceEngine::SizeVector getInputDims() const;
+
+    ///
+    /// \brief Opens an input on the shard which has the fewest of them.
+    ///
+    void openVideo(const std::string& source, bool native, bool loopVideo);
+
+    ///
+    /// \brief Starts the inputs and the inference.
+    /// \param duplicateFactor Number of channels reading every input. The channels of the input
+    /// opened k-th get indices from k * duplicateFactor to (k + 1) * duplicateFactor - 1.
+    /// \param channelWeights Frames a channel gives per turn, 1 for the channels not listed.
+    ///
+    void start(size_t duplicateFactor, IEGraph::PostprocessingFunc postprocessing,
+               const std::vector<unsigned>& channelWeights = {});
+
+    bool isRunning();
+
+    ///
+    /// \brief Returns the next inferred batch of any shard, an empty batch if all shards are stopped
+    /// or no batch was inferred before the deadline.
+    ///
+    std::vector<std::shared_ptr<VideoFrame>> getBatchData(cv::Size frameSize,
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    void setDetectionConfidence(float conf);
+
+    struct ShardStats {
+        std::string cpus;  // empty if the shard isn't pinned
+        float fps;  // frames inferred per second since the previous call
+        VideoSources::Stats input;
+        IEGraph::Stats infer;
+        std::vector<ChannelMultiplexer::ChannelStats> channels;
+    };
+
+    std::vector<ShardStats> getStats();
+
+private:
+    struct Shard {
+        std::vector<int> cpus;
+        std::unique_ptr<IEGraph> graph;
+        std::unique_ptr<VideoSources> sources;
+        std::unique_ptr<ChannelMultiplexer> multiplexer;
+        std::vector<size_t> inputs;  // global indices of the inputs of the shard
+        std::thread collector;
+        std::atomic<uint64_t> framesCount{0};
+        uint64_t lastFramesCount = 0;
+    };
+
+    // Runs the function on a thread bound to the CPUs of the shard, so threads it creates inherit the mask
+    void runOnShard(Shard& shard, const std::function<void()>& func);
+    void collect(Shard& shard, cv::Size frameSize);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t inputsCount = 0;
+    std::chrono::steady_clock::time_point lastStatsTime;
+
+    // Batches collected from the shards if there are several of them
+    std::mutex mutex;
+    std::condition_variable batchesCondVar;
+    std::deque<std::vector<std::shared_ptr<VideoFrame>>> batches;
+    size_t runningCollectors = 0;
+    bool collectorsStarted = false;
+    bool stopped = false;
+};
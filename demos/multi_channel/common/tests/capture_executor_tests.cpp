@@ -0,0 +1,91 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <tests/check.hpp>
+
+#include "capture_executor.hpp"
+
+namespace {
+using Clock = TimerWheel::Clock;
+using std::chrono::milliseconds;
+
+// Runs the wheel like the timekeeper of CaptureExecutor does, always sleeping exactly until getNextExpiry(),
+// and compares the timers it expires with a sorted reference. Every expired timer is scheduled again after
+// its period, so sources paced at different rates share the wheel.
+void checkPacing(const std::vector<milliseconds>& periods, unsigned seed, size_t wakeups) {
+    const Clock::time_point start;
+    TimerWheel wheel(milliseconds(1), start);
+    std::multimap<Clock::time_point, size_t> reference;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> jitter(0, 3);
+
+    for (size_t id = 0; id < periods.size(); id++) {
+        const Clock::time_point time = start + periods[id] + milliseconds(jitter(rng));
+        wheel.add(id, time);
+        reference.emplace(time, id);
+    }
+
+    std::vector<size_t> expired;
+    size_t lateExpiries = 0;
+    for (size_t i = 0; i < wakeups; i++) {
+        const Clock::time_point now = wheel.getNextExpiry();
+        if (now > reference.begin()->first) {
+            lateExpiries++;
+        }
+
+        expired.clear();
+        wheel.advance(now, expired);
+        std::vector<size_t> expected;
+        while (!reference.empty() && reference.begin()->first <= now) {
+            expected.push_back(reference.begin()->second);
+            reference.erase(reference.begin());
+        }
+        std::sort(expired.begin(), expired.end());
+        std::sort(expected.begin(), expected.end());
+        CHECK(expected == expired);
+
+        for (size_t id : expired) {
+            const Clock::time_point time = now + periods[id] + milliseconds(jitter(rng));
+            wheel.add(id, time);
+            reference.emplace(time, id);
+        }
+    }
+    CHECK(0 == lateExpiries);
+}
+
+void testShortPeriods() {
+    checkPacing({milliseconds(10), milliseconds(16), milliseconds(33)}, 1, 1000);
+}
+
+// sources paced at 15 fps and slower wait in the higher levels next to the faster ones in the first level
+void testMixedPeriods() {
+    checkPacing({milliseconds(16), milliseconds(33), milliseconds(67), milliseconds(100), milliseconds(500),
+                 milliseconds(5000), milliseconds(300000)}, 2, 10000);
+}
+
+void testLongPeriods() {
+    checkPacing({milliseconds(100), milliseconds(1000), milliseconds(70000)}, 3, 1000);
+}
+
+void testEmpty() {
+    TimerWheel wheel(milliseconds(1), Clock::time_point());
+    CHECK(Clock::time_point::max() == wheel.getNextExpiry());
+    std::vector<size_t> expired;
+    wheel.advance(Clock::time_point() + milliseconds(10), expired);
+    CHECK(expired.empty());
+}
+}  // namespace
+
+int main() {
+    testShortPeriods();
+    testMixedPeriods();
+    testLongPeriods();
+    testEmpty();
+    return tests::result();
+}
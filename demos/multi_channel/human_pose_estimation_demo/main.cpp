@@ -41,12 +41,14 @@
 #include <monitors/presenter.h>
 #include <samples/slog.hpp>
 #include <samples/args_helper.hpp>
+#include <tracing/tracing.hpp>
 
 #include "input.hpp"
 #include "multichannel_params.hpp"
 #include "output.hpp"
 #include "threading.hpp"
 #include "graph.hpp"
+#include "sharded_pipeline.hpp"
 
 #include "human_pose.hpp"
 #include "peak.hpp"
@@ -84,6 +86,15 @@ void showUsage() {
     std::cout << "    -i                           " << input_video << std::endl;
     std::cout << "    -loop_video                  " << loop_video_output_message << std::endl;
     std::cout << "    -u                           " << utilization_monitors_message << std::endl;
+    std::cout << "    -trace \"<path>\"              " << trace_message << std::endl;
+    std::cout << "    -shards                      " << shards_message << std::endl;
+    std::cout << "    -latency_budget              " << latency_budget_message << std::endl;
+    std::cout << "    -capture_threads             " << capture_threads_message << std::endl;
+    std::cout << "    -input_fps                   " << input_fps_message << std::endl;
+    std::cout << "    -channel_weights             " << channel_weights_message << std::endl;
+    std::cout << "    -record \"<path>\"             " << record_message << std::endl;
+    std::cout << "    -replay \"<path>\"             " << replay_message << std::endl;
+    std::cout << "    -replay_latency              " << replay_latency_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char *argv[]) {
@@ -96,7 +107,7 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
     }
     slog::info << "Parsing input parameters" << slog::endl;
 
-    if (FLAGS_m.empty()) {
+    if (FLAGS_m.empty() && FLAGS_replay.empty()) {
         throw std::logic_error("Parameter -m is not set");
     }
     if (FLAGS_nc == 0 && FLAGS_i.empty()) {
@@ -156,8 +167,9 @@ void displayNSources(const std::vector<std::shared_ptr<VideoFrame>>& data,
     cv::Mat windowImage = cv::Mat::zeros(params.windowSize, CV_8UC3);
     auto loopBody = [&](size_t i) {
         auto& elem = data[i];
-        if (!elem->frame.empty()) {
-            cv::Rect rectFrame = cv::Rect(params.points[i], params.frameSize);
+        // the cell is chosen by the channel, batches of several shards come in any order
+        if (elem && !elem->frame.empty() && elem->sourceIdx < params.count) {
+            cv::Rect rectFrame = cv::Rect(params.points[elem->sourceIdx], params.frameSize);
             cv::Mat windowPart = windowImage(rectFrame);
             cv::resize(elem->frame, windowPart, params.frameSize);
             renderHumanPose(elem->detections.get<std::vector<HumanPose>>(), windowPart);
@@ -215,15 +227,21 @@ int main(int argc, char* argv[]) {
         if (!ParseAndCheckCommandLine(argc, argv)) {
             return 0;
         }
+        if (!FLAGS_trace.empty()) {
+            tracing::enable();
+            tracing::setThreadName("main");
+        }
 
         std::string modelPath = FLAGS_m;
-        std::size_t found = modelPath.find_last_of(".");
-        if (found > modelPath.size()) {
-            slog::info << "Invalid model name: " << modelPath << slog::endl;
-            slog::info << "Expected to be <model_name>.xml" << slog::endl;
-            return -1;
+        if (!modelPath.empty()) {  // replaying doesn't need the model
+            std::size_t found = modelPath.find_last_of(".");
+            if (found > modelPath.size()) {
+                slog::info << "Invalid model name: " << modelPath << slog::endl;
+                slog::info << "Expected to be <model_name>.xml" << slog::endl;
+                return -1;
+            }
+            slog::info << "Model   path: " << modelPath << slog::endl;
         }
-        slog::info << "Model   path: " << modelPath << slog::endl;
 
         IEGraph::InitParams graphParams;
         graphParams.batchSize       = FLAGS_bs;
@@ -234,11 +252,12 @@ int main(int argc, char* argv[]) {
         graphParams.cpuExtPath      = FLAGS_l;
         graphParams.cldnnConfigPath = FLAGS_c;
         graphParams.deviceName      = FLAGS_d;
-
-        std::shared_ptr<IEGraph> network(new IEGraph(graphParams));
-        auto inputDims = network->getInputDims();
-        if (4 != inputDims.size()) {
-            throw std::runtime_error("Invalid network input dimensions");
+        if (!FLAGS_record.empty()) {
+            graphParams.recorder = std::make_shared<OutputsRecorder>(FLAGS_record);
+        }
+        if (!FLAGS_replay.empty()) {
+            graphParams.replayer = std::make_shared<OutputsReplayer>(FLAGS_replay,
+                std::chrono::microseconds(static_cast<int64_t>(FLAGS_replay_latency * 1000)));
         }
 
         std::vector<std::string> files;
@@ -266,15 +285,15 @@ int main(int argc, char* argv[]) {
         vsParams.queueSize            = FLAGS_n_iqs;
         vsParams.collectStats         = FLAGS_show_stats;
         vsParams.realFps              = FLAGS_real_input_fps;
-        vsParams.expectedHeight = static_cast<unsigned>(inputDims[2]);
-        vsParams.expectedWidth  = static_cast<unsigned>(inputDims[3]);
+        vsParams.captureThreads       = FLAGS_capture_threads;
+        vsParams.captureFps           = FLAGS_input_fps;
 
-        VideoSources sources(vsParams);
+        std::shared_ptr<ShardedPipeline> network(new ShardedPipeline(graphParams, vsParams, FLAGS_shards));
         if (!files.empty()) {
             slog::info << "Trying to open input video ..." << slog::endl;
             for (auto& file : files) {
                 try {
-                    sources.openVideo(file, false, FLAGS_loop_video);
+                    network->openVideo(file, false, FLAGS_loop_video);
                 } catch (...) {
                     slog::info << "Cannot open video [" << file << "]" << slog::endl;
                     throw;
@@ -285,31 +304,22 @@ int main(int argc, char* argv[]) {
             slog::info << "Trying to connect " << FLAGS_nc << " web cams ..." << slog::endl;
             for (size_t i = 0; i < FLAGS_nc; ++i) {
                 try {
-                    sources.openVideo(std::to_string(i), true, false);
+                    network->openVideo(std::to_string(i), true, false);
                 } catch (...) {
                     slog::info << "Cannot open web cam [" << i << "]" << slog::endl;
                     throw;
                 }
             }
         }
-        sources.start();
-
-        size_t currentFrame = 0;
-
-        network->start([&](VideoFrame& img) {
-            img.sourceIdx = currentFrame;
-            auto camIdx = currentFrame / duplicateFactor;
-            currentFrame = (currentFrame + 1) % numberOfInputs;
-            return sources.getFrame(camIdx, img);
-        }, [](InferenceEngine::InferRequest::Ptr req, const std::vector<std::string>& outputDataBlobNames, cv::Size frameSize) {
-            auto pafsBlobIt   = req->GetBlob(outputDataBlobNames[0]);
+        network->start(duplicateFactor, [](const InferenceEngine::BlobMap& outputs, const std::vector<std::string>& outputDataBlobNames, cv::Size frameSize) {
+            auto pafsBlobIt   = outputs.at(outputDataBlobNames[0]);
             auto pafsDesc     = pafsBlobIt->getTensorDesc();
             auto pafsWidth    = getTensorWidth(pafsDesc);
             auto pafsHeight   = getTensorHeight(pafsDesc);
             auto pafsChannels = getTensorChannels(pafsDesc);
             auto pafsBatch    = getTensorBatch(pafsDesc);
 
-            auto heatMapsBlobIt   = req->GetBlob(outputDataBlobNames[1]);
+            auto heatMapsBlobIt   = outputs.at(outputDataBlobNames[1]);
             auto heatMapsDesc     = heatMapsBlobIt->getTensorDesc();
             auto heatMapsWidth    = getTensorWidth(heatMapsDesc);
             auto heatMapsHeight   = getTensorHeight(heatMapsDesc);
@@ -337,11 +347,12 @@ int main(int argc, char* argv[]) {
                 }
             }
             return detections;
-        });
+        }, ChannelMultiplexer::parseWeights(FLAGS_channel_weights));
 
         std::atomic<float> averageFps = {0.0f};
 
-        std::vector<std::shared_ptr<VideoFrame>> batchRes;
+        // a stalled channel holds the others back for 40 ms at most
+        DisplayBatcher batcher(numberOfInputs, std::chrono::milliseconds(40));
 
         std::mutex statMutex;
         std::stringstream statStream;
@@ -355,20 +366,29 @@ int main(int argc, char* argv[]) {
         cv::Size graphSize{static_cast<int>(params.windowSize.width / 4), 60};
         Presenter presenter(FLAGS_u, params.windowSize.height - graphSize.height - 10, graphSize);
 
+        // channels missing from a batch keep showing their previous frame
+        std::vector<std::shared_ptr<VideoFrame>> shownFrames(numberOfInputs);
+
         const size_t outputQueueSize = 1;
-        AsyncOutput output(FLAGS_show_stats, outputQueueSize,
-        [&](const std::vector<std::shared_ptr<VideoFrame>>& result) {
-            std::string str;
-            if (FLAGS_show_stats) {
-                std::unique_lock<std::mutex> lock(statMutex);
-                str = statStream.str();
-            }
-            displayNSources(result, averageFps, str, params, presenter);
-            int key = cv::waitKey(1);
-            presenter.handleKey(key);
+        AsyncOutput output(FLAGS_show_stats, outputQueueSize, std::chrono::milliseconds(FLAGS_latency_budget),
+        FLAGS_no_show ? AsyncOutput::DrawFunc() :
+            [&](const std::vector<std::shared_ptr<VideoFrame>>& result) {
+                for (const auto& vframe : result) {
+                    if (vframe->sourceIdx < shownFrames.size()) {
+                        shownFrames[vframe->sourceIdx] = vframe;
+                    }
+                }
+                std::string str;
+                if (FLAGS_show_stats) {
+                    std::unique_lock<std::mutex> lock(statMutex);
+                    str = statStream.str();
+                }
+                displayNSources(shownFrames, averageFps, str, params, presenter);
+                int key = cv::waitKey(1);
+                presenter.handleKey(key);
 
-            return (key != 27);
-        });
+                return (key != 27);
+            });
 
         output.start();
 
@@ -381,28 +401,22 @@ int main(int argc, char* argv[]) {
 
         size_t perfItersCounter = 0;
 
-        while (sources.isRunning() || network->isRunning()) {
+        while (network->isRunning()) {
             bool readData = true;
             while (readData) {
-                auto br = network->getBatchData(params.frameSize);
+                auto br = network->getBatchData(params.frameSize, batcher.getDeadline());
                 if (br.empty()) {
-                    break; // IEGraph::getBatchData had nothing to process and returned. That means it was stopped
+                    break; // the pipeline was stopped, or the waiting frames are due and no new frame came
                 }
                 for (size_t i = 0; i < br.size(); i++) {
-                    // this approach waits for the next input image for sourceIdx. If provided a single image,
-                    // it may not show results, especially if -real_input_fps is enabled
-                    auto val = static_cast<unsigned int>(br[i]->sourceIdx);
-                    auto it = find_if(batchRes.begin(), batchRes.end(), [val] (const std::shared_ptr<VideoFrame>& vf) { return vf->sourceIdx == val; } );
-                    if (it != batchRes.end()) {
-                        if (!FLAGS_no_show) {
-                            output.push(std::move(batchRes));
-                        }
-                        batchRes.clear();
+                    if (batcher.add(std::move(br[i]))) {
                         readData = false;
                     }
-                    batchRes.push_back(std::move(br[i]));
                 }
             }
+            if (!batcher.empty()) {
+                output.push(batcher.take());
+            }
             ++fpsCounter;
 
             if (!output.isAlive()) {
@@ -428,33 +442,69 @@ int main(int argc, char* argv[]) {
                 }
 
                 if (FLAGS_show_stats) {
-                    auto inputStat = sources.getStats();
-                    auto inferStat = network->getStats();
+                    auto stats = network->getStats();
                     auto outputStat = output.getStats();
 
                     std::unique_lock<std::mutex> lock(statMutex);
                     statStream.str(std::string());
                     statStream << std::fixed << std::setprecision(1);
-                    statStream << "Input reads: ";
-                    for (size_t i = 0; i < inputStat.readTimes.size(); ++i) {
+                    for (size_t shard = 0; shard < stats.size(); ++shard) {
+                        const auto& inputStat = stats[shard].input;
+                        const auto& inferStat = stats[shard].infer;
+                        if (stats.size() > 1) {
+                            statStream << "Shard " << shard << " (CPUs " << stats[shard].cpus << "): "
+                                       << stats[shard].fps << " fps" << std::endl;
+                        }
+                        statStream << "Input reads (mean/p99): ";
+                        for (size_t i = 0; i < inputStat.readTimes.size(); ++i) {
+                            if (0 == (i % 4)) {
+                                statStream << std::endl;
+                            }
+                            statStream << inputStat.readTimes[i] << "/" << inputStat.readTimesP99[i] << "ms ";
+                        }
+                        statStream << std::endl;
+                        statStream << "HW decoding latency: "
+                                   << inputStat.decodingLatency << "ms (p99 "
+                                   << inputStat.decodingLatencyP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Preprocess time: "
+                                   << inferStat.preprocessTime << "ms (p99 "
+                                   << inferStat.preprocessTimeP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Plugin latency: "
+                                   << inferStat.inferTime << "ms (p99 "
+                                   << inferStat.inferTimeP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Served fps (starved): ";
+                        for (size_t i = 0; i < stats[shard].channels.size(); ++i) {
+                            if (0 == (i % 4)) {
+                                statStream << std::endl;
+                            }
+                            const auto& channel = stats[shard].channels[i];
+                            statStream << channel.channel << ": " << channel.fps << " (" << channel.starved << ") ";
+                        }
+                        statStream << std::endl;
+                    }
+
+                    statStream << "Render time: " << outputStat.renderTime
+                               << "ms (p99 " << outputStat.renderTimeP99 << "ms)" << std::endl;
+
+                    const auto& latency = outputStat.latency;
+                    statStream << "Input queue/preprocess/inference/output (mean/p99): "
+                               << latency.inputQueue.mean << "/" << latency.inputQueue.p99 << "ms "
+                               << latency.preprocess.mean << "/" << latency.preprocess.p99 << "ms "
+                               << latency.inference.mean << "/" << latency.inference.p99 << "ms "
+                               << latency.output.mean << "/" << latency.output.p99 << "ms" << std::endl;
+                    statStream << "Channel latency (mean/p99, dropped/skipped): ";
+                    for (size_t i = 0; i < latency.channels.size(); ++i) {
                         if (0 == (i % 4)) {
                             statStream << std::endl;
                         }
-                        statStream << inputStat.readTimes[i] << "ms ";
+                        const auto& channel = latency.channels[i];
+                        statStream << channel.channel << ": " << channel.latency << "/" << channel.latencyP99 << "ms "
+                                   << channel.dropped << "/" << channel.skipped << " ";
                     }
                     statStream << std::endl;
-                    statStream << "HW decoding latency: "
-                               << inputStat.decodingLatency << "ms";
-                    statStream << std::endl;
-                    statStream << "Preprocess time: "
-                               << inferStat.preprocessTime << "ms";
-                    statStream << std::endl;
-                    statStream << "Plugin latency: "
-                               << inferStat.inferTime << "ms";
-                    statStream << std::endl;
-
-                    statStream << "Render time: " << outputStat.renderTime
-                               << "ms" << std::endl;
 
                     if (FLAGS_no_show) {
                         slog::info << statStream.str() << slog::endl;
@@ -465,6 +515,11 @@ int main(int argc, char* argv[]) {
 
         network.reset();
 
+        if (!FLAGS_trace.empty()) {
+            tracing::save(FLAGS_trace);
+            slog::info << "Trace is saved to " << FLAGS_trace << slog::endl;
+        }
+
         std::cout << presenter.reportMeans() << '\n';
     }
     catch (const std::exception& error) {
@@ -31,6 +31,7 @@
 #include <monitors/presenter.h>
 #include <samples/slog.hpp>
 #include <samples/args_helper.hpp>
+#include <tracing/tracing.hpp>
 
 #include "input.hpp"
 #include "multichannel_params.hpp"
@@ -38,6 +39,7 @@
 #include "output.hpp"
 #include "threading.hpp"
 #include "graph.hpp"
+#include "sharded_pipeline.hpp"
 
 namespace {
 
@@ -70,6 +72,15 @@ void showUsage() {
     std::cout << "    -i                           " << input_video << std::endl;
     std::cout << "    -loop_video                  " << loop_video_output_message << std::endl;
     std::cout << "    -u                           " << utilization_monitors_message << std::endl;
+    std::cout << "    -trace \"<path>\"              " << trace_message << std::endl;
+    std::cout << "    -shards                      " << shards_message << std::endl;
+    std::cout << "    -latency_budget              " << latency_budget_message << std::endl;
+    std::cout << "    -capture_threads             " << capture_threads_message << std::endl;
+    std::cout << "    -input_fps                   " << input_fps_message << std::endl;
+    std::cout << "    -channel_weights             " << channel_weights_message << std::endl;
+    std::cout << "    -record \"<path>\"             " << record_message << std::endl;
+    std::cout << "    -replay \"<path>\"             " << replay_message << std::endl;
+    std::cout << "    -replay_latency              " << replay_latency_message << std::endl;
 }
 
 bool ParseAndCheckCommandLine(int argc, char *argv[]) {
@@ -171,13 +182,13 @@ double IntersectionOverUnion(const DetectionObject &box_1, const DetectionObject
     return area_of_overlap / area_of_union;
 }
 
-void ParseYOLOV3Output(InferenceEngine::InferRequest::Ptr req,
+void ParseYOLOV3Output(const InferenceEngine::BlobMap& outputs,
                        const std::string &outputName,
                        const YoloParams &yoloParams, const unsigned long resized_im_h,
                        const unsigned long resized_im_w, const unsigned long original_im_h,
                        const unsigned long original_im_w,
                        const double threshold, std::vector<DetectionObject> &objects) {
-    InferenceEngine::Blob::Ptr blob = req->GetBlob(outputName);
+    InferenceEngine::Blob::Ptr blob = outputs.at(outputName);
 
     const int out_blob_h = static_cast<int>(blob->getTensorDesc().getDims()[2]);
     const int out_blob_w = static_cast<int>(blob->getTensorDesc().getDims()[3]);
@@ -304,8 +315,9 @@ void displayNSources(const std::vector<std::shared_ptr<VideoFrame>>& data,
     cv::Mat windowImage = cv::Mat::zeros(params.windowSize, CV_8UC3);
     auto loopBody = [&](size_t i) {
         auto& elem = data[i];
-        if (!elem->frame.empty()) {
-            cv::Rect rectFrame = cv::Rect(params.points[i], params.frameSize);
+        // the cell is chosen by the channel, batches of several shards come in any order
+        if (elem && !elem->frame.empty() && elem->sourceIdx < params.count) {
+            cv::Rect rectFrame = cv::Rect(params.points[elem->sourceIdx], params.frameSize);
             cv::Mat windowPart = windowImage(rectFrame);
             cv::resize(elem->frame, windowPart, params.frameSize);
             drawDetections(windowPart, elem->detections.get<std::vector<DetectionObject>>(), colors);
@@ -364,6 +376,10 @@ int main(int argc, char* argv[]) {
         if (!ParseAndCheckCommandLine(argc, argv)) {
             return 0;
         }
+        if (!FLAGS_trace.empty()) {
+            tracing::enable();
+            tracing::setThreadName("main");
+        }
 
         std::string modelPath = FLAGS_m;
         std::size_t found = modelPath.find_last_of(".");
@@ -385,17 +401,18 @@ int main(int argc, char* argv[]) {
         graphParams.cpuExtPath      = FLAGS_l;
         graphParams.cldnnConfigPath = FLAGS_c;
         graphParams.deviceName      = FLAGS_d;
+        if (!FLAGS_record.empty()) {
+            graphParams.recorder = std::make_shared<OutputsRecorder>(FLAGS_record);
+        }
+        if (!FLAGS_replay.empty()) {
+            graphParams.replayer = std::make_shared<OutputsReplayer>(FLAGS_replay,
+                std::chrono::microseconds(static_cast<int64_t>(FLAGS_replay_latency * 1000)));
+        }
         graphParams.postLoadFunc    = [&yoloParams](const std::vector<std::string>& outputDataBlobNames,
                                                     InferenceEngine::CNNNetwork &network) {
                                                         yoloParams = GetYoloParams(outputDataBlobNames, network);
                                                     };
 
-        std::shared_ptr<IEGraph> network(new IEGraph(graphParams));
-        auto inputDims = network->getInputDims();
-        if (4 != inputDims.size()) {
-            throw std::runtime_error("Invalid network input dimensions");
-        }
-
         std::vector<std::string> files;
         parseInputFilesArguments(files);
 
@@ -421,15 +438,15 @@ int main(int argc, char* argv[]) {
         vsParams.queueSize            = FLAGS_n_iqs;
         vsParams.collectStats         = FLAGS_show_stats;
         vsParams.realFps              = FLAGS_real_input_fps;
-        vsParams.expectedHeight = static_cast<unsigned>(inputDims[2]);
-        vsParams.expectedWidth  = static_cast<unsigned>(inputDims[3]);
+        vsParams.captureThreads       = FLAGS_capture_threads;
+        vsParams.captureFps           = FLAGS_input_fps;
 
-        VideoSources sources(vsParams);
+        std::shared_ptr<ShardedPipeline> network(new ShardedPipeline(graphParams, vsParams, FLAGS_shards));
         if (!files.empty()) {
             slog::info << "Trying to open input video ..." << slog::endl;
             for (auto& file : files) {
                 try {
-                    sources.openVideo(file, false, FLAGS_loop_video);
+                    network->openVideo(file, false, FLAGS_loop_video);
                 } catch (...) {
                     slog::info << "Cannot open video [" << file << "]" << slog::endl;
                     throw;
@@ -440,28 +457,19 @@ int main(int argc, char* argv[]) {
             slog::info << "Trying to connect " << FLAGS_nc << " web cams ..." << slog::endl;
             for (size_t i = 0; i < FLAGS_nc; ++i) {
                 try {
-                    sources.openVideo(std::to_string(i), true, false);
+                    network->openVideo(std::to_string(i), true, false);
                 } catch (...) {
                     slog::info << "Cannot open web cam [" << i << "]" << slog::endl;
                     throw;
                 }
             }
         }
-        sources.start();
-
-        size_t currentFrame = 0;
-
         std::vector<cv::Scalar> colors;
         if (yoloParams.size() > 0)
             for (int i = 0; i < static_cast<int>(yoloParams.begin()->second.classes); ++i)
                 colors.push_back(cv::Scalar(rand() % 256, rand() % 256, rand() % 256));
 
-        network->start([&](VideoFrame& img) {
-            img.sourceIdx = currentFrame;
-            auto camIdx = currentFrame / duplicateFactor;
-            currentFrame = (currentFrame + 1) % numberOfInputs;
-            return sources.getFrame(camIdx, img);
-        }, [&yoloParams](InferenceEngine::InferRequest::Ptr req,
+        network->start(duplicateFactor, [&yoloParams](const InferenceEngine::BlobMap& outputs,
                 const std::vector<std::string>& outputDataBlobNames,
                 cv::Size frameSize
                 ) {
@@ -471,7 +479,7 @@ int main(int argc, char* argv[]) {
             std::vector<DetectionObject> objects;
             // Parsing outputs
             for (auto &output_name :outputDataBlobNames) {
-                ParseYOLOV3Output(req, output_name, yoloParams[output_name], resized_im_h, resized_im_w, frameSize.height, frameSize.width, FLAGS_t, objects);
+                ParseYOLOV3Output(outputs, output_name, yoloParams[output_name], resized_im_h, resized_im_w, frameSize.height, frameSize.width, FLAGS_t, objects);
             }
             // Filtering overlapping boxes and lower confidence object
             std::sort(objects.begin(), objects.end(), std::greater<DetectionObject>());
@@ -493,13 +501,14 @@ int main(int argc, char* argv[]) {
             }
 
             return detections;
-        });
+        }, ChannelMultiplexer::parseWeights(FLAGS_channel_weights));
 
         network->setDetectionConfidence(static_cast<float>(FLAGS_t));
 
         std::atomic<float> averageFps = {0.0f};
 
-        std::vector<std::shared_ptr<VideoFrame>> batchRes;
+        // a stalled channel holds the others back for 40 ms at most
+        DisplayBatcher batcher(numberOfInputs, std::chrono::milliseconds(40));
 
         std::mutex statMutex;
         std::stringstream statStream;
@@ -513,20 +522,29 @@ int main(int argc, char* argv[]) {
         cv::Size graphSize{static_cast<int>(params.windowSize.width / 4), 60};
         Presenter presenter(FLAGS_u, params.windowSize.height - graphSize.height - 10, graphSize);
 
+        // channels missing from a batch keep showing their previous frame
+        std::vector<std::shared_ptr<VideoFrame>> shownFrames(numberOfInputs);
+
         const size_t outputQueueSize = 1;
-        AsyncOutput output(FLAGS_show_stats, outputQueueSize,
-        [&](const std::vector<std::shared_ptr<VideoFrame>>& result) {
-            std::string str;
-            if (FLAGS_show_stats) {
-                std::unique_lock<std::mutex> lock(statMutex);
-                str = statStream.str();
-            }
-            displayNSources(result, averageFps, str, params, colors, presenter);
-            int key = cv::waitKey(1);
-            presenter.handleKey(key);
+        AsyncOutput output(FLAGS_show_stats, outputQueueSize, std::chrono::milliseconds(FLAGS_latency_budget),
+        FLAGS_no_show ? AsyncOutput::DrawFunc() :
+            [&](const std::vector<std::shared_ptr<VideoFrame>>& result) {
+                for (const auto& vframe : result) {
+                    if (vframe->sourceIdx < shownFrames.size()) {
+                        shownFrames[vframe->sourceIdx] = vframe;
+                    }
+                }
+                std::string str;
+                if (FLAGS_show_stats) {
+                    std::unique_lock<std::mutex> lock(statMutex);
+                    str = statStream.str();
+                }
+                displayNSources(shownFrames, averageFps, str, params, colors, presenter);
+                int key = cv::waitKey(1);
+                presenter.handleKey(key);
 
-            return (key != 27);
-        });
+                return (key != 27);
+            });
 
         output.start();
 
@@ -539,26 +557,22 @@ int main(int argc, char* argv[]) {
 
         size_t perfItersCounter = 0;
 
-        while (sources.isRunning() || network->isRunning()) {
+        while (network->isRunning()) {
             bool readData = true;
             while (readData) {
-                auto br = network->getBatchData(params.frameSize);
+                auto br = network->getBatchData(params.frameSize, batcher.getDeadline());
                 if (br.empty()) {
-                    break;
+                    break; // the pipeline was stopped, or the waiting frames are due and no new frame came
                 }
                 for (size_t i = 0; i < br.size(); i++) {
-                    auto val = static_cast<unsigned int>(br[i]->sourceIdx);
-                    auto it = find_if(batchRes.begin(), batchRes.end(), [val] (const std::shared_ptr<VideoFrame>& vf) { return vf->sourceIdx == val; } );
-                    if (it != batchRes.end()) {
-                        if (!FLAGS_no_show) {
-                            output.push(std::move(batchRes));
-                        }
-                        batchRes.clear();
+                    if (batcher.add(std::move(br[i]))) {
                         readData = false;
                     }
-                    batchRes.push_back(std::move(br[i]));
                 }
             }
+            if (!batcher.empty()) {
+                output.push(batcher.take());
+            }
             ++fpsCounter;
 
             if (!output.isAlive()) {
@@ -584,33 +598,69 @@ int main(int argc, char* argv[]) {
                 }
 
                 if (FLAGS_show_stats) {
-                    auto inputStat = sources.getStats();
-                    auto inferStat = network->getStats();
+                    auto stats = network->getStats();
                     auto outputStat = output.getStats();
 
                     std::unique_lock<std::mutex> lock(statMutex);
                     statStream.str(std::string());
                     statStream << std::fixed << std::setprecision(1);
-                    statStream << "Input reads: ";
-                    for (size_t i = 0; i < inputStat.readTimes.size(); ++i) {
+                    for (size_t shard = 0; shard < stats.size(); ++shard) {
+                        const auto& inputStat = stats[shard].input;
+                        const auto& inferStat = stats[shard].infer;
+                        if (stats.size() > 1) {
+                            statStream << "Shard " << shard << " (CPUs " << stats[shard].cpus << "): "
+                                       << stats[shard].fps << " fps" << std::endl;
+                        }
+                        statStream << "Input reads (mean/p99): ";
+                        for (size_t i = 0; i < inputStat.readTimes.size(); ++i) {
+                            if (0 == (i % 4)) {
+                                statStream << std::endl;
+                            }
+                            statStream << inputStat.readTimes[i] << "/" << inputStat.readTimesP99[i] << "ms ";
+                        }
+                        statStream << std::endl;
+                        statStream << "HW decoding latency: "
+                                   << inputStat.decodingLatency << "ms (p99 "
+                                   << inputStat.decodingLatencyP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Preprocess time: "
+                                   << inferStat.preprocessTime << "ms (p99 "
+                                   << inferStat.preprocessTimeP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Plugin latency: "
+                                   << inferStat.inferTime << "ms (p99 "
+                                   << inferStat.inferTimeP99 << "ms)";
+                        statStream << std::endl;
+                        statStream << "Served fps (starved): ";
+                        for (size_t i = 0; i < stats[shard].channels.size(); ++i) {
+                            if (0 == (i % 4)) {
+                                statStream << std::endl;
+                            }
+                            const auto& channel = stats[shard].channels[i];
+                            statStream << channel.channel << ": " << channel.fps << " (" << channel.starved << ") ";
+                        }
+                        statStream << std::endl;
+                    }
+
+                    statStream << "Render time: " << outputStat.renderTime
+                               << "ms (p99 " << outputStat.renderTimeP99 << "ms)" << std::endl;
+
+                    const auto& latency = outputStat.latency;
+                    statStream << "Input queue/preprocess/inference/output (mean/p99): "
+                               << latency.inputQueue.mean << "/" << latency.inputQueue.p99 << "ms "
+                               << latency.preprocess.mean << "/" << latency.preprocess.p99 << "ms "
+                               << latency.inference.mean << "/" << latency.inference.p99 << "ms "
+                               << latency.output.mean << "/" << latency.output.p99 << "ms" << std::endl;
+                    statStream << "Channel latency (mean/p99, dropped/skipped): ";
+                    for (size_t i = 0; i < latency.channels.size(); ++i) {
                         if (0 == (i % 4)) {
                             statStream << std::endl;
                         }
-                        statStream << inputStat.readTimes[i] << "ms ";
+                        const auto& channel = latency.channels[i];
+                        statStream << channel.channel << ": " << channel.latency << "/" << channel.latencyP99 << "ms "
+                                   << channel.dropped << "/" << channel.skipped << " ";
                     }
                     statStream << std::endl;
-                    statStream << "HW decoding latency: "
-                               << inputStat.decodingLatency << "ms";
-                    statStream << std::endl;
-                    statStream << "Preprocess time: "
-                               << inferStat.preprocessTime << "ms";
-                    statStream << std::endl;
-                    statStream << "Plugin latency: "
-                               << inferStat.inferTime << "ms";
-                    statStream << std::endl;
-
-                    statStream << "Render time: " << outputStat.renderTime
-                               << "ms" << std::endl;
 
                     if (FLAGS_no_show) {
                         slog::info << statStream.str() << slog::endl;
@@ -621,6 +671,11 @@ int main(int argc, char* argv[]) {
 
         network.reset();
 
+        if (!FLAGS_trace.empty()) {
+            tracing::save(FLAGS_trace);
+            slog::info << "Trace is saved to " << FLAGS_trace << slog::endl;
+        }
+
         std::cout << presenter.reportMeans() << '\n';
     }
     catch (const std::exception& error) {
@@ -10,6 +10,7 @@
 #include <algorithm>
 
 #include <inference_engine.hpp>
+#include <opencv2/core.hpp>
 
 using namespace InferenceEngine;
 using InferenceEngine::details::InferenceEngineException;
@@ -23,14 +24,19 @@ static bool SortScorePairDescend(const std::pair<float, T>& pair1,
 /**
  * @class DetectionOutputPostProcessor
  * @brief This class is almost a copy of MKLDNN extension implementation DetectionOutputImpl.
- * In our demo we use it as a post-processing class for Faster-RCNN networks
+ * In our demo we use it as a post-processing class for Faster-RCNN networks.
+ * Unlike DetectionOutputImpl it decodes only the boxes of the (prior, class) pairs whose confidence
+ * is above the threshold, so a threshold set to the one the caller applies to the results anyway
+ * saves most of the work without changing the results above it.
  */
 class DetectionOutputPostProcessor {
 public:
     explicit DetectionOutputPostProcessor(const SizeVector &image_dims,
                                           const SizeVector &loc_dims,
                                           const SizeVector &conf_dims,
-                                          const SizeVector &prior_dims) {
+                                          const SizeVector &prior_dims,
+                                          float confidence_threshold = -FLT_MAX)
+            : _confidence_threshold(confidence_threshold) {
         try {
             IE_ASSERT(4 == image_dims.size());
 
@@ -62,44 +68,18 @@ public:
             if (_num_priors * _num_classes != static_cast<int>(conf_size))
                 THROW_IE_EXCEPTION << "Number of priors must match number of confidence predictions.";
 
-            SizeVector bboxes_size{conf_size,
-                                                    static_cast<size_t>(_num_classes),
-                                                    static_cast<size_t>(_num_priors),
-                                                    4};
-            _decoded_bboxes = make_shared_blob<float>({Precision::FP32, bboxes_size, NCHW});
-            _decoded_bboxes->allocate();
-
-            SizeVector buf_size{conf_size,
-                                                 static_cast<size_t>(_num_classes),
-                                                 static_cast<size_t>(_num_priors)};
-            _buffer = make_shared_blob<int>({Precision::I32, buf_size, {buf_size, {0, 1, 2}}});
-            _buffer->allocate();
-
-            SizeVector indices_size{conf_size,
-                                                     static_cast<size_t>(_num_classes),
-                                                     static_cast<size_t>(_num_priors)};
-            _indices = make_shared_blob<int>(
-                    {Precision::I32, indices_size, {indices_size, {0, 1, 2}}});
-            _indices->allocate();
-
-            SizeVector detections_size{conf_size * static_cast<size_t>(_num_classes)};
-            _detections_count = make_shared_blob<int>({Precision::I32, detections_size, C});
-            _detections_count->allocate();
-
-            SizeVector conf_size1 = { conf_size, 1 };
-            _reordered_conf = make_shared_blob<float>({Precision::FP32, conf_size1, ANY});
-            _reordered_conf->allocate();
-
-            SizeVector decoded_bboxes_size{conf_size,
-                                                            static_cast<size_t>(_num_priors),
-                                                            static_cast<size_t>(_num_classes)};
-            _bbox_sizes = make_shared_blob<float>(
-                    {Precision::FP32, decoded_bboxes_size, {decoded_bboxes_size, {0, 1, 2}}});
-            _bbox_sizes->allocate();
-
-            SizeVector num_priors_actual_size{conf_size};
-            _num_priors_actual = make_shared_blob<int>({Precision::I32, num_priors_actual_size, C});
-            _num_priors_actual->allocate();
+            // the workspaces are reused by every call, so execute() doesn't allocate memory
+            _candidates.reserve(conf_size);
+            _classes.resize(_num_classes);
+            for (ClassWorkspace &workspace : _classes) {
+                workspace.priors.reserve(_num_priors);
+                workspace.confs.reserve(_num_priors);
+                workspace.boxes.reserve(4 * _num_priors);
+                workspace.sizes.reserve(_num_priors);
+                workspace.order.reserve(_num_priors);
+                workspace.kept.reserve(_num_priors);
+            }
+            _conf_index_class_map.reserve(_num_classes * std::min(_top_k, _num_priors));
         } catch (const InferenceEngineException& ex) {
             throw std::logic_error(std::string("Can't create detection output: ") + ex.what());
         }
@@ -119,133 +99,106 @@ public:
 
         const int N = 1;  // TODO: Support batch
 
-        LockedMemory<const void> decodedBboxesMapped = as<MemoryBlob>(_decoded_bboxes)->rmap();
-        float *decoded_bboxes_data = decodedBboxesMapped.as<float*>();
-        LockedMemory<const void> reorderedConfMapped = as<MemoryBlob>(_reordered_conf)->rmap();
-        float *reordered_conf_data = reorderedConfMapped.as<float*>();
-        LockedMemory<const void> bboxSizesMapped = as<MemoryBlob>(_bbox_sizes)->rmap();
-        float *bbox_sizes_data     = bboxSizesMapped.as<float*>();
-        LockedMemory<const void> detectionsCountMapped = as<MemoryBlob>(_detections_count)->rmap();
-        int *detections_data       = detectionsCountMapped.as<int*>();
-        LockedMemory<const void> bufferMapped = as<MemoryBlob>(_buffer)->rmap();
-        int *buffer_data           = bufferMapped.as<int*>();
-        LockedMemory<const void> indicesMapped = as<MemoryBlob>(_indices)->rmap();
-        int *indices_data          = indicesMapped.as<int*>();
-        LockedMemory<const void> numPriorsActualMapped = as<MemoryBlob>(_num_priors_actual)->rmap();
-        int *num_priors_actual     = numPriorsActualMapped.as<int*>();
-
-        const float *prior_variances = prior_data + _num_priors*_prior_size;
-        const float *ppriors = prior_data;
-
-        for (int n = 0; n < N; ++n) {
-            for (int c = 0; c < _num_loc_classes; ++c) {
-                if (c == _background_label_id) {
-                    continue;
-                }
-
-                const float *ploc = loc_data + n*4*_num_loc_classes*_num_priors + c*4;
-                float *pboxes = decoded_bboxes_data + n*4*_num_loc_classes*_num_priors + c*4*_num_priors;
-                float *psizes = bbox_sizes_data + n*_num_loc_classes*_num_priors + c*_num_priors;
-                decodeBBoxes(ppriors, ploc, prior_variances, pboxes, psizes, num_priors_actual, n);
+        int num_priors_actual = _num_priors;
+        for (int num = 0; num < _num_priors; ++num) {
+            float batch_id = prior_data[num * _prior_size + 0];
+            if (batch_id == -1.f) {
+                num_priors_actual = num;
+                break;
             }
         }
 
-        for (int n = 0; n < N; ++n) {
-            for (int c = 0; c < _num_classes; ++c) {
-                for (int p = 0; p < _num_priors; ++p) {
-                    reordered_conf_data[n*_num_priors*_num_classes + c*_num_priors + p] = conf_data[n*_num_priors*_num_classes + p*_num_classes + c];
-                }
-            }
+        const int DETECTION_SIZE = outputs[0]->getTensorDesc().getDims()[3];
+        if (DETECTION_SIZE != 7) {
+            return NOT_IMPLEMENTED;
         }
 
-        memset(detections_data, 0, N*_num_classes*sizeof(int));
-
-        for (int n = 0; n < N; ++n) {
-            int detections_total = 0;
-
-            for (int c = 0; c < _num_classes; ++c) {
-                if (c == _background_label_id) {
-                    // Ignore background class.
-                    continue;
-                }
-
-                int *pindices    = indices_data + n*_num_classes*_num_priors + c*_num_priors;
-                int *pbuffer     = buffer_data + c*_num_priors;
-                int *pdetections = detections_data + n*_num_classes + c;
-
-                const float *pconf = reordered_conf_data + n*_num_classes*_num_priors + c*_num_priors;
-                const float *pboxes = decoded_bboxes_data + n*4*_num_classes*_num_priors + c*4*_num_priors;
-                const float *psizes = bbox_sizes_data + n*_num_classes*_num_priors + c*_num_priors;
+        auto dst_data_size = N * _keep_top_k * DETECTION_SIZE * sizeof(float);
 
-                nms(pconf, pboxes, psizes, pbuffer, pindices, *pdetections, num_priors_actual[n]);
-            }
+        if (dst_data_size > outputs[0]->byteSize()) {
+            return OUT_OF_BOUNDS;
+        }
 
-            for (int c = 0; c < _num_classes; ++c) {
-                detections_total += detections_data[n*_num_classes + c];
+        // The confidences are scanned in their [prior][class] layout, the pairs above the threshold
+        // come out ordered by prior and are split to the classes keeping the order
+        for (ClassWorkspace &workspace : _classes) {
+            workspace.priors.clear();
+            workspace.confs.clear();
+        }
+        const cv::Mat conf(num_priors_actual, _num_classes, CV_32FC1, const_cast<float*>(conf_data));
+        cv::compare(conf, _confidence_threshold, _candidates_mask, cv::CMP_GT);
+        if (num_priors_actual > 0) {
+            cv::findNonZero(_candidates_mask, _candidates);
+        } else {
+            _candidates.clear();
+        }
+        for (const cv::Point &candidate : _candidates) {
+            if (candidate.x != _background_label_id) {
+                ClassWorkspace &workspace = _classes[candidate.x];
+                workspace.priors.push_back(candidate.y);
+                workspace.confs.push_back(conf_data[candidate.y * _num_classes + candidate.x]);
             }
+        }
 
-            if (_keep_top_k > -1 && detections_total > _keep_top_k) {
-                std::vector<std::pair<float, std::pair<int, int>>> conf_index_class_map;
-
-                for (int c = 0; c < _num_classes; ++c) {
-                    int detections = detections_data[n*_num_classes + c];
-                    int *pindices = indices_data + n*_num_classes*_num_priors + c*_num_priors;
-                    float *pconf  = reordered_conf_data + n*_num_classes*_num_priors + c*_num_priors;
-
-                    for (int i = 0; i < detections; ++i) {
-                        int idx = pindices[i];
-                        conf_index_class_map.push_back(std::make_pair(pconf[idx], std::make_pair(c, idx)));
-                    }
+        // The classes are independent, so decoding and NMS run in parallel
+        cv::parallel_for_(cv::Range(0, _num_classes), [&](const cv::Range &range) {
+            for (int c = range.start; c < range.end; ++c) {
+                ClassWorkspace &workspace = _classes[c];
+                workspace.kept.clear();
+                if (workspace.priors.empty()) {
+                    continue;
                 }
+                decodeBBoxes(prior_data, loc_data + c*4, workspace);
+                nms(workspace);
+            }
+        });
 
-                std::sort(conf_index_class_map.begin(), conf_index_class_map.end(),
-                          SortScorePairDescend<std::pair<int, int>>);
-                conf_index_class_map.resize(_keep_top_k);
+        int detections_total = 0;
+        for (const ClassWorkspace &workspace : _classes) {
+            detections_total += static_cast<int>(workspace.kept.size());
+        }
 
-                // Store the new indices.
-                memset(detections_data + n*_num_classes, 0, _num_classes * sizeof(int));
+        if (_keep_top_k > -1 && detections_total > _keep_top_k) {
+            _conf_index_class_map.clear();
 
-                for (size_t j = 0; j < conf_index_class_map.size(); ++j) {
-                    int label = conf_index_class_map[j].second.first;
-                    int idx = conf_index_class_map[j].second.second;
-                    int *pindices = indices_data + n * _num_classes * _num_priors + label * _num_priors;
-                    pindices[detections_data[n*_num_classes + label]] = idx;
-                    detections_data[n*_num_classes + label]++;
+            for (int c = 0; c < _num_classes; ++c) {
+                ClassWorkspace &workspace = _classes[c];
+                for (int idx : workspace.kept) {
+                    _conf_index_class_map.push_back(std::make_pair(workspace.confs[idx], std::make_pair(c, idx)));
                 }
             }
-        }
 
-        const int DETECTION_SIZE = outputs[0]->getTensorDesc().getDims()[3];
-        if (DETECTION_SIZE != 7) {
-            return NOT_IMPLEMENTED;
-        }
+            std::sort(_conf_index_class_map.begin(), _conf_index_class_map.end(),
+                      SortScorePairDescend<std::pair<int, int>>);
+            _conf_index_class_map.resize(_keep_top_k);
 
-        auto dst_data_size = N * _keep_top_k * DETECTION_SIZE * sizeof(float);
+            // Store the new indices.
+            for (ClassWorkspace &workspace : _classes) {
+                workspace.kept.clear();
+            }
 
-        if (dst_data_size > outputs[0]->byteSize()) {
-            return OUT_OF_BOUNDS;
+            for (size_t j = 0; j < _conf_index_class_map.size(); ++j) {
+                int label = _conf_index_class_map[j].second.first;
+                int idx = _conf_index_class_map[j].second.second;
+                _classes[label].kept.push_back(idx);
+            }
         }
 
         memset(dst_data, 0, dst_data_size);
 
         int count = 0;
         for (int n = 0; n < N; ++n) {
-            const float *pconf   = reordered_conf_data + n * _num_priors * _num_classes;
-            const float *pboxes  = decoded_bboxes_data + n*_num_priors*4*_num_loc_classes;
-            const int *pindices  = indices_data + n*_num_classes*_num_priors;
-
             for (int c = 0; c < _num_classes; ++c) {
-                for (int i = 0; i < detections_data[n*_num_classes + c]; ++i) {
-                    int idx = pindices[c*_num_priors + i];
-
+                const ClassWorkspace &workspace = _classes[c];
+                for (int idx : workspace.kept) {
                     dst_data[count * DETECTION_SIZE + 0] = static_cast<float>(n);
                     dst_data[count * DETECTION_SIZE + 1] = static_cast<float>(c);
-                    dst_data[count * DETECTION_SIZE + 2] = pconf[c*_num_priors + idx];
+                    dst_data[count * DETECTION_SIZE + 2] = workspace.confs[idx];
 
-                    float xmin = pboxes[c*4*_num_priors + idx*4 + 0];
-                    float ymin = pboxes[c*4*_num_priors + idx*4 + 1];
-                    float xmax = pboxes[c*4*_num_priors + idx*4 + 2];
-                    float ymax = pboxes[c*4*_num_priors + idx*4 + 3];
+                    float xmin = workspace.boxes[idx*4 + 0];
+                    float ymin = workspace.boxes[idx*4 + 1];
+                    float xmax = workspace.boxes[idx*4 + 2];
+                    float ymax = workspace.boxes[idx*4 + 3];
 
                     dst_data[count * DETECTION_SIZE + 3] = xmin;
                     dst_data[count * DETECTION_SIZE + 4] = ymin;
@@ -282,24 +235,30 @@ private:
     const int _offset = 1;
 
     const float _nms_threshold = 0.3f;
-    const float _confidence_threshold = -FLT_MAX;
+    const float _confidence_threshold;
 
     int _num_loc_classes = 0;
     int _num_priors = 0;
 
-    void decodeBBoxes(const float *prior_data, const float *loc_data, const float *variance_data,
-                      float *decoded_bboxes, float *decoded_bbox_sizes, int* num_priors_actual, int n);
-
-    void nms(const float *conf_data, const float *bboxes, const float *sizes,
-             int *buffer, int *indices, int &detections, int num_priors_actual);
-
-    Blob::Ptr _decoded_bboxes;
-    Blob::Ptr _buffer;
-    Blob::Ptr _indices;
-    Blob::Ptr _detections_count;
-    Blob::Ptr _reordered_conf;
-    Blob::Ptr _bbox_sizes;
-    Blob::Ptr _num_priors_actual;
+    // The candidates of a class are the priors whose confidence for the class is above the threshold.
+    // Boxes, confidences and indices refer to the candidates by their positions in priors.
+    struct ClassWorkspace {
+        std::vector<int> priors;
+        std::vector<float> confs;
+        std::vector<float> boxes;
+        std::vector<float> sizes;
+        std::vector<int> order;
+        std::vector<int> kept;
+    };
+
+    void decodeBBoxes(const float *prior_data, const float *loc_data, ClassWorkspace &workspace);
+
+    void nms(ClassWorkspace &workspace);
+
+    cv::Mat _candidates_mask;
+    std::vector<cv::Point> _candidates;
+    std::vector<ClassWorkspace> _classes;
+    std::vector<std::pair<float, std::pair<int, int>>> _conf_index_class_map;
 };
 
 struct ConfidenceComparator {
@@ -353,22 +312,12 @@ static inline float JaccardOverlap(const float *decoded_bbox,
 
 void DetectionOutputPostProcessor::decodeBBoxes(const float *prior_data,
                                    const float *loc_data,
-                                   const float *variance_data,
-                                   float *decoded_bboxes,
-                                   float *decoded_bbox_sizes,
-                                   int* num_priors_actual,
-                                   int n) {
-    num_priors_actual[n] = _num_priors;
-
-    for (int num = 0; num < _num_priors; ++num) {
-        float batch_id = prior_data[num * _prior_size + 0];
-        if (batch_id == -1.f) {
-            num_priors_actual[n] = num;
-            break;
-        }
-    }
+                                   ClassWorkspace &workspace) {
+    workspace.boxes.resize(4 * workspace.priors.size());
+    workspace.sizes.resize(workspace.priors.size());
 
-    for (int p = 0; p < num_priors_actual[n]; ++p) {
+    for (size_t i = 0; i < workspace.priors.size(); ++i) {
+        const int p = workspace.priors[i];
         float prior_xmin = prior_data[p*_prior_size + 0 + _offset];
         float prior_ymin = prior_data[p*_prior_size + 1 + _offset];
         float prior_xmax = prior_data[p*_prior_size + 2 + _offset];
@@ -403,52 +352,40 @@ void DetectionOutputPostProcessor::decodeBBoxes(const float *prior_data,
         float new_xmax = decode_bbox_center_x + decode_bbox_width  / 2.0f;
         float new_ymax = decode_bbox_center_y + decode_bbox_height / 2.0f;
 
-        decoded_bboxes[p*4 + 0] = new_xmin;
-        decoded_bboxes[p*4 + 1] = new_ymin;
-        decoded_bboxes[p*4 + 2] = new_xmax;
-        decoded_bboxes[p*4 + 3] = new_ymax;
+        workspace.boxes[i*4 + 0] = new_xmin;
+        workspace.boxes[i*4 + 1] = new_ymin;
+        workspace.boxes[i*4 + 2] = new_xmax;
+        workspace.boxes[i*4 + 3] = new_ymax;
 
-        decoded_bbox_sizes[p] = (new_xmax - new_xmin) * (new_ymax - new_ymin);
+        workspace.sizes[i] = (new_xmax - new_xmin) * (new_ymax - new_ymin);
     }
 }
 
-void DetectionOutputPostProcessor::nms(const float* conf_data,
-                          const float* bboxes,
-                          const float* sizes,
-                          int* buffer,
-                          int* indices,
-                          int& detections,
-                          int num_priors_actual) {
-    int count = 0;
-    for (int i = 0; i < num_priors_actual; ++i) {
-        if (conf_data[i] > _confidence_threshold) {
-            indices[count] = i;
-            count++;
-        }
-    }
-
+void DetectionOutputPostProcessor::nms(ClassWorkspace &workspace) {
+    int count = static_cast<int>(workspace.priors.size());
     int num_output_scores = (_top_k == -1 ? count : std::min<int>(_top_k, count));
 
-    std::partial_sort_copy(indices, indices + count,
-                           buffer, buffer + num_output_scores,
-                           ConfidenceComparator(conf_data));
+    // candidates are ordered by prior, so the ties are broken by prior as in DetectionOutputImpl
+    workspace.order.resize(count);
+    for (int i = 0; i < count; ++i) {
+        workspace.order[i] = i;
+    }
+    std::partial_sort(workspace.order.begin(), workspace.order.begin() + num_output_scores, workspace.order.end(),
+                      ConfidenceComparator(workspace.confs.data()));
 
     for (int i = 0; i < num_output_scores; ++i) {
-        const int idx = buffer[i];
+        const int idx = workspace.order[i];
 
         bool keep = true;
-        for (int k = 0; k < detections; ++k) {
-            const int kept_idx = indices[k];
-            float overlap = JaccardOverlap(bboxes, sizes, idx, kept_idx);
+        for (int kept_idx : workspace.kept) {
+            float overlap = JaccardOverlap(workspace.boxes.data(), workspace.sizes.data(), idx, kept_idx);
             if (overlap > _nms_threshold) {
                 keep = false;
                 break;
             }
         }
         if (keep) {
-            indices[detections] = idx;
-            detections++;
+            workspace.kept.push_back(idx);
         }
     }
 }
-
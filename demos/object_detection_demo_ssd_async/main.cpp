@@ -21,6 +21,7 @@
 #include <ngraph/ngraph.hpp>
 
 #include <monitors/presenter.h>
+#include <pipeline/async_pipeline.hpp>
 #include <samples/ocv_common.hpp>
 #include <samples/slog.hpp>
 
@@ -50,18 +51,27 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
 }
 
 void frameToBlob(const cv::Mat& frame,
-                 InferRequest::Ptr& inferRequest,
+                 InferRequest& inferRequest,
                  const std::string& inputName) {
     if (FLAGS_auto_resize) {
         /* Just set input blob containing read image. Resize and layout conversion will be done automatically */
-        inferRequest->SetBlob(inputName, wrapMat2Blob(frame));
+        inferRequest.SetBlob(inputName, wrapMat2Blob(frame));
     } else {
         /* Resize and copy data from the image to the input blob */
-        Blob::Ptr frameBlob = inferRequest->GetBlob(inputName);
+        Blob::Ptr frameBlob = inferRequest.GetBlob(inputName);
         matU8ToBlob<uint8_t>(frame, frameBlob);
     }
 }
 
+struct Detection {
+    int label;
+    float confidence;
+    float xmin;
+    float ymin;
+    float xmax;
+    float ymax;
+};
+
 int main(int argc, char *argv[]) {
     try {
         /** This demo covers certain topology and cannot be generalized for any object detection **/
@@ -81,8 +91,7 @@ int main(int argc, char *argv[]) {
         const size_t height = (size_t) cap.get(cv::CAP_PROP_FRAME_HEIGHT);
 
         // read input (video) frame
-        cv::Mat curr_frame;  cap >> curr_frame;
-        cv::Mat next_frame;
+        cv::Mat next_frame;  cap >> next_frame;
 
         if (!cap.grab()) {
             throw std::logic_error("This demo supports only video (or camera) inputs !!! "
@@ -221,22 +230,41 @@ int main(int argc, char *argv[]) {
         ExecutableNetwork network = ie.LoadNetwork(cnnNetwork, FLAGS_d);
         // -----------------------------------------------------------------------------------------------------
 
-        // --------------------------- 5. Create infer request -------------------------------------------------
-        InferRequest::Ptr async_infer_request_curr = network.CreateInferRequestPtr();
-        InferRequest::Ptr async_infer_request_next = network.CreateInferRequestPtr();
+        // --------------------------- 5. Create infer requests -----------------------------------------------
+        // Frames are preprocessed on the main thread and postprocessed on the threads of the pipeline
+        AsyncPipeline<cv::Mat, std::vector<Detection>> pipeline(network, FLAGS_nireq,
+            [&](const cv::Mat& frame, InferRequest& inferRequest) {
+                frameToBlob(frame, inferRequest, imageInputName);
+            },
+            [&](const cv::Mat&, InferRequest& inferRequest) {
+                LockedMemory<const void> outputMapped = as<MemoryBlob>(inferRequest.GetBlob(outputName))->rmap();
+                const float *detections = outputMapped.as<float*>();
+                std::vector<Detection> objects;
+                for (int i = 0; i < maxProposalCount; i++) {
+                    float image_id = detections[i * objectSize + 0];
+                    if (image_id < 0) {
+                        break;
+                    }
+                    objects.push_back({static_cast<int>(detections[i * objectSize + 1]),
+                                       detections[i * objectSize + 2],
+                                       detections[i * objectSize + 3] * width,
+                                       detections[i * objectSize + 4] * height,
+                                       detections[i * objectSize + 5] * width,
+                                       detections[i * objectSize + 6] * height});
+                }
+                return objects;
+            });
 
         /* it's enough just to set image info input (if used in the model) only once */
         if (!imageInfoInputName.empty()) {
-            auto setImgInfoBlob = [&](const InferRequest::Ptr &inferReq) {
-                auto blob = inferReq->GetBlob(imageInfoInputName);
+            for (size_t i = 0; i < pipeline.getDepth(); i++) {
+                auto blob = pipeline.getRequest(i).GetBlob(imageInfoInputName);
                 LockedMemory<void> blobMapped = as<MemoryBlob>(blob)->wmap();
                 auto data = blobMapped.as<float *>();
                 data[0] = static_cast<float>(netInputHeight);  // height
                 data[1] = static_cast<float>(netInputWidth);  // width
                 data[2] = 1;
-            };
-            setImgInfoBlob(async_infer_request_curr);
-            setImgInfoBlob(async_infer_request_next);
+            }
         }
         // -----------------------------------------------------------------------------------------------------
 
@@ -245,121 +273,93 @@ int main(int argc, char *argv[]) {
 
         bool isLastFrame = false;
         bool isAsyncMode = false;  // execution is always started using SYNC mode
-        bool isModeChanged = false;  // set to TRUE when execution mode is changed (SYNC<->ASYNC)
 
         typedef std::chrono::duration<double, std::ratio<1, 1000>> ms;
         auto total_t0 = std::chrono::high_resolution_clock::now();
         auto wallclock = std::chrono::high_resolution_clock::now();
         double ocv_render_time = 0;
+        size_t framesCount = 0;
 
         std::cout << "To close the application, press 'CTRL+C' here or switch to the output window and press ESC key" << std::endl;
         std::cout << "To switch between sync/async modes, press TAB key in the output window" << std::endl;
         cv::Size graphSize{static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH) / 4), 60};
         Presenter presenter(FLAGS_u, static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)) - graphSize.height - 10, graphSize);
+        cv::Mat curr_frame;
+        std::vector<Detection> detections;
         while (true) {
             auto t0 = std::chrono::high_resolution_clock::now();
             // Here is the first asynchronous point:
-            // in the async mode we capture frame to populate the NEXT infer request
-            // in the regular mode we capture frame to the CURRENT infer request
-            if (!cap.read(next_frame)) {
-                if (next_frame.empty()) {
-                    isLastFrame = true;  // end of video file
-                } else {
-                    throw std::logic_error("Failed to get frame from cv::VideoCapture");
-                }
-            }
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    frameToBlob(curr_frame, async_infer_request_curr, imageInputName);
-                }
-                if (!isLastFrame) {
-                    frameToBlob(next_frame, async_infer_request_next, imageInputName);
+            // in the async mode we capture frames to populate free infer requests until nireq of them are busy
+            // in the regular mode we capture the frame for the only busy infer request
+            const size_t depth = isAsyncMode ? pipeline.getDepth() : 1;
+            while (!isLastFrame && pipeline.pending() < depth) {
+                pipeline.submit(next_frame);
+                next_frame = cv::Mat();  // the pipeline keeps the submitted frame
+                if (!cap.read(next_frame)) {
+                    if (next_frame.empty()) {
+                        isLastFrame = true;  // end of video file
+                    } else {
+                        throw std::logic_error("Failed to get frame from cv::VideoCapture");
+                    }
                 }
-            } else if (!isModeChanged) {
-                frameToBlob(curr_frame, async_infer_request_curr, imageInputName);
             }
 
             auto t1 = std::chrono::high_resolution_clock::now();
             double ocv_decode_time = std::chrono::duration_cast<ms>(t1 - t0).count();
 
-            t0 = std::chrono::high_resolution_clock::now();
             // Main sync point:
-            // in the truly Async mode we start the NEXT infer request, while waiting for the CURRENT to complete
-            // in the regular mode we start the CURRENT request and immediately wait for it's completion
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    async_infer_request_curr->StartAsync();
-                }
-                if (!isLastFrame) {
-                    async_infer_request_next->StartAsync();
-                }
-            } else if (!isModeChanged) {
-                async_infer_request_curr->StartAsync();
+            // we wait for the results of the earliest submitted frame, in the regular mode it is the frame
+            // which was just submitted, so the wait measures the detection
+            if (!pipeline.pop(curr_frame, detections)) {
+                break;  // all frames are shown
             }
+            t1 = std::chrono::high_resolution_clock::now();
+            ms detection = std::chrono::duration_cast<ms>(t1 - t0);
+            framesCount++;
 
-            if (OK == async_infer_request_curr->Wait(IInferRequest::WaitMode::RESULT_READY)) {
-                t1 = std::chrono::high_resolution_clock::now();
-                ms detection = std::chrono::duration_cast<ms>(t1 - t0);
-
-                t0 = std::chrono::high_resolution_clock::now();
-                ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
-                wallclock = t0;
-
-                t0 = std::chrono::high_resolution_clock::now();
-
-                presenter.drawGraphs(curr_frame);
-
-                std::ostringstream out;
-                out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
-                    << (ocv_decode_time + ocv_render_time) << " ms";
-                cv::putText(curr_frame, out.str(), cv::Point2f(0, 25), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+            t0 = std::chrono::high_resolution_clock::now();
+            ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
+            wallclock = t0;
+
+            presenter.drawGraphs(curr_frame);
+
+            std::ostringstream out;
+            out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
+                << (ocv_decode_time + ocv_render_time) << " ms";
+            cv::putText(curr_frame, out.str(), cv::Point2f(0, 25), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+            out.str("");
+            out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
+            out << std::fixed << std::setprecision(2) << wall.count() << " ms (" << 1000.f / wall.count() << " fps)";
+            cv::putText(curr_frame, out.str(), cv::Point2f(0, 50), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
+            if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
                 out.str("");
-                out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
-                out << std::fixed << std::setprecision(2) << wall.count() << " ms (" << 1000.f / wall.count() << " fps)";
-                cv::putText(curr_frame, out.str(), cv::Point2f(0, 50), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
-                if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
-                    out.str("");
-                    out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
-                        << " ms ("
-                        << 1000.f / detection.count() << " fps)";
-                    cv::putText(curr_frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
-                                cv::Scalar(255, 0, 0));
-                }
-
-                // ---------------------------Process output blobs--------------------------------------------------
-                // Processing results of the CURRENT request
-                LockedMemory<const void> outputMapped = as<MemoryBlob>(
-                    async_infer_request_curr->GetBlob(outputName))->rmap();
-                const float *detections = outputMapped.as<float*>();
-                for (int i = 0; i < maxProposalCount; i++) {
-                    float image_id = detections[i * objectSize + 0];
-                    if (image_id < 0) {
-                        break;
-                    }
+                out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
+                    << " ms ("
+                    << 1000.f / detection.count() << " fps)";
+                cv::putText(curr_frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
+                            cv::Scalar(255, 0, 0));
+            }
 
-                    float confidence = detections[i * objectSize + 2];
-                    auto label = static_cast<int>(detections[i * objectSize + 1]);
-                    float xmin = detections[i * objectSize + 3] * width;
-                    float ymin = detections[i * objectSize + 4] * height;
-                    float xmax = detections[i * objectSize + 5] * width;
-                    float ymax = detections[i * objectSize + 6] * height;
-
-                    if (FLAGS_r) {
-                        std::cout << "[" << i << "," << label << "] element, prob = " << confidence <<
-                                  "    (" << xmin << "," << ymin << ")-(" << xmax << "," << ymax << ")"
-                                  << ((confidence > FLAGS_t) ? " WILL BE RENDERED!" : "") << std::endl;
-                    }
+            // ---------------------------Process output blobs--------------------------------------------------
+            // Processing results of the earliest submitted frame
+            for (size_t i = 0; i < detections.size(); i++) {
+                const Detection& object = detections[i];
+                if (FLAGS_r) {
+                    std::cout << "[" << i << "," << object.label << "] element, prob = " << object.confidence <<
+                              "    (" << object.xmin << "," << object.ymin << ")-(" << object.xmax << "," << object.ymax << ")"
+                              << ((object.confidence > FLAGS_t) ? " WILL BE RENDERED!" : "") << std::endl;
+                }
 
-                    if (confidence > FLAGS_t) {
-                        /** Drawing only objects when > confidence_threshold probability **/
-                        std::ostringstream conf;
-                        conf << ":" << std::fixed << std::setprecision(3) << confidence;
-                        cv::putText(curr_frame,
-                                    (!labels.empty() ? labels[label] : std::string("label #") + std::to_string(label)) + conf.str(),
-                                    cv::Point2f(xmin, ymin - 5), cv::FONT_HERSHEY_COMPLEX_SMALL, 1,
-                                    cv::Scalar(0, 0, 255));
-                        cv::rectangle(curr_frame, cv::Point2f(xmin, ymin), cv::Point2f(xmax, ymax), cv::Scalar(0, 0, 255));
-                    }
+                if (object.confidence > FLAGS_t) {
+                    /** Drawing only objects when > confidence_threshold probability **/
+                    std::ostringstream conf;
+                    conf << ":" << std::fixed << std::setprecision(3) << object.confidence;
+                    cv::putText(curr_frame,
+                                (!labels.empty() ? labels[object.label] : std::string("label #") + std::to_string(object.label)) + conf.str(),
+                                cv::Point2f(object.xmin, object.ymin - 5), cv::FONT_HERSHEY_COMPLEX_SMALL, 1,
+                                cv::Scalar(0, 0, 255));
+                    cv::rectangle(curr_frame, cv::Point2f(object.xmin, object.ymin), cv::Point2f(object.xmax, object.ymax),
+                                  cv::Scalar(0, 0, 255));
                 }
             }
 
@@ -370,40 +370,26 @@ int main(int argc, char *argv[]) {
             t1 = std::chrono::high_resolution_clock::now();
             ocv_render_time = std::chrono::duration_cast<ms>(t1 - t0).count();
 
-            if (isLastFrame) {
-                break;
-            }
-
-            if (isModeChanged) {
-                isModeChanged = false;
-            }
-
-            // Final point:
-            // in the truly Async mode we swap the NEXT and CURRENT requests for the next iteration
-            curr_frame = next_frame;
-            next_frame = cv::Mat();
-            if (isAsyncMode) {
-                async_infer_request_curr.swap(async_infer_request_next);
-            }
-
             const int key = cv::waitKey(1);
             if (27 == key)  // Esc
                 break;
             if (9 == key) {  // Tab
                 isAsyncMode ^= true;
-                isModeChanged = true;
             } else {
                 presenter.handleKey(key);
             }
         }
+        pipeline.waitAll();
         // -----------------------------------------------------------------------------------------------------
         auto total_t1 = std::chrono::high_resolution_clock::now();
         ms total = std::chrono::duration_cast<ms>(total_t1 - total_t0);
         std::cout << "Total Inference time: " << total.count() << std::endl;
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+                  << framesCount * 1000.0 / total.count() << " fps" << std::endl;
 
         /** Show performace results **/
         if (FLAGS_pc) {
-            printPerformanceCounts(*async_infer_request_curr, std::cout, getFullDeviceName(ie, FLAGS_d));
+            printPerformanceCounts(pipeline.getRequest(0), std::cout, getFullDeviceName(ie, FLAGS_d));
         }
         std::cout << presenter.reportMeans() << '\n';
     }
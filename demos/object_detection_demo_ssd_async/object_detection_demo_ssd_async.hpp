@@ -27,6 +27,8 @@ static const char raw_output_message[] = "Optional. Inference results as raw val
 static const char input_resizable_message[] = "Optional. Enables resizable input with support of ROI crop & auto resize.";
 static const char no_show_processed_video[] = "Optional. Do not show processed video.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char num_infer_requests_message[] = "Optional. Number of infer requests, the depth of the pipeline in the async mode. "
+                                                 "Default value is 2.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", video_message);
@@ -41,6 +43,7 @@ DEFINE_double(t, 0.5, thresh_output_message);
 DEFINE_bool(auto_resize, false, input_resizable_message);
 DEFINE_bool(no_show, false, no_show_processed_video);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_uint32(nireq, 2, num_infer_requests_message);
 
 /**
 * \brief This function shows a help message
@@ -64,4 +67,5 @@ static void showUsage() {
     std::cout << "    -auto_resize              " << input_resizable_message << std::endl;
     std::cout << "    -no_show                  " << no_show_processed_video << std::endl;
     std::cout << "    -u                        " << utilization_monitors_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"        " << num_infer_requests_message << std::endl;
 }
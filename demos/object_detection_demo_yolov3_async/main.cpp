@@ -23,10 +23,12 @@
 #include <ngraph/ngraph.hpp>
 
 #include <monitors/presenter.h>
+#include <pipeline/async_pipeline.hpp>
 #include <samples/ocv_common.hpp>
 #include <samples/slog.hpp>
 
 #include "object_detection_demo_yolov3_async.hpp"
+#include "yolo_output.hpp"
 
 using namespace InferenceEngine;
 
@@ -50,133 +52,17 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
     return true;
 }
 
-void FrameToBlob(const cv::Mat &frame, InferRequest::Ptr &inferRequest, const std::string &inputName) {
+void FrameToBlob(const cv::Mat &frame, InferRequest &inferRequest, const std::string &inputName) {
     if (FLAGS_auto_resize) {
         /* Just set input blob containing read image. Resize and layout conversion will be done automatically */
-        inferRequest->SetBlob(inputName, wrapMat2Blob(frame));
+        inferRequest.SetBlob(inputName, wrapMat2Blob(frame));
     } else {
         /* Resize and copy data from the image to the input blob */
-        Blob::Ptr frameBlob = inferRequest->GetBlob(inputName);
+        Blob::Ptr frameBlob = inferRequest.GetBlob(inputName);
         matU8ToBlob<uint8_t>(frame, frameBlob);
     }
 }
 
-static int EntryIndex(int side, int lcoords, int lclasses, int location, int entry) {
-    int n = location / (side * side);
-    int loc = location % (side * side);
-    return n * side * side * (lcoords + lclasses + 1) + entry * side * side + loc;
-}
-
-struct DetectionObject {
-    int xmin, ymin, xmax, ymax, class_id;
-    float confidence;
-
-    DetectionObject(double x, double y, double h, double w, int class_id, float confidence, float h_scale, float w_scale) {
-        this->xmin = static_cast<int>((x - w / 2) * w_scale);
-        this->ymin = static_cast<int>((y - h / 2) * h_scale);
-        this->xmax = static_cast<int>(this->xmin + w * w_scale);
-        this->ymax = static_cast<int>(this->ymin + h * h_scale);
-        this->class_id = class_id;
-        this->confidence = confidence;
-    }
-
-    bool operator <(const DetectionObject &s2) const {
-        return this->confidence < s2.confidence;
-    }
-    bool operator >(const DetectionObject &s2) const {
-        return this->confidence > s2.confidence;
-    }
-};
-
-double IntersectionOverUnion(const DetectionObject &box_1, const DetectionObject &box_2) {
-    double width_of_overlap_area = fmin(box_1.xmax, box_2.xmax) - fmax(box_1.xmin, box_2.xmin);
-    double height_of_overlap_area = fmin(box_1.ymax, box_2.ymax) - fmax(box_1.ymin, box_2.ymin);
-    double area_of_overlap;
-    if (width_of_overlap_area < 0 || height_of_overlap_area < 0)
-        area_of_overlap = 0;
-    else
-        area_of_overlap = width_of_overlap_area * height_of_overlap_area;
-    double box_1_area = (box_1.ymax - box_1.ymin)  * (box_1.xmax - box_1.xmin);
-    double box_2_area = (box_2.ymax - box_2.ymin)  * (box_2.xmax - box_2.xmin);
-    double area_of_union = box_1_area + box_2_area - area_of_overlap;
-    return area_of_overlap / area_of_union;
-}
-
-class YoloParams {
-    template <typename T>
-    void computeAnchors(const std::vector<T> & mask) {
-        std::vector<float> maskedAnchors(num * 2);
-        for (int i = 0; i < num; ++i) {
-            maskedAnchors[i * 2] = anchors[mask[i] * 2];
-            maskedAnchors[i * 2 + 1] = anchors[mask[i] * 2 + 1];
-        }
-        anchors = maskedAnchors;
-    }
-
-public:
-    int num = 0, classes = 0, coords = 0;
-    std::vector<float> anchors = {10.0, 13.0, 16.0, 30.0, 33.0, 23.0, 30.0, 61.0, 62.0, 45.0, 59.0, 119.0, 116.0, 90.0,
-                                  156.0, 198.0, 373.0, 326.0};
-
-    YoloParams() {}
-
-    YoloParams(const std::shared_ptr<ngraph::op::RegionYolo> regionYolo) {
-        coords = regionYolo->get_num_coords();
-        classes = regionYolo->get_num_classes();
-        anchors = regionYolo->get_anchors();
-        auto mask = regionYolo->get_mask();
-        num = mask.size();
-
-        computeAnchors(mask);
-    }
-};
-
-void ParseYOLOV3Output(const YoloParams &params, const std::string & output_name,
-                       const Blob::Ptr &blob, const unsigned long resized_im_h,
-                       const unsigned long resized_im_w, const unsigned long original_im_h,
-                       const unsigned long original_im_w,
-                       const double threshold, std::vector<DetectionObject> &objects) {
-
-    const int out_blob_h = static_cast<int>(blob->getTensorDesc().getDims()[2]);
-    const int out_blob_w = static_cast<int>(blob->getTensorDesc().getDims()[3]);
-    if (out_blob_h != out_blob_w)
-        throw std::runtime_error("Invalid size of output " + output_name +
-        " It should be in NCHW layout and H should be equal to W. Current H = " + std::to_string(out_blob_h) +
-        ", current W = " + std::to_string(out_blob_h));
-
-    auto side = out_blob_h;
-    auto side_square = side * side;
-    LockedMemory<const void> blobMapped = as<MemoryBlob>(blob)->rmap();
-    const float *output_blob = blobMapped.as<float *>();
-    // --------------------------- Parsing YOLO Region output -------------------------------------
-    for (int i = 0; i < side_square; ++i) {
-        int row = i / side;
-        int col = i % side;
-        for (int n = 0; n < params.num; ++n) {
-            int obj_index = EntryIndex(side, params.coords, params.classes, n * side * side + i, params.coords);
-            int box_index = EntryIndex(side, params.coords, params.classes, n * side * side + i, 0);
-            float scale = output_blob[obj_index];
-            if (scale < threshold)
-                continue;
-            double x = (col + output_blob[box_index + 0 * side_square]) / side * resized_im_w;
-            double y = (row + output_blob[box_index + 1 * side_square]) / side * resized_im_h;
-            double height = std::exp(output_blob[box_index + 3 * side_square]) * params.anchors[2 * n + 1];
-            double width = std::exp(output_blob[box_index + 2 * side_square]) * params.anchors[2 * n];
-            for (int j = 0; j < params.classes; ++j) {
-                int class_index = EntryIndex(side, params.coords, params.classes, n * side_square + i, params.coords + 1 + j);
-                float prob = scale * output_blob[class_index];
-                if (prob < threshold)
-                    continue;
-                DetectionObject obj(x, y, height, width, j, prob,
-                        static_cast<float>(original_im_h) / static_cast<float>(resized_im_h),
-                        static_cast<float>(original_im_w) / static_cast<float>(resized_im_w));
-                objects.push_back(obj);
-            }
-        }
-    }
-}
-
-
 int main(int argc, char *argv[]) {
     try {
         /** This demo covers a certain topology and cannot be generalized for any object detection **/
@@ -194,8 +80,7 @@ int main(int argc, char *argv[]) {
         }
 
         // read input (video) frame
-        cv::Mat frame;  cap >> frame;
-        cv::Mat next_frame;
+        cv::Mat next_frame;  cap >> next_frame;
 
         const size_t width  = (size_t) cap.get(cv::CAP_PROP_FRAME_WIDTH);
         const size_t height = (size_t) cap.get(cv::CAP_PROP_FRAME_HEIGHT);
@@ -306,9 +191,27 @@ int main(int argc, char *argv[]) {
         ExecutableNetwork network = ie.LoadNetwork(cnnNetwork, FLAGS_d);
         // -----------------------------------------------------------------------------------------------------
 
-        // --------------------------- 5. Creating infer request -----------------------------------------------
-        InferRequest::Ptr async_infer_request_next = network.CreateInferRequestPtr();
-        InferRequest::Ptr async_infer_request_curr = network.CreateInferRequestPtr();
+        // --------------------------- 5. Creating infer requests ---------------------------------------------
+        // Frames are preprocessed on the main thread and postprocessed on the threads of the pipeline
+        const TensorDesc& inputDesc = inputInfo.begin()->second.get()->getTensorDesc();
+        const unsigned long resized_im_h = getTensorHeight(inputDesc);
+        const unsigned long resized_im_w = getTensorWidth(inputDesc);
+        AsyncPipeline<cv::Mat, std::vector<DetectionObject>> pipeline(network, FLAGS_nireq,
+            [&](const cv::Mat &frame, InferRequest &inferRequest) {
+                FrameToBlob(frame, inferRequest, inputName);
+            },
+            [&](const cv::Mat &, InferRequest &inferRequest) {
+                std::vector<DetectionObject> objects;
+                // Parsing outputs
+                for (auto &output : outputInfo) {
+                    auto output_name = output.first;
+                    Blob::Ptr blob = inferRequest.GetBlob(output_name);
+                    ParseYOLOV3Output(yoloParams.at(output_name), output_name, blob, resized_im_h, resized_im_w, height, width, FLAGS_t, objects);
+                }
+                // Filtering overlapping boxes
+                FilterOverlappingObjects(objects, FLAGS_iou_t);
+                return objects;
+            });
         // -----------------------------------------------------------------------------------------------------
 
         // --------------------------- 6. Doing inference ------------------------------------------------------
@@ -316,127 +219,93 @@ int main(int argc, char *argv[]) {
 
         bool isLastFrame = false;
         bool isAsyncMode = false;  // execution is always started using SYNC mode
-        bool isModeChanged = false;  // set to TRUE when execution mode is changed (SYNC<->ASYNC)
 
         typedef std::chrono::duration<double, std::ratio<1, 1000>> ms;
         auto total_t0 = std::chrono::high_resolution_clock::now();
         auto wallclock = std::chrono::high_resolution_clock::now();
         double ocv_render_time = 0;
+        size_t framesCount = 0;
 
         std::cout << "To close the application, press 'CTRL+C' here or switch to the output window and press ESC key" << std::endl;
         std::cout << "To switch between sync/async modes, press TAB key in the output window" << std::endl;
         cv::Size graphSize{static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH) / 4), 60};
         Presenter presenter(FLAGS_u, static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)) - graphSize.height - 10, graphSize);
+        cv::Mat frame;
+        std::vector<DetectionObject> objects;
         while (true) {
             auto t0 = std::chrono::high_resolution_clock::now();
             // Here is the first asynchronous point:
-            // in the Async mode, we capture frame to populate the NEXT infer request
-            // in the regular mode, we capture frame to the CURRENT infer request
-            if (!cap.read(next_frame)) {
-                if (next_frame.empty()) {
-                    isLastFrame = true;  // end of video file
-                } else {
-                    throw std::logic_error("Failed to get frame from cv::VideoCapture");
-                }
-            }
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    FrameToBlob(frame, async_infer_request_curr, inputName);
-                }
-                if (!isLastFrame) {
-                    FrameToBlob(next_frame, async_infer_request_next, inputName);
+            // in the Async mode, we capture frames to populate free infer requests until nireq of them are busy
+            // in the regular mode, we capture the frame for the only busy infer request
+            const size_t depth = isAsyncMode ? pipeline.getDepth() : 1;
+            while (!isLastFrame && pipeline.pending() < depth) {
+                pipeline.submit(next_frame);
+                next_frame = cv::Mat();  // the pipeline keeps the submitted frame
+                if (!cap.read(next_frame)) {
+                    if (next_frame.empty()) {
+                        isLastFrame = true;  // end of video file
+                    } else {
+                        throw std::logic_error("Failed to get frame from cv::VideoCapture");
+                    }
                 }
-            } else if (!isModeChanged) {
-                FrameToBlob(frame, async_infer_request_curr, inputName);
             }
             auto t1 = std::chrono::high_resolution_clock::now();
             double ocv_decode_time = std::chrono::duration_cast<ms>(t1 - t0).count();
 
-            t0 = std::chrono::high_resolution_clock::now();
             // Main sync point:
-            // in the true Async mode, we start the NEXT infer request while waiting for the CURRENT to complete
-            // in the regular mode, we start the CURRENT request and wait for its completion
-            if (isAsyncMode) {
-                if (isModeChanged) {
-                    async_infer_request_curr->StartAsync();
-                }
-                if (!isLastFrame) {
-                    async_infer_request_next->StartAsync();
-                }
-            } else if (!isModeChanged) {
-                async_infer_request_curr->StartAsync();
+            // we wait for the results of the earliest submitted frame, in the regular mode, it is the frame
+            // which was just submitted, so the wait measures the detection
+            if (!pipeline.pop(frame, objects)) {
+                break;  // all frames are shown
             }
+            t1 = std::chrono::high_resolution_clock::now();
+            ms detection = std::chrono::duration_cast<ms>(t1 - t0);
+            framesCount++;
 
-            if (OK == async_infer_request_curr->Wait(IInferRequest::WaitMode::RESULT_READY)) {
-                t1 = std::chrono::high_resolution_clock::now();
-                ms detection = std::chrono::duration_cast<ms>(t1 - t0);
-
-                t0 = std::chrono::high_resolution_clock::now();
-                ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
-                wallclock = t0;
-
-                t0 = std::chrono::high_resolution_clock::now();
-                presenter.drawGraphs(frame);
-                std::ostringstream out;
-                out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
-                    << (ocv_decode_time + ocv_render_time) << " ms";
-                cv::putText(frame, out.str(), cv::Point2f(0, 25), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+            t0 = std::chrono::high_resolution_clock::now();
+            ms wall = std::chrono::duration_cast<ms>(t0 - wallclock);
+            wallclock = t0;
+
+            presenter.drawGraphs(frame);
+            std::ostringstream out;
+            out << "OpenCV cap/render time: " << std::fixed << std::setprecision(2)
+                << (ocv_decode_time + ocv_render_time) << " ms";
+            cv::putText(frame, out.str(), cv::Point2f(0, 25), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 255, 0));
+            out.str("");
+            out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
+            out << std::fixed << std::setprecision(2) << wall.count() << " ms (" << 1000.f / wall.count() << " fps)";
+            cv::putText(frame, out.str(), cv::Point2f(0, 50), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
+            if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
                 out.str("");
-                out << "Wallclock time " << (isAsyncMode ? "(TRUE ASYNC):      " : "(SYNC, press Tab): ");
-                out << std::fixed << std::setprecision(2) << wall.count() << " ms (" << 1000.f / wall.count() << " fps)";
-                cv::putText(frame, out.str(), cv::Point2f(0, 50), cv::FONT_HERSHEY_TRIPLEX, 0.6, cv::Scalar(0, 0, 255));
-                if (!isAsyncMode) {  // In the true async mode, there is no way to measure detection time directly
-                    out.str("");
-                    out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
-                        << " ms ("
-                        << 1000.f / detection.count() << " fps)";
-                    cv::putText(frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
-                                cv::Scalar(255, 0, 0));
-                }
+                out << "Detection time  : " << std::fixed << std::setprecision(2) << detection.count()
+                    << " ms ("
+                    << 1000.f / detection.count() << " fps)";
+                cv::putText(frame, out.str(), cv::Point2f(0, 75), cv::FONT_HERSHEY_TRIPLEX, 0.6,
+                            cv::Scalar(255, 0, 0));
+            }
 
-                // ---------------------------Processing output blobs--------------------------------------------------
-                // Processing results of the CURRENT request
-                const TensorDesc& inputDesc = inputInfo.begin()->second.get()->getTensorDesc();
-                unsigned long resized_im_h = getTensorHeight(inputDesc);
-                unsigned long resized_im_w = getTensorWidth(inputDesc);
-                std::vector<DetectionObject> objects;
-                // Parsing outputs
-                for (auto &output : outputInfo) {
-                    auto output_name = output.first;
-                    Blob::Ptr blob = async_infer_request_curr->GetBlob(output_name);
-                    ParseYOLOV3Output(yoloParams[output_name], output_name, blob, resized_im_h, resized_im_w, height, width, FLAGS_t, objects);
-                }
-                // Filtering overlapping boxes
-                std::sort(objects.begin(), objects.end(), std::greater<DetectionObject>());
-                for (size_t i = 0; i < objects.size(); ++i) {
-                    if (objects[i].confidence == 0)
-                        continue;
-                    for (size_t j = i + 1; j < objects.size(); ++j)
-                        if (IntersectionOverUnion(objects[i], objects[j]) >= FLAGS_iou_t)
-                            objects[j].confidence = 0;
+            // ---------------------------Processing output blobs--------------------------------------------------
+            // Drawing boxes of the earliest submitted frame
+            for (auto &object : objects) {
+                if (object.confidence < FLAGS_t)
+                    continue;
+                auto label = object.class_id;
+                float confidence = object.confidence;
+                if (FLAGS_r) {
+                    std::cout << "[" << label << "] element, prob = " << confidence <<
+                              "    (" << object.xmin << "," << object.ymin << ")-(" << object.xmax << "," << object.ymax << ")"
+                              << ((confidence > FLAGS_t) ? " WILL BE RENDERED!" : "") << std::endl;
                 }
-                // Drawing boxes
-                for (auto &object : objects) {
-                    if (object.confidence < FLAGS_t)
-                        continue;
-                    auto label = object.class_id;
-                    float confidence = object.confidence;
-                    if (FLAGS_r) {
-                        std::cout << "[" << label << "] element, prob = " << confidence <<
-                                  "    (" << object.xmin << "," << object.ymin << ")-(" << object.xmax << "," << object.ymax << ")"
-                                  << ((confidence > FLAGS_t) ? " WILL BE RENDERED!" : "") << std::endl;
-                    }
-                    if (confidence > FLAGS_t) {
-                        /** Drawing only objects when >confidence_threshold probability **/
-                        std::ostringstream conf;
-                        conf << ":" << std::fixed << std::setprecision(3) << confidence;
-                        cv::putText(frame,
-                                    (!labels.empty() ? labels[label] : std::string("label #") + std::to_string(label)) + conf.str(),
-                                    cv::Point2f(static_cast<float>(object.xmin), static_cast<float>(object.ymin - 5)), cv::FONT_HERSHEY_COMPLEX_SMALL, 1,
-                                    cv::Scalar(0, 0, 255));
-                        cv::rectangle(frame, cv::Point2f(static_cast<float>(object.xmin), static_cast<float>(object.ymin)),
-                                      cv::Point2f(static_cast<float>(object.xmax), static_cast<float>(object.ymax)), cv::Scalar(0, 0, 255));
-                    }
+                if (confidence > FLAGS_t) {
+                    /** Drawing only objects when >confidence_threshold probability **/
+                    std::ostringstream conf;
+                    conf << ":" << std::fixed << std::setprecision(3) << confidence;
+                    cv::putText(frame,
+                                (!labels.empty() ? labels[label] : std::string("label #") + std::to_string(label)) + conf.str(),
+                                cv::Point2f(static_cast<float>(object.xmin), static_cast<float>(object.ymin - 5)), cv::FONT_HERSHEY_COMPLEX_SMALL, 1,
+                                cv::Scalar(0, 0, 255));
+                    cv::rectangle(frame, cv::Point2f(static_cast<float>(object.xmin), static_cast<float>(object.ymin)),
+                                  cv::Point2f(static_cast<float>(object.xmax), static_cast<float>(object.ymax)), cv::Scalar(0, 0, 255));
                 }
             }
             if (!FLAGS_no_show) {
@@ -446,40 +315,26 @@ int main(int argc, char *argv[]) {
             t1 = std::chrono::high_resolution_clock::now();
             ocv_render_time = std::chrono::duration_cast<ms>(t1 - t0).count();
 
-            if (isLastFrame) {
-                break;
-            }
-
-            if (isModeChanged) {
-                isModeChanged = false;
-            }
-
-            // Final point:
-            // in the truly Async mode, we swap the NEXT and CURRENT requests for the next iteration
-            frame = next_frame;
-            next_frame = cv::Mat();
-            if (isAsyncMode) {
-                async_infer_request_curr.swap(async_infer_request_next);
-            }
-
             const int key = cv::waitKey(1);
             if (27 == key)  // Esc
                 break;
             if (9 == key) {  // Tab
                 isAsyncMode ^= true;
-                isModeChanged = true;
             } else {
                 presenter.handleKey(key);
             }
         }
+        pipeline.waitAll();
         // -----------------------------------------------------------------------------------------------------
         auto total_t1 = std::chrono::high_resolution_clock::now();
         ms total = std::chrono::duration_cast<ms>(total_t1 - total_t0);
         std::cout << "Total Inference time: " << total.count() << std::endl;
+        std::cout << "Throughput: " << std::fixed << std::setprecision(2)
+                  << framesCount * 1000.0 / total.count() << " fps" << std::endl;
 
         /** Showing performace results **/
         if (FLAGS_pc) {
-            printPerformanceCounts(*async_infer_request_curr, std::cout, getFullDeviceName(ie, FLAGS_d));
+            printPerformanceCounts(pipeline.getRequest(0), std::cout, getFullDeviceName(ie, FLAGS_d));
         }
 
         std::cout << presenter.reportMeans() << '\n';
@@ -25,6 +25,8 @@ struct CnnConfig {
     std::string path_to_model;
     /** @brief Maximal size of batch */
     int max_batch_size{1};
+    /** @brief Number of infer requests which process consecutive batches in parallel */
+    int num_requests{1};
 };
 
 /**
@@ -67,7 +69,8 @@ protected:
                const std::function<void(const InferenceEngine::BlobMap&, size_t)>& results_fetcher) const;
 
     /**
-     * @brief Run network in batch mode
+     * @brief Run network in batch mode. Images are split into batches which are
+     * inferred asynchronously on all the infer requests, results are fetched in order
      *
      * @param frames Vector of input images
      * @param results_fetcher Callback to fetch inference results
@@ -85,12 +88,12 @@ protected:
     InferenceEngine::OutputsDataMap outInfo_;
     /** @brief IE network */
     InferenceEngine::ExecutableNetwork executable_network_;
-    /** @brief IE InferRequest */
-    mutable InferenceEngine::InferRequest infer_request_;
-    /** @brief Pointer to the pre-allocated input blob */
-    mutable InferenceEngine::Blob::Ptr input_blob_;
-    /** @brief Map of output blobs */
-    InferenceEngine::BlobMap outputs_;
+    /** @brief IE InferRequests */
+    mutable std::vector<InferenceEngine::InferRequest> infer_requests_;
+    /** @brief Pointers to the pre-allocated input blobs of each request */
+    mutable std::vector<InferenceEngine::Blob::Ptr> input_blobs_;
+    /** @brief Maps of output blobs of each request */
+    std::vector<InferenceEngine::BlobMap> outputs_;
 };
 
 class VectorCNN : public CnnBase {
@@ -18,6 +18,7 @@
 #include "utils.hpp"
 #include "descriptor.hpp"
 #include "distance.hpp"
+#include "linear_assignment.hpp"
 
 ///
 /// \brief The TrackerParams struct stores parameters of PedestrianTracker
@@ -447,9 +448,15 @@ private:
     // Distance between current active tracks.
     std::unordered_map<std::pair<size_t, size_t>, float, pair_hash> tracks_dists_;
 
+    // Strong descriptors of the current frame detections, computed at most once per frame.
+    std::map<size_t, cv::Mat> det_descriptors_strong_;
+
     // Number of all current tracks.
     size_t tracks_counter_;
 
+    // Track to detection assignment solver, reuses its buffers across frames.
+    LinearAssignment assignment_;
+
     cv::Size frame_size_;
 
     std::vector<cv::Scalar> colors_;
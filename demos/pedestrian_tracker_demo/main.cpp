@@ -52,6 +52,7 @@ CreatePedestrianTracker(const std::string& reid_model,
     if (!reid_model.empty()) {
         CnnConfig reid_config(reid_model);
         reid_config.max_batch_size = 16;   // defaulting to 16
+        reid_config.num_requests = 2;      // the next batch is filled while the previous one is inferred
 
         std::shared_ptr<IImageDescriptor> descriptor_strong =
             std::make_shared<DescriptorIE>(reid_config, ie, deviceName);
@@ -141,6 +142,7 @@ int main(int argc, char **argv) {
                 should_use_perf_counter);
 
         DetectorConfig detector_confid(det_model);
+        detector_confid.is_async = true;
         ObjectDetector pedestrian_detector(detector_confid, ie, detector_mode);
 
         bool should_keep_tracking_info = should_save_det_log || should_print_out;
@@ -181,17 +183,25 @@ int main(int argc, char **argv) {
         cv::Size graphSize{static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH) / 4), 60};
         Presenter presenter(FLAGS_u, 10, graphSize);
 
-        for (int32_t frame_idx = std::max(0, FLAGS_first); 0 > FLAGS_last || frame_idx <= FLAGS_last; ++frame_idx) {
-            cv::Mat frame;
-            if (!cap.read(frame)) {
-                break;
-            }
-
+        // Detection of the next frame runs asynchronously while the current frame is being tracked,
+        // so two frames are kept: the one being tracked and the one being detected
+        int32_t frame_idx = std::max(0, FLAGS_first);
+        cv::Mat frame, next_frame;
+        bool has_frame = (0 > FLAGS_last || frame_idx <= FLAGS_last) && cap.read(frame);
+        if (has_frame) {
             pedestrian_detector.submitFrame(frame, frame_idx);
+        }
+
+        for (; has_frame; ++frame_idx) {
             pedestrian_detector.waitAndFetchResults();
 
             TrackedObjects detections = pedestrian_detector.getResults();
 
+            has_frame = (0 > FLAGS_last || frame_idx + 1 <= FLAGS_last) && cap.read(next_frame);
+            if (has_frame) {
+                pedestrian_detector.submitFrame(next_frame, frame_idx + 1);
+            }
+
             // timestamp in milliseconds
             uint64_t cur_timestamp = static_cast<uint64_t >(1000.0 / video_fps * frame_idx);
             tracker->Process(frame, detections, cur_timestamp);
@@ -200,25 +210,25 @@ int main(int argc, char **argv) {
 
             if (should_show) {
                 // Drawing colored "worms" (tracks).
-                frame = tracker->DrawActiveTracks(frame);
+                cv::Mat shown_frame = tracker->DrawActiveTracks(frame);
 
                 // Drawing all detected objects on a frame by BLUE COLOR
                 for (const auto &detection : detections) {
-                    cv::rectangle(frame, detection.rect, cv::Scalar(255, 0, 0), 3);
+                    cv::rectangle(shown_frame, detection.rect, cv::Scalar(255, 0, 0), 3);
                 }
 
                 // Drawing tracked detections only by RED color and print ID and detection
                 // confidence level.
                 for (const auto &detection : tracker->TrackedDetections()) {
-                    cv::rectangle(frame, detection.rect, cv::Scalar(0, 0, 255), 3);
+                    cv::rectangle(shown_frame, detection.rect, cv::Scalar(0, 0, 255), 3);
                     std::string text = std::to_string(detection.object_id) +
                         " conf: " + std::to_string(detection.confidence);
-                    cv::putText(frame, text, detection.rect.tl(), cv::FONT_HERSHEY_COMPLEX,
+                    cv::putText(shown_frame, text, detection.rect.tl(), cv::FONT_HERSHEY_COMPLEX,
                                 1.0, cv::Scalar(0, 0, 255), 3);
                 }
 
-                cv::resize(frame, frame, cv::Size(), 0.5, 0.5);
-                cv::imshow("dbg", frame);
+                cv::resize(shown_frame, shown_frame, cv::Size(), 0.5, 0.5);
+                cv::imshow("dbg", shown_frame);
                 char k = cv::waitKey(delay);
                 if (k == 27)
                     break;
@@ -229,6 +239,8 @@ int main(int argc, char **argv) {
                 DetectionLog log = tracker->GetDetectionLog(true);
                 SaveDetectionLogToTrajFile(detlog_out, log);
             }
+
+            cv::swap(frame, next_frame);
         }
 
         if (should_keep_tracking_info) {
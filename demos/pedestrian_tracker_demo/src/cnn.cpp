@@ -37,49 +37,79 @@ void CnnBase::Load() {
 
     SizeVector inputDims = in.begin()->second->getTensorDesc().getDims();
     in.begin()->second->setPrecision(Precision::U8);
-    input_blob_ = make_shared_blob<uint8_t>(TensorDesc(Precision::U8, inputDims, Layout::NCHW));
-    input_blob_->allocate();
-    BlobMap inputs;
-    inputs[in.begin()->first] = input_blob_;
     outInfo_ = cnnNetwork.getOutputsInfo();
-
     for (auto&& item : outInfo_) {
-        SizeVector outputDims = item.second->getTensorDesc().getDims();
-        auto outputLayout = item.second->getTensorDesc().getLayout();
         item.second->setPrecision(Precision::FP32);
-        TBlob<float>::Ptr output =
-            make_shared_blob<float>(TensorDesc(Precision::FP32, outputDims, outputLayout));
-        output->allocate();
-        outputs_[item.first] = output;
     }
 
     executable_network_ = ie_.LoadNetwork(cnnNetwork, deviceName_);
-    infer_request_ = executable_network_.CreateInferRequest();
-    infer_request_.SetInput(inputs);
-    infer_request_.SetOutput(outputs_);
+
+    for (int i = 0; i < std::max(config_.num_requests, 1); i++) {
+        Blob::Ptr input_blob = make_shared_blob<uint8_t>(TensorDesc(Precision::U8, inputDims, Layout::NCHW));
+        input_blob->allocate();
+        BlobMap inputs;
+        inputs[in.begin()->first] = input_blob;
+
+        BlobMap outputs;
+        for (auto&& item : outInfo_) {
+            SizeVector outputDims = item.second->getTensorDesc().getDims();
+            auto outputLayout = item.second->getTensorDesc().getLayout();
+            TBlob<float>::Ptr output =
+                make_shared_blob<float>(TensorDesc(Precision::FP32, outputDims, outputLayout));
+            output->allocate();
+            outputs[item.first] = output;
+        }
+
+        InferRequest infer_request = executable_network_.CreateInferRequest();
+        infer_request.SetInput(inputs);
+        infer_request.SetOutput(outputs);
+
+        infer_requests_.push_back(infer_request);
+        input_blobs_.push_back(input_blob);
+        outputs_.push_back(outputs);
+    }
 }
 
 void CnnBase::InferBatch(
     const std::vector<cv::Mat>& frames,
     const std::function<void(const InferenceEngine::BlobMap&, size_t)>& fetch_results) const {
-    const size_t batch_size = input_blob_->getTensorDesc().getDims()[0];
+    const size_t batch_size = input_blobs_.front()->getTensorDesc().getDims()[0];
+    const size_t num_requests = infer_requests_.size();
 
     size_t num_imgs = frames.size();
-    for (size_t batch_i = 0; batch_i < num_imgs; batch_i += batch_size) {
+    size_t num_batches = (num_imgs + batch_size - 1) / batch_size;
+    std::vector<size_t> current_batch_sizes(num_requests, 0);
+
+    auto fetch = [&](size_t request_i) {
+        if (current_batch_sizes[request_i] == 0) return;
+        infer_requests_[request_i].Wait(IInferRequest::WaitMode::RESULT_READY);
+        fetch_results(outputs_[request_i], current_batch_sizes[request_i]);
+        current_batch_sizes[request_i] = 0;
+    };
+
+    for (size_t batch_idx = 0; batch_idx < num_batches; batch_idx++) {
+        // Requests are used round-robin, so the oldest batch is fetched first and the order is kept
+        size_t request_i = batch_idx % num_requests;
+        fetch(request_i);
+
+        size_t batch_i = batch_idx * batch_size;
         const size_t current_batch_size = std::min(batch_size, num_imgs - batch_i);
         for (size_t b = 0; b < current_batch_size; b++) {
-            matU8ToBlob<uint8_t>(frames[batch_i + b], input_blob_, b);
+            matU8ToBlob<uint8_t>(frames[batch_i + b], input_blobs_[request_i], b);
         }
 
-        infer_request_.Infer();
+        infer_requests_[request_i].StartAsync();
+        current_batch_sizes[request_i] = current_batch_size;
+    }
 
-        fetch_results(outputs_, current_batch_size);
+    for (size_t batch_idx = num_batches; batch_idx < num_batches + num_requests; batch_idx++) {
+        fetch(batch_idx % num_requests);
     }
 }
 
 void CnnBase::PrintPerformanceCounts(std::string fullDeviceName) const {
     std::cout << "Performance counts for " << config_.path_to_model << std::endl << std::endl;
-    ::printPerformanceCounts(infer_request_, std::cout, fullDeviceName, false);
+    ::printPerformanceCounts(infer_requests_.front(), std::cout, fullDeviceName, false);
 }
 
 void CnnBase::Infer(const cv::Mat& frame,
@@ -93,7 +123,7 @@ VectorCNN::VectorCNN(const Config& config,
     : CnnBase(config, ie, deviceName) {
     Load();
 
-    if (outputs_.size() != 1) {
+    if (outInfo_.size() != 1) {
         THROW_IE_EXCEPTION << "Demo supports topologies only with 1 output";
     }
 
@@ -15,7 +15,6 @@
 #include "core.hpp"
 #include "tracker.hpp"
 #include "utils.hpp"
-#include "kuhn_munkres.hpp"
 
 namespace {
 cv::Point Center(const cv::Rect& rect) {
@@ -237,7 +236,9 @@ void PedestrianTracker::SolveAssignmentProblem(
     ComputeDissimilarityMatrix(track_ids, detections, descriptors,
                                &dissimilarity);
 
-    auto res = KuhnMunkres().Solve(dissimilarity);
+    // Pairs below the strong affinity threshold are dropped after matching
+    // anyway, so they are gated out of the assignment problem.
+    auto res = assignment_.Solve(dissimilarity, 1.0f - params_.strong_affinity_thr);
 
     for (size_t i = 0; i < detections.size(); i++) {
         unmatched_detections->insert(i);
@@ -459,6 +460,7 @@ void PedestrianTracker::Process(const cv::Mat &frame,
     if (params_.drop_forgotten_tracks) DropForgottenTracks();
 
     tracks_dists_.clear();
+    det_descriptors_strong_.clear();
     prev_timestamp_ = timestamp;
 }
 
@@ -546,24 +548,38 @@ std::vector<float> PedestrianTracker::ComputeDistances(
     std::map<size_t, size_t> det_to_batch_ids;
     std::map<size_t, size_t> track_to_batch_ids;
 
+    // Every image goes to the reid network at most once per frame: detections
+    // already described in this frame are taken from the cache
     std::vector<cv::Mat> images;
     std::vector<cv::Mat> descriptors;
     for (size_t i = 0; i < track_and_det_ids.size(); i++) {
         size_t track_id = track_and_det_ids[i].first;
         size_t det_id = track_and_det_ids[i].second;
 
-        if (tracks_.at(track_id).descriptor_strong.empty()) {
+        if (tracks_.at(track_id).descriptor_strong.empty() &&
+            track_to_batch_ids.find(track_id) == track_to_batch_ids.end()) {
             images.push_back(tracks_.at(track_id).last_image);
-            descriptors.push_back(cv::Mat());
-            track_to_batch_ids[track_id] = descriptors.size() - 1;
+            track_to_batch_ids[track_id] = images.size() - 1;
         }
 
-        images.push_back(frame(detections[det_id].rect));
-        descriptors.push_back(cv::Mat());
-        det_to_batch_ids[det_id] = descriptors.size() - 1;
+        if (det_descriptors_strong_.find(det_id) == det_descriptors_strong_.end() &&
+            det_to_batch_ids.find(det_id) == det_to_batch_ids.end()) {
+            images.push_back(frame(detections[det_id].rect));
+            det_to_batch_ids[det_id] = images.size() - 1;
+        }
+    }
+
+    if (!images.empty()) {
+        descriptor_strong_->Compute(images, &descriptors);
     }
 
-    descriptor_strong_->Compute(images, &descriptors);
+    for (const auto &track_and_batch_id : track_to_batch_ids) {
+        tracks_.at(track_and_batch_id.first).descriptor_strong =
+            descriptors[track_and_batch_id.second].clone();
+    }
+    for (const auto &det_and_batch_id : det_to_batch_ids) {
+        det_descriptors_strong_[det_and_batch_id.first] = descriptors[det_and_batch_id.second];
+    }
 
     std::vector<cv::Mat> descriptors1;
     std::vector<cv::Mat> descriptors2;
@@ -571,13 +587,10 @@ std::vector<float> PedestrianTracker::ComputeDistances(
         size_t track_id = track_and_det_ids[i].first;
         size_t det_id = track_and_det_ids[i].second;
 
-        if (tracks_.at(track_id).descriptor_strong.empty()) {
-            tracks_.at(track_id).descriptor_strong =
-                descriptors[track_to_batch_ids[track_id]].clone();
-        }
-        (*det_id_to_descriptor)[det_id] = descriptors[det_to_batch_ids[det_id]];
+        const cv::Mat &det_descriptor = det_descriptors_strong_.at(det_id);
+        (*det_id_to_descriptor)[det_id] = det_descriptor;
 
-        descriptors1.push_back(descriptors[det_to_batch_ids[det_id]]);
+        descriptors1.push_back(det_descriptor);
         descriptors2.push_back(tracks_.at(track_id).descriptor_strong);
     }
 
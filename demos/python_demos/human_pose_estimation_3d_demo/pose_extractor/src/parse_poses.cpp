@@ -0,0 +1,142 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "parse_poses.hpp"
+
+namespace human_pose_estimation {
+namespace {
+constexpr float avgPersonHeight = 180.0f;
+constexpr float keypointThreshold = 0.1f;
+constexpr int neckId = 1;
+// pelvis (body center) is missing, id == 2
+constexpr int mapIdToPanoptic[] = {1, 0, 9, 10, 11, 3, 4, 5, 12, 13, 14, 6, 7, 8, 15, 16, 17, 18};
+constexpr int limbs[][3] = {{18, 17, 1},
+                            {16, 15, 1},
+                            {5, 4, 3},
+                            {8, 7, 6},
+                            {11, 10, 9},
+                            {14, 13, 12}};
+
+// copies x, y, z of the keypoint from its features at the given point of the features space
+void readKeypoint3d(const std::vector<cv::Mat>& features, int kptId, const float* point2d, float* kpt3d) {
+    const cv::Mat& xMap = features[kptId * 3];
+    int x = std::min(std::max(static_cast<int>(point2d[0]), 0), xMap.cols - 1);
+    int y = std::min(std::max(static_cast<int>(point2d[1]), 0), xMap.rows - 1);
+    for (int coordId = 0; coordId < 3; coordId++) {
+        kpt3d[coordId] = features[kptId * 3 + coordId].at<float>(y, x);
+    }
+}
+} // namespace
+
+void removePosesWithoutNeck(std::vector<HumanPose>& poses) {
+    poses.erase(std::remove_if(poses.begin(), poses.end(), [](const HumanPose& pose) {
+                    return pose.keypoints[neckId].z == -1.0f;
+                }), poses.end());
+}
+
+void getRootRelativePoses(const std::vector<HumanPose>& poses,
+                          const std::vector<cv::Mat>& features,
+                          int upsampleRatio,
+                          float* poses2d,
+                          float* poses3d) {
+    std::fill(poses2d, poses2d + poses.size() * pose2dSize, -1.0f);
+    std::fill(poses3d, poses3d + poses.size() * pose3dSize, -1.0f);
+    for (size_t poseId = 0; poseId < poses.size(); poseId++) {
+        float* pose2d = poses2d + poseId * pose2dSize;
+        float* pose3d = poses3d + poseId * pose3dSize;
+        const HumanPose& pose = poses[poseId];
+        for (size_t kptId = 0; kptId < pose.keypoints.size(); kptId++) {
+            const cv::Point3f& kpt = pose.keypoints[kptId];
+            if (kpt.x != -1.0f) {
+                float* kpt2d = pose2d + mapIdToPanoptic[kptId] * 3;
+                kpt2d[0] = kpt.x / upsampleRatio;  // scale coordinates to features space
+                kpt2d[1] = kpt.y / upsampleRatio;
+                kpt2d[2] = kpt.z;
+            }
+        }
+        pose2d[pose2dSize - 1] = pose.score;
+
+        if (pose2d[2] > keypointThreshold) {
+            // read all pose coordinates at neck location
+            for (int kptId = 0; kptId < panopticKeypointsNumber; kptId++) {
+                readKeypoint3d(features, kptId, pose2d, pose3d + kptId * 4);
+                pose3d[kptId * 4 + 3] = pose2d[kptId * 3 + 2];
+            }
+            // refine keypoints coordinates at corresponding limbs locations
+            for (const auto& limb : limbs) {
+                for (int kptIdFrom : limb) {
+                    if (pose2d[kptIdFrom * 3 + 2] <= keypointThreshold) {
+                        continue;
+                    }
+                    for (int kptIdWhere : limb) {
+                        readKeypoint3d(features, kptIdWhere, pose2d + kptIdFrom * 3, pose3d + kptIdWhere * 4);
+                    }
+                    break;
+                }
+            }
+        }
+
+        for (int kptId = 0; kptId < panopticKeypointsNumber; kptId++) {
+            for (int coordId = 0; coordId < 3; coordId++) {
+                pose3d[kptId * 4 + coordId] *= avgPersonHeight;
+            }
+        }
+    }
+}
+
+void getTranslations(const float* poses2d,
+                     const float* poses3d,
+                     int posesNumber,
+                     cv::Size featuresSize,
+                     float depth,
+                     float* translations) {
+    for (int poseId = 0; poseId < posesNumber; poseId++) {
+        const float* pose2d = poses2d + poseId * pose2dSize;
+        const float* pose3d = poses3d + poseId * pose3dSize;
+
+        double mean2d[2] = {0, 0};
+        double mean3d[2] = {0, 0};
+        int validNumber = 0;
+        for (int kptId = 0; kptId < panopticKeypointsNumber; kptId++) {
+            if (pose2d[kptId * 3 + 2] == -1.0f) {
+                continue;
+            }
+            mean2d[0] += pose2d[kptId * 3] - featuresSize.width / 2.0;
+            mean2d[1] += pose2d[kptId * 3 + 1] - featuresSize.height / 2.0;
+            mean3d[0] += pose3d[kptId * 4];
+            mean3d[1] += pose3d[kptId * 4 + 1];
+            validNumber++;
+        }
+        for (int coordId = 0; coordId < 2; coordId++) {
+            mean2d[coordId] /= validNumber;
+            mean3d[coordId] /= validNumber;
+        }
+
+        double spread2d = 0;
+        double spread3d = 0;
+        for (int kptId = 0; kptId < panopticKeypointsNumber; kptId++) {
+            if (pose2d[kptId * 3 + 2] == -1.0f) {
+                continue;
+            }
+            for (int coordId = 0; coordId < 2; coordId++) {
+                double delta2d = pose2d[kptId * 3 + coordId]
+                    - (coordId == 0 ? featuresSize.width : featuresSize.height) / 2.0 - mean2d[coordId];
+                double delta3d = pose3d[kptId * 4 + coordId] - mean3d[coordId];
+                spread2d += delta2d * delta2d;
+                spread3d += delta3d * delta3d;
+            }
+        }
+        double scale = std::sqrt(spread3d) / std::sqrt(spread2d);
+
+        float* translation = translations + poseId * 3;
+        translation[0] = static_cast<float>(scale * mean2d[0] - mean3d[0]);
+        translation[1] = static_cast<float>(scale * mean2d[1] - mean3d[1]);
+        translation[2] = static_cast<float>(scale * depth);
+    }
+}
+} // namespace human_pose_estimation
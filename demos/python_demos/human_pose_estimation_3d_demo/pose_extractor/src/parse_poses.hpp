@@ -0,0 +1,37 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "human_pose.hpp"
+
+namespace human_pose_estimation {
+constexpr int panopticKeypointsNumber = 19;
+constexpr int pose2dSize = panopticKeypointsNumber * 3 + 1;  // x, y, confidence per keypoint and pose confidence
+constexpr int pose3dSize = panopticKeypointsNumber * 4;  // x, y, z, confidence per keypoint
+
+void removePosesWithoutNeck(std::vector<HumanPose>& poses);
+
+// Fills poses2d (poses.size() x pose2dSize) with keypoints in the panoptic order
+// scaled to the features space, and poses3d (poses.size() x pose3dSize) with
+// root relative 3D keypoints read from the features.
+void getRootRelativePoses(const std::vector<HumanPose>& poses,
+                          const std::vector<cv::Mat>& features,
+                          int upsampleRatio,
+                          float* poses2d,
+                          float* poses3d);
+
+// Fills translations (posesNumber x 3) which move root relative poses to the
+// camera space.
+void getTranslations(const float* poses2d,
+                     const float* poses3d,
+                     int posesNumber,
+                     cv::Size featuresSize,
+                     float depth,
+                     float* translations);
+} // namespace human_pose_estimation
@@ -15,6 +15,7 @@
 #include <opencv2/core/core.hpp>
 
 #include "extract_poses.hpp"
+#include "parse_poses.hpp"
 
 static std::vector<cv::Mat> wrap_feature_maps(PyArrayObject* py_feature_maps) {
     int num_channels = static_cast<int>(PyArray_SHAPE(py_feature_maps)[0]);
@@ -64,16 +65,112 @@ static PyObject* extract_poses(PyObject* self, PyObject* args) {
     return out_array;
 }
 
+static PyObject* get_root_relative_poses(PyObject* self, PyObject* args) {
+    PyArrayObject* py_features;
+    PyArrayObject* py_heatmaps;
+    PyArrayObject* py_pafs;
+    int ratio;
+    if (!PyArg_ParseTuple(args, "OOOi", &py_features, &py_heatmaps, &py_pafs, &ratio)) {
+        return nullptr;
+    }
+    std::vector<cv::Mat> features = wrap_feature_maps(py_features);
+    if (features.size() != human_pose_estimation::panopticKeypointsNumber * 3) {
+        PyErr_SetString(PyExc_ValueError, "Features should have 3 channels per keypoint");
+        return nullptr;
+    }
+    std::vector<cv::Mat> heatmaps = wrap_feature_maps(py_heatmaps);
+    std::vector<cv::Mat> pafs = wrap_feature_maps(py_pafs);
+
+    std::vector<human_pose_estimation::HumanPose> poses;
+    Py_BEGIN_ALLOW_THREADS
+    poses = human_pose_estimation::extractPoses(heatmaps, pafs, ratio);
+    human_pose_estimation::removePosesWithoutNeck(poses);
+    Py_END_ALLOW_THREADS
+
+    npy_intp dims_2d[] = {static_cast<npy_intp>(poses.size()), human_pose_estimation::pose2dSize};
+    npy_intp dims_3d[] = {static_cast<npy_intp>(poses.size()), human_pose_estimation::pose3dSize};
+    PyObject* poses_2d_array = PyArray_SimpleNew(2, dims_2d, NPY_FLOAT);
+    PyObject* poses_3d_array = PyArray_SimpleNew(2, dims_3d, NPY_FLOAT);
+    if (!poses_2d_array || !poses_3d_array) {
+        Py_XDECREF(poses_2d_array);
+        Py_XDECREF(poses_3d_array);
+        return nullptr;
+    }
+    float* poses_2d = static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(poses_2d_array)));
+    float* poses_3d = static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(poses_3d_array)));
+
+    Py_BEGIN_ALLOW_THREADS
+    human_pose_estimation::getRootRelativePoses(poses, features, ratio, poses_2d, poses_3d);
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("NN", poses_3d_array, poses_2d_array);
+}
+
+static PyArrayObject* as_poses_array(PyObject* object, npy_intp pose_size) {
+    PyArrayObject* array = reinterpret_cast<PyArrayObject*>(
+        PyArray_FROM_OTF(object, NPY_FLOAT, NPY_ARRAY_IN_ARRAY));
+    if (array && (PyArray_NDIM(array) != 2 || PyArray_SHAPE(array)[1] != pose_size)) {
+        PyErr_Format(PyExc_ValueError, "Poses should be an N x %d array", static_cast<int>(pose_size));
+        Py_DECREF(array);
+        return nullptr;
+    }
+    return array;
+}
+
+static PyObject* get_translations(PyObject* self, PyObject* args) {
+    PyObject* py_poses_3d;
+    PyObject* py_poses_2d;
+    int features_width;
+    int features_height;
+    float depth;
+    if (!PyArg_ParseTuple(args, "OOiif", &py_poses_3d, &py_poses_2d, &features_width, &features_height, &depth)) {
+        return nullptr;
+    }
+    PyArrayObject* poses_3d_array = as_poses_array(py_poses_3d, human_pose_estimation::pose3dSize);
+    if (!poses_3d_array) {
+        return nullptr;
+    }
+    PyArrayObject* poses_2d_array = as_poses_array(py_poses_2d, human_pose_estimation::pose2dSize);
+    if (!poses_2d_array) {
+        Py_DECREF(poses_3d_array);
+        return nullptr;
+    }
+    npy_intp num_persons = PyArray_SHAPE(poses_3d_array)[0];
+    PyObject* translations_array = nullptr;
+    if (PyArray_SHAPE(poses_2d_array)[0] != num_persons) {
+        PyErr_SetString(PyExc_ValueError, "Numbers of 2D and 3D poses are different");
+    } else {
+        npy_intp dims[] = {num_persons, 3};
+        translations_array = PyArray_SimpleNew(2, dims, NPY_FLOAT);
+    }
+    if (translations_array) {
+        const float* poses_2d = static_cast<const float*>(PyArray_DATA(poses_2d_array));
+        const float* poses_3d = static_cast<const float*>(PyArray_DATA(poses_3d_array));
+        float* translations = static_cast<float*>(PyArray_DATA(reinterpret_cast<PyArrayObject*>(translations_array)));
+        Py_BEGIN_ALLOW_THREADS
+        human_pose_estimation::getTranslations(poses_2d, poses_3d, static_cast<int>(num_persons),
+                                               cv::Size(features_width, features_height), depth, translations);
+        Py_END_ALLOW_THREADS
+    }
+    Py_DECREF(poses_2d_array);
+    Py_DECREF(poses_3d_array);
+    return translations_array;
+}
+
 PyMethodDef method_table[] = {
     {"extract_poses", static_cast<PyCFunction>(extract_poses), METH_VARARGS,
      "Extracts 2D poses from provided heatmaps and pafs"},
+    {"get_root_relative_poses", static_cast<PyCFunction>(get_root_relative_poses), METH_VARARGS,
+     "Extracts 2D poses with found neck and their root relative 3D poses from provided features, heatmaps and pafs"},
+    {"get_translations", static_cast<PyCFunction>(get_translations), METH_VARARGS,
+     "Computes translations of root relative 3D poses to the camera space"},
     {NULL, NULL, 0, NULL}
 };
 
 PyModuleDef pose_extractor_module = {
     PyModuleDef_HEAD_INIT,
     "pose_extractor",
-    "Module for fast 2D pose extraction",
+    "Module for fast 2D and 3D pose extraction",
     -1,
     method_table
 };
@@ -6,8 +6,11 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -18,6 +21,8 @@
 
 #include <opencv2/core/core.hpp>
 
+#include <tracing/tracing.hpp>
+
 class VideoFrame {  // VideoFrame can represent not a single image but the whole grid
 public:
     typedef std::shared_ptr<VideoFrame> Ptr;
@@ -62,8 +67,11 @@ public:
     }
     void runThreads() {
         running = true;
-        for (std::thread& t : threadPool) {
-            t = std::thread(&Worker::threadFunc, this);
+        for (std::size_t i = 0; i < threadPool.size(); i++) {
+            threadPool[i] = std::thread([this, i] {
+                tracing::setThreadName("worker " + std::to_string(i + 1));
+                threadFunc();
+            });
         }
     }
     void push(std::shared_ptr<Task> task) {
@@ -124,6 +132,62 @@ void tryPush(const std::weak_ptr<Worker>& worker, std::shared_ptr<Task>&& task)
     } catch (const std::bad_weak_ptr&) {}
 }
 
+class Timer {  // calls functions at their time on a thread of its own, so tasks waiting for a deadline don't keep Worker busy
+public:
+    Timer(): stopped{false}, thread{[this] {
+        tracing::setThreadName("timer");
+        threadFunc();
+    }} {}
+    ~Timer() {
+        stop();
+    }
+    void schedule(std::chrono::steady_clock::time_point time, std::function<void()> function) {
+        std::unique_lock<std::mutex> lk(mutex);
+        const bool earliest = functions.empty() || time < functions.begin()->first;
+        functions.emplace(time, std::move(function));
+        lk.unlock();
+        if (earliest) {
+            condVar.notify_one();
+        }
+    }
+    void stop() {  // joins the thread and destroys the functions which weren't called
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopped = true;
+        }
+        condVar.notify_one();
+        if (thread.joinable()) {
+            thread.join();
+        }
+        functions.clear();
+    }
+
+private:
+    void threadFunc() {
+        std::unique_lock<std::mutex> lk(mutex);
+        while (!stopped) {
+            if (functions.empty()) {
+                condVar.wait(lk);
+            } else if (std::chrono::steady_clock::now() < functions.begin()->first) {
+                condVar.wait_until(lk, functions.begin()->first);
+            } else {
+                std::function<void()> function = std::move(functions.begin()->second);
+                functions.erase(functions.begin());
+                lk.unlock();
+                function();
+                function = nullptr;  // the function may own objects which must be destroyed unlocked
+                lk.lock();
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condVar;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> functions;
+    bool stopped;
+    std::thread thread;
+};
+
 template <class C> class ConcurrentContainer {
 public:
     C container;
@@ -5,13 +5,13 @@
 #pragma once
 
 #include <algorithm>
-#include <set>
 #include <string>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
 
-class GridMat {
+class GridMat {  // composes frames of all sources, resizing only changed cells when the Mat is requested
 public:
     cv::Mat outimg;
 
@@ -47,6 +47,10 @@ public:
 
         outimg.create(cellSize.height * nGridRows, cellSize.width * nGridCols, CV_8UC3);
         outimg.setTo(0);
+        cellFrames.resize(points.size());
+        cellImages.resize(points.size());
+        frameIds.assign(points.size(), -1);
+        dirty.assign(points.size(), false);
         clear();
     }
 
@@ -60,50 +64,88 @@ public:
         }
 
         for (size_t i = 0; i < frames.size(); i++) {
-            cv::Mat cell = outimg(cv::Rect(points[i].x, points[i].y, cellSize.width, cellSize.height));
-
-            if ((cellSize.width == frames[i].cols) && (cellSize.height == frames[i].rows)) {
-                frames[i].copyTo(cell);
-            } else if ((cellSize.width > frames[i].cols) && (cellSize.height > frames[i].rows)) {
-                frames[i].copyTo(cell(cv::Rect(0, 0, frames[i].cols, frames[i].rows)));
-            } else {
-                cv::resize(frames[i], cell, cellSize);
-            }
+            update(frames[i], i);
         }
-        unupdatedSourceIDs.clear();
+        compose();
+        updated.assign(points.size(), true);
+        unupdatedNumber = 0;
     }
 
-    void update(const cv::Mat& frame, const size_t sourceID) {
-        cv::Mat cell = outimg(cv::Rect(points[sourceID], cellSize));
+    // keeps the frame until the grid is composed, frameId allows to skip a frame which is already in the cell
+    void update(const cv::Mat& frame, const size_t sourceID, int64_t frameId = -1) {
+        if (frameId < 0 || frameIds[sourceID] != frameId
+                || (cellFrames[sourceID].empty() && cellImages[sourceID].empty())) {
+            cellFrames[sourceID] = frame;
+            frameIds[sourceID] = frameId;
+            dirty[sourceID] = true;
+        }
+        if (!updated[sourceID]) {
+            updated[sourceID] = true;
+            unupdatedNumber--;
+        }
+    }
 
-        if ((cellSize.width == frame.cols) && (cellSize.height == frame.rows)) {
-            frame.copyTo(cell);
-        } else if ((cellSize.width > frame.cols) && (cellSize.height > frame.rows)) {
-            frame.copyTo(cell(cv::Rect(0, 0, frame.cols, frame.rows)));
-        } else {
-            cv::resize(frame, cell, cellSize);
+    // makes cells under drawings on outimg be composed again
+    void invalidate(const cv::Rect& area) {
+        for (size_t i = 0; i < points.size(); i++) {
+            if ((cv::Rect(points[i], cellSize) & area).area() > 0 && !cellImages[i].empty()) {
+                dirty[i] = true;
+            }
         }
-        unupdatedSourceIDs.erase(unupdatedSourceIDs.find(sourceID));
     }
 
     bool isFilled() const noexcept {
-        return unupdatedSourceIDs.empty();
+        return 0 == unupdatedNumber;
     }
     void clear() {
-        size_t counter = 0;
-        std::generate_n(std::inserter(unupdatedSourceIDs, unupdatedSourceIDs.end()), points.size(), [&counter]{return counter++;});
+        updated.assign(points.size(), false);
+        unupdatedNumber = points.size();
     }
-    std::set<size_t> getUnupdatedSourceIDs() const noexcept {
-        return unupdatedSourceIDs;
+    size_t getUnupdatedSourcesNumber() const noexcept {
+        return unupdatedNumber;
     }
-    cv::Mat getMat() const noexcept {
+    cv::Mat getMat() {
+        compose();
         return outimg;
     }
 
 private:
+    void compose() {
+        std::vector<size_t> dirtyCells;
+        for (size_t i = 0; i < points.size(); i++) {
+            if (dirty[i]) {
+                dirtyCells.push_back(i);
+                dirty[i] = false;
+            }
+        }
+        cv::parallel_for_(cv::Range(0, static_cast<int>(dirtyCells.size())), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                cv::Mat& frame = cellFrames[dirtyCells[i]];
+                cv::Mat& image = cellImages[dirtyCells[i]];
+                // without a new frame the cell is only restored under drawings
+                if (!frame.empty()) {
+                    if (((cellSize.width == frame.cols) && (cellSize.height == frame.rows))
+                            || ((cellSize.width > frame.cols) && (cellSize.height > frame.rows))) {
+                        frame.copyTo(image);
+                    } else {
+                        cv::resize(frame, image, cellSize);
+                    }
+                    // a grid may wait for other sources for long, it shouldn't hold full frames meanwhile
+                    frame.release();
+                }
+                image.copyTo(outimg(cv::Rect(points[dirtyCells[i]], image.size())));
+            }
+        });
+    }
+
     cv::Size cellSize;
-    std::set<size_t> unupdatedSourceIDs;
     std::vector<cv::Point> points;
+    std::vector<cv::Mat> cellFrames;  // the last frame of every source until its cell is composed
+    std::vector<cv::Mat> cellImages;  // the composed cell of every source
+    std::vector<int64_t> frameIds;
+    std::vector<bool> dirty;  // bitset of cells which differ from their frames
+    std::vector<bool> updated;  // bitset of sources updated since clear()
+    size_t unupdatedNumber;
 };
 
 void fillROIColor(cv::Mat& displayImage, cv::Rect roi, cv::Scalar color, double opacity) {
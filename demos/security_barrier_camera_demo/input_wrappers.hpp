@@ -4,15 +4,19 @@
 
 #pragma once
 
-#include <list>
+#include <algorithm>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
-#include <thread>
+#include <stdexcept>
 #include <vector>
-#include <queue>
 
 #include <opencv2/core/core.hpp>
 
+#include <tracing/tracing.hpp>
+
 class InputChannel;
 
 class IInputSource {
@@ -20,15 +24,7 @@ public:
     virtual bool read(cv::Mat& mat, const std::shared_ptr<InputChannel>& caller) = 0;
     virtual void addSubscriber(const std::weak_ptr<InputChannel>& inputChannel) = 0;
     virtual cv::Size getSize() = 0;
-    virtual void lock() {
-        sourceLock.lock();
-    }
-    virtual void unlock() {
-        sourceLock.unlock();
-    }
     virtual ~IInputSource() = default;
-private:
-    std::mutex sourceLock;
 };
 
 class InputChannel: public std::enable_shared_from_this<InputChannel> {  // note: public inheritance
@@ -40,30 +36,9 @@ public:
         source->addSubscriber(tmp);
         return tmp;
     }
+    // the frame can share its data with other channels of the same source, call makeWritable() before drawing on it
     bool read(cv::Mat& mat) {
-        readQueueMutex.lock();
-        if (readQueue.empty()) {
-            readQueueMutex.unlock();
-            source->lock();
-            readQueueMutex.lock();
-            if (readQueue.empty()) {
-                bool res = source->read(mat, shared_from_this());
-                readQueueMutex.unlock();
-                source->unlock();
-                return res;
-            } else {
-                source->unlock();
-            }
-        }
-        mat = readQueue.front().clone();
-        readQueue.pop();
-        readQueueMutex.unlock();
-        return true;
-    }
-    void push(const cv::Mat& mat) {
-        readQueueMutex.lock();
-        readQueue.push(mat);
-        readQueueMutex.unlock();
+        return source->read(mat, shared_from_this());
     }
     cv::Size getSize() {
         return source->getSize();
@@ -72,54 +47,118 @@ public:
 private:
     explicit InputChannel(const std::shared_ptr<IInputSource>& source): source{source} {}
     std::shared_ptr<IInputSource> source;
-    std::queue<cv::Mat, std::list<cv::Mat>> readQueue;
-    std::mutex readQueueMutex;
 };
 
-class VideoCaptureSource: public IInputSource {
+// copy-on-write for frames read from an InputChannel
+inline void makeWritable(cv::Mat& mat) {
+    if (mat.u && 1 < mat.u->refcount) {
+        mat = mat.clone();
+    }
+}
+
+class VideoCaptureSource: public IInputSource {  // broadcasts frames to its channels through a ring of shared frames
 public:
-    VideoCaptureSource(const cv::VideoCapture& videoCapture, bool loop): videoCapture{videoCapture}, loop{loop},
-        imSize{static_cast<int>(videoCapture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(videoCapture.get(cv::CAP_PROP_FRAME_HEIGHT))} {}
+    // queueSize is the number of frames a channel can lag behind the fastest channel of the source, older frames are dropped for it
+    VideoCaptureSource(const cv::VideoCapture& videoCapture, bool loop, std::size_t queueSize): videoCapture{videoCapture}, loop{loop},
+        imSize{static_cast<int>(videoCapture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(videoCapture.get(cv::CAP_PROP_FRAME_HEIGHT))},
+        ring(queueSize + 1), head{0}, decoding{false}, ended{false}, droppedFrames{0} {}
     bool read(cv::Mat& mat, const std::shared_ptr<InputChannel>& caller) override {
-        if (!videoCapture.read(mat)) {
-            if (loop) {
-                videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
-                videoCapture.read(mat);
-            } else {
+        std::unique_lock<std::mutex> lock{mutex};
+        uint64_t& cursor = cursors.at(caller);
+        while (cursor == head) {
+            if (ended) {
                 return false;
+            } else if (!decoding) {
+                return decode(mat, cursor, lock);
             }
+            decodedCondVar.wait(lock);  // another channel is decoding the frame, take it from the ring
         }
-        if (1 != subscribedInputChannels.size()) {
-            cv::Mat shared = mat.clone();
-            for (const std::weak_ptr<InputChannel>& weakInputChannel : subscribedInputChannels) {
-                try {
-                    std::shared_ptr<InputChannel> sharedInputChannel = std::shared_ptr<InputChannel>(weakInputChannel);
-                    if (caller != sharedInputChannel) {
-                        sharedInputChannel->push(shared);
-                    }
-                } catch (const std::bad_weak_ptr&) {}
-            }
+        // the slot of head is not readable because it is filled during decoding
+        if (head - cursor > ring.size() - 1) {
+            droppedFrames += head - (ring.size() - 1) - cursor;
+            cursor = head - (ring.size() - 1);
         }
+        mat = ring[cursor % ring.size()];  // no copy, the data is shared
+        cursor++;
+        releaseConsumed();
         return true;
     }
     void addSubscriber(const std::weak_ptr<InputChannel>& inputChannel) override {
-        subscribedInputChannels.push_back(inputChannel);
+        std::lock_guard<std::mutex> lock{mutex};
+        if (false == cursors.emplace(inputChannel, head).second)
+            throw std::invalid_argument("The insertion did not take place");
     }
     cv::Size getSize() override {
         return imSize;
     }
+    uint64_t getDroppedFrames() {
+        std::lock_guard<std::mutex> lock{mutex};
+        return droppedFrames;
+    }
 
 private:
-    std::vector<std::weak_ptr<InputChannel>> subscribedInputChannels;
+    bool decode(cv::Mat& mat, uint64_t& cursor, std::unique_lock<std::mutex>& lock) {
+        decoding = true;
+        // reuse the buffer of the caller if it is not shared with anybody
+        cv::Mat frame;
+        if (mat.u && 1 == mat.u->refcount) {
+            frame = mat;
+        }
+        mat.release();
+        lock.unlock();
+        bool res;
+        {
+            tracing::Scope scope("decode");
+            res = videoCapture.read(frame);
+            if (!res && loop) {
+                videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
+                res = videoCapture.read(frame);
+            }
+        }
+        lock.lock();
+        decoding = false;
+        if (res) {
+            ring[head % ring.size()] = frame;
+            head++;
+            cursor = head;
+            mat = frame;
+            releaseConsumed();
+        } else {
+            ended = true;
+        }
+        decodedCondVar.notify_all();
+        return res;
+    }
+    void releaseConsumed() {  // frames read by all channels are released from the ring, so their readers can draw without copying
+        uint64_t minCursor = head;
+        for (const auto& weakChannelAndCursor : cursors) {
+            if (!weakChannelAndCursor.first.expired()) {
+                minCursor = std::min(minCursor, weakChannelAndCursor.second);
+            }
+        }
+        for (uint64_t i = head > ring.size() ? head - ring.size() : 0; i < minCursor; i++) {
+            ring[i % ring.size()].release();
+        }
+    }
+
     cv::VideoCapture videoCapture;
     bool loop;
     cv::Size imSize;
+    std::mutex mutex;  // guards the fields below
+    std::condition_variable decodedCondVar;
+    std::map<std::weak_ptr<InputChannel>, uint64_t, std::owner_less<std::weak_ptr<InputChannel>>> cursors;  // next frame to read
+    std::vector<cv::Mat> ring;
+    uint64_t head;  // number of decoded frames
+    bool decoding;
+    bool ended;
+    uint64_t droppedFrames;
 };
 
 class ImageSource: public IInputSource {
 public:
     ImageSource(const cv::Mat& im, bool loop): im{im.clone()}, loop{loop} {}  // clone to avoid image changing
     bool read(cv::Mat& mat, const std::shared_ptr<InputChannel>& caller) override {
+        std::lock_guard<std::mutex> lock{mutex};
         if (!loop) {
             auto subscribedInputChannelsIt = subscribedInputChannels.find(caller);
             if (subscribedInputChannels.end() == subscribedInputChannelsIt) {
@@ -135,6 +174,7 @@ public:
         }
     }
     void addSubscriber(const std::weak_ptr<InputChannel>& inputChannel) override {
+        std::lock_guard<std::mutex> lock{mutex};
         if (false == subscribedInputChannels.insert(inputChannel).second)
             throw std::invalid_argument("The insertion did not take place");
     }
@@ -143,6 +183,7 @@ public:
     }
 
 private:
+    std::mutex mutex;
     std::set<std::weak_ptr<InputChannel>, std::owner_less<std::weak_ptr<InputChannel>>> subscribedInputChannels;
     cv::Mat im;
     bool loop;
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <iomanip>
 #include <list>
 #include <map>
@@ -17,9 +19,14 @@
 #include <cldnn/cldnn_config.hpp>
 #include <inference_engine.hpp>
 #include <vpu/vpu_plugin_config.hpp>
+#include <cpu_planner/cpu_planner.hpp>
+#include <monitors/cpu_monitor.h>
 #include <monitors/presenter.h>
 #include <samples/ocv_common.hpp>
 #include <samples/args_helper.hpp>
+#include <model_loader/model_loader.hpp>
+#include <replay/replay.hpp>
+#include <tracing/tracing.hpp>
 
 #include "common.hpp"
 #include "grid_mat.hpp"
@@ -52,6 +59,9 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
     if (FLAGS_n_wt == 0) {
         throw std::logic_error("-n_wt can not be zero");
     }
+    if (FLAGS_n_cb == 0) {
+        throw std::logic_error("-n_cb can not be zero");
+    }
     return true;
 }
 
@@ -70,22 +80,93 @@ struct InferRequestsContainer {
     InferRequestsContainer(const InferRequestsContainer&) = delete;
     InferRequestsContainer& operator=(const InferRequestsContainer&) = delete;
 
-    void assign(const std::vector<InferRequest>& inferRequests) {
+    void assign(const std::vector<InferRequest>& inferRequests, const std::string& name) {
         actualInferRequests = inferRequests;
         this->inferRequests.container.clear();
+        tracks.clear();
 
         for (auto& ir : this->actualInferRequests) {
             this->inferRequests.container.push_back(ir);
+            tracks.emplace_back(name + " request " + std::to_string(tracks.size()));
         }
     }
 
     std::vector<InferRequest> getActualInferRequests() {
         return actualInferRequests;
     }
+    // a request is used by one task at a time, so the task may record to its track
+    tracing::Track& getTrack(const InferRequest& inferRequest) {
+        return tracks[&inferRequest - actualInferRequests.data()];
+    }
+
+    // records the outputs of the network to the recorder or replays them instead of inferring the network
+    void setReplay(const ExecutableNetwork& network, std::shared_ptr<OutputsRecorder> recorder,
+                   std::shared_ptr<OutputsReplayer> replayer) {
+        this->network = network;
+        this->recorder = std::move(recorder);
+        this->replayer = std::move(replayer);
+        if (this->replayer && this->replayer->getInputDims() != getInputDims(network)) {
+            throw std::logic_error("The outputs were recorded for another network or batch size");
+        }
+        if (this->recorder) {
+            this->recorder->setInputDims(getInputDims(network));
+        }
+    }
+
+    // starts the request and calls the callback when it completes. Replayed requests get the outputs recorded for
+    // the frame of the stream and complete on the timer after the latency of the replay
+    void startAsync(InferRequest& inferRequest, const std::function<void()>& callback, std::size_t stream, int64_t frame,
+                    Timer& timer) {
+        std::function<void()> complete = callback;
+        if (recorder) {
+            complete = [this, &inferRequest, callback, stream, frame] {
+                recorder->write(stream, frame, getOutputs(inferRequest, network));
+                const std::function<void()> completeRecorded = callback;  // the callback may destroy this function
+                completeRecorded();
+            };
+        }
+        if (replayer) {
+            setOutputs(inferRequest, replayer->getOutputs(stream, frame));
+            timer.schedule(std::chrono::steady_clock::now() + replayer->getLatency(), std::move(complete));
+        } else {
+            inferRequest.SetCompletionCallback(complete);
+            inferRequest.StartAsync();
+        }
+    }
     ConcurrentContainer<std::vector<std::reference_wrapper<InferRequest>>> inferRequests;
 
 private:
     std::vector<InferRequest> actualInferRequests;
+    std::vector<tracing::Track> tracks;
+    ExecutableNetwork network;
+    std::shared_ptr<OutputsRecorder> recorder;
+    std::shared_ptr<OutputsReplayer> replayer;
+};
+
+class ClassifiersAggreagator;
+
+struct RoiBatcher {  // collects vehicles or plates of all channels for batched InferRequests of a classifier or a recogniser
+    struct Roi {
+        std::shared_ptr<ClassifiersAggreagator> classifiersAggreagator;  // keeps the frame and receives the result
+        cv::Rect rect;
+        std::chrono::steady_clock::time_point enqueueTime;
+    };
+
+    RoiBatcher(std::size_t maxBatch, std::chrono::steady_clock::duration maxWait):
+        maxBatch{maxBatch}, maxWait{maxWait}, dynamicBatch{false}, batchScheduled{false}, deadlineId{0}, deadlinesCount{0},
+        batchesCount{0}, roisCount{0}, waitTime{std::chrono::steady_clock::duration::zero()} {}
+
+    const std::size_t maxBatch;
+    const std::chrono::steady_clock::duration maxWait;  // how long the oldest ROI may wait for a batch to fill up
+    bool dynamicBatch;  // if InferRequest::SetBatch() can be used for incomplete batches
+    std::mutex mutex;  // guards the fields below
+    std::deque<Roi> rois;
+    bool batchScheduled;  // at most one ClassifiersBatch task exists for the batcher, it is pushed when rois fill a batch or wait too long
+    uint64_t deadlineId;  // the timer waits for the deadline of the oldest ROI, 0 if it doesn't, earlier deadlines are ignored
+    uint64_t deadlinesCount;
+    uint64_t batchesCount;
+    uint64_t roisCount;
+    std::chrono::steady_clock::duration waitTime;  // accumulated time ROIs spent in the queue
 };
 
 struct Context {  // stores all global data for tasks
@@ -93,15 +174,17 @@ struct Context {  // stores all global data for tasks
             const Detector& detector,
             const VehicleAttributesClassifier& vehicleAttributesClassifier, const Lpr& lpr,
             int pause, const std::vector<cv::Size>& gridParam, cv::Size displayResolution, std::chrono::steady_clock::duration showPeriod,
-                const std::string& monitorsStr,
+                std::chrono::steady_clock::duration displayPeriod, const std::string& monitorsStr,
             uint64_t lastFrameId,
             uint64_t nireq,
             bool isVideo,
-            std::size_t nclassifiersireq, std::size_t nrecognizersireq):
+            std::size_t nclassifiersireq, std::size_t nrecognizersireq,
+            std::size_t maxClassifiersBatch, std::chrono::steady_clock::duration maxClassifiersWait):
         readersContext{inputChannels, std::vector<int64_t>(inputChannels.size(), -1), std::vector<std::mutex>(inputChannels.size())},
         inferTasksContext{detector},
-        detectionsProcessorsContext{vehicleAttributesClassifier, lpr},
-        drawersContext{pause, gridParam, displayResolution, showPeriod, monitorsStr},
+        detectionsProcessorsContext{vehicleAttributesClassifier, lpr,
+            {}, {maxClassifiersBatch, maxClassifiersWait}, {maxClassifiersBatch, maxClassifiersWait}},
+        drawersContext{pause, gridParam, displayResolution, showPeriod, displayPeriod, monitorsStr},
         videoFramesContext{std::vector<uint64_t>(inputChannels.size(), lastFrameId), std::vector<std::mutex>(inputChannels.size())},
         nireq{nireq},
         isVideo{isVideo},
@@ -122,9 +205,9 @@ struct Context {  // stores all global data for tasks
             return detectionsProcessorsContext.vehicleAttributesClassifier.createInferRequest();});
         std::generate_n(std::back_inserter(lprInferRequests), nrecognizersireq, [&]{
             return detectionsProcessorsContext.lpr.createInferRequest();});
-        detectorsInfers.assign(detectorInferRequests);
-        attributesInfers.assign(attributesInferRequests);
-        platesInfers.assign(lprInferRequests);
+        detectorsInfers.assign(detectorInferRequests, "detection");
+        attributesInfers.assign(attributesInferRequests, "vehicle attributes");
+        platesInfers.assign(lprInferRequests, "license plate recognition");
     }
     struct {
         std::vector<std::shared_ptr<InputChannel>> inputChannels;
@@ -140,12 +223,16 @@ struct Context {  // stores all global data for tasks
         VehicleAttributesClassifier vehicleAttributesClassifier;
         Lpr lpr;
         std::weak_ptr<Worker> detectionsProcessorsWorker;
+        RoiBatcher attributesBatcher;
+        RoiBatcher platesBatcher;
     } detectionsProcessorsContext;
     struct DrawersContext {
         DrawersContext(int pause, const std::vector<cv::Size>& gridParam, cv::Size displayResolution, std::chrono::steady_clock::duration showPeriod,
-                       const std::string& monitorsStr):
-            pause{pause}, gridParam{gridParam}, displayResolution{displayResolution}, showPeriod{showPeriod},
-            lastShownframeId{0}, prevShow{std::chrono::steady_clock::time_point()}, framesAfterUpdate{0}, updateTime{std::chrono::steady_clock::time_point()},
+                       std::chrono::steady_clock::duration displayPeriod, const std::string& monitorsStr):
+            pause{pause}, gridParam{gridParam}, displayResolution{displayResolution}, showPeriod{showPeriod}, displayPeriod{displayPeriod},
+            lastShownframeId{0}, prevShow{std::chrono::steady_clock::time_point()},
+            prevDraws(gridParam.size(), std::chrono::steady_clock::time_point()),
+            framesAfterUpdate{0}, updateTime{std::chrono::steady_clock::time_point()},
             presenter{monitorsStr,
                 GridMat(gridParam, displayResolution).outimg.rows - 70,
                 cv::Size{GridMat(gridParam, displayResolution).outimg.cols / 4, 60}} {}
@@ -153,9 +240,12 @@ struct Context {  // stores all global data for tasks
         std::vector<cv::Size> gridParam;
         cv::Size displayResolution;
         std::chrono::steady_clock::duration showPeriod;  // desiered frequency of imshow
+        // if not zero, the latest frames of channels are shown with this period instead of grids of frames with the same id
+        std::chrono::steady_clock::duration displayPeriod;
         std::weak_ptr<Worker> drawersWorker;
         int64_t lastShownframeId;
         std::chrono::steady_clock::time_point prevShow;  // time stamp of previous imshow
+        std::vector<std::chrono::steady_clock::time_point> prevDraws;  // time stamps of previous frames of channels if displayPeriod is set
         std::map<int64_t, GridMat> gridMats;
         std::mutex drawerMutex;
         std::ostringstream outThroughput;
@@ -175,6 +265,7 @@ struct Context {  // stores all global data for tasks
     std::atomic<std::vector<InferRequest>::size_type> freeDetectionInfersCount;
     std::atomic<uint64_t> frameCounter;
     InferRequestsContainer detectorsInfers, attributesInfers, platesInfers;
+    Timer timer;  // flushes partial batches of vehicles and plates and completes replayed requests
 };
 
 class ReborningVideoFrame: public VideoFrame {
@@ -236,25 +327,43 @@ private:
     ConcurrentContainer<std::list<BboxAndDescr>> boxesAndDescrs;
 };
 
-class DetectionsProcessor: public Task {  // extracts detections from blob InferRequests and runs classifiers and recognisers
+class DetectionsProcessor: public Task {  // extracts detections from blob InferRequests and passes them to classifiers and recognisers
 public:
     DetectionsProcessor(VideoFrame::Ptr sharedVideoFrame, InferRequest* inferRequest):
-        Task{sharedVideoFrame, 1.0}, inferRequest{inferRequest}, requireGettingNumberOfDetections{true} {}
-    DetectionsProcessor(VideoFrame::Ptr sharedVideoFrame, std::shared_ptr<ClassifiersAggreagator>&& classifiersAggreagator, std::list<cv::Rect>&& vehicleRects,
-    std::list<cv::Rect>&& plateRects):
-        Task{sharedVideoFrame, 1.0}, classifiersAggreagator{std::move(classifiersAggreagator)}, inferRequest{nullptr},
-        vehicleRects{std::move(vehicleRects)}, plateRects{std::move(plateRects)}, requireGettingNumberOfDetections{false} {}
-    bool isReady() override;
+        Task{sharedVideoFrame, 1.0}, inferRequest{inferRequest} {}
+    bool isReady() override {
+        return true;
+    }
     void process() override;
 
 private:
-    std::shared_ptr<ClassifiersAggreagator> classifiersAggreagator;  // when no one stores this object we will draw
     InferRequest* inferRequest;
-    std::list<cv::Rect> vehicleRects;
-    std::list<cv::Rect> plateRects;
-    std::vector<std::reference_wrapper<InferRequest>> reservedAttributesRequests;
-    std::vector<std::reference_wrapper<InferRequest>> reservedLprRequests;
-    bool requireGettingNumberOfDetections;
+};
+
+class ClassifiersBatch: public Task {  // runs a batch of vehicles or plates collected from all channels
+public:
+    ClassifiersBatch(VideoFrame::Ptr sharedVideoFrame, BboxAndDescr::ObjectType objectType):
+        Task{sharedVideoFrame, 1.0}, objectType{objectType} {}
+    bool isReady() override;
+    void process() override;
+
+    static void enqueue(const std::shared_ptr<ClassifiersAggreagator>& classifiersAggreagator, BboxAndDescr::ObjectType objectType,
+        const std::list<cv::Rect>& rects);
+
+private:
+    // pushes the task if the ROIs fill a batch or the oldest one has waited long enough, otherwise sets the timer to its deadline
+    static void schedule(Context& context, BboxAndDescr::ObjectType objectType, std::unique_lock<std::mutex>& batcherLock);
+    static void onDeadline(Context& context, BboxAndDescr::ObjectType objectType, uint64_t deadlineId);
+
+    static RoiBatcher& getBatcher(Context& context, BboxAndDescr::ObjectType objectType) {
+        return BboxAndDescr::ObjectType::VEHICLE == objectType ? context.detectionsProcessorsContext.attributesBatcher
+                                                               : context.detectionsProcessorsContext.platesBatcher;
+    }
+    static InferRequestsContainer& getInfers(Context& context, BboxAndDescr::ObjectType objectType) {
+        return BboxAndDescr::ObjectType::VEHICLE == objectType ? context.attributesInfers : context.platesInfers;
+    }
+
+    const BboxAndDescr::ObjectType objectType;  // VEHICLE for vehicle attributes, PLATE for license plate recognition
 };
 
 class InferTask: public Task {  // runs detection
@@ -288,7 +397,11 @@ bool Drawer::isReady() {
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     std::chrono::steady_clock::time_point prevShow = context.drawersContext.prevShow;
     std::chrono::steady_clock::duration showPeriod = context.drawersContext.showPeriod;
-    if (1u == context.drawersContext.gridParam.size()) {
+    if (std::chrono::steady_clock::duration::zero() != context.drawersContext.displayPeriod) {
+        // the display doesn't hold frames, only the playback speed is limited
+        std::lock_guard<std::mutex> lock{context.drawersContext.drawerMutex};
+        return std::chrono::steady_clock::now() - context.drawersContext.prevDraws[sharedVideoFrame->sourceID] > showPeriod;
+    } else if (1u == context.drawersContext.gridParam.size()) {
         if (std::chrono::steady_clock::now() - prevShow > showPeriod) {
             return true;
         } else {
@@ -304,7 +417,7 @@ bool Drawer::isReady() {
                 return false;
             }
         } else {
-            if (1u == gridMatIt->second.getUnupdatedSourceIDs().size()) {
+            if (1u == gridMatIt->second.getUnupdatedSourcesNumber()) {
                 if (context.drawersContext.lastShownframeId == sharedVideoFrame->frameId
                     && std::chrono::steady_clock::now() - prevShow > showPeriod) {
                     return true;
@@ -318,11 +431,74 @@ bool Drawer::isReady() {
     }
 }
 
+static void showGrid(Context& context, GridMat& gridMat, unsigned framesPerGrid) {
+    cv::Mat mat = gridMat.getMat();
+
+    constexpr float OPACITY = 0.6f;
+    const cv::Rect infoRect(5, 5, 390, 115);
+    fillROIColor(mat, infoRect, cv::Scalar(255, 0, 0), OPACITY);
+    cv::putText(mat, "Detection InferRequests usage", cv::Point2f(15, 70), cv::FONT_HERSHEY_TRIPLEX, 0.7, cv::Scalar{255, 255, 255});
+    cv::Rect usage(15, 90, 370, 20);
+    cv::rectangle(mat, usage, {0, 255, 0}, 2);
+    uint64_t nireq = context.nireq;
+    uint64_t frameCounter = context.frameCounter;
+    usage.width = static_cast<int>(usage.width * static_cast<float>(frameCounter * nireq - context.freeDetectionInfersCount) / (frameCounter * nireq));
+    cv::rectangle(mat, usage, {0, 255, 0}, cv::FILLED);
+
+    const std::chrono::steady_clock::time_point localT1 = std::chrono::steady_clock::now();
+    const Sec timeDuration = localT1 - context.drawersContext.updateTime;
+    if (Sec{1} <= timeDuration || context.drawersContext.updateTime == context.t0) {
+        context.drawersContext.outThroughput.str("");
+        context.drawersContext.outThroughput << std::fixed << std::setprecision(1)
+            << static_cast<float>(context.drawersContext.framesAfterUpdate) / framesPerGrid / timeDuration.count() << "FPS";
+        context.drawersContext.framesAfterUpdate = 0;
+        context.drawersContext.updateTime = localT1;
+    }
+    cv::putText(mat, context.drawersContext.outThroughput.str(), cv::Point2f(15, 35), cv::FONT_HERSHEY_TRIPLEX, 0.7, cv::Scalar{255, 255, 255});
+
+    context.drawersContext.presenter.drawGraphs(mat);
+
+    cv::imshow("Detection results", mat);
+    // cells under the drawings are composed again for the next show
+    gridMat.invalidate(infoRect);
+    gridMat.invalidate(cv::Rect{0, mat.rows - 70, mat.cols, 70});
+    context.drawersContext.prevShow = std::chrono::steady_clock::now();
+    const int key = cv::waitKey(context.drawersContext.pause);
+    if (key == 27 || 'q' == key || 'Q' == key || !context.isVideo) {
+        try {
+            std::shared_ptr<Worker>(context.drawersContext.drawersWorker)->stop();
+        } catch (const std::bad_weak_ptr&) {}
+    } else if (key == 32) {
+        context.drawersContext.pause = (context.drawersContext.pause + 1) & 1;
+    } else {
+        context.drawersContext.presenter.handleKey(key);
+    }
+}
+
 void Drawer::process() {
     const int64_t frameId = sharedVideoFrame->frameId;
+    tracing::Scope scope("render", sharedVideoFrame->sourceID, frameId);
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     std::map<int64_t, GridMat>& gridMats = context.drawersContext.gridMats;
     context.drawersContext.drawerMutex.lock();
+    if (std::chrono::steady_clock::duration::zero() != context.drawersContext.displayPeriod) {
+        // a single grid keeps the latest frame of every channel
+        auto gridMatIt = gridMats.find(0);
+        if (gridMats.end() == gridMatIt) {
+            gridMatIt = gridMats.emplace(0, GridMat(context.drawersContext.gridParam,
+                                                    context.drawersContext.displayResolution)).first;
+        }
+        gridMatIt->second.update(sharedVideoFrame->frame, sharedVideoFrame->sourceID, frameId);
+        context.drawersContext.prevDraws[sharedVideoFrame->sourceID] = std::chrono::steady_clock::now();
+        context.drawersContext.framesAfterUpdate++;
+        if (gridMatIt->second.isFilled()
+                && std::chrono::steady_clock::now() - context.drawersContext.prevShow >= context.drawersContext.displayPeriod) {
+            showGrid(context, gridMatIt->second, static_cast<unsigned>(context.drawersContext.gridParam.size()));
+        }
+        context.drawersContext.drawerMutex.unlock();
+        return;
+    }
+
     auto gridMatIt = gridMats.find(frameId);
     if (gridMats.end() == gridMatIt) {
         gridMatIt = gridMats.emplace(frameId, GridMat(context.drawersContext.gridParam,
@@ -334,44 +510,8 @@ void Drawer::process() {
     int64_t& lastShownframeId = context.drawersContext.lastShownframeId;
     if (firstGridIt->first == lastShownframeId && firstGridIt->second.isFilled()) {
         lastShownframeId++;
-        cv::Mat mat = firstGridIt->second.getMat();
-
-        constexpr float OPACITY = 0.6f;
-        fillROIColor(mat, cv::Rect(5, 5, 390, 115), cv::Scalar(255, 0, 0), OPACITY);
-        cv::putText(mat, "Detection InferRequests usage", cv::Point2f(15, 70), cv::FONT_HERSHEY_TRIPLEX, 0.7, cv::Scalar{255, 255, 255});
-        cv::Rect usage(15, 90, 370, 20);
-        cv::rectangle(mat, usage, {0, 255, 0}, 2);
-        uint64_t nireq = context.nireq;
-        uint64_t frameCounter = context.frameCounter;
-        usage.width = static_cast<int>(usage.width * static_cast<float>(frameCounter * nireq - context.freeDetectionInfersCount) / (frameCounter * nireq));
-        cv::rectangle(mat, usage, {0, 255, 0}, cv::FILLED);
-
         context.drawersContext.framesAfterUpdate++;
-        const std::chrono::steady_clock::time_point localT1 = std::chrono::steady_clock::now();
-        const Sec timeDuration = localT1 - context.drawersContext.updateTime;
-        if (Sec{1} <= timeDuration || context.drawersContext.updateTime == context.t0) {
-            context.drawersContext.outThroughput.str("");
-            context.drawersContext.outThroughput << std::fixed << std::setprecision(1)
-                << static_cast<float>(context.drawersContext.framesAfterUpdate) / timeDuration.count() << "FPS";
-            context.drawersContext.framesAfterUpdate = 0;
-            context.drawersContext.updateTime = localT1;
-        }
-        cv::putText(mat, context.drawersContext.outThroughput.str(), cv::Point2f(15, 35), cv::FONT_HERSHEY_TRIPLEX, 0.7, cv::Scalar{255, 255, 255});
-
-        context.drawersContext.presenter.drawGraphs(mat);
-
-        cv::imshow("Detection results", firstGridIt->second.getMat());
-        context.drawersContext.prevShow = std::chrono::steady_clock::now();
-        const int key = cv::waitKey(context.drawersContext.pause);
-        if (key == 27 || 'q' == key || 'Q' == key || !context.isVideo) {
-            try {
-                std::shared_ptr<Worker>(context.drawersContext.drawersWorker)->stop();
-            } catch (const std::bad_weak_ptr&) {}
-        } else if (key == 32) {
-            context.drawersContext.pause = (context.drawersContext.pause + 1) & 1;
-        } else {
-            context.drawersContext.presenter.handleKey(key);
-        }
+        showGrid(context, firstGridIt->second, 1);
         firstGridIt->second.clear();
         gridMats.emplace((--gridMats.end())->first + 1, firstGridIt->second);
         gridMats.erase(firstGridIt);
@@ -380,10 +520,12 @@ void Drawer::process() {
 }
 
 void ResAggregator::process() {
+    tracing::Scope scope("draw results", sharedVideoFrame->sourceID, sharedVideoFrame->frameId);
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     context.freeDetectionInfersCount += context.detectorsInfers.inferRequests.lockedSize();
     context.frameCounter++;
     if (!FLAGS_no_show) {
+        makeWritable(sharedVideoFrame->frame);
         for (const BboxAndDescr& bboxAndDescr : boxesAndDescrs) {
             switch (bboxAndDescr.objectType) {
                 case BboxAndDescr::ObjectType::NONE: cv::rectangle(sharedVideoFrame->frame, bboxAndDescr.rect, {255, 255, 0},  4);
@@ -412,152 +554,219 @@ void ResAggregator::process() {
     }
 }
 
-bool DetectionsProcessor::isReady() {
+void DetectionsProcessor::process() {
+    tracing::Scope scope("detection postprocess", sharedVideoFrame->sourceID, sharedVideoFrame->frameId);
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
-    if (requireGettingNumberOfDetections) {
-        classifiersAggreagator = std::make_shared<ClassifiersAggreagator>(sharedVideoFrame);
-        std::list<Detector::Result> results;
-        if (!(FLAGS_r && ((sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo))) {
-            results = context.inferTasksContext.detector.getResults(*inferRequest, sharedVideoFrame->frame.size());
-        } else {
-            std::ostringstream rawResultsStream;
-            results = context.inferTasksContext.detector.getResults(*inferRequest, sharedVideoFrame->frame.size(), &rawResultsStream);
-            classifiersAggreagator->rawDetections = rawResultsStream.str();
-        }
-        for (Detector::Result result : results) {
-            switch (result.label) {
-                case 1:
-                {
-                    vehicleRects.emplace_back(result.location & cv::Rect{cv::Point(0, 0), sharedVideoFrame->frame.size()});
-                    break;
-                }
-                case 2:
-                {
-                    // expanding a bounding box a bit, better for the license plate recognition
-                    result.location.x -= 5;
-                    result.location.y -= 5;
-                    result.location.width += 10;
-                    result.location.height += 10;
-                    plateRects.emplace_back(result.location & cv::Rect{cv::Point(0, 0), sharedVideoFrame->frame.size()});
-                    break;
-                }
-                default: throw std::exception();  // must never happen
-                         break;
-            }
-        }
-        context.detectorsInfers.inferRequests.lockedPush_back(*inferRequest);
-        requireGettingNumberOfDetections = false;
+    std::shared_ptr<ClassifiersAggreagator> classifiersAggreagator = std::make_shared<ClassifiersAggreagator>(sharedVideoFrame);
+    std::list<Detector::Result> results;
+    if (!(FLAGS_r && ((sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo))) {
+        results = context.inferTasksContext.detector.getResults(*inferRequest, sharedVideoFrame->frame.size());
+    } else {
+        std::ostringstream rawResultsStream;
+        results = context.inferTasksContext.detector.getResults(*inferRequest, sharedVideoFrame->frame.size(), &rawResultsStream);
+        classifiersAggreagator->rawDetections = rawResultsStream.str();
     }
+    context.detectorsInfers.inferRequests.lockedPush_back(*inferRequest);
 
-    if ((vehicleRects.empty() || FLAGS_m_va.empty()) && (plateRects.empty() || FLAGS_m_lpr.empty())) {
-        return true;
-    } else {
-        // isReady() is called under mutexes so it is assured that available InferRequests will not be taken, but new InferRequests can come in
-        // acquire as many InferRequests as it is possible or needed
-        InferRequestsContainer& attributesInfers = context.attributesInfers;
-        attributesInfers.inferRequests.mutex.lock();
-        const std::size_t numberOfAttributesInferRequestsAcquired = std::min(vehicleRects.size(), attributesInfers.inferRequests.container.size());
-        reservedAttributesRequests.assign(attributesInfers.inferRequests.container.end() - numberOfAttributesInferRequestsAcquired,
-                                          attributesInfers.inferRequests.container.end());
-        attributesInfers.inferRequests.container.erase(attributesInfers.inferRequests.container.end() - numberOfAttributesInferRequestsAcquired,
-                                                       attributesInfers.inferRequests.container.end());
-        attributesInfers.inferRequests.mutex.unlock();
-
-        InferRequestsContainer& platesInfers = context.platesInfers;
-        platesInfers.inferRequests.mutex.lock();
-        const std::size_t numberOfLprInferRequestsAcquired = std::min(plateRects.size(), platesInfers.inferRequests.container.size());
-        reservedLprRequests.assign(platesInfers.inferRequests.container.end() - numberOfLprInferRequestsAcquired, platesInfers.inferRequests.container.end());
-        platesInfers.inferRequests.container.erase(platesInfers.inferRequests.container.end() - numberOfLprInferRequestsAcquired,
-                                                   platesInfers.inferRequests.container.end());
-        platesInfers.inferRequests.mutex.unlock();
-        return numberOfAttributesInferRequestsAcquired || numberOfLprInferRequestsAcquired;
+    std::list<cv::Rect> vehicleRects;
+    std::list<cv::Rect> plateRects;
+    for (Detector::Result result : results) {
+        switch (result.label) {
+            case 1:
+            {
+                vehicleRects.emplace_back(result.location & cv::Rect{cv::Point(0, 0), sharedVideoFrame->frame.size()});
+                break;
+            }
+            case 2:
+            {
+                // expanding a bounding box a bit, better for the license plate recognition
+                result.location.x -= 5;
+                result.location.y -= 5;
+                result.location.width += 10;
+                result.location.height += 10;
+                plateRects.emplace_back(result.location & cv::Rect{cv::Point(0, 0), sharedVideoFrame->frame.size()});
+                break;
+            }
+            default: throw std::exception();  // must never happen
+                     break;
+        }
     }
-}
 
-void DetectionsProcessor::process() {
-    Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     if (!FLAGS_m_va.empty()) {
-        auto vehicleRectsIt = vehicleRects.begin();
-        for (auto attributesRequestIt = reservedAttributesRequests.begin(); attributesRequestIt != reservedAttributesRequests.end();
-                vehicleRectsIt++, attributesRequestIt++) {
-            const cv::Rect vehicleRect = *vehicleRectsIt;
-            InferRequest& attributesRequest = *attributesRequestIt;
-            context.detectionsProcessorsContext.vehicleAttributesClassifier.setImage(attributesRequest, sharedVideoFrame->frame, vehicleRect);
-
-            attributesRequest.SetCompletionCallback(
-                std::bind(
-                    [](std::shared_ptr<ClassifiersAggreagator> classifiersAggreagator,
-                        InferRequest& attributesRequest,
-                        cv::Rect rect,
-                        Context& context) {
-                            attributesRequest.SetCompletionCallback([]{});  // destroy the stored bind object
-
-                            const std::pair<std::string, std::string>& attributes
-                                = context.detectionsProcessorsContext.vehicleAttributesClassifier.getResults(attributesRequest);
-
-                            if (FLAGS_r && ((classifiersAggreagator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
-                                classifiersAggreagator->rawAttributes.lockedPush_back("Vehicle Attributes results:" + attributes.first + ';'
-                                                                                      + attributes.second + '\n');
-                            }
-                            classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::VEHICLE, rect, attributes.first + ' ' + attributes.second});
-                            context.attributesInfers.inferRequests.lockedPush_back(attributesRequest);
-                        }, classifiersAggreagator,
-                           std::ref(attributesRequest),
-                           vehicleRect,
-                           std::ref(context)));
-
-            attributesRequest.StartAsync();
-        }
-        vehicleRects.erase(vehicleRects.begin(), vehicleRectsIt);
+        ClassifiersBatch::enqueue(classifiersAggreagator, BboxAndDescr::ObjectType::VEHICLE, vehicleRects);
     } else {
         for (const cv::Rect vehicleRect : vehicleRects) {
             classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::NONE, vehicleRect, ""});
         }
-        vehicleRects.clear();
     }
-
     if (!FLAGS_m_lpr.empty()) {
-        auto plateRectsIt = plateRects.begin();
-        for (auto lprRequestsIt = reservedLprRequests.begin(); lprRequestsIt != reservedLprRequests.end(); plateRectsIt++, lprRequestsIt++) {
-            const cv::Rect plateRect = *plateRectsIt;
-            InferRequest& lprRequest = *lprRequestsIt;
-            context.detectionsProcessorsContext.lpr.setImage(lprRequest, sharedVideoFrame->frame, plateRect);
-
-            lprRequest.SetCompletionCallback(
-                std::bind(
-                    [](std::shared_ptr<ClassifiersAggreagator> classifiersAggreagator,
-                        InferRequest& lprRequest,
-                        cv::Rect rect,
-                        Context& context) {
-                            lprRequest.SetCompletionCallback([]{});  // destroy the stored bind object
-
-                            std::string result = context.detectionsProcessorsContext.lpr.getResults(lprRequest);
-
-                            if (FLAGS_r && ((classifiersAggreagator->sharedVideoFrame->frameId == 0 && !context.isVideo) || context.isVideo)) {
-                                classifiersAggreagator->rawDecodedPlates.lockedPush_back("License Plate Recognition results:" + result + '\n');
-                            }
-                            classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::PLATE, rect, std::move(result)});
-                            context.platesInfers.inferRequests.lockedPush_back(lprRequest);
-                        }, classifiersAggreagator,
-                           std::ref(lprRequest),
-                           plateRect,
-                           std::ref(context)));
-
-            lprRequest.StartAsync();
-        }
-        plateRects.erase(plateRects.begin(), plateRectsIt);
+        ClassifiersBatch::enqueue(classifiersAggreagator, BboxAndDescr::ObjectType::PLATE, plateRects);
     } else {
         for (const cv::Rect& plateRect : plateRects) {
             classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::NONE, plateRect, ""});
         }
-        plateRects.clear();
     }
-    if (!vehicleRects.empty() || !plateRects.empty()) {
+}
+
+void ClassifiersBatch::enqueue(const std::shared_ptr<ClassifiersAggreagator>& classifiersAggreagator, BboxAndDescr::ObjectType objectType,
+        const std::list<cv::Rect>& rects) {
+    if (rects.empty()) {
+        return;
+    }
+    Context& context = static_cast<ReborningVideoFrame*>(classifiersAggreagator->sharedVideoFrame.get())->context;
+    RoiBatcher& batcher = getBatcher(context, objectType);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock{batcher.mutex};
+    for (const cv::Rect& rect : rects) {
+        batcher.rois.push_back(RoiBatcher::Roi{classifiersAggreagator, rect, now});
+    }
+    schedule(context, objectType, lock);
+}
+
+void ClassifiersBatch::schedule(Context& context, BboxAndDescr::ObjectType objectType, std::unique_lock<std::mutex>& batcherLock) {
+    RoiBatcher& batcher = getBatcher(context, objectType);
+    if (batcher.batchScheduled || batcher.rois.empty()) {
+        batcherLock.unlock();
+        return;
+    }
+    const VideoFrame::Ptr sharedVideoFrame = batcher.rois.front().classifiersAggreagator->sharedVideoFrame;
+    const std::chrono::steady_clock::time_point deadline = batcher.rois.front().enqueueTime + batcher.maxWait;
+    if (batcher.rois.size() >= batcher.maxBatch || std::chrono::steady_clock::now() >= deadline) {
+        batcher.batchScheduled = true;
+        batcher.deadlineId = 0;
+        batcherLock.unlock();
+        // the Worker calls isReady() under its mutex and isReady() locks the batcher, so push outside of the batcher's lock
         tryPush(context.detectionsProcessorsContext.detectionsProcessorsWorker,
-            std::make_shared<DetectionsProcessor>(sharedVideoFrame, std::move(classifiersAggreagator), std::move(vehicleRects), std::move(plateRects)));
+            std::make_shared<ClassifiersBatch>(sharedVideoFrame, objectType));
+    } else if (0 == batcher.deadlineId) {
+        const uint64_t deadlineId = batcher.deadlineId = ++batcher.deadlinesCount;
+        batcherLock.unlock();
+        // the function keeps the frame, which keeps the context
+        context.timer.schedule(deadline, [sharedVideoFrame, objectType, deadlineId] {
+            onDeadline(static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context, objectType, deadlineId);
+        });
+    } else {
+        batcherLock.unlock();
     }
 }
 
+void ClassifiersBatch::onDeadline(Context& context, BboxAndDescr::ObjectType objectType, uint64_t deadlineId) {
+    RoiBatcher& batcher = getBatcher(context, objectType);
+    std::unique_lock<std::mutex> lock{batcher.mutex};
+    if (deadlineId == batcher.deadlineId) {
+        schedule(context, objectType, lock);
+    }
+}
+
+bool ClassifiersBatch::isReady() {
+    Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
+    if (getInfers(context, objectType).inferRequests.lockedEmpty()) {
+        return false;
+    }
+    // the task is pushed when its ROIs are ready to be inferred, so it only waits for an InferRequest
+    RoiBatcher& batcher = getBatcher(context, objectType);
+    std::lock_guard<std::mutex> lock{batcher.mutex};
+    return !batcher.rois.empty();
+}
+
+void ClassifiersBatch::process() {
+    Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
+    RoiBatcher& batcher = getBatcher(context, objectType);
+    // only the single scheduled task of the batcher takes InferRequests from the container, so isReady() assures there is one
+    InferRequestsContainer& infers = getInfers(context, objectType);
+    infers.inferRequests.mutex.lock();
+    std::reference_wrapper<InferRequest> inferRequest = infers.inferRequests.container.back();
+    infers.inferRequests.container.pop_back();
+    infers.inferRequests.mutex.unlock();
+
+    std::vector<RoiBatcher::Roi> batch;
+    {
+        std::unique_lock<std::mutex> lock{batcher.mutex};
+        const std::size_t batchSize = std::min(batcher.rois.size(), batcher.maxBatch);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        batch.reserve(batchSize);
+        for (std::size_t i = 0; i < batchSize; i++) {
+            batcher.waitTime += now - batcher.rois.front().enqueueTime;
+            batch.push_back(std::move(batcher.rois.front()));
+            batcher.rois.pop_front();
+        }
+        batcher.batchesCount++;
+        batcher.roisCount += batchSize;
+        batcher.batchScheduled = false;
+        schedule(context, objectType, lock);
+    }
+
+    const char* const preprocessName = BboxAndDescr::ObjectType::VEHICLE == objectType ? "vehicle attributes preprocess"
+                                                                                        : "license plate recognition preprocess";
+    {
+        tracing::Scope scope(preprocessName);
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            const VideoFrame::Ptr& videoFrame = batch[i].classifiersAggreagator->sharedVideoFrame;
+            tracing::mark(videoFrame->sourceID, videoFrame->frameId);
+            if (BboxAndDescr::ObjectType::VEHICLE == objectType) {
+                context.detectionsProcessorsContext.vehicleAttributesClassifier.setImage(inferRequest, videoFrame->frame, batch[i].rect, i);
+            } else {
+                context.detectionsProcessorsContext.lpr.setImage(inferRequest, videoFrame->frame, batch[i].rect, i);
+            }
+        }
+    }
+    // without dynamic batch the empty slots of an incomplete batch keep crops of an earlier one, their results are ignored
+    if (batcher.dynamicBatch) {
+        inferRequest.get().SetBatch(static_cast<int>(batch.size()));
+    }
+
+    // batches mix frames of all channels, so they are recorded and replayed in order
+    getInfers(context, objectType).startAsync(inferRequest,
+        std::bind(
+            [](std::vector<RoiBatcher::Roi> batch,
+               InferRequest& inferRequest,
+               BboxAndDescr::ObjectType objectType,
+               Context& context,
+               tracing::Clock::time_point inferStart) {
+                    inferRequest.SetCompletionCallback([]{});  // destroy the stored bind object
+
+                    const bool isVehicle = BboxAndDescr::ObjectType::VEHICLE == objectType;
+                    if (tracing::isEnabled()) {
+                        tracing::Track& track = getInfers(context, objectType).getTrack(inferRequest);
+                        track.complete(isVehicle ? "vehicle attributes" : "license plate recognition", inferStart, tracing::Clock::now());
+                        for (const RoiBatcher::Roi& roi : batch) {
+                            track.mark(roi.classifiersAggreagator->sharedVideoFrame->sourceID,
+                                       roi.classifiersAggreagator->sharedVideoFrame->frameId, inferStart);
+                        }
+                    }
+                    tracing::Scope scope(isVehicle ? "vehicle attributes postprocess" : "license plate recognition postprocess");
+
+                    for (std::size_t i = 0; i < batch.size(); i++) {
+                        const std::shared_ptr<ClassifiersAggreagator>& classifiersAggreagator = batch[i].classifiersAggreagator;
+                        tracing::mark(classifiersAggreagator->sharedVideoFrame->sourceID, classifiersAggreagator->sharedVideoFrame->frameId);
+                        const bool rawOutput = FLAGS_r && ((classifiersAggreagator->sharedVideoFrame->frameId == 0 && !context.isVideo)
+                                                           || context.isVideo);
+                        if (BboxAndDescr::ObjectType::VEHICLE == objectType) {
+                            const std::pair<std::string, std::string>& attributes
+                                = context.detectionsProcessorsContext.vehicleAttributesClassifier.getResults(inferRequest, i);
+                            if (rawOutput) {
+                                classifiersAggreagator->rawAttributes.lockedPush_back("Vehicle Attributes results:" + attributes.first + ';'
+                                                                                      + attributes.second + '\n');
+                            }
+                            classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::VEHICLE, batch[i].rect,
+                                                                      attributes.first + ' ' + attributes.second});
+                        } else {
+                            std::string result = context.detectionsProcessorsContext.lpr.getResults(inferRequest, i);
+                            if (rawOutput) {
+                                classifiersAggreagator->rawDecodedPlates.lockedPush_back("License Plate Recognition results:" + result + '\n');
+                            }
+                            classifiersAggreagator->push(BboxAndDescr{BboxAndDescr::ObjectType::PLATE, batch[i].rect, std::move(result)});
+                        }
+                    }
+                    getInfers(context, objectType).inferRequests.lockedPush_back(inferRequest);
+                }, std::move(batch),
+                   inferRequest,
+                   objectType,
+                   std::ref(context),
+                   tracing::Clock::now()),
+        0, -1, context.timer);
+}
+
 bool InferTask::isReady() {
     InferRequestsContainer& detectorsInfers = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context.detectorsInfers;
     if (detectorsInfers.inferRequests.container.empty()) {
@@ -580,20 +789,29 @@ void InferTask::process() {
     detectorsInfers.inferRequests.container.pop_back();
     detectorsInfers.inferRequests.mutex.unlock();
 
-    context.inferTasksContext.detector.setImage(inferRequest, sharedVideoFrame->frame);
+    {
+        tracing::Scope scope("detection preprocess", sharedVideoFrame->sourceID, sharedVideoFrame->frameId);
+        context.inferTasksContext.detector.setImage(inferRequest, sharedVideoFrame->frame);
+    }
 
-    inferRequest.get().SetCompletionCallback(
+    detectorsInfers.startAsync(inferRequest,
         std::bind(
             [](VideoFrame::Ptr sharedVideoFrame,
                InferRequest& inferRequest,
-               Context& context) {
+               Context& context,
+               tracing::Clock::time_point inferStart) {
                     inferRequest.SetCompletionCallback([]{});  // destroy the stored bind object
+                    if (tracing::isEnabled()) {
+                        context.detectorsInfers.getTrack(inferRequest).complete("detection", inferStart, tracing::Clock::now(),
+                            sharedVideoFrame->sourceID, sharedVideoFrame->frameId);
+                    }
                     tryPush(context.detectionsProcessorsContext.detectionsProcessorsWorker,
                         std::make_shared<DetectionsProcessor>(sharedVideoFrame, &inferRequest));
                 }, sharedVideoFrame,
                    inferRequest,
-                   std::ref(context)));
-    inferRequest.get().StartAsync();
+                   std::ref(context),
+                   tracing::Clock::now()),
+        sharedVideoFrame->sourceID, sharedVideoFrame->frameId, context.timer);
     // do not push as callback does it
 }
 
@@ -612,7 +830,12 @@ void Reader::process() {
     unsigned sourceID = sharedVideoFrame->sourceID;
     Context& context = static_cast<ReborningVideoFrame*>(sharedVideoFrame.get())->context;
     const std::vector<std::shared_ptr<InputChannel>>& inputChannels = context.readersContext.inputChannels;
-    if (inputChannels[sourceID]->read(sharedVideoFrame->frame)) {
+    bool res;
+    {
+        tracing::Scope scope("capture", sourceID, sharedVideoFrame->frameId);
+        res = inputChannels[sourceID]->read(sharedVideoFrame->frame);
+    }
+    if (res) {
         context.readersContext.lastCapturedFrameIds[sourceID]++;
         context.readersContext.lastCapturedFrameIdsMutexes[sourceID].unlock();
         tryPush(context.inferTasksContext.inferTasksWorker, std::make_shared<InferTask>(sharedVideoFrame));
@@ -639,10 +862,18 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        if (!FLAGS_trace.empty()) {
+            tracing::enable();
+            tracing::setThreadName("main");
+        }
+
         std::vector<std::string> files;
         parseInputFilesArguments(files);
         if (files.empty() && 0 == FLAGS_nc) throw std::logic_error("No inputs were found");
         std::vector<std::shared_ptr<VideoCaptureSource>> videoCapturSourcess;
+        // channels of a source read the same frames, but a channel which falls behind
+        // the others for more than twice the number of its allocated frames skips frames
+        const std::size_t sourceQueueSize = 2 * FLAGS_n_iqs;
         std::vector<std::shared_ptr<ImageSource>> imageSourcess;
         if (FLAGS_nc) {
             for (size_t i = 0; i < FLAGS_nc; ++i) {
@@ -655,7 +886,7 @@ int main(int argc, char* argv[]) {
                 videoCapture.set(cv::CAP_PROP_BUFFERSIZE , 1);
                 videoCapture.set(cv::CAP_PROP_FRAME_WIDTH, 640);
                 videoCapture.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
-                videoCapturSourcess.push_back(std::make_shared<VideoCaptureSource>(videoCapture, FLAGS_loop_video));
+                videoCapturSourcess.push_back(std::make_shared<VideoCaptureSource>(videoCapture, FLAGS_loop_video, sourceQueueSize));
             }
         }
         for (const std::string& file : files) {
@@ -666,7 +897,7 @@ int main(int argc, char* argv[]) {
                     slog::info << "Cannot open " << file << slog::endl;
                     return 1;
                 }
-                videoCapturSourcess.push_back(std::make_shared<VideoCaptureSource>(videoCapture, FLAGS_loop_video));
+                videoCapturSourcess.push_back(std::make_shared<VideoCaptureSource>(videoCapture, FLAGS_loop_video, sourceQueueSize));
             } else {
                 imageSourcess.push_back(std::make_shared<ImageSource>(frame, true));
             }
@@ -719,14 +950,16 @@ int main(int argc, char* argv[]) {
                     ie.AddExtension(extension_ptr, "CPU");
                     slog::info << "CPU Extension loaded: " << FLAGS_l << slog::endl;
                 }
-                if (FLAGS_nthreads != 0) {
-                    ie.SetConfig({{ CONFIG_KEY(CPU_THREADS_NUM), std::to_string(FLAGS_nthreads) }}, "CPU");
-                }
                 ie.SetConfig({{ CONFIG_KEY(CPU_BIND_THREAD), CONFIG_VALUE(NO) }}, "CPU");
-                ie.SetConfig({{ CONFIG_KEY(CPU_THROUGHPUT_STREAMS),
-                                (device_nstreams.count("CPU") > 0 ? std::to_string(device_nstreams.at("CPU")) :
-                                                                    CONFIG_VALUE(CPU_THROUGHPUT_AUTO)) }}, "CPU");
-                device_nstreams["CPU"] = std::stoi(ie.GetConfig("CPU", CONFIG_KEY(CPU_THROUGHPUT_STREAMS)).as<std::string>());
+                if (!FLAGS_cpu_plan) {  // otherwise every network gets threads and streams of the plan
+                    if (FLAGS_nthreads != 0) {
+                        ie.SetConfig({{ CONFIG_KEY(CPU_THREADS_NUM), std::to_string(FLAGS_nthreads) }}, "CPU");
+                    }
+                    ie.SetConfig({{ CONFIG_KEY(CPU_THROUGHPUT_STREAMS),
+                                    (device_nstreams.count("CPU") > 0 ? std::to_string(device_nstreams.at("CPU")) :
+                                                                        CONFIG_VALUE(CPU_THROUGHPUT_AUTO)) }}, "CPU");
+                    device_nstreams["CPU"] = std::stoi(ie.GetConfig("CPU", CONFIG_KEY(CPU_THROUGHPUT_STREAMS)).as<std::string>());
+                }
             }
 
             if ("GPU" == device) {
@@ -764,29 +997,86 @@ int main(int argc, char* argv[]) {
             return config;
         };
 
+        /** Dynamic batch lets incomplete batches of vehicles skip inference of empty slots. It limits the first dimension
+            of every input, but the sequence input of LPR is [sequence size, batch], so LPR always infers full batches **/
+        auto isDynamicBatch = [&](const std::string &deviceName) {
+            return FLAGS_dyn_cb && FLAGS_n_cb > 1
+                && (deviceName.find("CPU") != std::string::npos || deviceName.find("GPU") != std::string::npos);
+        };
+        auto makeAttributesConfig = [&](const std::string &deviceName, const std::string &suffix) {
+            std::map<std::string, std::string> config = makeTagConfig(deviceName, suffix);
+            if (isDynamicBatch(deviceName)) {
+                config[PluginConfigParams::KEY_DYN_BATCH_ENABLED] = PluginConfigParams::YES;
+            }
+            return config;
+        };
+
+        /** Networks on the CPU get cores of their own, the workers get the rest **/
+        CpuPlanner cpuPlanner;
+        if (FLAGS_cpu_plan) {
+            if ("CPU" == FLAGS_d) {
+                cpuPlanner.addNetwork("detection", 2);
+            }
+            if (!FLAGS_m_va.empty() && "CPU" == FLAGS_d_va) {
+                cpuPlanner.addNetwork("vehicle attributes", 1);
+            }
+            if (!FLAGS_m_lpr.empty() && "CPU" == FLAGS_d_lpr) {
+                cpuPlanner.addNetwork("license plate recognition", 1);
+            }
+            cpuPlanner.addStage("workers", FLAGS_n_wt);
+            cpuPlanner.plan();
+            cpuPlanner.printPlan();
+        }
+        // Must be called by the thread loading the network: inference threads of the plugin inherit its CPU mask
+        auto planCpu = [&](const std::string &deviceName, const std::string &networkName, std::map<std::string, std::string> config) {
+            if (FLAGS_cpu_plan && "CPU" == deviceName) {
+                const CpuPlanner::Assignment& assignment = cpuPlanner.getAssignment(networkName);
+                config[CONFIG_KEY(CPU_THREADS_NUM)] = std::to_string(assignment.threads);
+                config[CONFIG_KEY(CPU_THROUGHPUT_STREAMS)] = std::to_string(assignment.streams);
+                cpuPlanner.bindCurrentThread(networkName);
+            }
+            return config;
+        };
+
         // -----------------------------------------------------------------------------------------------------
         unsigned nireq = FLAGS_nireq == 0 ? inputChannels.size() : FLAGS_nireq;
+        ModelLoader loader(ie, FLAGS_cache_dir);
+        std::vector<std::function<void()>> loaders;
         slog::info << "Loading detection model to the "<< FLAGS_d << " plugin" << slog::endl;
-        Detector detector(ie, FLAGS_d, FLAGS_m,
-            {static_cast<float>(FLAGS_t), static_cast<float>(FLAGS_t)}, FLAGS_auto_resize, makeTagConfig(FLAGS_d, "Detect"));
+        Detector detector;
+        loaders.emplace_back([&]() {
+            detector = Detector(loader, FLAGS_d, FLAGS_m,
+                {static_cast<float>(FLAGS_t), static_cast<float>(FLAGS_t)}, FLAGS_auto_resize,
+                planCpu(FLAGS_d, "detection", makeTagConfig(FLAGS_d, "Detect")));
+        });
         VehicleAttributesClassifier vehicleAttributesClassifier;
         std::size_t nclassifiersireq{0};
         Lpr lpr;
         std::size_t nrecognizersireq{0};
         if (!FLAGS_m_va.empty()) {
             slog::info << "Loading Vehicle Attribs model to the "<< FLAGS_d_va << " plugin" << slog::endl;
-            vehicleAttributesClassifier = VehicleAttributesClassifier(ie, FLAGS_d_va, FLAGS_m_va, FLAGS_auto_resize, makeTagConfig(FLAGS_d_va, "Attr"));
+            loaders.emplace_back([&]() {
+                vehicleAttributesClassifier = VehicleAttributesClassifier(loader, FLAGS_d_va, FLAGS_m_va, FLAGS_auto_resize, FLAGS_n_cb,
+                    planCpu(FLAGS_d_va, "vehicle attributes", makeAttributesConfig(FLAGS_d_va, "Attr")));
+            });
             nclassifiersireq = nireq * 3;
         }
         if (!FLAGS_m_lpr.empty()) {
             slog::info << "Loading Licence Plate Recognition (LPR) model to the "<< FLAGS_d_lpr << " plugin" << slog::endl;
-            lpr = Lpr(ie, FLAGS_d_lpr, FLAGS_m_lpr, FLAGS_auto_resize, makeTagConfig(FLAGS_d_lpr, "LPR"));
+            loaders.emplace_back([&]() {
+                lpr = Lpr(loader, FLAGS_d_lpr, FLAGS_m_lpr, FLAGS_auto_resize, FLAGS_n_cb,
+                    planCpu(FLAGS_d_lpr, "license plate recognition", makeTagConfig(FLAGS_d_lpr, "LPR")));
+            });
             nrecognizersireq = nireq * 3;
         }
+        loader.run(loaders);
+        loader.printReport();
         bool isVideo = imageSourcess.empty() ? true : false;
         int pause = imageSourcess.empty() ? 1 : 0;
         std::chrono::steady_clock::duration showPeriod = 0 == FLAGS_fps ? std::chrono::steady_clock::duration::zero()
             : std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds{1}) / FLAGS_fps;
+        std::chrono::steady_clock::duration displayPeriod = 0 == FLAGS_display_fps || FLAGS_no_show ? std::chrono::steady_clock::duration::zero()
+            : std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds{1}) / FLAGS_display_fps;
         std::vector<cv::Size> gridParam;
         gridParam.reserve(inputChannels.size());
         for (const auto& inputChannel : inputChannels) {
@@ -797,6 +1087,9 @@ int main(int argc, char* argv[]) {
                                               std::stoi(FLAGS_display_resolution.substr(found + 1, FLAGS_display_resolution.length()))};
 
         slog::info << "Number of InferRequests: " << nireq << " (detection), " << nclassifiersireq << " (classification), " << nrecognizersireq << " (recognition)" << slog::endl;
+        if (FLAGS_n_cb > 1) {
+            slog::info << "Batch size of classification and recognition: " << FLAGS_n_cb << ", maximum wait " << FLAGS_cb_wait << " ms" << slog::endl;
+        }
         std::ostringstream device_ss;
         for (const auto& nstreams : device_nstreams) {
             if (!device_ss.str().empty()) {
@@ -812,11 +1105,38 @@ int main(int argc, char* argv[]) {
         Context context{inputChannels,
                         detector,
                         vehicleAttributesClassifier, lpr,
-                        pause, gridParam, displayResolution, showPeriod, FLAGS_u,
+                        pause, gridParam, displayResolution, showPeriod, displayPeriod, FLAGS_u,
                         FLAGS_n_iqs - 1,
                         nireq,
                         isVideo,
-                        nclassifiersireq, nrecognizersireq};
+                        nclassifiersireq, nrecognizersireq,
+                        FLAGS_n_cb, std::chrono::milliseconds{FLAGS_cb_wait}};
+        context.detectionsProcessorsContext.attributesBatcher.dynamicBatch = isDynamicBatch(FLAGS_d_va);
+
+        /** Every network records its outputs to a file of its own and replays them from it **/
+        auto setReplay = [&](InferRequestsContainer& infers, const ExecutableNetwork& network, const std::string& fileName) {
+            std::shared_ptr<OutputsRecorder> recorder;
+            std::shared_ptr<OutputsReplayer> replayer;
+            if (!FLAGS_record.empty()) {
+                recorder = std::make_shared<OutputsRecorder>(FLAGS_record + '/' + fileName);
+            }
+            if (!FLAGS_replay.empty()) {
+                replayer = std::make_shared<OutputsReplayer>(FLAGS_replay + '/' + fileName,
+                    std::chrono::microseconds(static_cast<int64_t>(FLAGS_replay_latency * 1000)));
+            }
+            infers.setReplay(network, std::move(recorder), std::move(replayer));
+        };
+        setReplay(context.detectorsInfers, context.inferTasksContext.detector.getNetwork(), "detection.bin");
+        if (!FLAGS_m_va.empty()) {
+            setReplay(context.attributesInfers, context.detectionsProcessorsContext.vehicleAttributesClassifier.getNetwork(),
+                      "vehicle_attributes.bin");
+        }
+        if (!FLAGS_m_lpr.empty()) {
+            setReplay(context.platesInfers, context.detectionsProcessorsContext.lpr.getNetwork(), "license_plate_recognition.bin");
+        }
+        if (!FLAGS_replay.empty()) {
+            slog::info << "Outputs of the networks are replayed from " << FLAGS_replay << slog::endl;
+        }
         // Create a worker after a context because the context has only weak_ptr<Worker>, but the worker is going to
         // indirectly store ReborningVideoFrames which have a reference to the context. So there won't be a situation
         // when the context is destroyed and the worker still lives with its ReborningVideoFrames referring to the
@@ -843,10 +1163,23 @@ int main(int argc, char* argv[]) {
         const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
         context.t0 = t0;
         context.drawersContext.updateTime = t0;
+        CpuMonitor cpuMonitor;
+        if (FLAGS_cpu_plan) {
+            cpuMonitor.setHistorySize(1);
+            cpuPlanner.bindCurrentThread("workers");  // the worker threads inherit the mask
+        }
         worker->runThreads();
         worker->threadFunc();
         worker->join();
         const auto t1 = std::chrono::steady_clock::now();
+        if (FLAGS_cpu_plan) {
+            cpuMonitor.collectData();
+            cpuPlanner.printUtilization(cpuMonitor.getMeanCpuLoad());
+        }
+        // vehicles and plates left in the queues refer to frames, which must not outlive the parts of the context they use
+        context.timer.stop();
+        context.detectionsProcessorsContext.attributesBatcher.rois.clear();
+        context.detectionsProcessorsContext.platesBatcher.rois.clear();
 
         std::map<std::string, std::string> mapDevices = getMapFullDevicesNames(ie, {FLAGS_d, FLAGS_d_va, FLAGS_d_lpr});
         for (auto& net : std::array<std::pair<std::vector<InferRequest>, std::string>, 3>{
@@ -855,12 +1188,16 @@ int main(int argc, char* argv[]) {
                 std::make_pair(context.platesInfers.getActualInferRequests(), FLAGS_d_lpr)}) {
             for (InferRequest& ir : net.first) {
                 ir.Wait(IInferRequest::WaitMode::RESULT_READY);
-                if (FLAGS_pc) {  // Show performace results
+                if (FLAGS_pc && FLAGS_replay.empty()) {  // Show performace results
                     printPerformanceCounts(ir, std::cout, std::string::npos == net.second.find("MULTI") ? getFullDeviceName(mapDevices, net.second)
                                                                                                         : net.second);
                 }
             }
         }
+        if (!FLAGS_trace.empty()) {
+            tracing::save(FLAGS_trace);
+            slog::info << "Trace is saved to " << FLAGS_trace << slog::endl;
+        }
 
         uint64_t frameCounter = context.frameCounter;
         if (0 != frameCounter) {
@@ -872,6 +1209,23 @@ int main(int argc, char* argv[]) {
                 / (frameCounter * context.nireq) * 100;
             std::cout << "Detection InferRequests usage: " << detectionsInfersUsage << "%\n";
         }
+        for (const auto& batcher : {std::make_pair(&context.detectionsProcessorsContext.attributesBatcher, "Vehicle Attributes"),
+                                    std::make_pair(&context.detectionsProcessorsContext.platesBatcher, "License Plate Recognition")}) {
+            if (0 != batcher.first->batchesCount) {
+                std::cout << batcher.second << " batches: " << static_cast<float>(batcher.first->roisCount) / batcher.first->batchesCount
+                    << " of " << batcher.first->maxBatch << " filled on average, "
+                    << std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(batcher.first->waitTime).count()
+                        / batcher.first->roisCount << " ms average wait\n";
+            }
+        }
+
+        uint64_t droppedFrames = 0;
+        for (const std::shared_ptr<VideoCaptureSource>& videoSource : videoCapturSourcess) {
+            droppedFrames += videoSource->getDroppedFrames();
+        }
+        if (0 != droppedFrames) {
+            std::cout << "Frames skipped by channels lagging behind their source: " << droppedFrames << '\n';
+        }
 
         std::cout << context.drawersContext.presenter.reportMeans() << '\n';
     } catch (const std::exception& error) {
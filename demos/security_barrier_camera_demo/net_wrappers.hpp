@@ -13,6 +13,7 @@
 #include <inference_engine.hpp>
 #include <samples/common.hpp>
 #include <samples/ocv_common.hpp>
+#include <model_loader/model_loader.hpp>
 
 class Detector {
 public:
@@ -26,10 +27,10 @@ public:
     static constexpr int objectSize = 7;  // Output should have 7 as a last dimension"
 
     Detector() = default;
-    Detector(InferenceEngine::Core& ie, const std::string& deviceName, const std::string& xmlPath, const std::vector<float>& detectionTresholds,
+    Detector(const ModelLoader& loader, const std::string& deviceName, const std::string& xmlPath, const std::vector<float>& detectionTresholds,
             const bool autoResize, const std::map<std::string, std::string> & pluginConfig) :
-        detectionTresholds{detectionTresholds}, ie_{ie} {
-        auto network = ie.ReadNetwork(xmlPath);
+        detectionTresholds{detectionTresholds}, ie_{loader.getCore()} {
+        auto network = loader.readNetwork(xmlPath);
         InferenceEngine::InputsDataMap inputInfo(network.getInputsInfo());
         if (inputInfo.size() != 1) {
             throw std::logic_error("Detector should have only one input");
@@ -64,13 +65,17 @@ public:
         }
         _output->setPrecision(InferenceEngine::Precision::FP32);
 
-        net = ie_.LoadNetwork(network, deviceName, pluginConfig);
+        net = loader.loadNetwork(network, xmlPath, deviceName, pluginConfig);
     }
 
     InferenceEngine::InferRequest createInferRequest() {
         return net.CreateInferRequest();
     }
 
+    const InferenceEngine::ExecutableNetwork& getNetwork() const {
+        return net;
+    }
+
     void setImage(InferenceEngine::InferRequest& inferRequest, const cv::Mat& img) {
         InferenceEngine::Blob::Ptr input = inferRequest.GetBlob(detectorInputBlobName);
         if (InferenceEngine::Layout::NHWC == input->getTensorDesc().getLayout()) {  // autoResize is set
@@ -130,16 +135,18 @@ private:
 class VehicleAttributesClassifier {
 public:
     VehicleAttributesClassifier() = default;
-    VehicleAttributesClassifier(InferenceEngine::Core& ie, const std::string & deviceName,
-        const std::string& xmlPath, const bool autoResize, const std::map<std::string, std::string> & pluginConfig) : ie_(ie) {
-        auto network = ie.ReadNetwork(FLAGS_m_va);
+    VehicleAttributesClassifier(const ModelLoader& loader, const std::string & deviceName,
+        const std::string& xmlPath, const bool autoResize, const std::size_t maxBatch,
+        const std::map<std::string, std::string> & pluginConfig) : ie_(loader.getCore()) {
+        auto network = loader.readNetwork(xmlPath);
         InferenceEngine::InputsDataMap attributesInputInfo(network.getInputsInfo());
         if (attributesInputInfo.size() != 1) {
             throw std::logic_error("Vehicle Attribs topology should have only one input");
         }
         InferenceEngine::InputInfo::Ptr& attributesInputInfoFirst = attributesInputInfo.begin()->second;
         attributesInputInfoFirst->setPrecision(InferenceEngine::Precision::U8);
-        if (FLAGS_auto_resize) {
+        // a ROI blob can't be a part of a batch, so crops of batched requests are resized by OpenCV
+        if (autoResize && 1 == maxBatch) {
             attributesInputInfoFirst->getPreProcess().setResizeAlgorithm(InferenceEngine::ResizeAlgorithm::RESIZE_BILINEAR);
             attributesInputInfoFirst->setLayout(InferenceEngine::Layout::NHWC);
         } else {
@@ -158,14 +165,21 @@ public:
         it->second->setPrecision(InferenceEngine::Precision::FP32);
         outputNameForType = (it)->second->getName();  // type is the second output.
 
-        net = ie_.LoadNetwork(network, deviceName, pluginConfig);
+        if (1 != maxBatch) {
+            network.setBatchSize(maxBatch);
+        }
+        net = loader.loadNetwork(network, xmlPath, deviceName, pluginConfig);
     }
 
     InferenceEngine::InferRequest createInferRequest() {
         return net.CreateInferRequest();
     }
 
-    void setImage(InferenceEngine::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect vehicleRect) {
+    const InferenceEngine::ExecutableNetwork& getNetwork() const {
+        return net;
+    }
+
+    void setImage(InferenceEngine::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect vehicleRect, std::size_t batchIndex = 0) {
         InferenceEngine::Blob::Ptr roiBlob = inferRequest.GetBlob(attributesInputName);
         if (InferenceEngine::Layout::NHWC == roiBlob->getTensorDesc().getLayout()) {  // autoResize is set
             InferenceEngine::ROI cropRoi{0, static_cast<size_t>(vehicleRect.x), static_cast<size_t>(vehicleRect.y), static_cast<size_t>(vehicleRect.width),
@@ -175,10 +189,10 @@ public:
             inferRequest.SetBlob(attributesInputName, roiBlob);
         } else {
             const cv::Mat& vehicleImage = img(vehicleRect);
-            matU8ToBlob<uint8_t>(vehicleImage, roiBlob);
+            matU8ToBlob<uint8_t>(vehicleImage, roiBlob, static_cast<int>(batchIndex));
         }
     }
-    std::pair<std::string, std::string> getResults(InferenceEngine::InferRequest& inferRequest) {
+    std::pair<std::string, std::string> getResults(InferenceEngine::InferRequest& inferRequest, std::size_t batchIndex = 0) {
         static const std::string colors[] = {
             "white", "gray", "yellow", "red", "green", "blue", "black"
         };
@@ -189,11 +203,11 @@ public:
         // 7 possible colors for each vehicle and we should select the one with the maximum probability
         InferenceEngine::LockedMemory<const void> colorsMapped = InferenceEngine::as<InferenceEngine::MemoryBlob>(
             inferRequest.GetBlob(outputNameForColor))->rmap();
-        auto colorsValues = colorsMapped.as<float*>();
+        auto colorsValues = colorsMapped.as<float*>() + 7 * batchIndex;
         // 4 possible types for each vehicle and we should select the one with the maximum probability
         InferenceEngine::LockedMemory<const void> typesMapped = InferenceEngine::as<InferenceEngine::MemoryBlob>(
             inferRequest.GetBlob(outputNameForType))->rmap();
-        auto typesValues = typesMapped.as<float*>();
+        auto typesValues = typesMapped.as<float*>() + 4 * batchIndex;
 
         const auto color_id = std::max_element(colorsValues, colorsValues + 7) - colorsValues;
         const auto  type_id = std::max_element(typesValues,  typesValues  + 4) - typesValues;
@@ -211,10 +225,10 @@ private:
 class Lpr {
 public:
     Lpr() = default;
-    Lpr(InferenceEngine::Core& ie, const std::string & deviceName, const std::string& xmlPath, const bool autoResize,
-        const std::map<std::string, std::string> &pluginConfig) :
-        ie_{ie} {
-        auto network = ie.ReadNetwork(FLAGS_m_lpr);
+    Lpr(const ModelLoader& loader, const std::string & deviceName, const std::string& xmlPath, const bool autoResize,
+        const std::size_t maxBatch, const std::map<std::string, std::string> &pluginConfig) :
+        ie_{loader.getCore()} {
+        auto network = loader.readNetwork(xmlPath);
 
         /** LPR network should have 2 inputs (and second is just a stub) and one output **/
         // ---------------------------Check inputs ------------------------------------------------------
@@ -224,7 +238,8 @@ public:
         }
         InferenceEngine::InputInfo::Ptr& LprInputInfoFirst = LprInputInfo.begin()->second;
         LprInputInfoFirst->setPrecision(InferenceEngine::Precision::U8);
-        if (FLAGS_auto_resize) {
+        // a ROI blob can't be a part of a batch, so crops of batched requests are resized by OpenCV
+        if (autoResize && 1 == maxBatch) {
             LprInputInfoFirst->getPreProcess().setResizeAlgorithm(InferenceEngine::ResizeAlgorithm::RESIZE_BILINEAR);
             LprInputInfoFirst->setLayout(InferenceEngine::Layout::NHWC);
         } else {
@@ -253,14 +268,43 @@ public:
         size_t indexOfSequenceSize = LprInputSeqName == "" ? 2 : 1;
         maxSequenceSizePerPlate = lprOutputInfo->second->getTensorDesc().getDims()[indexOfSequenceSize];
 
-        net = ie_.LoadNetwork(network, deviceName, pluginConfig);
+        if (1 != maxBatch) {
+            // the sequence input is [sequence size, batch], so setBatchSize() can't be used
+            InferenceEngine::ICNNNetwork::InputShapes shapes = network.getInputShapes();
+            shapes.at(LprInputName)[0] = maxBatch;
+            if (LprInputSeqName != "") {
+                InferenceEngine::SizeVector& seqShape = shapes.at(LprInputSeqName);
+                if (seqShape.size() != 2) {
+                    throw std::logic_error("LPR sequence input should have 2 dimensions");
+                }
+                seqShape[1] = maxBatch;
+            }
+            network.reshape(shapes);
+        }
+        net = loader.loadNetwork(network, xmlPath, deviceName, pluginConfig);
+    }
+
+    const InferenceEngine::ExecutableNetwork& getNetwork() const {
+        return net;
     }
 
     InferenceEngine::InferRequest createInferRequest() {
-        return net.CreateInferRequest();
+        InferenceEngine::InferRequest inferRequest = net.CreateInferRequest();
+        if (LprInputSeqName != "") {
+            InferenceEngine::Blob::Ptr seqBlob = inferRequest.GetBlob(LprInputSeqName);
+            // second input is sequence, which is some relic from the training
+            // it should have the leading 0.0f and rest 1.0f for every plate of a batch
+            InferenceEngine::LockedMemory<void> seqBlobMapped =
+                InferenceEngine::as<InferenceEngine::MemoryBlob>(seqBlob)->wmap();
+            float* blob_data = seqBlobMapped.as<float*>();
+            const std::size_t batchSize = seqBlob->size() / seqBlob->getTensorDesc().getDims()[0];
+            std::fill(blob_data, blob_data + batchSize, 0.0f);
+            std::fill(blob_data + batchSize, blob_data + seqBlob->size(), 1.0f);
+        }
+        return inferRequest;
     }
 
-    void setImage(InferenceEngine::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect plateRect) {
+    void setImage(InferenceEngine::InferRequest& inferRequest, const cv::Mat& img, const cv::Rect plateRect, std::size_t batchIndex = 0) {
         InferenceEngine::Blob::Ptr roiBlob = inferRequest.GetBlob(LprInputName);
         if (InferenceEngine::Layout::NHWC == roiBlob->getTensorDesc().getLayout()) {  // autoResize is set
             InferenceEngine::ROI cropRoi{0, static_cast<size_t>(plateRect.x), static_cast<size_t>(plateRect.y), static_cast<size_t>(plateRect.width),
@@ -270,22 +314,11 @@ public:
             inferRequest.SetBlob(LprInputName, roiBlob);
         } else {
             const cv::Mat& vehicleImage = img(plateRect);
-            matU8ToBlob<uint8_t>(vehicleImage, roiBlob);
-        }
-
-        if (LprInputSeqName != "") {
-            InferenceEngine::Blob::Ptr seqBlob = inferRequest.GetBlob(LprInputSeqName);
-            // second input is sequence, which is some relic from the training
-            // it should have the leading 0.0f and rest 1.0f
-            InferenceEngine::LockedMemory<void> seqBlobMapped =
-                InferenceEngine::as<InferenceEngine::MemoryBlob>(seqBlob)->wmap();
-            float* blob_data = seqBlobMapped.as<float*>();
-            blob_data[0] = 0.0f;
-            std::fill(blob_data + 1, blob_data + seqBlob->getTensorDesc().getDims()[0], 1.0f);
+            matU8ToBlob<uint8_t>(vehicleImage, roiBlob, static_cast<int>(batchIndex));
         }
     }
 
-    std::string getResults(InferenceEngine::InferRequest& inferRequest) {
+    std::string getResults(InferenceEngine::InferRequest& inferRequest, std::size_t batchIndex = 0) {
         static const char *const items[] = {
                 "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
                 "<Anhui>", "<Beijing>", "<Chongqing>", "<Fujian>",
@@ -306,7 +339,7 @@ public:
         // up to 88 items per license plate, ended with "-1"
         InferenceEngine::LockedMemory<const void> lprOutputMapped = InferenceEngine::as<InferenceEngine::MemoryBlob>(
             inferRequest.GetBlob(LprOutputName))->rmap();
-        const auto data = lprOutputMapped.as<float*>();
+        const auto data = lprOutputMapped.as<float*>() + maxSequenceSizePerPlate * batchIndex;
         for (int i = 0; i < maxSequenceSizePerPlate; i++) {
             if (data[i] == -1) {
                 break;
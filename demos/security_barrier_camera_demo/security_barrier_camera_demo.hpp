@@ -44,6 +44,9 @@ static const char ninputs_message[] = "Optional. Specify the number of channels
                                       "For example, if only one camera is provided, but -ni is set to 2, the demo will process frames as if they are captured from two cameras. "
                                       "0 sets the number of input channels equal to the number of provided inputs.";
 static const char fps[] = "Optional. Set the playback speed not faster than the specified FPS. 0 removes the upper bound.";
+static const char display_fps_message[] = "Optional. Show the latest frames of all channels with the specified FPS instead of waiting for "
+                                          "frames with the same index from every channel, so the display doesn't slow down processing. "
+                                          "0 shows frames with the same index together.";
 static const char worker_threads[] = "Optional. Set the number of threads including the main thread a Worker class will use.";
 static const char display_resolution_message[] = "Optional. Specify the maximum output window resolution.";
 static const char use_tag_scheduler_message[] = "Required for HDDL plugin only. "
@@ -56,6 +59,27 @@ static const char infer_num_threads_message[] = "Optional. Number of threads to
 static const char infer_num_streams_message[] = "Optional. Number of streams to use for inference on the CPU or/and GPU in throughput mode "
                                                 "(for HETERO and MULTI device cases use format <device1>:<nstreams1>,<device2>:<nstreams2> or just <nstreams>)";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char classifiers_batch_message[] = "Optional. Maximum number of vehicles or license plates from all channels processed by one "
+                                                "Vehicle Attributes or License Plate Recognition infer request. "
+                                                "Values greater than 1 disable -auto_resize for these networks.";
+static const char classifiers_wait_message[] = "Optional. Maximum time in milliseconds a vehicle or a license plate waits for a batch to fill up.";
+static const char dyn_batch_classifiers_message[] = "Optional. Enable dynamic batch size for Vehicle Attributes network on CPU and GPU. "
+                                                    "License Plate Recognition always infers full batches.";
+static const char trace_message[] = "Optional. Save the timeline of capture, inference and rendering of frames to the specified file "
+                                    "in the Chrome trace event format, which chrome://tracing and ui.perfetto.dev open.";
+static const char cache_dir_message[] = "Optional. Existing directory to cache compiled networks in. Networks found in the cache "
+                                        "are imported instead of being compiled. Only devices which support network export use the cache.";
+static const char cpu_plan_message[] = "Optional. Split the CPU cores available to the demo between the networks inferred on the CPU "
+                                       "and the worker threads, so that they don't compete for the cores. -nthreads and -nstreams "
+                                       "are ignored for the CPU. Use taskset or numactl to run several demos on different cores.";
+
+static const char record_message[] = "Optional. Save the outputs of every network to a file of its own in the specified existing "
+                                     "directory, to replay them with -replay.";
+static const char replay_message[] = "Optional. Take the outputs of the networks from the files saved with -record to the specified "
+                                     "directory instead of running inference. The models are still loaded for the descriptions of "
+                                     "their inputs and outputs, but no request is inferred. Channels and frames which weren't "
+                                     "recorded get the outputs of the recorded ones in a loop.";
+static const char replay_latency_message[] = "Optional. Time in msec every replayed request takes. Default value is 0.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "", video_message);
@@ -79,12 +103,22 @@ DEFINE_bool(loop_video, false, loop_video_output_message);
 DEFINE_uint32(n_iqs, 3, input_queue_size);
 DEFINE_uint32(ni, 0, ninputs_message);
 DEFINE_uint32(fps, 0, fps);
+DEFINE_uint32(display_fps, 0, display_fps_message);
 DEFINE_uint32(n_wt, 1, worker_threads);
 DEFINE_string(display_resolution, "1920x1080", display_resolution_message);
 DEFINE_bool(tag, false, use_tag_scheduler_message);
 DEFINE_uint32(nthreads, 0, infer_num_threads_message);
 DEFINE_string(nstreams, "", infer_num_streams_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_uint32(n_cb, 1, classifiers_batch_message);
+DEFINE_uint32(cb_wait, 5, classifiers_wait_message);
+DEFINE_bool(dyn_cb, false, dyn_batch_classifiers_message);
+DEFINE_string(trace, "", trace_message);
+DEFINE_string(cache_dir, "", cache_dir_message);
+DEFINE_bool(cpu_plan, false, cpu_plan_message);
+DEFINE_string(record, "", record_message);
+DEFINE_string(replay, "", replay_message);
+DEFINE_double(replay_latency, 0.0, replay_latency_message);
 
 /**
 * \brief This function show a help message
@@ -117,10 +151,20 @@ void showUsage() {
     std::cout << "    -n_iqs                     " << input_queue_size << std::endl;
     std::cout << "    -ni                        " << ninputs_message << std::endl;
     std::cout << "    -fps                       " << fps << std::endl;
+    std::cout << "    -display_fps               " << display_fps_message << std::endl;
     std::cout << "    -n_wt                      " << worker_threads << std::endl;
     std::cout << "    -display_resolution        " << display_resolution_message << std::endl;
     std::cout << "    -tag                       " << use_tag_scheduler_message << std::endl;
     std::cout << "    -nstreams \"<integer>\"      " << infer_num_streams_message << std::endl;
     std::cout << "    -nthreads \"<integer>\"      " << infer_num_threads_message << std::endl;
     std::cout << "    -u                         " << utilization_monitors_message << std::endl;
+    std::cout << "    -n_cb                      " << classifiers_batch_message << std::endl;
+    std::cout << "    -cb_wait                   " << classifiers_wait_message << std::endl;
+    std::cout << "    -dyn_cb                    " << dyn_batch_classifiers_message << std::endl;
+    std::cout << "    -trace \"<path>\"            " << trace_message << std::endl;
+    std::cout << "    -cache_dir \"<path>\"        " << cache_dir_message << std::endl;
+    std::cout << "    -cpu_plan                  " << cpu_plan_message << std::endl;
+    std::cout << "    -record \"<path>\"           " << record_message << std::endl;
+    std::cout << "    -replay \"<path>\"           " << replay_message << std::endl;
+    std::cout << "    -replay_latency            " << replay_latency_message << std::endl;
 }
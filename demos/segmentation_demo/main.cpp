@@ -19,6 +19,7 @@
 #include <samples/slog.hpp>
 
 #include "segmentation_demo.h"
+#include "segmentation_output.h"
 
 using namespace InferenceEngine;
 typedef std::chrono::duration<double, std::chrono::milliseconds::period> Ms;
@@ -138,7 +139,7 @@ int main(int argc, char *argv[]) {
                 &blending);
         }
 
-        cv::Mat inImg, resImg, maskImg(outHeight, outWidth, CV_8UC3);
+        cv::Mat inImg, resImg, classMap, maskImg(outHeight, outWidth, CV_8UC3);
         std::vector<cv::Vec3b> colors(arraySize(CITYSCAPES_COLORS));
         for (std::size_t i = 0; i < colors.size(); ++i)
             colors[i] = {CITYSCAPES_COLORS[i].blue(), CITYSCAPES_COLORS[i].green(), CITYSCAPES_COLORS[i].red()};
@@ -161,21 +162,10 @@ int main(int argc, char *argv[]) {
 
             LockedMemory<const void> outMapped = as<MemoryBlob>(inferRequest.GetBlob(outName))->rmap();
             const float * const predictions = outMapped.as<float*>();
+            argMaxClasses(predictions, outChannels, outHeight, outWidth, classMap);
             for (int rowId = 0; rowId < outHeight; ++rowId) {
                 for (int colId = 0; colId < outWidth; ++colId) {
-                    std::size_t classId = 0;
-                    if (outChannels < 2) {  // assume the output is already ArgMax'ed
-                        classId = static_cast<std::size_t>(predictions[rowId * outWidth + colId]);
-                    } else {
-                        float maxProb = -1.0f;
-                        for (int chId = 0; chId < outChannels; ++chId) {
-                            float prob = predictions[chId * outHeight * outWidth + rowId * outWidth + colId];
-                            if (prob > maxProb) {
-                                classId = chId;
-                                maxProb = prob;
-                            }
-                        }
-                    }
+                    std::size_t classId = static_cast<std::size_t>(classMap.at<int>(rowId, colId));
                     while (classId >= colors.size()) {
                         cv::Vec3b color(distr(rng), distr(rng), distr(rng));
                         colors.push_back(color);
@@ -0,0 +1,34 @@
+// Copyright (C) 2018-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+/**
+ * @brief Fills classMap (CV_32SC1 of outHeight x outWidth) with the class of every pixel: the channel with the
+ * greatest score, or the value itself if the output is already ArgMax'ed (outChannels < 2)
+ */
+inline void argMaxClasses(const float* predictions, int outChannels, int outHeight, int outWidth, cv::Mat& classMap) {
+    classMap.create(outHeight, outWidth, CV_32SC1);
+    for (int rowId = 0; rowId < outHeight; ++rowId) {
+        int* classIds = classMap.ptr<int>(rowId);
+        for (int colId = 0; colId < outWidth; ++colId) {
+            int classId = 0;
+            if (outChannels < 2) {  // assume the output is already ArgMax'ed
+                classId = static_cast<int>(predictions[rowId * outWidth + colId]);
+            } else {
+                float maxProb = -1.0f;
+                for (int chId = 0; chId < outChannels; ++chId) {
+                    float prob = predictions[chId * outHeight * outWidth + rowId * outWidth + colId];
+                    if (prob > maxProb) {
+                        classId = chId;
+                        maxProb = prob;
+                    }
+                }
+            }
+            classIds[colId] = classId;
+        }
+    }
+}
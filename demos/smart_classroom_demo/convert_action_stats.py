@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+'''
+ Copyright (C) 2020 Intel Corporation
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+'''
+
+import struct
+import sys
+from argparse import ArgumentParser
+
+MAGIC = b'SCAS'
+VERSION = 1
+UNKNOWN_LABEL = 'Unknown'
+
+
+def read_exact(stream, size):
+    data = stream.read(size)
+    if len(data) != size:
+        raise EOFError('Unexpected end of file')
+    return data
+
+
+def read_value(stream, fmt):
+    return struct.unpack(fmt, read_exact(stream, struct.calcsize(fmt)))[0]
+
+
+def read_string(stream):
+    return read_exact(stream, read_value(stream, '<I')).decode('utf-8')
+
+
+def read_labels(stream):
+    return [read_string(stream) for _ in range(read_value(stream, '<I'))]
+
+
+def convert(in_stream, out_stream):
+    if read_exact(in_stream, len(MAGIC)) != MAGIC:
+        raise ValueError('Not a smart classroom action statistics file')
+    version = read_value(in_stream, '<I')
+    if version != VERSION:
+        raise ValueError('Unsupported version {}'.format(version))
+
+    actions = read_labels(in_stream)
+    persons = read_labels(in_stream)
+    row_format = '<{}h'.format(len(persons))
+    row_size = struct.calcsize(row_format)
+
+    out_stream.write(','.join(['frame_idx'] + persons) + '\n')
+
+    name = ''
+    while True:
+        record = in_stream.read(1)
+        if not record:
+            break
+        if record == b'P':
+            name = read_string(in_stream).rpartition('/')[2]
+        elif record == b'F':
+            frame_idx = read_value(in_stream, '<i')
+            row = struct.unpack(row_format, read_exact(in_stream, row_size))
+            labels = [actions[action] if action >= 0 else UNKNOWN_LABEL for action in row]
+            out_stream.write(','.join(['{}@{:06d}'.format(name, frame_idx)] + labels) + '\n')
+        else:
+            raise ValueError('Unknown record type {!r}'.format(record))
+
+
+def main():
+    parser = ArgumentParser(description='Converts binary per-person action statistics of '
+                                        'smart_classroom_demo (-ad_bin) to the text format')
+    parser.add_argument('input', help='Binary action statistics file')
+    parser.add_argument('output', nargs='?', help='Output text file, standard output if omitted')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as in_stream:
+        if args.output:
+            with open(args.output, 'w') as out_stream:
+                convert(in_stream, out_stream)
+        else:
+            convert(in_stream, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
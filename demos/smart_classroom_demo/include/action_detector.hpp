@@ -112,6 +112,17 @@ class ActionDetection : public AsyncDetection<DetectedAction>, public BaseCnnDet
 public:
     explicit ActionDetection(const ActionDetectorConfig& config);
 
+    /**
+    * @brief Constructor for parsing recorded outputs without loading the network
+    *
+    * @param config Detector config, the model is not read
+    * @param outputs Outputs of the network
+    * @param network_input_size Size of the network input (WxH)
+    */
+    ActionDetection(const ActionDetectorConfig& config,
+                    const InferenceEngine::OutputsDataMap& outputs,
+                    const cv::Size& network_input_size);
+
     void submitRequest() override;
     void enqueue(const cv::Mat &frame) override;
     void wait() override { BaseCnnDetection::wait(); }
@@ -120,6 +131,16 @@ public:
     }
     DetectedActions fetchResults() override;
 
+     /**
+    * @brief Translates the network outputs to the detections
+    *
+    * @param outputs Output blobs of the network
+    * @param frame_size Size of input image (WxH)
+    * @return Detected objects
+    */
+    DetectedActions GetDetections(const InferenceEngine::BlobMap& outputs,
+                                  const cv::Size& frame_size) const;
+
 private:
     ActionDetectorConfig config_;
     InferenceEngine::ExecutableNetwork net_;
@@ -151,6 +172,36 @@ private:
     };
     typedef std::vector<NormalizedBBox> NormalizedBBoxes;
 
+    /**
+    * @brief Frame-invariant data of the candidates, one element of every vector per candidate
+    */
+    struct PriorTable {
+        /** @brief Index of the action conf blob */
+        std::vector<int> glob_anchor_ids;
+        /** @brief Offset of the first action conf in the blob */
+        std::vector<int> action_conf_shifts;
+        /** @brief Distance between the action confs in the blob */
+        std::vector<int> action_conf_steps;
+        /** @brief Prior boxes of the new network version, the old one reads them from the output */
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> width;
+        std::vector<float> height;
+    };
+    PriorTable prior_table_;
+
+     /**
+    * @brief Fills the layout of the action heads from the network outputs
+    *
+    * @param outputs Outputs of the network
+    */
+    void InitHeads(const InferenceEngine::OutputsDataMap& outputs);
+
+     /**
+    * @brief Fills the prior table from the layout of the action heads
+    */
+    void InitPriorTable();
+
      /**
     * @brief Translates the detections from the network outputs
     *
@@ -200,6 +251,24 @@ private:
                            const NormalizedBBox& encoded_bbox,
                            const cv::Size& frame_size) const;
 
+     /**
+    * @brief Translates input blobs in SSD format to bbox in CV_Rect
+    *
+    * @param prior_center_x X coordinate of the center of the prior box
+    * @param prior_center_y Y coordinate of the center of the prior box
+    * @param prior_width Width of the prior box
+    * @param prior_height Height of the prior box
+    * @param variances Variances of prior boxes in SSD format
+    * @param encoded_bbox BBox to decode
+    * @param frame_size Size of input image (WxH)
+    * @return BBox in CV_Rect format
+    */
+    cv::Rect DecodeBBox(float prior_center_x, float prior_center_y,
+                        float prior_width, float prior_height,
+                        const NormalizedBBox& variances,
+                        const NormalizedBBox& encoded_bbox,
+                        const cv::Size& frame_size) const;
+
      /**
     * @brief Carry out Soft Non-Maximum Suppression algorithm under detected actions
     *
@@ -0,0 +1,120 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "actions.hpp"
+
+/**
+* @brief Face with its track, person label and action on a single frame
+*/
+struct FaceActionRecord {
+    /** @brief Face track ID */
+    int object_id;
+    /** @brief Face bounding box */
+    cv::Rect rect;
+    /** @brief Person label index */
+    int label;
+    /** @brief Action label */
+    Action action;
+
+    FaceActionRecord(int object_id, const cv::Rect& rect, int label, Action action)
+        : object_id(object_id), rect(rect), label(label), action(action) {}
+};
+
+/**
+* @brief Faces of a single frame
+*/
+struct FrameActionsRecord {
+    /** @brief Frame index */
+    int frame_idx;
+    /** @brief Path of the video or image the frame comes from */
+    std::string path;
+    /** @brief Frame size */
+    cv::Size frame_size;
+    /** @brief Faces of the frame */
+    std::vector<FaceActionRecord> faces;
+};
+
+/**
+* @brief Smooths face actions and labels over tracks while the video is processed
+*
+* Frames are finalized with a fixed delay instead of at the end of the video,
+* which keeps the memory constant with the video length. Actions are smoothed by
+* the same rules as the whole-video smoothing: events of the same action closer
+* than the window are merged, ranges shorter than the minimal length are
+* dropped and gaps are split at their middle point. The delay is twice the
+* sum of the window and the minimal length, so the result matches the whole-video one
+* unless a gap between ranges is longer than that: such gaps keep the previous
+* action, and frames of a track before its first range get the default action.
+* Faces are labelled by the most frequent label of their track observed so far,
+* faces of unknown tracks are dropped.
+*/
+class ActionsSmoother {
+public:
+    using FrameCallback = std::function<void(const FrameActionsRecord&)>;
+    using TrackCallback = std::function<void(int label, const RangeEventsTrack&)>;
+
+    /**
+    * @brief Constructor
+    * @param default_action Action which does not form events
+    * @param window_size Maximum distance in frames between merged events
+    * @param min_length Minimum length of an event in frames
+    * @param forget_delay Number of frames after which a lost track is finalized
+    * @param on_frame Called for every finalized frame in frame order
+    * @param on_track Called with merged events of every finalized track
+    */
+    ActionsSmoother(Action default_action, int window_size, int min_length, int forget_delay,
+                    FrameCallback on_frame, TrackCallback on_track);
+
+    /**
+    * @brief Adds faces of the next frame and finalizes frames which settled
+    * @param frame Faces with raw labels and actions
+    */
+    void AddFrame(FrameActionsRecord frame);
+
+    /**
+    * @brief Finalizes all remaining frames and tracks
+    */
+    void Finish();
+
+private:
+    struct TrackState {
+        std::unordered_map<int, int> label_votes;
+        int best_label = -1;
+        int best_label_votes = 0;
+        int last_seen = -1;
+        // Kept ranges, the last one is still growing if open.
+        std::deque<RangeEvent> ranges;
+        bool open = false;
+        RangeEventsTrack events;
+    };
+
+    void AddEvent(TrackState& track, int frame_idx, Action action);
+    void CloseRange(TrackState& track);
+    Action SmoothedAction(TrackState& track, int frame_idx);
+    void FinalizeFrame();
+    void FinalizeTrack(const TrackState& track);
+
+    Action default_action_;
+    int window_size_;
+    int min_length_;
+    int forget_delay_;
+    int latency_;
+    FrameCallback on_frame_;
+    TrackCallback on_track_;
+
+    std::deque<FrameActionsRecord> pending_frames_;
+    std::map<int, TrackState> tracks_;
+    int last_frame_idx_;
+};
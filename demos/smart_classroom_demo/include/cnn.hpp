@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <functional>
 
@@ -14,6 +16,9 @@
 
 #include <inference_engine.hpp>
 
+#include <model_loader/model_loader.hpp>
+#include <replay/replay.hpp>
+
 /**
 * @brief Base class of config for network
 */
@@ -26,12 +31,22 @@ struct CnnConfig {
     /** @brief Maximal size of batch */
     int max_batch_size{1};
 
-    /** @brief Inference Engine */
-    InferenceEngine::Core ie;
+    /** @brief Loader of the network */
+    ModelLoader loader;
     /** @brief Device name */
     std::string deviceName;
+    /** @brief Recorder of the outputs of the network, if they are recorded */
+    std::shared_ptr<OutputsRecorder> recorder;
+    /** @brief Replayer of the outputs of the network, if they are replayed instead of inferring the network */
+    std::shared_ptr<OutputsReplayer> replayer;
 };
 
+/**
+* @brief Writes the input dimensions of the network to the recorder of the config
+* and checks that the replayed outputs were recorded for the same input
+*/
+void InitReplay(const CnnConfig& config, const InferenceEngine::ExecutableNetwork& network);
+
 /**
 * @brief Base class of network
 */
@@ -134,6 +149,27 @@ protected:
     InferenceEngine::InferRequest::Ptr request;
     const bool isAsync;
     std::string topoName;
+    /** @brief Network of the request, all its outputs are recorded */
+    InferenceEngine::ExecutableNetwork replayNetwork;
+    std::shared_ptr<OutputsRecorder> recorder;
+    std::shared_ptr<OutputsReplayer> replayer;
+    /** @brief If the request was submitted and its outputs weren't recorded yet */
+    bool submitted = false;
+    std::chrono::steady_clock::time_point replayEndTime;
+
+    void setReplay(const CnnConfig& config, const InferenceEngine::ExecutableNetwork& network) {
+        InitReplay(config, network);
+        replayNetwork = network;
+        recorder = config.recorder;
+        replayer = config.replayer;
+    }
+
+    void record() {
+        if (recorder && submitted) {
+            recorder->write(0, -1, getOutputs(*request, replayNetwork));
+        }
+        submitted = false;
+    }
 
 public:
     explicit BaseCnnDetection(bool isAsync = false) :
@@ -141,19 +177,38 @@ public:
 
     void submitRequest() override {
         if (request == nullptr) return;
-        if (isAsync) {
+        submitted = true;
+        if (replayer) {
+            // the demo has one stream of frames, which are replayed in the order they were recorded
+            setOutputs(*request, replayer->getOutputs(0, -1));
+            replayEndTime = std::chrono::steady_clock::now() + replayer->getLatency();
+            if (!isAsync) {
+                std::this_thread::sleep_until(replayEndTime);
+            }
+        } else if (isAsync) {
             request->StartAsync();
         } else {
             request->Infer();
         }
+        if (!isAsync) {
+            record();
+        }
     }
 
     void wait() override {
         if (!request || !isAsync) return;
-        request->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+        if (replayer) {
+            if (submitted) {
+                std::this_thread::sleep_until(replayEndTime);
+            }
+        } else {
+            request->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
+        }
+        record();
     }
 
     void printPerformanceCounts(const std::string &fullDeviceName) override {
+        if (replayer) return;
         std::cout << "Performance counts for " << topoName << std::endl << std::endl;
         ::printPerformanceCounts(*request, std::cout, fullDeviceName, false);
     }
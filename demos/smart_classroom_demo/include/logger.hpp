@@ -11,24 +11,88 @@
 #include <map>
 #include <string>
 #include <iostream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <opencv2/opencv.hpp>
 #include <sstream>
 #include <details/ie_exception.hpp>
 #include "tracker.hpp"
 
 #include "actions.hpp"
+#include "actions_smoother.hpp"
+
+///
+/// \brief Writes to a stream from a background thread.
+///
+/// Data is collected into chunks which are written by the thread, so the caller
+/// is not blocked by the output. At most a fixed number of chunks are pending,
+/// the caller waits for the thread when it falls behind.
+///
+class AsyncWriter {
+public:
+    explicit AsyncWriter(std::ostream& stream, size_t chunk_size = 1 << 16, size_t max_pending_chunks = 8);
+    ~AsyncWriter();
+
+    void Write(const char* data, size_t size);
+    void Write(const std::string& str) { Write(str.data(), str.size()); }
+
+    ///
+    /// \brief Waits until everything written so far reaches the stream.
+    ///
+    void Flush();
+
+private:
+    void Submit();
+    void Run();
+
+    std::ostream& stream_;
+    size_t chunk_size_;
+    size_t max_pending_chunks_;
+    std::string chunk_;
+    std::deque<std::string> pending_;
+    bool writing_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable has_chunks_;
+    std::condition_variable has_space_;
+    std::thread thread_;
+};
 
 class DetectionsLogger {
 private:
     bool write_logs_;
+    bool binary_act_stat_;
     std::ofstream act_stat_log_stream_;
     cv::FileStorage act_det_log_stream_;
     std::ostream& log_stream_;
+    AsyncWriter act_stat_writer_;
+    size_t num_persons_;
+    std::string last_path_;
+    std::vector<std::string> action_idx_to_label_;
+    std::vector<std::string> person_id_to_label_;
+    bool frame_record_open_;
+    std::string delayed_records_;
+
+    void WriteRecord(const std::string& record);
 
 public:
+    ///
+    /// \brief Constructor
+    /// \param stream Stream for raw records, written only if enabled. Unlike the
+    /// action statistics the records are written on the caller thread, so they keep
+    /// their order with other output to the stream.
+    /// \param enabled Write raw records.
+    /// \param act_stat_log_file File for per-person action statistics.
+    /// \param act_det_log_file File for per-person action detections.
+    /// \param binary_act_stat Write action statistics in the binary format
+    /// which is converted to text with convert_action_stats.py.
+    ///
     explicit DetectionsLogger(std::ostream& stream, bool enabled,
                               const std::string& act_stat_log_file,
-                              const std::string& act_det_log_file);
+                              const std::string& act_det_log_file,
+                              bool binary_act_stat = false);
 
     ~DetectionsLogger();
     void CreateNextFrameRecord(const std::string& path, const int frame_idx,
@@ -37,18 +101,27 @@ public:
     void AddPersonToFrame(const cv::Rect& rect, const std::string& action, const std::string& id);
     void AddDetectionToFrame(const TrackedObject& object, const int frame_idx);
     void FinalizeFrameRecord();
-    void DumpDetections(const std::string& video_path,
-                        const cv::Size frame_size,
-                        const size_t num_frames,
-                        const std::vector<Track>& face_tracks,
-                        const std::map<int, int>& track_id_to_label_faces,
-                        const std::vector<std::string>& action_idx_to_label,
-                        const std::vector<std::string>& person_id_to_label,
-                        const std::vector<std::map<int, int>>& frame_face_obj_id_to_action_maps);
-    void DumpTracks(const std::map<int, RangeEventsTrack>& obj_id_to_events,
-                    const std::vector<std::string>& action_idx_to_label,
-                    const std::map<int, int>& track_id_to_label_faces,
-                    const std::vector<std::string>& person_id_to_label);
+
+    ///
+    /// \brief Starts per-person action statistics and writes their header.
+    ///
+    void StartActionStatistics(const std::vector<std::string>& action_idx_to_label,
+                               const std::vector<std::string>& person_id_to_label);
+
+    ///
+    /// \brief Writes faces of a finalized frame with their smoothed actions.
+    ///
+    void DumpFrame(const FrameActionsRecord& frame);
+
+    ///
+    /// \brief Writes merged action events of a finalized face track.
+    ///
+    void DumpTrack(int person_id, const RangeEventsTrack& events);
+
+    ///
+    /// \brief Waits until all records are written.
+    ///
+    void Flush();
 };
 
 
@@ -44,6 +44,8 @@ static const char threshold_output_message_face_reid[] = "Optional. Cosine dista
 static const char reid_gallery_path_message[] = "Optional. Path to a faces gallery in .json format.";
 static const char output_video_message[] = "Optional. File to write output video with visualization to.";
 static const char act_stat_output_message[] = "Optional. Output file name to save per-person action statistics in.";
+static const char act_stat_binary_message[] = "Optional. Save per-person action statistics in a compact binary format. "
+                                             "Use convert_action_stats.py to convert them to text.";
 static const char raw_output_message[] = "Optional. Output Inference results as raw values.";
 static const char no_show_processed_video[] = "Optional. Do not show processed video.";
 static const char input_image_height_output_message[] = "Optional. Input image height for face detector.";
@@ -65,6 +67,10 @@ static const char min_size_fr_reg_output_message[] = "Optional. Minimum input si
 static const char act_det_output_message[] = "Optional. Output file name to save per-person action detections in.";
 static const char tracker_smooth_size_message[] = "Optional. Number of frames to smooth actions.";
 static const char utilization_monitors_message[] = "Optional. List of monitors to show initially.";
+static const char cache_dir_message[] = "Optional. Existing directory to cache compiled networks in. Networks found in the cache are imported instead of being compiled. Only devices which support network export use the cache.";
+static const char record_message[] = "Optional. Save the outputs of every network to a file of its own in the specified existing directory, to replay them with -replay.";
+static const char replay_message[] = "Optional. Take the outputs of the networks from the files saved with -record to the specified directory instead of running inference. The models are still loaded for the descriptions of their inputs and outputs, but no request is inferred.";
+static const char replay_latency_message[] = "Optional. Time in msec every replayed request takes. Default value is 0.";
 
 DEFINE_bool(h, false, help_message);
 DEFINE_string(i, "cam", video_message);
@@ -81,6 +87,7 @@ DEFINE_bool(pc, false, performance_counter_message);
 DEFINE_string(c, "", custom_cldnn_message);
 DEFINE_string(l, "", custom_cpu_library_message);
 DEFINE_string(ad, "", act_stat_output_message);
+DEFINE_bool(ad_bin, false, act_stat_binary_message);
 DEFINE_bool(r, false, raw_output_message);
 DEFINE_double(t_ad, 0.3, person_threshold_output_message);
 DEFINE_double(t_ar, 0.75, action_threshold_output_message);
@@ -107,6 +114,10 @@ DEFINE_int32(min_size_fr, 128, min_size_fr_reg_output_message);
 DEFINE_string(al, "", act_det_output_message);
 DEFINE_int32(ss_t, -1, tracker_smooth_size_message);
 DEFINE_string(u, "", utilization_monitors_message);
+DEFINE_string(cache_dir, "", cache_dir_message);
+DEFINE_string(record, "", record_message);
+DEFINE_string(replay, "", replay_message);
+DEFINE_double(replay_latency, 0.0, replay_latency_message);
 
 /**
 * @brief This function show a help message
@@ -134,6 +145,7 @@ static void showUsage() {
     std::cout << "    -pc                            " << performance_counter_message << std::endl;
     std::cout << "    -r                             " << raw_output_message << std::endl;
     std::cout << "    -ad                            " << act_stat_output_message << std::endl;
+    std::cout << "    -ad_bin                        " << act_stat_binary_message << std::endl;
     std::cout << "    -t_ad                          " << person_threshold_output_message << std::endl;
     std::cout << "    -t_ar                          " << action_threshold_output_message << std::endl;
     std::cout << "    -t_fd                          " << face_threshold_output_message << std::endl;
@@ -158,4 +170,8 @@ static void showUsage() {
     std::cout << "    -al                            " << act_det_output_message << std::endl;
     std::cout << "    -ss_t                          " << tracker_smooth_size_message << std::endl;
     std::cout << "    -u                             " << utilization_monitors_message << std::endl;
+    std::cout << "    -cache_dir \"<path>\"            " << cache_dir_message << std::endl;
+    std::cout << "    -record \"<path>\"               " << record_message << std::endl;
+    std::cout << "    -replay \"<path>\"               " << replay_message << std::endl;
+    std::cout << "    -replay_latency                " << replay_latency_message << std::endl;
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "cnn.hpp"
+#include "linear_assignment.hpp"
 
 #include <memory>
 #include <set>
@@ -33,34 +34,6 @@ struct TrackedObject {
 
 using TrackedObjects = std::vector<TrackedObject>;
 
-///
-/// \brief The KuhnMunkres class
-///
-/// Solves the assignment problem.
-///
-class KuhnMunkres {
-public:
-    ///
-    /// \brief Initializes the class for assignment problem solving.
-    /// \param[in] greedy If a faster greedy matching algorithm should be used.
-    explicit KuhnMunkres(bool greedy = false);
-
-    ///
-    /// \brief Solves the assignment problem for given dissimilarity matrix.
-    /// It returns a vector that where each element is a column index for
-    /// corresponding row (e.g. result[0] stores optimal column index for very
-    /// first row in the dissimilarity matrix).
-    /// \param dissimilarity_matrix CV_32F dissimilarity matrix.
-    /// \return Optimal column index for each row. -1 means that there is no
-    /// column for row.
-    ///
-    std::vector<size_t> Solve(const cv::Mat &dissimilarity_matrix);
-
-private:
-    class Impl;
-    std::shared_ptr<Impl> impl_;  ///< Class implementation.
-};
-
 ///
 /// \brief The Params struct stores parameters of Tracker.
 ///
@@ -87,6 +60,10 @@ struct TrackerParams {
     bool drop_forgotten_tracks;  ///< Drop forgotten tracks. If it's enabled it
     /// disables an ability to get detection log.
 
+    bool reassign_ids;  ///< Renumber the tracks from zero when their IDs grow
+    /// too large. It's done only when forgotten tracks are dropped, so an ID may
+    /// be given to a different track.
+
     int max_num_objects_in_track;  ///< The number of objects in track is
     /// restricted by this parameter. If it is negative or zero, the max number of
     /// objects in track is not restricted.
@@ -326,6 +303,9 @@ private:
     // Number of all current tracks.
     size_t tracks_counter_;
 
+    // Track to detection assignment solver, reuses its buffers across frames.
+    LinearAssignment assignment_;
+
     cv::Size frame_size_;
 };
 
@@ -17,6 +17,7 @@
 #include <set>
 #include <algorithm>
 #include <utility>
+#include <functional>
 #include <ie_iextension.h>
 
 #include "actions.hpp"
@@ -227,108 +228,6 @@ public:
 
 const int default_action_index = -1;  // Unknown action class
 
-void ConvertActionMapsToFrameEventTracks(const std::vector<std::map<int, int>>& obj_id_to_action_maps,
-                                         int default_action,
-                                         std::map<int, FrameEventsTrack>* obj_id_to_actions_track) {
-    for (size_t frame_id = 0; frame_id < obj_id_to_action_maps.size(); ++frame_id) {
-        for (const auto& tup : obj_id_to_action_maps[frame_id]) {
-            if (tup.second != default_action) {
-                (*obj_id_to_actions_track)[tup.first].emplace_back(frame_id, tup.second);
-            }
-        }
-    }
-}
-
-void SmoothTracks(const std::map<int, FrameEventsTrack>& obj_id_to_actions_track,
-                  int start_frame, int end_frame, int window_size, int min_length, int default_action,
-                  std::map<int, RangeEventsTrack>* obj_id_to_events) {
-    // Iterate over face tracks
-    for (const auto& tup : obj_id_to_actions_track) {
-        const auto& frame_events = tup.second;
-        if (frame_events.empty()) {
-            continue;
-        }
-
-        RangeEventsTrack range_events;
-
-
-        // Merge neighbouring events and filter short ones
-        range_events.emplace_back(frame_events.front().frame_id,
-                                  frame_events.front().frame_id + 1,
-                                  frame_events.front().action);
-
-        for (size_t frame_id = 1; frame_id < frame_events.size(); ++frame_id) {
-            const auto& last_range_event = range_events.back();
-            const auto& cur_frame_event = frame_events[frame_id];
-
-            if (last_range_event.end_frame_id + window_size - 1 >= cur_frame_event.frame_id &&
-                last_range_event.action == cur_frame_event.action) {
-                range_events.back().end_frame_id = cur_frame_event.frame_id + 1;
-            } else {
-                if (range_events.back().end_frame_id - range_events.back().begin_frame_id < min_length) {
-                    range_events.pop_back();
-                }
-
-                range_events.emplace_back(cur_frame_event.frame_id,
-                                          cur_frame_event.frame_id + 1,
-                                          cur_frame_event.action);
-            }
-        }
-        if (range_events.back().end_frame_id - range_events.back().begin_frame_id < min_length) {
-            range_events.pop_back();
-        }
-
-        // Extrapolate track
-        if (range_events.empty()) {
-            range_events.emplace_back(start_frame, end_frame, default_action);
-        } else {
-            range_events.front().begin_frame_id = start_frame;
-            range_events.back().end_frame_id = end_frame;
-        }
-
-        // Interpolate track
-        for (size_t event_id = 1; event_id < range_events.size(); ++event_id) {
-            auto& last_event = range_events[event_id - 1];
-            auto& cur_event = range_events[event_id];
-
-            int middle_point = static_cast<int>(0.5f * (cur_event.begin_frame_id + last_event.end_frame_id));
-
-            cur_event.begin_frame_id = middle_point;
-            last_event.end_frame_id = middle_point;
-        }
-
-        // Merge consecutive events
-        auto& final_events = (*obj_id_to_events)[tup.first];
-        final_events.push_back(range_events.front());
-        for (size_t event_id = 1; event_id < range_events.size(); ++event_id) {
-            const auto& cur_event = range_events[event_id];
-
-            if (final_events.back().action == cur_event.action) {
-                final_events.back().end_frame_id = cur_event.end_frame_id;
-            } else {
-                final_events.push_back(cur_event);
-            }
-        }
-    }
-}
-
-void ConvertRangeEventsTracksToActionMaps(int num_frames,
-                                          const std::map<int, RangeEventsTrack>& obj_id_to_events,
-                                          std::vector<std::map<int, int>>* obj_id_to_action_maps) {
-    obj_id_to_action_maps->resize(num_frames);
-
-    for (const auto& tup : obj_id_to_events) {
-        const int obj_id = tup.first;
-        const auto& events = tup.second;
-
-        for (const auto& event : events) {
-            for (int frame_id = event.begin_frame_id; frame_id < event.end_frame_id; ++frame_id) {
-                (*obj_id_to_action_maps)[frame_id].emplace(obj_id, event.action);
-            }
-        }
-    }
-}
-
 std::vector<std::string> ParseActionLabels(const std::string& in_str) {
     std::vector<std::string> labels;
     std::string label;
@@ -397,26 +296,6 @@ int GetIndexOfTheNearestPerson(const TrackedObject& face, const std::vector<Trac
     return argmax;
 }
 
-std::map<int, int> GetMapFaceTrackIdToLabel(const std::vector<Track>& face_tracks) {
-    std::map<int, int> face_track_id_to_label;
-    for (const auto& track : face_tracks) {
-        const auto& first_obj = track.first_object;
-        // check consistency
-        // to receive this consistency for labels
-        // use the function UpdateTrackLabelsToBestAndFilterOutUnknowns
-        for (const auto& obj : track.objects) {
-            SCR_CHECK_EQ(obj.label, first_obj.label);
-            SCR_CHECK_EQ(obj.object_id, first_obj.object_id);
-        }
-
-        auto cur_obj_id = first_obj.object_id;
-        auto cur_label = first_obj.label;
-        SCR_CHECK(face_track_id_to_label.count(cur_obj_id) == 0) << " Repeating face tracks";
-        face_track_id_to_label[cur_obj_id] = cur_label;
-    }
-    return face_track_id_to_label;
-}
-
 bool checkDynamicBatchSupport(const Core& ie, const std::string& device)  {
     try  {
         if (ie.GetConfig(device, CONFIG_KEY(DYN_BATCH_ENABLED)).as<std::string>() != PluginConfigParams::YES)
@@ -634,17 +513,38 @@ int main(int argc, char* argv[]) {
             loadedDevices.insert(device);
         }
 
+        // Networks are loaded concurrently after all of them are configured
+        ModelLoader loader(ie, FLAGS_cache_dir);
+        std::vector<std::function<void()>> loaders;
+
+        /** Every network records its outputs to a file of its own and replays them from it **/
+        auto setReplay = [](CnnConfig& config, const std::string& fileName) {
+            if (!FLAGS_record.empty()) {
+                config.recorder = std::make_shared<OutputsRecorder>(FLAGS_record + '/' + fileName);
+            }
+            if (!FLAGS_replay.empty()) {
+                config.replayer = std::make_shared<OutputsReplayer>(FLAGS_replay + '/' + fileName,
+                    std::chrono::microseconds(static_cast<int64_t>(FLAGS_replay_latency * 1000)));
+            }
+        };
+        if (!FLAGS_replay.empty()) {
+            slog::info << "Outputs of the networks are replayed from " << FLAGS_replay << slog::endl;
+        }
+
         std::unique_ptr<AsyncDetection<DetectedAction>> action_detector;
         if (!ad_model_path.empty()) {
             // Load action detector
             ActionDetectorConfig action_config(ad_model_path);
             action_config.deviceName = FLAGS_d_act;
-            action_config.ie = ie;
+            action_config.loader = loader;
             action_config.is_async = true;
             action_config.detection_confidence_threshold = static_cast<float>(FLAGS_t_ad);
             action_config.action_confidence_threshold = static_cast<float>(FLAGS_t_ar);
             action_config.num_action_classes = actions_map.size();
-            action_detector.reset(new ActionDetection(action_config));
+            setReplay(action_config, "action_detection.bin");
+            loaders.emplace_back([&action_detector, action_config]() {
+                action_detector.reset(new ActionDetection(action_config));
+            });
         } else {
             action_detector.reset(new NullDetection<DetectedAction>);
         }
@@ -654,14 +554,17 @@ int main(int argc, char* argv[]) {
             // Load face detector
             detection::DetectorConfig face_config(fd_model_path);
             face_config.deviceName = FLAGS_d_fd;
-            face_config.ie = ie;
+            face_config.loader = loader;
             face_config.is_async = true;
             face_config.confidence_threshold = static_cast<float>(FLAGS_t_fd);
             face_config.input_h = FLAGS_inh_fd;
             face_config.input_w = FLAGS_inw_fd;
             face_config.increase_scale_x = static_cast<float>(FLAGS_exp_r_fd);
             face_config.increase_scale_y = static_cast<float>(FLAGS_exp_r_fd);
-            face_detector.reset(new detection::FaceDetection(face_config));
+            setReplay(face_config, "face_detection.bin");
+            loaders.emplace_back([&face_detector, face_config]() {
+                face_detector.reset(new detection::FaceDetection(face_config));
+            });
         } else {
             face_detector.reset(new NullDetection<detection::DetectedObject>);
         }
@@ -673,7 +576,7 @@ int main(int argc, char* argv[]) {
 
             detection::DetectorConfig face_registration_det_config(fd_model_path);
             face_registration_det_config.deviceName = FLAGS_d_fd;
-            face_registration_det_config.ie = ie;
+            face_registration_det_config.loader = loader;
             face_registration_det_config.is_async = false;
             face_registration_det_config.confidence_threshold = static_cast<float>(FLAGS_t_reg_fd);
             face_registration_det_config.increase_scale_x = static_cast<float>(FLAGS_exp_r_fd);
@@ -685,7 +588,8 @@ int main(int argc, char* argv[]) {
                 reid_config.max_batch_size = 16;
             else
                 reid_config.max_batch_size = 1;
-            reid_config.ie = ie;
+            reid_config.loader = loader;
+            setReplay(reid_config, "face_reidentification.bin");
 
             CnnConfig landmarks_config(lm_model_path);
             landmarks_config.deviceName = FLAGS_d_lm;
@@ -693,17 +597,15 @@ int main(int argc, char* argv[]) {
                 landmarks_config.max_batch_size = 16;
             else
                 landmarks_config.max_batch_size = 1;
-            landmarks_config.ie = ie;
-
-            face_recognizer.reset(new FaceRecognizerDefault(
-                landmarks_config, reid_config,
-                face_registration_det_config,
-                FLAGS_fg, FLAGS_t_reid, FLAGS_min_size_fr, FLAGS_crop_gallery, FLAGS_greedy_reid_matching));
-
-            if (actions_type == TEACHER && !face_recognizer->LabelExists(teacher_id)) {
-                slog::err << "Teacher id does not exist in the gallery!" << slog::endl;
-                return 1;
-            }
+            landmarks_config.loader = loader;
+            setReplay(landmarks_config, "landmarks_regression.bin");
+
+            loaders.emplace_back([&face_recognizer, landmarks_config, reid_config, face_registration_det_config]() {
+                face_recognizer.reset(new FaceRecognizerDefault(
+                    landmarks_config, reid_config,
+                    face_registration_det_config,
+                    FLAGS_fg, FLAGS_t_reid, FLAGS_min_size_fr, FLAGS_crop_gallery, FLAGS_greedy_reid_matching));
+            });
         } else {
             slog::warn << "Face recognition models are disabled!" << slog::endl;
             if (actions_type == TEACHER) {
@@ -714,6 +616,18 @@ int main(int argc, char* argv[]) {
             face_recognizer.reset(new FaceRecognizerNull);
         }
 
+        loader.run(loaders);
+        loader.printReport();
+
+        if (actions_type == TEACHER && !face_recognizer->LabelExists(teacher_id)) {
+            slog::err << "Teacher id does not exist in the gallery!" << slog::endl;
+            return 1;
+        }
+
+        // Per-frame results are logged while the video is processed, so tracks
+        // only need a bounded history and forgotten tracks are dropped
+        const int max_track_length = 1000;
+
         // Create tracker for reid
         TrackerParams tracker_reid_params;
         tracker_reid_params.min_track_duration = 1;
@@ -722,8 +636,10 @@ int main(int argc, char* argv[]) {
         tracker_reid_params.averaging_window_size_for_rects = 1;
         tracker_reid_params.averaging_window_size_for_labels = std::numeric_limits<int>::max();
         tracker_reid_params.bbox_heights_range = cv::Vec2f(10, 1080);
-        tracker_reid_params.drop_forgotten_tracks = false;
-        tracker_reid_params.max_num_objects_in_track = std::numeric_limits<int>::max();
+        tracker_reid_params.drop_forgotten_tracks = true;
+        // The smoother keeps the state of a face track by its ID
+        tracker_reid_params.reassign_ids = false;
+        tracker_reid_params.max_num_objects_in_track = max_track_length;
         tracker_reid_params.objects_type = "face";
 
         Tracker tracker_reid(tracker_reid_params);
@@ -738,8 +654,8 @@ int main(int argc, char* argv[]) {
                                                                  ? FLAGS_ss_t
                                                                  : actions_type == TOP_K ? 5 : 1;
         tracker_action_params.bbox_heights_range = cv::Vec2f(10, 2160);
-        tracker_action_params.drop_forgotten_tracks = false;
-        tracker_action_params.max_num_objects_in_track = std::numeric_limits<int>::max();
+        tracker_action_params.drop_forgotten_tracks = true;
+        tracker_action_params.max_num_objects_in_track = max_track_length;
         tracker_action_params.objects_type = "action";
 
         Tracker tracker_action(tracker_action_params);
@@ -756,7 +672,6 @@ int main(int argc, char* argv[]) {
         const cv::Scalar green_color(0, 255, 0);
         const cv::Scalar red_color(0, 0, 255);
         const cv::Scalar white_color(255, 255, 255);
-        std::vector<std::map<int, int>> face_obj_id_to_action_maps;
         std::map<int, int> top_k_obj_ids;
 
         int teacher_track_id = -1;
@@ -787,11 +702,22 @@ int main(int argc, char* argv[]) {
                                          cap.GetFPS(), Visualizer::GetOutputSize(frame.size()));
         }
         Visualizer sc_visualizer(!FLAGS_no_show, vid_writer, num_top_persons);
-        DetectionsLogger logger(std::cout, FLAGS_r, FLAGS_ad, FLAGS_al);
+        DetectionsLogger logger(std::cout, FLAGS_r, FLAGS_ad, FLAGS_al, FLAGS_ad_bin);
 
         const int smooth_window_size = static_cast<int>(cap.GetFPS() * FLAGS_d_ad);
         const int smooth_min_length = static_cast<int>(cap.GetFPS() * FLAGS_min_ad);
 
+        const std::vector<std::string> face_id_to_label_map = face_recognizer->GetIDToLabelMap();
+        std::unique_ptr<ActionsSmoother> actions_smoother;
+        if (actions_type == STUDENT && !face_id_to_label_map.empty()) {
+            logger.StartActionStatistics(actions_map, face_id_to_label_map);
+            actions_smoother.reset(new ActionsSmoother(
+                default_action_index, smooth_window_size, smooth_min_length,
+                static_cast<int>(tracker_reid_params.forget_delay),
+                [&logger](const FrameActionsRecord& frame) { logger.DumpFrame(frame); },
+                [&logger](int person_id, const RangeEventsTrack& events) { logger.DumpTrack(person_id, events); }));
+        }
+
         std::cout << "To close the application, press 'CTRL+C' here";
         if (!FLAGS_no_show) {
             std::cout << " or switch to the output window and press ESC key";
@@ -802,7 +728,8 @@ int main(int argc, char* argv[]) {
         Presenter presenter(FLAGS_u, frame.rows - graphSize.height - 10, graphSize);
 
         while (!is_last_frame) {
-            logger.CreateNextFrameRecord(cap.GetVideoPath(), work_num_frames, prev_frame.cols, prev_frame.rows);
+            const auto frame_path = cap.GetVideoPath();
+            logger.CreateNextFrameRecord(frame_path, work_num_frames, prev_frame.cols, prev_frame.rows);
             auto started = std::chrono::high_resolution_clock::now();
 
             is_last_frame = !cap.GrabNext();
@@ -943,7 +870,7 @@ int main(int argc, char* argv[]) {
 
                 work_time_ms += elapsed_ms;
 
-                std::map<int, int> frame_face_obj_id_to_action;
+                FrameActionsRecord frame_actions{static_cast<int>(work_num_frames), frame_path, prev_frame.size(), {}};
                 for (size_t j = 0; j < tracked_faces.size(); j++) {
                     const auto& face = tracked_faces[j];
                     std::string face_label = face_recognizer->GetLabelByID(face.label);
@@ -962,7 +889,7 @@ int main(int argc, char* argv[]) {
                         if (action_ind != default_action_index) {
                             label_to_draw += "[" + GetActionTextLabel(action_ind, actions_map) + "]";
                         }
-                        frame_face_obj_id_to_action[face.object_id] = action_ind;
+                        frame_actions.faces.emplace_back(face.object_id, face.rect, face.label, action_ind);
                         sc_visualizer.DrawObject(face.rect, label_to_draw, red_color, white_color, true);
                         logger.AddFaceToFrame(face.rect, face_label, "");
                     }
@@ -985,7 +912,9 @@ int main(int argc, char* argv[]) {
                         logger.AddPersonToFrame(action.rect, action_label, "");
                         logger.AddDetectionToFrame(action, work_num_frames);
                     }
-                    face_obj_id_to_action_maps.push_back(frame_face_obj_id_to_action);
+                    if (actions_smoother) {
+                        actions_smoother->AddFrame(std::move(frame_actions));
+                    }
                 } else if (teacher_track_id >= 0) {
                     auto res_find = std::find_if(tracked_actions.begin(), tracked_actions.end(),
                                 [teacher_track_id](const TrackedObject& o){ return o.object_id == teacher_track_id; });
@@ -1032,44 +961,10 @@ int main(int argc, char* argv[]) {
                 getFullDeviceName(mapDevices, FLAGS_d_reid));
         }
 
-        if (actions_type == STUDENT) {
-            auto face_tracks = tracker_reid.vector_tracks();
-
-            // correct labels for track
-            std::vector<Track> new_face_tracks = UpdateTrackLabelsToBestAndFilterOutUnknowns(face_tracks);
-            std::map<int, int> face_track_id_to_label = GetMapFaceTrackIdToLabel(new_face_tracks);
-
-            std::vector<std::string> face_id_to_label_map = face_recognizer->GetIDToLabelMap();
-
-            if (!face_id_to_label_map.empty()) {
-                std::map<int, FrameEventsTrack> face_obj_id_to_actions_track;
-                ConvertActionMapsToFrameEventTracks(face_obj_id_to_action_maps, default_action_index,
-                                                    &face_obj_id_to_actions_track);
-
-                const int start_frame = 0;
-                const int end_frame = face_obj_id_to_action_maps.size();
-                std::map<int, RangeEventsTrack> face_obj_id_to_events;
-                SmoothTracks(face_obj_id_to_actions_track, start_frame, end_frame,
-                             smooth_window_size, smooth_min_length, default_action_index,
-                             &face_obj_id_to_events);
-
-                slog::info << "Final ID->events mapping" << slog::endl;
-                logger.DumpTracks(face_obj_id_to_events,
-                                  actions_map, face_track_id_to_label,
-                                  face_id_to_label_map);
-
-                std::vector<std::map<int, int>> face_obj_id_to_smoothed_action_maps;
-                ConvertRangeEventsTracksToActionMaps(end_frame, face_obj_id_to_events,
-                                                     &face_obj_id_to_smoothed_action_maps);
-
-                slog::info << "Final per-frame ID->action mapping" << slog::endl;
-                logger.DumpDetections(cap.GetVideoPath(), frame.size(), work_num_frames,
-                                      new_face_tracks,
-                                      face_track_id_to_label,
-                                      actions_map, face_id_to_label_map,
-                                      face_obj_id_to_smoothed_action_maps);
-            }
+        if (actions_smoother) {
+            actions_smoother->Finish();
         }
+        logger.Flush();
 
         std::cout << presenter.reportMeans() << '\n';
     }
@@ -4,6 +4,7 @@
 
 #include "action_detector.hpp"
 #include <algorithm>
+#include <string>
 #include <utility>
 #include <vector>
 #include <limits>
@@ -48,7 +49,7 @@ void ActionDetection::enqueue(const cv::Mat &frame) {
 ActionDetection::ActionDetection(const ActionDetectorConfig& config)
         : BaseCnnDetection(config.is_async), config_(config) {
     topoName = "action detector";
-    auto network = config.ie.ReadNetwork(config.path_to_model);
+    auto network = config.loader.readNetwork(config.path_to_model);
 
     network.setBatchSize(config.max_batch_size);
 
@@ -69,9 +70,23 @@ ActionDetection::ActionDetection(const ActionDetectorConfig& config)
         item.second->setPrecision(Precision::FP32);
     }
 
-    new_network_ = outputInfo.find(config_.new_loc_blob_name) != outputInfo.end();
     input_name_ = inputInfo.begin()->first;
-    net_ = config_.ie.LoadNetwork(network, config_.deviceName);
+    net_ = config_.loader.loadNetwork(network, config_.path_to_model, config_.deviceName);
+    setReplay(config_, net_);
+
+    InitHeads(outputInfo);
+}
+
+ActionDetection::ActionDetection(const ActionDetectorConfig& config,
+                                 const OutputsDataMap& outputs,
+                                 const cv::Size& network_input_size)
+        : BaseCnnDetection(config.is_async), config_(config), network_input_size_(network_input_size) {
+    topoName = "action detector";
+    InitHeads(outputs);
+}
+
+void ActionDetection::InitHeads(const OutputsDataMap& outputInfo) {
+    new_network_ = outputInfo.find(config_.new_loc_blob_name) != outputInfo.end();
 
     const auto& head_anchors = new_network_ ? config_.new_anchors : config_.old_anchors;
     const int num_heads = head_anchors.size();
@@ -94,7 +109,7 @@ ActionDetection::ActionDetection(const ActionDetectorConfig& config)
                   : config_.old_action_conf_blob_name_prefix + std::to_string(anchor_id + 1);
             glob_anchor_names_.push_back(glob_anchor_name);
 
-            const auto anchor_dims = outputInfo[glob_anchor_name]->getDims();
+            const auto anchor_dims = outputInfo.at(glob_anchor_name)->getDims();
             anchor_height = new_network_ ? anchor_dims[2] : anchor_dims[1];
             anchor_width = new_network_ ? anchor_dims[3] : anchor_dims[2];
             std::size_t action_dimention_idx = new_network_ ? 1 : 3;
@@ -117,6 +132,47 @@ ActionDetection::ActionDetection(const ActionDetectorConfig& config)
     num_candidates_ = head_shift;
 
     binary_task_ = config_.num_action_classes == 2;
+
+    InitPriorTable();
+}
+
+void ActionDetection::InitPriorTable() {
+    prior_table_ = PriorTable();
+    prior_table_.glob_anchor_ids.reserve(num_candidates_);
+    prior_table_.action_conf_shifts.reserve(num_candidates_);
+    prior_table_.action_conf_steps.reserve(num_candidates_);
+    if (new_network_) {
+        prior_table_.center_x.reserve(num_candidates_);
+        prior_table_.center_y.reserve(num_candidates_);
+        prior_table_.width.reserve(num_candidates_);
+        prior_table_.height.reserve(num_candidates_);
+    }
+
+    for (int head_id = 0; head_id + 1 < static_cast<int>(head_ranges_.size()); ++head_id) {
+        const int head_num_anchors =
+            new_network_ ? config_.new_anchors[head_id] : config_.old_anchors[head_id];
+        for (int head_p = 0; head_p < head_ranges_[head_id + 1] - head_ranges_[head_id]; ++head_p) {
+            const int anchor_id = head_p % head_num_anchors;
+            prior_table_.glob_anchor_ids.push_back(glob_anchor_map_[head_id][anchor_id]);
+            prior_table_.action_conf_shifts.push_back(new_network_
+                                                        ? head_p / head_num_anchors
+                                                        : head_p / head_num_anchors * config_.num_action_classes);
+            prior_table_.action_conf_steps.push_back(head_step_sizes_[head_id]);
+            if (!new_network_) {
+                continue;
+            }
+
+            /** Store the prior box in the center form ConvertToRect() converts it to **/
+            const auto priorbox = GeneratePriorBox(head_p / head_num_anchors,
+                                                   config_.new_det_heads[head_id].step,
+                                                   config_.new_det_heads[head_id].anchors[anchor_id],
+                                                   head_blob_sizes_[head_id]);
+            prior_table_.center_x.push_back(0.5f * (priorbox.xmin + priorbox.xmax));
+            prior_table_.center_y.push_back(0.5f * (priorbox.ymin + priorbox.ymax));
+            prior_table_.width.push_back(priorbox.xmax - priorbox.xmin);
+            prior_table_.height.push_back(priorbox.ymax - priorbox.ymin);
+        }
+    }
 }
 
 std::vector<int> ieSizeToVector(const SizeVector& ie_output_dims) {
@@ -128,40 +184,53 @@ std::vector<int> ieSizeToVector(const SizeVector& ie_output_dims) {
 }
 
 DetectedActions ActionDetection::fetchResults() {
+    std::vector<std::string> blob_names = glob_anchor_names_;
+    blob_names.push_back(new_network_ ? config_.new_loc_blob_name : config_.old_loc_blob_name);
+    blob_names.push_back(new_network_ ? config_.new_det_conf_blob_name : config_.old_det_conf_blob_name);
+    if (!new_network_) {
+        blob_names.push_back(config_.old_priorbox_blob_name);
+    }
+    BlobMap outputs;
+    for (const auto& blob_name : blob_names) {
+        outputs[blob_name] = request->GetBlob(blob_name);
+    }
+    return GetDetections(outputs, cv::Size(static_cast<int>(width_), static_cast<int>(height_)));
+}
+
+DetectedActions ActionDetection::GetDetections(const BlobMap& outputs, const cv::Size& frame_size) const {
     const auto loc_blob_name = new_network_ ? config_.new_loc_blob_name : config_.old_loc_blob_name;
     const auto det_conf_blob_name = new_network_ ? config_.new_det_conf_blob_name : config_.old_det_conf_blob_name;
 
-    LockedMemory<const void> locBlobMapped = as<MemoryBlob>(request->GetBlob(loc_blob_name))->rmap();
-    const cv::Mat loc_out(ieSizeToVector(request->GetBlob(loc_blob_name)->getTensorDesc().getDims()),
+    const Blob::Ptr& loc_blob = outputs.at(loc_blob_name);
+    LockedMemory<const void> locBlobMapped = as<MemoryBlob>(loc_blob)->rmap();
+    const cv::Mat loc_out(ieSizeToVector(loc_blob->getTensorDesc().getDims()),
                           CV_32F, locBlobMapped.as<float*>());
 
-    LockedMemory<const void> detConfBlobMapped = as<MemoryBlob>(request->GetBlob(det_conf_blob_name))->rmap();
-    const cv::Mat main_conf_out(ieSizeToVector(request->GetBlob(det_conf_blob_name)->getTensorDesc().getDims()),
+    const Blob::Ptr& det_conf_blob = outputs.at(det_conf_blob_name);
+    LockedMemory<const void> detConfBlobMapped = as<MemoryBlob>(det_conf_blob)->rmap();
+    const cv::Mat main_conf_out(ieSizeToVector(det_conf_blob->getTensorDesc().getDims()),
                                 CV_32F, detConfBlobMapped.as<float*>());
 
     std::vector<LockedMemory<const void>> blobsMapped;
     std::vector<cv::Mat> add_conf_out;
     for (int glob_anchor_id = 0; glob_anchor_id < num_glob_anchors_; ++glob_anchor_id) {
-        const auto& blob_name = glob_anchor_names_[glob_anchor_id];
-        blobsMapped.push_back(as<MemoryBlob>(request->GetBlob(blob_name))->rmap());
-        add_conf_out.emplace_back(ieSizeToVector(request->GetBlob(blob_name)->getTensorDesc().getDims()),
+        const Blob::Ptr& blob = outputs.at(glob_anchor_names_[glob_anchor_id]);
+        blobsMapped.push_back(as<MemoryBlob>(blob)->rmap());
+        add_conf_out.emplace_back(ieSizeToVector(blob->getTensorDesc().getDims()),
                                   CV_32F, blobsMapped[glob_anchor_id].as<float*>());
     }
 
     /** Parse detections **/
     if (new_network_) {
         const cv::Mat priorbox_out;
-        return GetDetections(loc_out, main_conf_out, priorbox_out, add_conf_out,
-                             cv::Size(static_cast<int>(width_), static_cast<int>(height_)));
+        return GetDetections(loc_out, main_conf_out, priorbox_out, add_conf_out, frame_size);
     }
 
-    LockedMemory<const void> priorboxOutBlobMapped =
-        as<MemoryBlob>(request->GetBlob(config_.old_priorbox_blob_name))->rmap();
-    const cv::Mat priorbox_out = cv::Mat(ieSizeToVector(request->
-                                         GetBlob(config_.old_priorbox_blob_name)->getTensorDesc().getDims()), CV_32F,
+    const Blob::Ptr& priorbox_blob = outputs.at(config_.old_priorbox_blob_name);
+    LockedMemory<const void> priorboxOutBlobMapped = as<MemoryBlob>(priorbox_blob)->rmap();
+    const cv::Mat priorbox_out = cv::Mat(ieSizeToVector(priorbox_blob->getTensorDesc().getDims()), CV_32F,
                                          priorboxOutBlobMapped.as<float*>());
-    return GetDetections(loc_out, main_conf_out, priorbox_out, add_conf_out,
-                         cv::Size(static_cast<int>(width_), static_cast<int>(height_)));
+    return GetDetections(loc_out, main_conf_out, priorbox_out, add_conf_out, frame_size);
 }
 
 inline ActionDetection::NormalizedBBox
@@ -201,6 +270,14 @@ cv::Rect ActionDetection::ConvertToRect(
     const float prior_center_x = 0.5f * (prior_bbox.xmin + prior_bbox.xmax);
     const float prior_center_y = 0.5f * (prior_bbox.ymin + prior_bbox.ymax);
 
+    return DecodeBBox(prior_center_x, prior_center_y, prior_width, prior_height,
+                      variances, encoded_bbox, frame_size);
+}
+
+cv::Rect ActionDetection::DecodeBBox(
+        float prior_center_x, float prior_center_y, float prior_width, float prior_height,
+        const NormalizedBBox& variances, const NormalizedBBox& encoded_bbox,
+        const cv::Size& frame_size) const {
     /** Decode bbox coordinates from the SSD format **/
     const float decoded_bbox_center_x =
             variances.xmin * encoded_bbox.xmin * prior_width + prior_center_x;
@@ -238,40 +315,35 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc, const cv::Mat
         action_conf_data[i] = reinterpret_cast<float*>(add_conf[i].data);
     }
 
+    /** Select the candidates with confident detections. The scan has no branches
+        to mispredict on noisy confidences, and only the selected candidates are decoded **/
+    const float detection_threshold = config_.detection_confidence_threshold;
+    std::vector<int> candidates(num_candidates_);
+    int num_selected = 0;
+    for (int p = 0; p < num_candidates_; ++p) {
+        candidates[num_selected] = p;
+        num_selected += !(det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX] < detection_threshold);
+    }
+
     /** Variable to store all detection candidates**/
     DetectedActions valid_detections;
+    valid_detections.reserve(num_selected);
+
+    const float scale = new_network_ ? config_.new_action_scale : config_.old_action_scale;
+    const NormalizedBBox new_network_variance = ParseBBoxRecord(config_.variances, false);
+
+    /** Iterate over the selected candidate bboxes**/
+    for (int i = 0; i < num_selected; ++i) {
+        const int p = candidates[i];
 
-    /** Iterate over all candidate bboxes**/
-    for (int p = 0; p < num_candidates_; ++p) {
         /** Parse detection confidence from the SSD Detection output **/
         const float detection_conf =
                 det_conf_data[p * NUM_DETECTION_CLASSES + POSITIVE_DETECTION_IDX];
 
-        /** Skip low-confidence detections **/
-        if (detection_conf < config_.detection_confidence_threshold) {
-            continue;
-        }
-
-        /** Estimate the action head ID **/
-        int head_id = 0;
-        while (p >= head_ranges_[head_id + 1]) {
-            ++head_id;
-        }
-        const int head_p = p - head_ranges_[head_id];
-
-        /** Estimate the action anchor ID **/
-        const int head_num_anchors =
-            new_network_ ? config_.new_anchors[head_id] : config_.old_anchors[head_id];
-        const int anchor_id = head_p % head_num_anchors;
-
         /** Estimate the action label **/
-        const int glob_anchor_id = glob_anchor_map_[head_id][anchor_id];
-        const float* anchor_conf_data = action_conf_data[glob_anchor_id];
-        const int action_conf_idx_shift = new_network_
-                                            ? head_p / head_num_anchors
-                                            : head_p / head_num_anchors * config_.num_action_classes;
-        const int action_conf_step = head_step_sizes_[head_id];
-        const float scale = new_network_ ? config_.new_action_scale : config_.old_action_scale;
+        const float* anchor_conf_data = action_conf_data[prior_table_.glob_anchor_ids[p]];
+        const int action_conf_idx_shift = prior_table_.action_conf_shifts[p];
+        const int action_conf_step = prior_table_.action_conf_steps[p];
         int action_label = -1;
         float action_max_exp_value = 0.f;
         float action_sum_exp_values = 0.f;
@@ -298,21 +370,16 @@ DetectedActions ActionDetection::GetDetections(const cv::Mat& loc, const cv::Mat
         }
 
         /** Parse bbox from the SSD Detection output **/
-        const auto priorbox = new_network_
-                                ? GeneratePriorBox(head_p / head_num_anchors,
-                                                   config_.new_det_heads[head_id].step,
-                                                   config_.new_det_heads[head_id].anchors[anchor_id],
-                                                   head_blob_sizes_[head_id])
-                                : ParseBBoxRecord(prior_data + p * SSD_PRIORBOX_RECORD_SIZE, false);
-        const auto variance =
-                ParseBBoxRecord(new_network_
-                                    ? config_.variances
-                                    : prior_data + (num_candidates_ + p) * SSD_PRIORBOX_RECORD_SIZE,
-                                false);
         const auto encoded_bbox =
                 ParseBBoxRecord(loc_data + p * SSD_LOCATION_RECORD_SIZE, new_network_);
 
-        const auto det_rect = ConvertToRect(priorbox, variance, encoded_bbox, frame_size);
+        const auto det_rect = new_network_
+            ? DecodeBBox(prior_table_.center_x[p], prior_table_.center_y[p],
+                         prior_table_.width[p], prior_table_.height[p],
+                         new_network_variance, encoded_bbox, frame_size)
+            : ConvertToRect(ParseBBoxRecord(prior_data + p * SSD_PRIORBOX_RECORD_SIZE, false),
+                            ParseBBoxRecord(prior_data + (num_candidates_ + p) * SSD_PRIORBOX_RECORD_SIZE, false),
+                            encoded_bbox, frame_size);
 
         /** Store detected action **/
         valid_detections.emplace_back(det_rect, action_label, detection_conf, action_conf);
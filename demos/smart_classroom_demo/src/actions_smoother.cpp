@@ -0,0 +1,157 @@
+// Copyright (C) 2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "actions_smoother.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+ActionsSmoother::ActionsSmoother(Action default_action, int window_size, int min_length, int forget_delay,
+                                 FrameCallback on_frame, TrackCallback on_track)
+    : default_action_(default_action),
+      window_size_(std::max(window_size, 1)),
+      min_length_(std::max(min_length, 0)),
+      forget_delay_(std::max(forget_delay, 0)),
+      latency_(2 * (window_size_ + min_length_)),
+      on_frame_(std::move(on_frame)),
+      on_track_(std::move(on_track)),
+      last_frame_idx_(-1) {}
+
+void ActionsSmoother::AddFrame(FrameActionsRecord frame) {
+    const int frame_idx = frame.frame_idx;
+    for (const auto& face : frame.faces) {
+        auto& track = tracks_[face.object_id];
+        track.last_seen = frame_idx;
+        if (face.label >= 0) {
+            int votes = ++track.label_votes[face.label];
+            if (votes > track.best_label_votes) {
+                track.best_label_votes = votes;
+                track.best_label = face.label;
+            }
+        }
+        if (face.action != default_action_) {
+            AddEvent(track, frame_idx, face.action);
+        }
+    }
+
+    // Ranges which can't be extended by future events
+    for (auto& item : tracks_) {
+        auto& track = item.second;
+        if (track.open && track.ranges.back().end_frame_id + window_size_ - 1 <= frame_idx) {
+            CloseRange(track);
+        }
+    }
+
+    last_frame_idx_ = frame_idx;
+    pending_frames_.push_back(std::move(frame));
+    while (!pending_frames_.empty() && pending_frames_.front().frame_idx + latency_ <= last_frame_idx_) {
+        FinalizeFrame();
+    }
+
+    // All frames of tracks lost for that long are finalized already
+    for (auto it = tracks_.begin(); it != tracks_.end();) {
+        if (it->second.last_seen + latency_ + forget_delay_ < last_frame_idx_) {
+            FinalizeTrack(it->second);
+            it = tracks_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ActionsSmoother::Finish() {
+    for (auto& item : tracks_) {
+        if (item.second.open) {
+            CloseRange(item.second);
+        }
+    }
+    while (!pending_frames_.empty()) {
+        FinalizeFrame();
+    }
+    for (const auto& item : tracks_) {
+        FinalizeTrack(item.second);
+    }
+    tracks_.clear();
+}
+
+void ActionsSmoother::AddEvent(TrackState& track, int frame_idx, Action action) {
+    if (track.open) {
+        auto& last_range = track.ranges.back();
+        if (last_range.end_frame_id + window_size_ - 1 >= frame_idx && last_range.action == action) {
+            last_range.end_frame_id = frame_idx + 1;
+            return;
+        }
+        CloseRange(track);
+    }
+    track.ranges.emplace_back(frame_idx, frame_idx + 1, action);
+    track.open = true;
+}
+
+void ActionsSmoother::CloseRange(TrackState& track) {
+    track.open = false;
+    const auto& last_range = track.ranges.back();
+    if (last_range.end_frame_id - last_range.begin_frame_id < min_length_) {
+        track.ranges.pop_back();
+    }
+}
+
+Action ActionsSmoother::SmoothedAction(TrackState& track, int frame_idx) {
+    auto& ranges = track.ranges;
+
+    // An open range is not kept until it reaches the minimum length
+    size_t num_kept = ranges.size();
+    if (track.open && ranges.back().end_frame_id - ranges.back().begin_frame_id < min_length_) {
+        num_kept--;
+    }
+
+    // Frames are finalized in order, so ranges before the one preceding
+    // the frame are not needed anymore
+    while (num_kept > 1 && ranges[1].begin_frame_id <= frame_idx) {
+        ranges.pop_front();
+        num_kept--;
+    }
+
+    if (num_kept == 0) {
+        return default_action_;
+    }
+    const auto& prev_range = ranges[0];
+    if (frame_idx < prev_range.end_frame_id || num_kept == 1) {
+        return prev_range.action;
+    }
+    const auto& next_range = ranges[1];
+    int middle_point = static_cast<int>(0.5f * (next_range.begin_frame_id + prev_range.end_frame_id));
+    return frame_idx < middle_point ? prev_range.action : next_range.action;
+}
+
+void ActionsSmoother::FinalizeFrame() {
+    FrameActionsRecord frame = std::move(pending_frames_.front());
+    pending_frames_.pop_front();
+
+    std::vector<FaceActionRecord> faces;
+    faces.reserve(frame.faces.size());
+    for (const auto& face : frame.faces) {
+        auto& track = tracks_.at(face.object_id);
+        if (track.best_label < 0) {
+            continue;
+        }
+
+        Action action = SmoothedAction(track, frame.frame_idx);
+        if (!track.events.empty() && track.events.back().action == action) {
+            track.events.back().end_frame_id = frame.frame_idx + 1;
+        } else {
+            track.events.emplace_back(frame.frame_idx, frame.frame_idx + 1, action);
+        }
+        faces.emplace_back(face.object_id, face.rect, track.best_label, action);
+    }
+    frame.faces.swap(faces);
+
+    on_frame_(frame);
+}
+
+void ActionsSmoother::FinalizeTrack(const TrackState& track) {
+    if (track.best_label >= 0 && !track.events.empty()) {
+        on_track_(track.best_label, track.events);
+    }
+}
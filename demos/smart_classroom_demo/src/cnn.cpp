@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <thread>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -15,10 +16,19 @@
 
 using namespace InferenceEngine;
 
+void InitReplay(const CnnConfig& config, const InferenceEngine::ExecutableNetwork& network) {
+    if (config.replayer && config.replayer->getInputDims() != getInputDims(network)) {
+        THROW_IE_EXCEPTION << "The outputs of " << config.path_to_model << " were recorded for another network or batch size";
+    }
+    if (config.recorder) {
+        config.recorder->setInputDims(getInputDims(network));
+    }
+}
+
 CnnDLSDKBase::CnnDLSDKBase(const Config& config) : config_(config) {}
 
 void CnnDLSDKBase::Load() {
-    auto cnnNetwork = config_.ie.ReadNetwork(config_.path_to_model);
+    auto cnnNetwork = config_.loader.readNetwork(config_.path_to_model);
 
 
     const int currentBatchSize = cnnNetwork.getBatchSize();
@@ -39,8 +49,9 @@ void CnnDLSDKBase::Load() {
         output_blobs_names_.push_back(item.first);
     }
 
-    executable_network_ = config_.ie.LoadNetwork(cnnNetwork, config_.deviceName);
+    executable_network_ = config_.loader.loadNetwork(cnnNetwork, config_.path_to_model, config_.deviceName);
     infer_request_ = executable_network_.CreateInferRequest();
+    InitReplay(config_, executable_network_);
 }
 
 void CnnDLSDKBase::InferBatch(
@@ -56,19 +67,31 @@ void CnnDLSDKBase::InferBatch(
             matU8ToBlob<uint8_t>(frames[batch_i + b], input, b);
         }
 
-        if (config_.max_batch_size != 1)
-            infer_request_.SetBatch(current_batch_size);
-        infer_request_.Infer();
+        if (config_.replayer) {
+            // batches are replayed in the order they were recorded
+            setOutputs(infer_request_, config_.replayer->getOutputs(0, -1));
+            std::this_thread::sleep_for(config_.replayer->getLatency());
+        } else {
+            if (config_.max_batch_size != 1)
+                infer_request_.SetBatch(current_batch_size);
+            infer_request_.Infer();
+        }
 
         InferenceEngine::BlobMap blobs;
         for (const auto& name : output_blobs_names_)  {
             blobs[name] = infer_request_.GetBlob(name);
         }
+        if (config_.recorder) {
+            config_.recorder->write(0, -1, blobs);
+        }
         fetch_results(blobs, current_batch_size);
     }
 }
 
 void CnnDLSDKBase::PrintPerformanceCounts(std::string fullDeviceName) const {
+    if (config_.replayer) {
+        return;
+    }
     std::cout << "Performance counts for " << config_.path_to_model << std::endl << std::endl;
     ::printPerformanceCounts(infer_request_, std::cout, fullDeviceName, false);
 }
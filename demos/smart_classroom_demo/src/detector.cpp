@@ -73,7 +73,7 @@ void FaceDetection::enqueue(const cv::Mat &frame) {
 FaceDetection::FaceDetection(const DetectorConfig& config) :
         BaseCnnDetection(config.is_async), config_(config) {
     topoName = "face detector";
-    auto cnnNetwork = config.ie.ReadNetwork(config.path_to_model);
+    auto cnnNetwork = config.loader.readNetwork(config.path_to_model);
 
     InputsDataMap inputInfo(cnnNetwork.getInputsInfo());
     if (inputInfo.size() != 1) {
@@ -111,7 +111,8 @@ FaceDetection::FaceDetection(const DetectorConfig& config) :
     _output->setLayout(TensorDesc::getLayoutByDims(_output->getDims()));
 
     input_name_ = inputInfo.begin()->first;
-    net_ = config_.ie.LoadNetwork(cnnNetwork, config_.deviceName);
+    net_ = config_.loader.loadNetwork(cnnNetwork, config_.path_to_model, config_.deviceName);
+    setReplay(config_, net_);
 }
 
 DetectedObjects FaceDetection::fetchResults() {
@@ -7,6 +7,9 @@
 #include <set>
 #include <vector>
 #include <fstream>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 #include "logger.hpp"
 
@@ -18,6 +21,50 @@ std::string GetUnknownOrLabel(const std::vector<std::string>& labels, int idx)
     return idx >= 0 ? labels.at(idx) : unknown_label;
 }
 
+// Binary per-person action statistics: magic and version, action labels and
+// person labels, followed by records. A path record holds the path of the next
+// frames, a frame record holds the frame index and the action of every person.
+// Values are little-endian whatever the byte order of the host is.
+const char kActStatMagic[] = "SCAS";
+const uint32_t kActStatVersion = 1;
+const char kPathRecord = 'P';
+const char kFrameRecord = 'F';
+const int16_t kUnknownIdx = -1;
+
+template <typename T>
+void WriteValue(AsyncWriter& writer, T value) {
+    auto bits = static_cast<typename std::make_unsigned<T>::type>(value);
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bytes[i] = static_cast<char>(bits & 0xFF);
+        bits = static_cast<decltype(bits)>(bits >> 8);
+    }
+    writer.Write(bytes, sizeof(T));
+}
+
+void WriteString(AsyncWriter& writer, const std::string& str) {
+    WriteValue(writer, static_cast<uint32_t>(str.size()));
+    writer.Write(str);
+}
+
+std::string FrameRecordHeader(const std::string& path, const int frame_idx,
+                              const size_t width, const size_t height) {
+    std::ostringstream record;
+    record << "Frame_name: " << path << "@" << frame_idx << " width: "
+           << width << " height: " << height << "\n";
+    return record.str();
+}
+
+std::string FaceRecord(const cv::Rect& rect, const std::string& id, const std::string& action) {
+    std::ostringstream record;
+    record << "Object type: face. Box: " << rect << " id: " << id;
+    if (!action.empty()) {
+        record << " action: " << action;
+    }
+    record << "\n";
+    return record.str();
+}
+
 std::string FrameIdxToString(const std::string& path, int frame_idx) {
     std::stringstream ss;
     ss << std::setw(6) << std::setfill('0') << frame_idx;
@@ -25,12 +72,81 @@ std::string FrameIdxToString(const std::string& path, int frame_idx) {
 }
 }  // anonymous namespace
 
+AsyncWriter::AsyncWriter(std::ostream& stream, size_t chunk_size, size_t max_pending_chunks)
+    : stream_(stream), chunk_size_(chunk_size), max_pending_chunks_(max_pending_chunks),
+      writing_(false), stop_(false) {
+    chunk_.reserve(chunk_size_);
+    thread_ = std::thread(&AsyncWriter::Run, this);
+}
+
+AsyncWriter::~AsyncWriter() {
+    Submit();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    has_chunks_.notify_one();
+    thread_.join();
+    stream_.flush();
+}
+
+void AsyncWriter::Write(const char* data, size_t size) {
+    chunk_.append(data, size);
+    if (chunk_.size() >= chunk_size_) {
+        Submit();
+    }
+}
+
+void AsyncWriter::Flush() {
+    Submit();
+    std::unique_lock<std::mutex> lock(mutex_);
+    has_space_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    stream_.flush();
+}
+
+void AsyncWriter::Submit() {
+    if (chunk_.empty()) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        has_space_.wait(lock, [this] { return pending_.size() < max_pending_chunks_; });
+        pending_.push_back(std::move(chunk_));
+    }
+    has_chunks_.notify_one();
+    chunk_ = std::string();
+    chunk_.reserve(chunk_size_);
+}
+
+void AsyncWriter::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        has_chunks_.wait(lock, [this] { return !pending_.empty() || stop_; });
+        if (pending_.empty()) {
+            break;
+        }
+        std::string chunk = std::move(pending_.front());
+        pending_.pop_front();
+        writing_ = true;
+        lock.unlock();
+
+        stream_.write(chunk.data(), chunk.size());
+
+        lock.lock();
+        writing_ = false;
+        has_space_.notify_all();
+    }
+}
+
 DetectionsLogger::DetectionsLogger(std::ostream& stream, bool enabled,
                                    const std::string& act_stat_log_file,
-                                   const std::string& act_det_log_file)
-    : log_stream_(stream) {
-    write_logs_ = enabled;
-    act_stat_log_stream_.open(act_stat_log_file, std::fstream::out);
+                                   const std::string& act_det_log_file,
+                                   bool binary_act_stat)
+    : write_logs_(enabled), binary_act_stat_(binary_act_stat),
+      log_stream_(stream), act_stat_writer_(act_stat_log_stream_), num_persons_(0),
+      frame_record_open_(false) {
+    act_stat_log_stream_.open(act_stat_log_file,
+                              binary_act_stat ? std::fstream::out | std::fstream::binary : std::fstream::out);
 
     if (!act_det_log_file.empty()) {
         act_det_log_stream_.open(act_det_log_file, cv::FileStorage::WRITE);
@@ -41,28 +157,27 @@ DetectionsLogger::DetectionsLogger(std::ostream& stream, bool enabled,
 
 void DetectionsLogger::CreateNextFrameRecord(const std::string& path, const int frame_idx,
                                              const size_t width, const size_t height) {
-    if (write_logs_)
-        log_stream_ << "Frame_name: " << path << "@" << frame_idx << " width: "
-                    << width << " height: " << height << std::endl;
+    if (write_logs_) {
+        log_stream_ << FrameRecordHeader(path, frame_idx, width, height);
+        frame_record_open_ = true;
+    }
 }
 
 void DetectionsLogger::AddFaceToFrame(const cv::Rect& rect, const std::string& id, const std::string& action) {
     if (write_logs_) {
-        log_stream_ << "Object type: face. Box: " << rect << " id: " << id;
-        if (!action.empty()) {
-            log_stream_ << " action: " << action;
-        }
-        log_stream_ << std::endl;
+        log_stream_ << FaceRecord(rect, id, action);
     }
 }
 
 void DetectionsLogger::AddPersonToFrame(const cv::Rect& rect, const std::string& action, const std::string& id) {
     if (write_logs_) {
-        log_stream_ << "Object type: person. Box: " << rect << " action: " << action;
+        std::ostringstream record;
+        record << "Object type: person. Box: " << rect << " action: " << action;
         if (!id.empty()) {
-            log_stream_ << " id: " << id;
+            record << " id: " << id;
         }
-        log_stream_ << std::endl;
+        record << "\n";
+        log_stream_ << record.str();
     }
 }
 
@@ -77,85 +192,113 @@ void DetectionsLogger::AddDetectionToFrame(const TrackedObject& object, const in
 
 void DetectionsLogger::FinalizeFrameRecord() {
     if (write_logs_) {
-        log_stream_ << std::endl;
+        log_stream_ << "\n";
+        frame_record_open_ = false;
+        log_stream_ << delayed_records_;
+        delayed_records_.clear();
+    }
+}
+
+void DetectionsLogger::WriteRecord(const std::string& record) {
+    // Smoothed results come while the record of the current frame is open,
+    // they follow it once it's finalized
+    if (frame_record_open_) {
+        delayed_records_ += record;
+    } else {
+        log_stream_ << record;
     }
 }
 
-void DetectionsLogger::DumpDetections(const std::string& video_path,
-                                      const cv::Size frame_size,
-                                      const size_t num_frames,
-                                      const std::vector<Track>& face_tracks,
-                                      const std::map<int, int>& track_id_to_label_faces,
-                                      const std::vector<std::string>& action_idx_to_label,
-                                      const std::vector<std::string>& person_id_to_label,
-                                      const std::vector<std::map<int, int>>& frame_face_obj_id_to_action_maps)  {
-    std::map<int, std::vector<const TrackedObject*>> frame_idx_to_face_track_objs;
+void DetectionsLogger::StartActionStatistics(const std::vector<std::string>& action_idx_to_label,
+                                             const std::vector<std::string>& person_id_to_label) {
+    action_idx_to_label_ = action_idx_to_label;
+    person_id_to_label_ = person_id_to_label;
+    num_persons_ = person_id_to_label.size();
 
-    for (const auto& tr : face_tracks) {
-        for (const auto& obj : tr.objects) {
-            frame_idx_to_face_track_objs[obj.frame_idx].emplace_back(&obj);
+    if (binary_act_stat_) {
+        act_stat_writer_.Write(kActStatMagic, sizeof(kActStatMagic) - 1);
+        WriteValue(act_stat_writer_, kActStatVersion);
+        WriteValue(act_stat_writer_, static_cast<uint32_t>(action_idx_to_label.size()));
+        for (const auto& label : action_idx_to_label) {
+            WriteString(act_stat_writer_, label);
+        }
+        WriteValue(act_stat_writer_, static_cast<uint32_t>(person_id_to_label.size()));
+        for (const auto& label : person_id_to_label) {
+            WriteString(act_stat_writer_, label);
         }
+    } else {
+        std::ostringstream header;
+        header << "frame_idx";
+        for (const auto& label : person_id_to_label) {
+            header << "," << label;
+        }
+        header << "\n";
+        act_stat_writer_.Write(header.str());
     }
+}
 
-    std::map<std::string, std::string> face_label_to_action;
-    for (const auto& label : person_id_to_label) {
-        face_label_to_action[label] = unknown_label;
-    }
-    act_stat_log_stream_ << "frame_idx";
-    for (const auto& label : person_id_to_label) {
-        act_stat_log_stream_ << "," << label;
+void DetectionsLogger::DumpFrame(const FrameActionsRecord& frame) {
+    std::string record;
+    if (write_logs_) {
+        record = FrameRecordHeader(frame.path, frame.frame_idx, frame.frame_size.width, frame.frame_size.height);
     }
-    act_stat_log_stream_ << std::endl;
 
-    for (size_t i = 0; i < num_frames; i++)  {
-        CreateNextFrameRecord(video_path, i, frame_size.width, frame_size.height);
-        const auto& frame_face_obj_id_to_action = frame_face_obj_id_to_action_maps.at(i);
-        for (auto& kv : face_label_to_action) {
-            kv.second = unknown_label;
+    std::vector<int16_t> person_actions(num_persons_, kUnknownIdx);
+    for (const auto& face : frame.faces) {
+        if (write_logs_) {
+            record += FaceRecord(face.rect, GetUnknownOrLabel(person_id_to_label_, face.label),
+                                 GetUnknownOrLabel(action_idx_to_label_, face.action));
         }
-
-        for (const auto& p_obj : frame_idx_to_face_track_objs[i]) {
-            const auto& obj = *p_obj;
-            std::string action_label = unknown_label;
-            if (frame_face_obj_id_to_action.count(obj.object_id) > 0) {
-                action_label = GetUnknownOrLabel(action_idx_to_label, frame_face_obj_id_to_action.at(obj.object_id));
-            }
-            std::string face_label = GetUnknownOrLabel(person_id_to_label, track_id_to_label_faces.at(obj.object_id));
-            face_label_to_action[face_label] = action_label;
-            AddFaceToFrame(obj.rect, face_label, action_label);
+        if (face.label >= 0 && static_cast<size_t>(face.label) < num_persons_) {
+            person_actions[face.label] = static_cast<int16_t>(face.action);
         }
+    }
 
-        act_stat_log_stream_ << FrameIdxToString(video_path, i);
-        for (const auto& label : person_id_to_label) {
-            act_stat_log_stream_ << "," << face_label_to_action[label];
+    if (binary_act_stat_) {
+        if (frame.path != last_path_) {
+            act_stat_writer_.Write(&kPathRecord, 1);
+            WriteString(act_stat_writer_, frame.path);
+            last_path_ = frame.path;
+        }
+        act_stat_writer_.Write(&kFrameRecord, 1);
+        WriteValue(act_stat_writer_, static_cast<int32_t>(frame.frame_idx));
+        for (const auto action : person_actions) {
+            WriteValue(act_stat_writer_, action);
+        }
+    } else {
+        std::ostringstream row;
+        row << FrameIdxToString(frame.path, frame.frame_idx);
+        for (const auto action : person_actions) {
+            row << "," << GetUnknownOrLabel(action_idx_to_label_, action);
         }
-        act_stat_log_stream_ << std::endl;
+        row << "\n";
+        act_stat_writer_.Write(row.str());
+    }
 
-        FinalizeFrameRecord();
+    if (write_logs_) {
+        WriteRecord(record + "\n");
     }
 }
 
-void DetectionsLogger::DumpTracks(const std::map<int, RangeEventsTrack>& obj_id_to_events,
-                                  const std::vector<std::string>& action_idx_to_label,
-                                  const std::map<int, int>& track_id_to_label_faces,
-                                  const std::vector<std::string>& person_id_to_label) {
-    for (const auto& tup : obj_id_to_events) {
-        const int obj_id = tup.first;
-        if (track_id_to_label_faces.count(obj_id) > 0) {
-            const auto& events = tup.second;
-
-            std::string face_label = GetUnknownOrLabel(person_id_to_label, track_id_to_label_faces.at(obj_id));
-            log_stream_ << "Person: " << face_label << std::endl;
+void DetectionsLogger::DumpTrack(int person_id, const RangeEventsTrack& events) {
+    if (!write_logs_) {
+        return;
+    }
 
-            for (const auto& event : events) {
-                std::string action_label = GetUnknownOrLabel(action_idx_to_label, event.action);
-                log_stream_ << "   - " << action_label
-                            << ": from " << event.begin_frame_id
-                            << " to " << event.end_frame_id
-                            << " frames" <<std::endl;
-            }
-        }
+    std::ostringstream record;
+    record << "Person: " << GetUnknownOrLabel(person_id_to_label_, person_id) << "\n";
+    for (const auto& event : events) {
+        record << "   - " << GetUnknownOrLabel(action_idx_to_label_, event.action)
+               << ": from " << event.begin_frame_id
+               << " to " << event.end_frame_id
+               << " frames" << "\n";
     }
+    WriteRecord(record.str());
+}
+
+void DetectionsLogger::Flush() {
+    log_stream_.flush();
+    act_stat_writer_.Flush();
 }
 
 DetectionsLogger::~DetectionsLogger() {
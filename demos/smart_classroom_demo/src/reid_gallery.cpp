@@ -144,11 +144,11 @@ std::vector<int> EmbeddingsGallery::GetIDsByEmbeddings(const std::vector<cv::Mat
             }
         }
     }
-    KuhnMunkres matcher(use_greedy_matcher);
-    auto matched_idx = matcher.Solve(distances);
+    LinearAssignment matcher(use_greedy_matcher);
+    auto matched_idx = matcher.Solve(distances, static_cast<float>(reid_threshold));
     std::vector<int> output_ids;
     for (auto col_idx : matched_idx) {
-        if (distances.at<float>(output_ids.size(), col_idx) > reid_threshold)
+        if (col_idx >= idx_to_id.size())
             output_ids.push_back(unknown_id);
         else
             output_ids.push_back(idx_to_id[col_idx]);
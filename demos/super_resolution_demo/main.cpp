@@ -8,6 +8,8 @@
  * @example super_resolution_demo/main.cpp
  */
 #include <algorithm>
+#include <chrono>
+#include <utility>
 #include <vector>
 #include <string>
 #include <memory>
@@ -44,6 +46,159 @@ bool ParseAndCheckCommandLine(int argc, char *argv[]) {
     return true;
 }
 
+/**
+ * @brief Splits an axis of the given length into overlapping segments of tileLength,
+ *        the last segment is aligned to the end of the axis
+ * @return start positions of the segments
+ */
+std::vector<int> splitIntoTiles(int length, int tileLength, int overlap) {
+    std::vector<int> positions{0};
+    int stride = tileLength - overlap;
+    while (positions.back() + tileLength < length) {
+        positions.push_back(std::min(positions.back() + stride, length - tileLength));
+    }
+    return positions;
+}
+
+/**
+ * @brief Blending weights of a tile along one axis: they grow linearly across the overlap
+ *        on the sides which are shared with neighbouring tiles and equal 1 elsewhere
+ */
+cv::Mat getTileWeights(int tileLength, int rampLength, bool hasPrev, bool hasNext) {
+    cv::Mat weights(1, tileLength, CV_32F, cv::Scalar(1.f));
+    for (int i = 0; i < rampLength && i < tileLength; ++i) {
+        float weight = (i + 0.5f) / rampLength;
+        if (hasPrev) {
+            weights.at<float>(i) = std::min(weights.at<float>(i), weight);
+        }
+        if (hasNext) {
+            weights.at<float>(tileLength - 1 - i) = std::min(weights.at<float>(tileLength - 1 - i), weight);
+        }
+    }
+    return weights;
+}
+
+/**
+ * @brief Upscales an image of any size with a network compiled for a fixed input size.
+ *        The image is split into overlapping tiles of the network input size, the tiles are inferred
+ *        on a pool of asynchronous requests, and the upscaled tiles are blended into one output image
+ *        with weights fading out across the overlaps, so that the seams are not visible.
+ */
+class TiledUpscaler {
+public:
+    TiledUpscaler(std::vector<InferRequest>& requests, const std::string& lrInputName, const std::string& bicInputName,
+                  const std::string& outputName, const cv::Size& tileSize, int scale, int overlap) :
+        requests(requests), lrInputName(lrInputName), bicInputName(bicInputName), outputName(outputName),
+        tileSize(tileSize), scale(scale), overlap(overlap) {}
+
+    /** @return upscaled image planes in the [0, 1] range */
+    std::vector<cv::Mat> upscale(const cv::Mat& img) {
+        // Images smaller than a tile are padded up to the tile size, padding is cropped from the result
+        cv::Mat padded;
+        cv::copyMakeBorder(img, padded, 0, std::max(tileSize.height - img.rows, 0),
+                           0, std::max(tileSize.width - img.cols, 0), cv::BORDER_REPLICATE);
+
+        cv::Size outputSize(padded.cols * scale, padded.rows * scale);
+        weightsSum = cv::Mat::zeros(outputSize, CV_32F);
+        planesSum.clear();
+
+        std::vector<int> xs = splitIntoTiles(padded.cols, tileSize.width, overlap);
+        std::vector<int> ys = splitIntoTiles(padded.rows, tileSize.height, overlap);
+        std::vector<std::pair<cv::Rect, cv::Mat>> tiles;  // tile location and its blending weights
+        for (size_t i = 0; i < ys.size(); ++i) {
+            cv::Mat rowWeights = getTileWeights(tileSize.height * scale, overlap * scale, i > 0, i + 1 < ys.size());
+            for (size_t j = 0; j < xs.size(); ++j) {
+                cv::Mat colWeights = getTileWeights(tileSize.width * scale, overlap * scale, j > 0, j + 1 < xs.size());
+                tiles.emplace_back(cv::Rect(cv::Point(xs[j], ys[i]), tileSize), rowWeights.t() * colWeights);
+            }
+        }
+
+        // Every request gets the next tile as soon as the tile it was busy with is blended into the result
+        std::vector<int> requestTiles(requests.size(), -1);
+        for (size_t tileIdx = 0; tileIdx < tiles.size(); ++tileIdx) {
+            size_t requestIdx = tileIdx % requests.size();
+            if (requestTiles[requestIdx] >= 0) {
+                blend(requests[requestIdx], tiles[requestTiles[requestIdx]]);
+            }
+            startTile(requests[requestIdx], padded(tiles[tileIdx].first));
+            requestTiles[requestIdx] = static_cast<int>(tileIdx);
+        }
+        for (size_t requestIdx = 0; requestIdx < requests.size(); ++requestIdx) {
+            if (requestTiles[requestIdx] >= 0) {
+                blend(requests[requestIdx], tiles[requestTiles[requestIdx]]);
+            }
+        }
+
+        cv::Rect imageArea(0, 0, img.cols * scale, img.rows * scale);
+        std::vector<cv::Mat> planes;
+        for (auto& planeSum : planesSum) {
+            cv::divide(planeSum, weightsSum, planeSum);
+            planes.push_back(planeSum(imageArea));
+        }
+        lastTilesNum = tiles.size();
+        return planes;
+    }
+
+    size_t lastTilesNum = 0;
+
+private:
+    void startTile(InferRequest& request, const cv::Mat& tile) {
+        Blob::Ptr lrInputBlob = request.GetBlob(lrInputName);
+        matU8ToBlob<float_t>(tile, lrInputBlob);
+
+        if (!bicInputName.empty()) {
+            Blob::Ptr bicInputBlob = request.GetBlob(bicInputName);
+
+            int w = bicInputBlob->getTensorDesc().getDims()[3];
+            int h = bicInputBlob->getTensorDesc().getDims()[2];
+
+            cv::Mat resized;
+            cv::resize(tile, resized, cv::Size(w, h), 0, 0, cv::INTER_CUBIC);
+
+            matU8ToBlob<float_t>(resized, bicInputBlob);
+        }
+        request.StartAsync();
+    }
+
+    void blend(InferRequest& request, const std::pair<cv::Rect, cv::Mat>& tile) {
+        request.Wait(IInferRequest::WaitMode::RESULT_READY);
+
+        const Blob::Ptr outputBlob = request.GetBlob(outputName);
+        LockedMemory<const void> outputBlobMapped = as<MemoryBlob>(outputBlob)->rmap();
+        const auto outputData = outputBlobMapped.as<float*>();
+
+        int numOfChannels = static_cast<int>(outputBlob->getTensorDesc().getDims()[1]);
+        int h = static_cast<int>(outputBlob->getTensorDesc().getDims()[2]);
+        int w = static_cast<int>(outputBlob->getTensorDesc().getDims()[3]);
+
+        if (planesSum.empty()) {
+            for (int c = 0; c < numOfChannels; ++c) {
+                planesSum.push_back(cv::Mat::zeros(weightsSum.size(), CV_32F));
+            }
+        }
+
+        cv::Rect outputArea(tile.first.tl() * scale, cv::Size(w, h));
+        for (int c = 0; c < numOfChannels; ++c) {
+            cv::Mat plane(h, w, CV_32FC1, &(outputData[c * w * h]));
+            cv::Mat planeSumArea = planesSum[c](outputArea);
+            cv::accumulateProduct(plane, tile.second, planeSumArea);
+        }
+        cv::Mat weightsSumArea = weightsSum(outputArea);
+        weightsSumArea += tile.second;
+    }
+
+    std::vector<InferRequest>& requests;
+    std::string lrInputName;
+    std::string bicInputName;
+    std::string outputName;
+    cv::Size tileSize;
+    int scale;
+    int overlap;
+
+    std::vector<cv::Mat> planesSum;
+    cv::Mat weightsSum;
+};
+
 int main(int argc, char *argv[]) {
     try {
         slog::info << "InferenceEngine: " << GetInferenceEngineVersion() << slog::endl;
@@ -98,26 +253,28 @@ int main(int argc, char *argv[]) {
             throw std::logic_error("The demo supports topologies with 1 or 2 inputs only");
 
         const std::string lrInputBlobName = "0";
+        const std::string bicInputBlobName = inputInfo.size() == 2 ? "1" : "";
+
+        /** The network is compiled for its original input size, images of other sizes are processed by tiles **/
+        auto lrInputInfoItem = inputInfo[lrInputBlobName];
+        int tileWidth = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[3]);
+        int tileHeight = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[2]);
+        int c = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[1]);
+
+        if (static_cast<int>(FLAGS_overlap) >= std::min(tileWidth, tileHeight)) {
+            throw std::logic_error("Parameter -overlap must be less than the network input size " +
+                                   std::to_string(tileWidth) + "x" + std::to_string(tileHeight));
+        }
 
         /** Collect images**/
         std::vector<cv::Mat> inputImages;
         for (const auto &i : imageNames) {
-            /** Get size of low resolution input **/
-            auto lrInputInfoItem = inputInfo[lrInputBlobName];
-            int w = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[3]);
-            int h = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[2]);
-            int c = static_cast<int>(lrInputInfoItem->getTensorDesc().getDims()[1]);
-
             cv::Mat img = cv::imread(i, c == 1 ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
             if (img.empty()) {
                 slog::warn << "Image " + i + " cannot be read!" << slog::endl;
                 continue;
             }
 
-            if (w != img.cols || h != img.rows) {
-                slog::warn << "Size of the image " << i << " is not equal to WxH = " << w << "x" << h << slog::endl;
-                continue;
-            }
             if (c != img.channels()) {
                 slog::warn << "Number of channels of the image " << i << " is not equal to " << c <<slog::endl;
                 continue;
@@ -128,9 +285,7 @@ int main(int argc, char *argv[]) {
 
         if (inputImages.empty()) throw std::logic_error("Valid input images were not found!");
 
-        /** Setting batch size using image count **/
-        network.setBatchSize(imageNames.size());
-        slog::info << "Batch size is " << std::to_string(network.getBatchSize()) << slog::endl;
+        network.setBatchSize(1);
 
         // ------------------------------ Prepare output blobs -------------------------------------------------
         slog::info << "Preparing output blobs" << slog::endl;
@@ -149,41 +304,43 @@ int main(int argc, char *argv[]) {
 
             item.second->setPrecision(Precision::FP32);
         }
+
+        const SizeVector outputDims = outputInfo[firstOutputName]->getTensorDesc().getDims();
+        int scale = static_cast<int>(outputDims[3]) / tileWidth;
+        if (scale == 0 || static_cast<int>(outputDims[3]) != tileWidth * scale
+                || static_cast<int>(outputDims[2]) != tileHeight * scale) {
+            throw std::logic_error("The demo supports topologies which upscale the input by an integer factor only");
+        }
         // -----------------------------------------------------------------------------------------------------
 
+        if (FLAGS_d.find("CPU") != std::string::npos) {
+            // tiles are independent, so throughput-oriented execution via streams infers them in parallel
+            ie.SetConfig({{ CONFIG_KEY(CPU_THROUGHPUT_STREAMS), CONFIG_VALUE(CPU_THROUGHPUT_AUTO) }}, "CPU");
+        }
+
         // --------------------------- 4. Loading model to the device ------------------------------------------
         slog::info << "Loading model to the device" << slog::endl;
         ExecutableNetwork executableNetwork = ie.LoadNetwork(network, FLAGS_d);
         // -----------------------------------------------------------------------------------------------------
 
-        // --------------------------- 5. Create infer request -------------------------------------------------
-        slog::info << "Create infer request" << slog::endl;
-        InferRequest inferRequest = executableNetwork.CreateInferRequest();
-        // -----------------------------------------------------------------------------------------------------
-
-        // --------------------------- 6. Prepare input --------------------------------------------------------
-        Blob::Ptr lrInputBlob = inferRequest.GetBlob(lrInputBlobName);
-        for (size_t i = 0; i < inputImages.size(); ++i) {
-            cv::Mat img = inputImages[i];
-            matU8ToBlob<float_t>(img, lrInputBlob, i);
-
-            bool twoInputs = inputInfo.size() == 2;
-            if (twoInputs) {
-                const std::string bicInputBlobName = "1";
-                Blob::Ptr bicInputBlob = inferRequest.GetBlob(bicInputBlobName);
-
-                int w = bicInputBlob->getTensorDesc().getDims()[3];
-                int h = bicInputBlob->getTensorDesc().getDims()[2];
-
-                cv::Mat resized;
-                cv::resize(img, resized, cv::Size(w, h), 0, 0, cv::INTER_CUBIC);
-
-                matU8ToBlob<float_t>(resized, bicInputBlob, i);
+        // --------------------------- 5. Create infer requests ------------------------------------------------
+        slog::info << "Create infer requests" << slog::endl;
+        unsigned nireq = FLAGS_nireq;
+        if (nireq == 0) {
+            try {
+                nireq = executableNetwork.GetMetric(METRIC_KEY(OPTIMAL_NUMBER_OF_INFER_REQUESTS)).as<unsigned int>();
+            } catch (const details::InferenceEngineException&) {
+                nireq = 1;
             }
         }
+        std::vector<InferRequest> inferRequests;
+        for (unsigned infReqId = 0; infReqId < nireq; ++infReqId) {
+            inferRequests.push_back(executableNetwork.CreateInferRequest());
+        }
+        slog::info << "Number of infer requests is " << nireq << slog::endl;
         // -----------------------------------------------------------------------------------------------------
 
-        // --------------------------- 7. Do inference ---------------------------------------------------------
+        // --------------------------- 6. Do inference ---------------------------------------------------------
         std::cout << "To close the application, press 'CTRL+C' here";
         if (FLAGS_show) {
             std::cout << " or switch to the output window and press any key";
@@ -191,35 +348,24 @@ int main(int argc, char *argv[]) {
         std::cout << std::endl;
 
         slog::info << "Start inference" << slog::endl;
-        inferRequest.Infer();
-        // -----------------------------------------------------------------------------------------------------
-
-        // --------------------------- 8. Process output -------------------------------------------------------
-        const Blob::Ptr outputBlob = inferRequest.GetBlob(firstOutputName);
-        LockedMemory<const void> outputBlobMapped = as<MemoryBlob>(outputBlob)->rmap();
-        const auto outputData = outputBlobMapped.as<float*>();
-
-        size_t numOfImages = outputBlob->getTensorDesc().getDims()[0];
-        size_t numOfChannels = outputBlob->getTensorDesc().getDims()[1];
-        size_t h = outputBlob->getTensorDesc().getDims()[2];
-        size_t w = outputBlob->getTensorDesc().getDims()[3];
-        size_t nunOfPixels = w * h;
-
-        slog::info << "Output size [N,C,H,W]: " << numOfImages << ", " << numOfChannels << ", " << h << ", " << w << slog::endl;
-
-        for (size_t i = 0; i < numOfImages; ++i) {
-            std::vector<cv::Mat> imgPlanes;
-            if (numOfChannels == 3) {
-                imgPlanes = std::vector<cv::Mat>{
-                      cv::Mat(h, w, CV_32FC1, &(outputData[i * nunOfPixels * numOfChannels])),
-                      cv::Mat(h, w, CV_32FC1, &(outputData[i * nunOfPixels * numOfChannels + nunOfPixels])),
-                      cv::Mat(h, w, CV_32FC1, &(outputData[i * nunOfPixels * numOfChannels + nunOfPixels * 2]))};
-            } else {
-                imgPlanes = std::vector<cv::Mat>{cv::Mat(h, w, CV_32FC1, &(outputData[i * nunOfPixels * numOfChannels]))};
+        TiledUpscaler upscaler(inferRequests, lrInputBlobName, bicInputBlobName, firstOutputName,
+                               cv::Size(tileWidth, tileHeight), scale, FLAGS_overlap);
 
+        for (size_t i = 0; i < inputImages.size(); ++i) {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            std::vector<cv::Mat> imgPlanes = upscaler.upscale(inputImages[i]);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            slog::info << "Image " << i + 1 << " [W,H]: " << inputImages[i].cols << ", " << inputImages[i].rows
+                       << " is upscaled " << scale << "x by " << upscaler.lastTilesNum << " tiles in "
+                       << std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(t1 - t0).count()
+                       << " ms" << slog::endl;
+            // -------------------------------------------------------------------------------------------------
+
+            // --------------------------- 7. Process output ---------------------------------------------------
+            if (imgPlanes.size() == 1) {
                 // Post-processing for text-image-super-resolution models
                 cv::threshold(imgPlanes[0], imgPlanes[0], 0.5f, 1.0f, cv::THRESH_BINARY);
-            };
+            }
 
             for (auto & img : imgPlanes)
                 img.convertTo(img, CV_8UC1, 255);
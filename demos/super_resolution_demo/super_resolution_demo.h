@@ -22,6 +22,10 @@ static const char custom_cpu_library_message[] = "Required for CPU custom layers
 static const char custom_cldnn_message[] = "Required for GPU custom kernels."
                                             "Absolute path to the xml file with the kernels descriptions.";
 static const char show_processed_images[] = "Optional. Show processed images. Default value is false.";
+static const char num_inf_req_message[] = "Optional. Number of infer requests used to process image tiles in parallel. "
+                                          "If this option is omitted, the optimal number for the device is used.";
+static const char overlap_message[] = "Optional. Overlap of neighbouring tiles in pixels of the input image. "
+                                      "Images larger than the network input are processed by tiles. Default value is 16.";
 
 
 DEFINE_bool(h, false, help_message);
@@ -31,6 +35,8 @@ DEFINE_string(d, "CPU", target_device_message);
 DEFINE_string(l, "", custom_cpu_library_message);
 DEFINE_string(c, "", custom_cldnn_message);
 DEFINE_bool(show, false, show_processed_images);
+DEFINE_uint32(nireq, 0, num_inf_req_message);
+DEFINE_uint32(overlap, 16, overlap_message);
 
 /**
 * @brief This function show a help message
@@ -44,5 +50,7 @@ static void showUsage() {
     std::cout << "    -i \"<path>\"             " << image_message << std::endl;
     std::cout << "    -m \"<path>\"             " << model_message << std::endl;
     std::cout << "    -d \"<device>\"           " << target_device_message << std::endl;
+    std::cout << "    -nireq \"<integer>\"      " << num_inf_req_message << std::endl;
+    std::cout << "    -overlap \"<integer>\"    " << overlap_message << std::endl;
     std::cout << "    -show                   " << show_processed_images << std::endl;
 }